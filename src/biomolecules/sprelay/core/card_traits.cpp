@@ -0,0 +1,113 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      card_traits.cpp
+ * \brief     Compile-time traits of Velleman K8090 compatible relay cards.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "card_traits.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \struct K8090Traits
+ *
+ * The traits describe everything in which Velleman compatible cards can differ: command and response codes, command
+ * priorities, relay count, timing defaults and USB identifiers. The card specific class is then only a K8090
+ * subclass, which passes card_descriptor() of its traits to the protected K8090 constructor. The header is installed
+ * with the library, so the subclasses can be defined outside of it.
+ *
+ * The traits are checked at compile time, but K8090 is parameterized by the runtime CardDescriptor, not by the traits
+ * type, because moc doesn't support class templates. The card type is never tested on the hot path, but each command
+ * code, response code and relay count is read from the descriptor through a pointer, which costs one memory
+ * indirection per lookup compared to tables compiled into the code.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+// initialization of static member variables
+constexpr unsigned int K8090Traits::kRelayCount;
+constexpr int K8090Traits::kCommandDelay;
+constexpr int K8090Traits::kFactoryDefaultsDelayFactor;
+constexpr int K8090Traits::kFailureDelay;
+constexpr int K8090Traits::kMaxFailureCount;
+constexpr quint16 K8090Traits::kProductID;
+constexpr quint16 K8090Traits::kVendorID;
+
+
+/*!
+ * \struct CardDescriptor
+ *
+ * Besides the command and priority tables, the descriptor contains the inverse of the response table, which maps
+ * every command byte received from the card to ResponseID in one lookup. Unknown bytes map to ResponseID::None. It is
+ * the runtime form of the traits, which K8090 reads when it encodes the commands and decodes the responses.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Creates card descriptor, used by card_descriptor().
+ * \param commands Command codes indexed by CommandID.
+ * \param priorities Command priorities indexed by CommandID.
+ * \param responses Response codes indexed by ResponseID.
+ * \param relay_count Number of relays.
+ * \param command_delay Default command delay in ms, see K8090::setCommandDelay().
+ * \param factory_defaults_delay_factor Multiple of command delay needed by CommandID::ResetFactoryDefaults.
+ * \param failure_delay Default failure delay in ms, see K8090::setFailureDelay().
+ * \param max_failure_count Default max failure count, see K8090::setMaxFailureCount().
+ * \param product_id Product id for the automatic port identification.
+ * \param vendor_id Vendor id for the automatic port identification.
+ * \return The descriptor.
+ */
+CardDescriptor make_card_descriptor(const CommandTable& commands, const PriorityTable& priorities,
+    const ResponseTable& responses, unsigned int relay_count, int command_delay, int factory_defaults_delay_factor,
+    int failure_delay, int max_failure_count, quint16 product_id, quint16 vendor_id)
+{
+    CardDescriptor descriptor{commands.data(), priorities.data(), {}, relay_count, command_delay,
+        factory_defaults_delay_factor, failure_delay, max_failure_count, product_id, vendor_id};
+    descriptor.response_ids.fill(ResponseID::None);
+    for (unsigned int i = 0; i < responses.size(); ++i) {
+        descriptor.response_ids[responses[i]] = static_cast<ResponseID>(i);
+    }
+    return descriptor;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,130 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      card_traits.h
+ * \brief     Compile-time traits of Velleman K8090 compatible relay cards.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_CARD_TRAITS_H_
+#define BIOMOLECULES_SPRELAY_CORE_CARD_TRAITS_H_
+
+#include <array>
+
+#include <QtGlobal>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_commands.h"
+#include "k8090_defines.h"
+#include "k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Array of binary command codes indexed by CommandID.
+using CommandTable = std::array<unsigned char, as_number(CommandID::None)>;
+/// \brief Array of command priorities indexed by CommandID.
+using PriorityTable = std::array<int, as_number(CommandID::None)>;
+/// \brief Array of binary response codes indexed by ResponseID.
+using ResponseTable = std::array<unsigned char, as_number(ResponseID::None)>;
+
+/// \brief Compile-time description of the Velleman %K8090 card protocol and timing.
+/// \headerfile ""
+struct K8090Traits
+{
+    static constexpr unsigned int kRelayCount = 8;             ///< Number of relays.
+    static constexpr int kCommandDelay = 50;                   ///< Default command delay in ms.
+    static constexpr int kFactoryDefaultsDelayFactor = 2;      ///< Command delay multiple after factory defaults.
+    static constexpr int kFailureDelay = 1000;                 ///< Default failure delay in ms.
+    static constexpr int kMaxFailureCount = 3;                 ///< Default max failure count.
+    static constexpr quint16 kProductID = impl_::kProductID;  ///< USB product id.
+    static constexpr quint16 kVendorID = impl_::kVendorID;    ///< USB vendor id.
+
+    /// \brief Command codes indexed by CommandID.
+    static const CommandTable& commands() { return kCommands; }
+    /// \brief Command priorities indexed by CommandID.
+    static const PriorityTable& priorities() { return kPriorities; }
+    /// \brief Response codes indexed by ResponseID.
+    static const ResponseTable& responses() { return kResponses; }
+};
+
+/// \brief Card traits resolved to tables used by K8090 when it talks to the card.
+/// \headerfile ""
+struct CardDescriptor
+{
+    const unsigned char* commands;             ///< Command codes indexed by CommandID.
+    const int* priorities;                     ///< Command priorities indexed by CommandID.
+    std::array<ResponseID, 256> response_ids;  ///< ResponseID indexed by the received response code.
+    unsigned int relay_count;                  ///< Number of relays.
+    int command_delay;                         ///< Default command delay in ms.
+    int factory_defaults_delay_factor;         ///< Command delay multiple after factory defaults.
+    int failure_delay;                         ///< Default failure delay in ms.
+    int max_failure_count;                     ///< Default max failure count.
+    quint16 product_id;                        ///< USB product id.
+    quint16 vendor_id;                         ///< USB vendor id.
+};
+
+SPRELAY_LIBRARY_EXPORT CardDescriptor make_card_descriptor(const CommandTable& commands,
+    const PriorityTable& priorities, const ResponseTable& responses, unsigned int relay_count, int command_delay,
+    int factory_defaults_delay_factor, int failure_delay, int max_failure_count, quint16 product_id, quint16 vendor_id);
+
+/*!
+ * \brief Descriptor of the card described by TTraits.
+ *
+ * The descriptor is created once per traits type and lives until the program exits, so K8090 can keep a pointer to it.
+ *
+ * \tparam TTraits Traits type with the same members as K8090Traits.
+ * \return The descriptor.
+ */
+template<typename TTraits>
+const CardDescriptor& card_descriptor()
+{
+    static_assert(TTraits::kRelayCount > 0 && TTraits::kRelayCount <= 8, "The card must have from 1 to 8 relays.");
+    static_assert(TTraits::kCommandDelay >= 0, "The command delay can't be negative.");
+    static_assert(TTraits::kFactoryDefaultsDelayFactor > 0, "The factory defaults delay factor must be positive.");
+    static const CardDescriptor descriptor = make_card_descriptor(TTraits::commands(), TTraits::priorities(),
+        TTraits::responses(), TTraits::kRelayCount, TTraits::kCommandDelay, TTraits::kFactoryDefaultsDelayFactor,
+        TTraits::kFailureDelay, TTraits::kMaxFailureCount, TTraits::kProductID, TTraits::kVendorID);
+    return descriptor;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_CARD_TRAITS_H_
@@ -0,0 +1,166 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      coalescing_window.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CoalescingWindow class which adapts the micro-batching
+ *            window of command bursts.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "coalescing_window.h"
+
+#include <algorithm>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class CoalescingWindow
+ *
+ * When a command arrives at the idle line, K8090 can hold it back for a short window, so the commands following it in
+ * the same burst are merged in the command queue before the first one is sent. The window is a trade-off between the
+ * latency of lone commands and the number of merged commands, so it is adapted to the observed bursts.
+ *
+ * Each burst starts with CoalescingWindow::startBurst() and the following commands are reported with the time elapsed
+ * since the start by CoalescingWindow::commandArrived(). The commands arriving later than the maximal window after the
+ * start do not belong to the burst. The commands arriving after the window closes are counted too, so the window grows
+ * again, if the bursts become longer. When the next burst starts, the window moves halfway to twice the span of the
+ * previous burst, or to 1 ms, if the previous command was alone. CoalescingWindow::endBurst() ends the burst
+ * explicitly, for example when the user flushes the commands.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs the disabled window.
+ */
+CoalescingWindow::CoalescingWindow()
+    : max_window_{0},
+      window_{0},
+      bursting_{false},
+      burst_size_{0},
+      burst_span_{0}
+{}
+
+
+/*!
+ * \brief Sets the maximal window and restarts the adaptation from it.
+ * \param msec The maximal window in ms, 0 disables the coalescing.
+ */
+void CoalescingWindow::setMaxWindow(int msec)
+{
+    max_window_ = std::max(msec, 0);
+    window_ = max_window_;
+    bursting_ = false;
+    burst_size_ = 0;
+    burst_span_ = 0;
+}
+
+
+/*!
+ * \brief Starts a new burst with its first command.
+ *
+ * The previous burst is ended and the window is adapted to it.
+ *
+ * \return The window in ms, for which the first command should be held back.
+ */
+int CoalescingWindow::startBurst()
+{
+    if (burst_size_ > 0) {
+        adapt();
+    }
+    bursting_ = true;
+    burst_size_ = 1;
+    burst_span_ = 0;
+    return window_;
+}
+
+
+/*!
+ * \brief Reports the command following the first command of the burst.
+ * \param elapsed Time in ms elapsed since the burst start.
+ */
+void CoalescingWindow::commandArrived(qint64 elapsed)
+{
+    if (!bursting_ || elapsed > max_window_) {
+        return;
+    }
+    ++burst_size_;
+    burst_span_ = std::max(burst_span_, static_cast<int>(elapsed));
+}
+
+
+/*!
+ * \brief Ends the burst, the commands arriving later are not counted.
+ */
+void CoalescingWindow::endBurst()
+{
+    bursting_ = false;
+}
+
+
+/*!
+ * \fn bool CoalescingWindow::enabled() const
+ * \brief Tests if the coalescing is enabled.
+ */
+
+/*!
+ * \fn int CoalescingWindow::maxWindow() const
+ * \brief The maximal window in ms.
+ */
+
+/*!
+ * \fn int CoalescingWindow::window() const
+ * \brief The current window in ms.
+ */
+
+/*!
+ * \fn int CoalescingWindow::burstSize() const
+ * \brief The number of commands in the current or the last burst.
+ */
+
+
+// moves the window halfway to the target derived from the last burst
+void CoalescingWindow::adapt()
+{
+    int target = burst_size_ > 1 ? std::min(max_window_, 2 * burst_span_ + 1) : 1;
+    window_ = std::max(1, target + (window_ - target) / 2);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,83 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      coalescing_window.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CoalescingWindow class which adapts the micro-batching
+ *            window of command bursts.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_COALESCING_WINDOW_H_
+#define BIOMOLECULES_SPRELAY_CORE_COALESCING_WINDOW_H_
+
+#include <QtGlobal>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Adapts the time, for which the first command of a burst is held back, to the observed bursts.
+/// \headerfile ""
+class CoalescingWindow
+{
+public:
+    CoalescingWindow();
+
+    void setMaxWindow(int msec);
+    int startBurst();
+    void commandArrived(qint64 elapsed);
+    void endBurst();
+
+    bool enabled() const { return max_window_ > 0; }
+    int maxWindow() const { return max_window_; }
+    int window() const { return window_; }
+    int burstSize() const { return burst_size_; }
+
+private:
+    void adapt();
+
+    int max_window_;
+    int window_;
+    bool bursting_;
+    int burst_size_;
+    int burst_span_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_COALESCING_WINDOW_H_
@@ -0,0 +1,322 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      command_log.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CommandLog class which implements the write-ahead log of
+ *            commands.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "command_log.h"
+
+#include <QFile>
+#include <QtGlobal>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// forces the written data to the storage device
+bool sync_file(int handle)
+{
+#ifdef Q_OS_WIN
+    return _commit(handle) == 0;
+#else
+    return fsync(handle) == 0;
+#endif
+}
+
+}  // namespace
+
+/*!
+ * \class CommandLog
+ *
+ * The log is used by K8090 to survive crashes of the controlling process. Each accepted command, which changes the
+ * card state, is appended as a command record. When the card becomes idle, a checkpoint record with the last known
+ * relay state is appended, which acknowledges all the previous commands. The records are collected in memory and
+ * written by group commit, see CommandLog::takePendingRecords() and CommandLog::commit(), so one synchronization of
+ * the file is shared by the whole burst of commands. The log is compacted at checkpoints, the records before the last
+ * checkpoint are dropped by truncation of the file.
+ *
+ * Each record has 6 bytes, the record kind, 4 data bytes and the checksum computed by check_sum(). The command record
+ * stores the command id, mask and parameters, the checkpoint record stores the flag, if the relay state is known, and
+ * the relay state. Recovery stops at the first invalid record, so a torn write at the end of the file is ignored.
+ *
+ * \remark reentrant
+ */
+
+// initialization of static member variables
+
+// Kind of record with accepted command.
+const unsigned char CommandLog::kCommandRecord_ = 'C';
+// Kind of record which acknowledges all the previous commands.
+const unsigned char CommandLog::kCheckpointRecord_ = 'K';
+// Size of one record in bytes.
+const int CommandLog::kRecordSize_ = 6;
+
+
+/*!
+ * \brief Constructs empty log.
+ */
+CommandLog::CommandLog()
+    : last_checkpoint_{-1},
+      uncommitted_commands_{false},
+      unacknowledged_commands_{false},
+      has_recovered_relays_{false},
+      recovered_relays_{RelayID::None}
+{}
+
+
+/*!
+ * \brief Tests if the command changes the card state and so it is logged.
+ * \param id The command id.
+ * \return True if the command is logged.
+ */
+bool CommandLog::isLogged(CommandID id)
+{
+    switch (id) {
+        case CommandID::RelayOn:
+        case CommandID::RelayOff:
+        case CommandID::ToggleRelay:
+        case CommandID::SetButtonMode:
+        case CommandID::StartTimer:
+        case CommandID::SetTimer:
+        case CommandID::ResetFactoryDefaults:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/*!
+ * \brief Computes relay state after the commands are applied.
+ *
+ * Timed relays are not included, because their state depends on the time elapsed since the timer was started.
+ *
+ * \param start The relay state before the commands.
+ * \param commands The commands.
+ * \return The relay state.
+ */
+RelayID CommandLog::expectedRelays(RelayID start, const std::vector<CardCommand>& commands)
+{
+    RelayID relays = start;
+    for (const CardCommand& command : commands) {
+        switch (command.id) {
+            case CommandID::RelayOn:
+                relays |= command.mask;
+                break;
+            case CommandID::RelayOff:
+                relays &= ~command.mask;
+                break;
+            case CommandID::ToggleRelay:
+                relays ^= command.mask;
+                break;
+            case CommandID::ResetFactoryDefaults:
+                relays = RelayID::None;
+                break;
+            default:
+                break;
+        }
+    }
+    return relays;
+}
+
+
+/*!
+ * \brief Writes records to the log file and synchronizes it to the storage device.
+ * \param file The log file opened for appending.
+ * \param records The records obtained by CommandLog::takePendingRecords().
+ * \param truncate If the file should be truncated before the records are written.
+ * \return True if the records are durable.
+ */
+bool CommandLog::commit(QFile* file, const QByteArray& records, bool truncate)
+{
+    if (truncate && (!file->resize(0) || !file->seek(0))) {
+        return false;
+    }
+    if (file->write(records) != records.size() || !file->flush()) {
+        return false;
+    }
+    return sync_file(file->handle());
+}
+
+
+/*!
+ * \brief Appends the command record.
+ * \param command The accepted command.
+ */
+void CommandLog::append(const CardCommand& command)
+{
+    appendRecord(kCommandRecord_, static_cast<unsigned char>(as_number(command.id)), as_number(command.mask),
+        command.param1, command.param2);
+    uncommitted_commands_ = true;
+    unacknowledged_commands_ = true;
+}
+
+
+/*!
+ * \brief Appends the checkpoint record, which acknowledges all the previous commands.
+ * \param has_relays If the relay state is known.
+ * \param relays The relay state.
+ */
+void CommandLog::checkpoint(bool has_relays, RelayID relays)
+{
+    last_checkpoint_ = pending_.size();
+    appendRecord(kCheckpointRecord_, has_relays ? 1u : 0u, as_number(relays), 0, 0);
+    unacknowledged_commands_ = false;
+}
+
+
+/*!
+ * \brief Takes the records, which are waiting for the group commit.
+ * \param truncate Set to true if the records contain a checkpoint, so the log file can be truncated before they are
+ * written.
+ * \return The records.
+ */
+QByteArray CommandLog::takePendingRecords(bool* truncate)
+{
+    QByteArray records;
+    *truncate = last_checkpoint_ >= 0;
+    if (*truncate) {
+        records = pending_.mid(last_checkpoint_);
+    } else {
+        records = pending_;
+    }
+    pending_.clear();
+    last_checkpoint_ = -1;
+    uncommitted_commands_ = false;
+    return records;
+}
+
+
+/*!
+ * \fn bool CommandLog::hasPendingRecords() const
+ * \brief Tests if some records wait for the group commit.
+ */
+
+/*!
+ * \fn bool CommandLog::hasUncommittedCommands() const
+ * \brief Tests if some command records wait for the group commit, so the commands cannot be sent yet.
+ */
+
+/*!
+ * \fn bool CommandLog::hasUnacknowledgedCommands() const
+ * \brief Tests if some commands were appended after the last checkpoint.
+ */
+
+
+/*!
+ * \brief Recovers commands which were not acknowledged before the log was closed.
+ * \param data Content of the log file.
+ * \return Length of the valid part of the data in bytes.
+ */
+int CommandLog::recover(const QByteArray& data)
+{
+    clearRecovered();
+    int length = 0;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.constData());
+    for (; length + kRecordSize_ <= data.size(); length += kRecordSize_) {
+        const unsigned char* record = bytes + length;
+        if (check_sum(record, kRecordSize_ - 1) != record[kRecordSize_ - 1]) {
+            break;
+        }
+        if (record[0] == kCommandRecord_ && record[1] < as_number(CommandID::None)) {
+            recovered_commands_.push_back(
+                CardCommand{static_cast<CommandID>(record[1]), static_cast<RelayID>(record[2]), record[3], record[4]});
+        } else if (record[0] == kCheckpointRecord_) {
+            recovered_commands_.clear();
+            has_recovered_relays_ = record[1] != 0u;
+            recovered_relays_ = static_cast<RelayID>(record[2]);
+        } else {
+            break;
+        }
+    }
+    unacknowledged_commands_ = !recovered_commands_.empty();
+    return length;
+}
+
+
+/*!
+ * \fn const std::vector<CardCommand>& CommandLog::recoveredCommands() const
+ * \brief Commands recovered by CommandLog::recover(), which were not acknowledged by a checkpoint.
+ */
+
+/*!
+ * \fn bool CommandLog::hasRecoveredRelays() const
+ * \brief Tests if the last recovered checkpoint contains known relay state.
+ */
+
+/*!
+ * \fn RelayID CommandLog::recoveredRelays() const
+ * \brief Relay state stored in the last recovered checkpoint.
+ */
+
+
+/*!
+ * \brief Forgets the recovered commands after they are replayed.
+ */
+void CommandLog::clearRecovered()
+{
+    recovered_commands_.clear();
+    has_recovered_relays_ = false;
+    recovered_relays_ = RelayID::None;
+}
+
+
+// encodes one record into the pending records
+void CommandLog::appendRecord(
+    unsigned char kind, unsigned char b1, unsigned char b2, unsigned char b3, unsigned char b4)
+{
+    const unsigned char record[kRecordSize_ - 1] = {kind, b1, b2, b3, b4};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    pending_.append(reinterpret_cast<const char*>(record), kRecordSize_ - 1);
+    pending_.append(static_cast<char>(check_sum(record, kRecordSize_ - 1)));
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
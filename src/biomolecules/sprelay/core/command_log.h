@@ -0,0 +1,103 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      command_log.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CommandLog class which implements the write-ahead log of
+ *            commands.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_COMMAND_LOG_H_
+#define BIOMOLECULES_SPRELAY_CORE_COMMAND_LOG_H_
+
+#include <vector>
+
+#include <QByteArray>
+
+#include "k8090_defines.h"
+
+// forward declarations
+class QFile;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Encodes accepted commands and checkpoints into the write-ahead log and recovers unacknowledged commands.
+/// \headerfile ""
+class CommandLog
+{
+public:
+    CommandLog();
+
+    static bool isLogged(CommandID id);
+    static RelayID expectedRelays(RelayID start, const std::vector<CardCommand>& commands);
+    static bool commit(QFile* file, const QByteArray& records, bool truncate);
+
+    void append(const CardCommand& command);
+    void checkpoint(bool has_relays, RelayID relays);
+    bool hasPendingRecords() const { return !pending_.isEmpty(); }
+    bool hasUncommittedCommands() const { return uncommitted_commands_; }
+    bool hasUnacknowledgedCommands() const { return unacknowledged_commands_; }
+    QByteArray takePendingRecords(bool* truncate);
+
+    int recover(const QByteArray& data);
+    const std::vector<CardCommand>& recoveredCommands() const { return recovered_commands_; }
+    bool hasRecoveredRelays() const { return has_recovered_relays_; }
+    RelayID recoveredRelays() const { return recovered_relays_; }
+    void clearRecovered();
+
+private:
+    static const unsigned char kCommandRecord_;
+    static const unsigned char kCheckpointRecord_;
+    static const int kRecordSize_;
+
+    void appendRecord(unsigned char kind, unsigned char b1, unsigned char b2, unsigned char b3, unsigned char b4);
+
+    QByteArray pending_;
+    int last_checkpoint_;
+    bool uncommitted_commands_;
+    bool unacknowledged_commands_;
+    std::vector<CardCommand> recovered_commands_;
+    bool has_recovered_relays_;
+    RelayID recovered_relays_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_COMMAND_LOG_H_
@@ -38,12 +38,15 @@
 #ifndef BIOMOLECULES_SPRELAY_CORE_COMMAND_QUEUE_H_
 #define BIOMOLECULES_SPRELAY_CORE_COMMAND_QUEUE_H_
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <initializer_list>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include <QList>
 
@@ -94,6 +97,37 @@ private:
 
 }  // namespace impl_
 
+/// \brief std::vector with the part of QList interface used by CommandQueue.
+/// \headerfile ""
+template<typename T>
+class VectorList
+{
+public:
+    VectorList() = default;
+    VectorList(std::initializer_list<T> items) : items_{items} {}
+
+    int size() const { return static_cast<int>(items_.size()); }
+    bool empty() const { return items_.empty(); }
+    bool isEmpty() const { return items_.empty(); }
+    const T& at(int idx) const { return items_[static_cast<std::size_t>(idx)]; }
+    const T& operator[](int idx) const { return items_[static_cast<std::size_t>(idx)]; }
+    T& operator[](int idx) { return items_[static_cast<std::size_t>(idx)]; }
+    void append(const T& item) { items_.push_back(item); }
+    bool removeOne(const T& item)
+    {
+        auto it = std::find(items_.begin(), items_.end(), item);
+        if (it == items_.end()) {
+            return false;
+        }
+        items_.erase(it);
+        return true;
+    }
+    void clear() { items_.clear(); }
+
+private:
+    std::vector<T> items_;
+};
+
 /// \brief Queue used for storing command before invokations.
 /// \headerfile ""
 template<typename TCommand, int tSize, template<typename> class TList = QList>
@@ -101,6 +101,18 @@ namespace command_queue {
  */
 
 
+/*!
+ * \class biomolecules::sprelay::core::command_queue::VectorList
+ *
+ * The list can be used as the TList parameter of CommandQueue instead of QList. Unlike QList, it allocates through
+ * the global operator new, so its allocations are seen by the allocation budget tests, and VectorList::clear() and
+ * VectorList::removeOne() keep the capacity, so the steady state of the queue doesn't allocate the index.
+ *
+ * \tparam T Stored item type.
+ * \remark reentrant
+ */
+
+
 /*!
  * \fn const TList<const TCommand*>& PendingCommands::operator[](std::size_t id) const
  * \brief Direct constant member access.
@@ -46,10 +46,24 @@ namespace impl_ {
 
 /*!
  * \class ConcurentCommandQueue
+ *
+ * The commands with the same id are indexed by command_queue::VectorList, which reuses its storage, so the queue
+ * doesn't allocate the index once it is warmed up.
+ *
  * \remark thread-safe
  */
 
 
+/*!
+ * \brief Constructs empty queue.
+ * \param priorities Command priorities indexed by CommandID, see CardDescriptor. The array must outlive the queue.
+ * \param policy The scheduling policy. PriorityQueuePolicy is used if it is nullptr.
+ */
+ConcurentCommandQueue::ConcurentCommandQueue(const int* priorities, std::shared_ptr<const QueuePolicy> policy)
+    : priorities_{priorities}, policy_{policy ? std::move(policy) : QueuePolicy::create(SchedulingPolicy::Priority)}
+{}
+
+
 /*!
  * For more details see command_queue::CommandQueue::empty().
  */
@@ -60,6 +74,16 @@ bool ConcurentCommandQueue::empty() const
 }
 
 
+/*!
+ * For more details see command_queue::CommandQueue::size().
+ */
+std::size_t ConcurentCommandQueue::size() const
+{
+    std::lock_guard<std::mutex> lock{global_mutex_};
+    return Predecessor::size();
+}
+
+
 /*!
  * For more details see command_queue::CommandQueue::pop().
  */
@@ -86,42 +110,52 @@ unsigned int ConcurentCommandQueue::stampCounter() const
  * \param mask Mask parameter of the command.
  * \param param1 First parameter of the command.
  * \param param2 Second parameter of the command.
+ * \return True if the command was merged into some already enqueued command.
  *
  * Tests, if compatible command is already in the queue and if so, the command is updated, otherwise a new command
  * is inserted. It also tests for CommandID::RelayOn and CommandID::RelayOff command oposites and removes possible
- * conflicts from the queue. CommandID::ToggleRelay commands are not subjected to such a test.
+ * conflicts from the queue. CommandID::ToggleRelay commands are not subjected to such a test. The priority of the
+ * command, merging and the opposites test are controlled by the policy, see QueuePolicy.
  */
-void ConcurentCommandQueue::updateOrPush(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+bool ConcurentCommandQueue::updateOrPush(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
 {
     std::lock_guard<std::mutex> lock{global_mutex_};
     // TODO(lumik): don't insert query commands if set command with the same response is already inside
     // TODO(lumik): treat commands, which are directly sended better (avoid duplication)
-    Command command{command_id, kPriorities[as_number(command_id)], as_number(mask), param1, param2};
+    Command command{command_id, policy_->priority(command_id, priorities_), as_number(mask), param1, param2};
 
-    const QList<const Command*>& pending_command_list = Predecessor::get(command_id);
-    // if there is no command with the same id waiting
-    if (pending_command_list.isEmpty()) {
+    const CommandList& pending_command_list = Predecessor::get(command_id);
+    bool merged = false;
+    if (!policy_->merges(command_id)) {
+        Predecessor::push(command, false);
+    } else if (pending_command_list.isEmpty()) {  // if there is no command with the same id waiting
         Predecessor::push(command);
     } else if (!updateCommandImpl(command_id, command)) {
         // else try to update stored command and if it is not possible (updateCommandImpl returns false), push it to the
         // queue
         Predecessor::push(command, false);
+    } else {
+        merged = true;
     }
 
     // if the enqueued command was switch relay on or off command and there is the oposit command stored
     // TODO(lumik): test if updated oposite command doesn't update any relay and if it does, remove it from the
     // queue
+    if (!policy_->cancelsOpposites()) {
+        return merged;
+    }
     if (command_id == CommandID::RelayOn) {
-        const QList<const impl_::Command*>& off_pending_command_list = Predecessor::get(CommandID::RelayOff);
+        const CommandList& off_pending_command_list = Predecessor::get(CommandID::RelayOff);
         if (!off_pending_command_list.isEmpty()) {
             updateCommandImpl(CommandID::RelayOff, command);
         }
     } else if (command_id == CommandID::RelayOff) {
-        const QList<const impl_::Command*>& on_pending_command_list = Predecessor::get(CommandID::RelayOn);
+        const CommandList& on_pending_command_list = Predecessor::get(CommandID::RelayOn);
         if (!on_pending_command_list.isEmpty()) {
             updateCommandImpl(CommandID::RelayOn, command);
         }
     }
+    return merged;
 }
 
 
@@ -137,10 +171,38 @@ int ConcurentCommandQueue::count(CommandID command_id) const
 }
 
 
+/*!
+ * \brief Gets the scheduling policy.
+ * \return The policy.
+ */
+std::shared_ptr<const QueuePolicy> ConcurentCommandQueue::policy() const
+{
+    std::lock_guard<std::mutex> lock{global_mutex_};
+    return policy_;
+}
+
+
+/*!
+ * \brief Sets the scheduling policy.
+ *
+ * The policy is applied to the commands enqueued after the change, the pending commands keep their priorities.
+ *
+ * \param policy The policy. PriorityQueuePolicy is used if it is nullptr.
+ */
+void ConcurentCommandQueue::setPolicy(std::shared_ptr<const QueuePolicy> policy)
+{
+    if (!policy) {
+        policy = QueuePolicy::create(SchedulingPolicy::Priority);
+    }
+    std::lock_guard<std::mutex> lock{global_mutex_};
+    policy_ = std::move(policy);
+}
+
+
 // helper method which updates already enqueued command
 bool ConcurentCommandQueue::updateCommandImpl(CommandID command_id, const Command& command)
 {
-    const QList<const impl_::Command*>& pending_command_list = Predecessor::get(command_id);
+    const CommandList& pending_command_list = Predecessor::get(command_id);
     // check if equal command is in pending command list
     int compatible_idx = pending_command_list.size();
     for (int i = 0; i < pending_command_list.size(); ++i) {
@@ -40,10 +40,14 @@
 #ifndef BIOMOLECULES_SPRELAY_CORE_CONCURENT_COMMAND_QUEUE_H_
 #define BIOMOLECULES_SPRELAY_CORE_CONCURENT_COMMAND_QUEUE_H_
 
+#include <memory>
+#include <mutex>
+
 #include "command_queue.h"
 #include "k8090_commands.h"
 #include "k8090_defines.h"
 #include "k8090_utils.h"
+#include "queue_policy.h"
 
 namespace biomolecules {
 namespace sprelay {
@@ -53,19 +57,30 @@ namespace impl_ {
 
 /// \brief Thread-safe version of command_queue::CommandQueue adapted for usage in K8090 class.
 /// \headerfile ""
-class ConcurentCommandQueue : private command_queue::CommandQueue<Command, as_number(k8090::CommandID::None)>
+class ConcurentCommandQueue
+    : private command_queue::CommandQueue<Command, as_number(k8090::CommandID::None), command_queue::VectorList>
 {
-    using Predecessor = command_queue::CommandQueue<Command, as_number(k8090::CommandID::None)>;
+    using Predecessor =
+        command_queue::CommandQueue<Command, as_number(k8090::CommandID::None), command_queue::VectorList>;
+    using CommandList = command_queue::VectorList<const Command*>;
 
 public:
+    explicit ConcurentCommandQueue(
+        const int* priorities = kPriorities.data(), std::shared_ptr<const QueuePolicy> policy = nullptr);
+
     bool empty() const;
+    std::size_t size() const;
     Command pop();
     unsigned int stampCounter() const;
-    void updateOrPush(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2);
+    bool updateOrPush(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2);
     int count(CommandID command_id) const;
+    std::shared_ptr<const QueuePolicy> policy() const;
+    void setPolicy(std::shared_ptr<const QueuePolicy> policy);
 
 private:
     bool updateCommandImpl(CommandID command_id, const Command& command);
+    const int* priorities_;
+    std::shared_ptr<const QueuePolicy> policy_;
     mutable std::mutex global_mutex_;
 };
 
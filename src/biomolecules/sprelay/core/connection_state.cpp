@@ -0,0 +1,165 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      connection_state.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ConnectionState class which drives the connection
+ *            lifecycle of K8090.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "connection_state.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// the phases as stored in the state word
+const unsigned char kDisconnected = as_number(ConnectionPhase::Disconnected);
+const unsigned char kConnecting = as_number(ConnectionPhase::Connecting);
+const unsigned char kConnected = as_number(ConnectionPhase::Connected);
+const unsigned char kRejected = 0xFFu;
+
+const unsigned int kPhaseCount = 3;
+const unsigned int kEventCount = 3;
+const unsigned int kResponseCount = as_number(ResponseID::None) + 1;
+
+// next phase indexed by the current phase and the event
+const unsigned char kTransitions[kPhaseCount][kEventCount] = {
+    // Connect     Establish    Disconnect
+    {kConnecting, kRejected, kRejected},       // Disconnected
+    {kRejected, kConnected, kDisconnected},    // Connecting
+    {kConnecting, kRejected, kDisconnected}};  // Connected
+
+// response processing indexed by the current phase and the response
+const ResponseAction kFail = ResponseAction::Fail;
+const ResponseAction kIgnore = ResponseAction::Ignore;
+const ResponseAction kDeliver = ResponseAction::Deliver;
+const ResponseAction kHandshake = ResponseAction::Handshake;
+const ResponseAction kResponseActions[kPhaseCount][kResponseCount] = {
+    // ButtonMode, Timer, ButtonStatus, RelayStatus, JumperStatus, FirmwareVersion, None
+    {kFail, kFail, kIgnore, kIgnore, kFail, kFail, kFail},                          // Disconnected
+    {kHandshake, kHandshake, kIgnore, kHandshake, kHandshake, kHandshake, kFail},  // Connecting
+    {kDeliver, kDeliver, kDeliver, kDeliver, kDeliver, kDeliver, kFail}};          // Connected
+
+}  // namespace
+
+
+/*!
+ * \class ConnectionState
+ *
+ * The phase is stored in one atomic word, so it can be tested from any thread without locking and the response
+ * processing needs only one lookup per frame. The phase is changed only by ConnectionState::transition(), which
+ * follows the transition table:
+ *
+ * phase \\ event | Connect    | Establish | Disconnect
+ * ------------- | ---------- | --------- | ------------
+ * Disconnected  | Connecting | rejected  | rejected
+ * Connecting    | rejected   | Connected | Disconnected
+ * Connected     | Connecting | rejected  | Disconnected
+ *
+ * The response processing is given by ConnectionState::responseAction(). The button status is an unsolicited event,
+ * so it is delivered only to the connected card and it is never treated as failure. The relay status can be
+ * unsolicited too, so it is dropped when the card is disconnected. The other responses answer queries, so they fail
+ * when the card is disconnected.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs the state in the ConnectionPhase::Disconnected phase.
+ */
+ConnectionState::ConnectionState() : state_{kDisconnected} {}
+
+
+/*!
+ * \brief Changes the phase according to the transition table.
+ *
+ * The transition is atomic, so only one of the concurrent transitions from the same phase succeeds.
+ *
+ * \param event The event.
+ * \return False if the event is rejected in the current phase.
+ */
+bool ConnectionState::transition(ConnectionEvent event)
+{
+    unsigned char current = state_.load(std::memory_order_acquire);
+    unsigned char next;
+    do {
+        next = kTransitions[current][as_number(event)];
+        if (next == kRejected) {
+            return false;
+        }
+    } while (!state_.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+}
+
+
+/*!
+ * \brief Looks up the processing of the response in the current phase.
+ * \param response The response.
+ * \return The action.
+ */
+ResponseAction ConnectionState::responseAction(ResponseID response) const
+{
+    return kResponseActions[state_.load(std::memory_order_acquire)][as_number(response)];
+}
+
+
+/*!
+ * \brief The current phase.
+ * \return The phase.
+ */
+ConnectionPhase ConnectionState::phase() const
+{
+    return static_cast<ConnectionPhase>(state_.load(std::memory_order_acquire));
+}
+
+
+/*!
+ * \fn bool ConnectionState::isConnected() const
+ * \brief Tests if the phase is ConnectionPhase::Connected.
+ */
+
+/*!
+ * \fn bool ConnectionState::isActive() const
+ * \brief Tests if the phase is ConnectionPhase::Connecting or ConnectionPhase::Connected.
+ */
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,102 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      connection_state.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ConnectionState class which drives the connection
+ *            lifecycle of K8090.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_CONNECTION_STATE_H_
+#define BIOMOLECULES_SPRELAY_CORE_CONNECTION_STATE_H_
+
+#include <atomic>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// Phase of the connection lifecycle.
+enum struct ConnectionPhase : unsigned char {
+    Disconnected,  ///< The card is not connected.
+    Connecting,    ///< The port is opened and the initial queries are pending.
+    Connected      ///< The card is connected.
+};
+
+
+/// Event changing the connection phase.
+enum struct ConnectionEvent : unsigned char {
+    Connect,    ///< The connection is requested.
+    Establish,  ///< The initial queries are answered.
+    Disconnect  ///< The connection is closed or it failed.
+};
+
+
+/// The way K8090 processes the response in the current connection phase.
+enum struct ResponseAction : unsigned char {
+    Fail,       ///< The response is not expected, it is treated as the command failure.
+    Ignore,     ///< The response is dropped.
+    Deliver,    ///< The response is delivered and the next command is sent.
+    Handshake   ///< The response is delivered and it completes the connection, if no initial query is pending.
+};
+
+
+/// \brief Atomic connection phase with table-driven transitions and response dispatch.
+/// \headerfile ""
+class ConnectionState
+{
+public:
+    ConnectionState();
+
+    bool transition(ConnectionEvent event);
+    ResponseAction responseAction(ResponseID response) const;
+
+    ConnectionPhase phase() const;
+    bool isConnected() const { return phase() == ConnectionPhase::Connected; }
+    bool isActive() const { return phase() != ConnectionPhase::Disconnected; }
+
+private:
+    std::atomic<unsigned char> state_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_CONNECTION_STATE_H_
@@ -0,0 +1,309 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      dwell_filter.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::DwellFilter class which enforces minimal dwell time between
+ *            relay transitions.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "dwell_filter.h"
+
+#include <chrono>
+
+#include "k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class DwellFilter
+ *
+ * The filter protects relay contacts and the line against producers, which switch the same relay on and off faster
+ * than it is useful. When a relay transition is requested within the dwell time after the previous transition of the
+ * same relay, it is deferred. Further requests for the deferred relay replace the deferred intent, so the transitions
+ * are collapsed to the latest one. When the dwell expires, DwellFilter::release() returns the intents, which differ
+ * from the current relay state. The intents equal to the current state are dropped.
+ *
+ * The filter counts the suppressed transitions, which never reached the relay, and the saved commands, which is the
+ * difference between the requests with some deferred relay and the commands sent on their release.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs the disabled filter.
+ */
+DwellFilter::DwellFilter()
+    : dwell_{0},
+      last_transition_{},
+      commanded_on_{RelayID::None},
+      commanded_known_{RelayID::None},
+      deferred_on_{RelayID::None},
+      deferred_off_{RelayID::None},
+      suppressed_transitions_{0},
+      held_commands_{0},
+      released_commands_{0}
+{
+    last_transition_.fill(-1);
+}
+
+
+/*!
+ * \brief The current time used by the filter.
+ * \return The monotonic time in ms.
+ */
+qint64 DwellFilter::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+
+/*!
+ * \brief Sets the minimal dwell time between transitions of each relay.
+ *
+ * The deferred intents are kept, they are released when the new dwell expires.
+ *
+ * \param msec The dwell in ms, 0 disables the filter.
+ */
+void DwellFilter::setDwell(int msec)
+{
+    dwell_ = msec > 0 ? msec : 0;
+}
+
+
+/*!
+ * \brief Filters the request switching relays on or off.
+ *
+ * The relays, which are not deferred, are considered switched at the specified time. The request, which doesn't
+ * change the state commanded by previous requests, passes without starting the dwell.
+ *
+ * \param on True if the relays are switched on, false if they are switched off.
+ * \param relays The relays.
+ * \param now The current time, see DwellFilter::now().
+ * \return The relays, which can be switched now.
+ */
+RelayID DwellFilter::filter(bool on, RelayID relays, qint64 now)
+{
+    if (dwell_ == 0 && deferred() == RelayID::None) {
+        return relays;
+    }
+    RelayID passed = RelayID::None;
+    RelayID deferred_relays = RelayID::None;
+    for (unsigned int i = 0; i < last_transition_.size(); ++i) {
+        RelayID relay = from_number(i);
+        if ((relays & relay) == RelayID::None) {
+            continue;
+        }
+        bool pending = (deferred() & relay) != RelayID::None;
+        bool transition =
+            (commanded_known_ & relay) == RelayID::None || ((commanded_on_ & relay) != RelayID::None) != on;
+        if (!pending && !transition) {
+            passed |= relay;
+        } else if (!pending && (last_transition_[i] < 0 || now - last_transition_[i] >= dwell_)) {
+            passed |= relay;
+            last_transition_[i] = now;
+        } else {
+            if (pending) {
+                // the previous deferred transition is collapsed into this one
+                ++suppressed_transitions_;
+            }
+            deferred_on_ &= ~relay;
+            deferred_off_ &= ~relay;
+            deferred_relays |= relay;
+        }
+    }
+    if (on) {
+        deferred_on_ |= deferred_relays;
+        commanded_on_ |= passed;
+    } else {
+        deferred_off_ |= deferred_relays;
+        commanded_on_ &= ~passed;
+    }
+    commanded_known_ |= passed;
+    if (deferred_relays != RelayID::None) {
+        ++held_commands_;
+    }
+    return passed;
+}
+
+
+/*!
+ * \brief Records the toggled relays.
+ *
+ * Toggling is never deferred. It replaces the deferred intents of the relays and their commanded state becomes
+ * unknown.
+ *
+ * \param relays The relays.
+ * \param now The current time, see DwellFilter::now().
+ */
+void DwellFilter::toggle(RelayID relays, qint64 now)
+{
+    for (unsigned int i = 0; i < last_transition_.size(); ++i) {
+        RelayID relay = from_number(i);
+        if ((relays & relay) == RelayID::None) {
+            continue;
+        }
+        if ((deferred() & relay) != RelayID::None) {
+            ++suppressed_transitions_;
+        }
+        last_transition_[i] = now;
+    }
+    deferred_on_ &= ~relays;
+    deferred_off_ &= ~relays;
+    commanded_known_ &= ~relays;
+}
+
+
+/*!
+ * \brief The time, when the dwell of some deferred relay expires.
+ * \return The time, see DwellFilter::now(), or -1 if no relay is deferred.
+ */
+qint64 DwellFilter::nextRelease() const
+{
+    qint64 next = -1;
+    for (unsigned int i = 0; i < last_transition_.size(); ++i) {
+        if ((deferred() & from_number(i)) == RelayID::None) {
+            continue;
+        }
+        qint64 release = last_transition_[i] + dwell_;
+        if (next < 0 || release < next) {
+            next = release;
+        }
+    }
+    return next;
+}
+
+
+/*!
+ * \brief Releases the deferred intents, the dwell of which expired.
+ *
+ * The intents equal to the current relay state are dropped and counted as suppressed transitions. The other relays
+ * are considered switched at the specified time.
+ *
+ * \param now The current time, see DwellFilter::now().
+ * \param current The relays, which are currently switched on.
+ * \param on Output parameter, the relays, which should be switched on.
+ * \param off Output parameter, the relays, which should be switched off.
+ */
+void DwellFilter::release(qint64 now, RelayID current, RelayID* on, RelayID* off)
+{
+    *on = RelayID::None;
+    *off = RelayID::None;
+    for (unsigned int i = 0; i < last_transition_.size(); ++i) {
+        RelayID relay = from_number(i);
+        if ((deferred() & relay) == RelayID::None || now - last_transition_[i] < dwell_) {
+            continue;
+        }
+        bool intent_on = (deferred_on_ & relay) != RelayID::None;
+        deferred_on_ &= ~relay;
+        deferred_off_ &= ~relay;
+        commanded_known_ |= relay;
+        if (intent_on) {
+            commanded_on_ |= relay;
+        } else {
+            commanded_on_ &= ~relay;
+        }
+        if (((current & relay) != RelayID::None) == intent_on) {
+            ++suppressed_transitions_;
+        } else {
+            last_transition_[i] = now;
+            (intent_on ? *on : *off) |= relay;
+        }
+    }
+    if (*on != RelayID::None) {
+        ++released_commands_;
+    }
+    if (*off != RelayID::None) {
+        ++released_commands_;
+    }
+}
+
+
+/*!
+ * \brief Drops the deferred intents and forgets the transitions, for example when the card is disconnected.
+ */
+void DwellFilter::clear()
+{
+    last_transition_.fill(-1);
+    commanded_on_ = RelayID::None;
+    commanded_known_ = RelayID::None;
+    deferred_on_ = RelayID::None;
+    deferred_off_ = RelayID::None;
+}
+
+
+/*!
+ * \brief Clears the statistics.
+ */
+void DwellFilter::resetStatistics()
+{
+    suppressed_transitions_ = 0;
+    held_commands_ = 0;
+    released_commands_ = 0;
+}
+
+
+/*!
+ * \fn bool DwellFilter::enabled() const
+ * \brief Tests if the filter is enabled.
+ */
+
+/*!
+ * \fn int DwellFilter::dwell() const
+ * \brief The dwell in ms.
+ */
+
+/*!
+ * \fn RelayID DwellFilter::deferred() const
+ * \brief The relays with deferred intents.
+ */
+
+/*!
+ * \fn quint32 DwellFilter::suppressedTransitions() const
+ * \brief The number of requested relay transitions, which were collapsed or dropped, modulo 2^32.
+ */
+
+/*!
+ * \fn quint32 DwellFilter::savedCommands() const
+ * \brief The number of commands, which were not sent thanks to the filter, modulo 2^32.
+ */
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,95 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      dwell_filter.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::DwellFilter class which enforces minimal dwell time between
+ *            relay transitions.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_DWELL_FILTER_H_
+#define BIOMOLECULES_SPRELAY_CORE_DWELL_FILTER_H_
+
+#include <array>
+
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Defers relay transitions requested within the dwell time after the previous transition of the same relay.
+/// \headerfile ""
+class DwellFilter
+{
+public:
+    DwellFilter();
+
+    static qint64 now();
+
+    void setDwell(int msec);
+    RelayID filter(bool on, RelayID relays, qint64 now);
+    void toggle(RelayID relays, qint64 now);
+    qint64 nextRelease() const;
+    void release(qint64 now, RelayID current, RelayID* on, RelayID* off);
+    void clear();
+    void resetStatistics();
+
+    bool enabled() const { return dwell_ > 0; }
+    int dwell() const { return dwell_; }
+    RelayID deferred() const { return deferred_on_ | deferred_off_; }
+    quint32 suppressedTransitions() const { return suppressed_transitions_; }
+    quint32 savedCommands() const { return held_commands_ - released_commands_; }
+
+private:
+    int dwell_;
+    std::array<qint64, 8> last_transition_;
+    RelayID commanded_on_;
+    RelayID commanded_known_;
+    RelayID deferred_on_;
+    RelayID deferred_off_;
+    quint32 suppressed_transitions_;
+    quint32 held_commands_;
+    quint32 released_commands_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_DWELL_FILTER_H_
@@ -0,0 +1,218 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_cache.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventCache class which stores the last known card state.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "event_cache.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class EventCache
+ *
+ * The cache is used by K8090 to filter events delivered to EventSubscription objects and to replay the last known
+ * values to new subscribers. The update methods store the new state and return relays, which are changed by the
+ * event, so the caller can match them against subscription masks with one bitwise operation.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs empty cache, no value is known.
+ */
+EventCache::EventCache()
+    : has_relay_status_{false},
+      current_relays_{RelayID::None},
+      timed_relays_{RelayID::None},
+      has_button_status_{false},
+      button_state_{RelayID::None},
+      known_delays_{{RelayID::None, RelayID::None}},
+      delays_{}
+{}
+
+
+/*!
+ * \brief Stores relay status and computes changed relays.
+ *
+ * Relays are changed if the card reports their transition, if their state differs from the last known state or if
+ * their timed flag differs. The first relay status after construction or EventCache::reset() changes all relays.
+ *
+ * \param previous Relays which were previously switched on.
+ * \param current Relays which are currently switched on.
+ * \param timed Timed relays.
+ * \return Changed relays.
+ */
+RelayID EventCache::updateRelayStatus(RelayID previous, RelayID current, RelayID timed)
+{
+    RelayID changed = RelayID::All;
+    if (has_relay_status_) {
+        changed = (previous ^ current) | (current_relays_ ^ current) | (timed_relays_ ^ timed);
+    }
+    has_relay_status_ = true;
+    current_relays_ = current;
+    timed_relays_ = timed;
+    return changed;
+}
+
+
+/*!
+ * \brief Stores button status and computes changed buttons.
+ *
+ * \param state Buttons which are pressed.
+ * \param pressed Buttons currently pressed.
+ * \param released Buttons currently released.
+ * \return Changed buttons.
+ */
+RelayID EventCache::updateButtonStatus(RelayID state, RelayID pressed, RelayID released)
+{
+    RelayID changed = pressed | released;
+    if (has_button_status_) {
+        changed |= button_state_ ^ state;
+    } else {
+        changed = RelayID::All;
+    }
+    has_button_status_ = true;
+    button_state_ = state;
+    return changed;
+}
+
+
+/*!
+ * \brief Stores timer delay of specified relays and computes relays with changed delay.
+ *
+ * \param type Timer delay type, TimerDelayType::Total or TimerDelayType::Remaining.
+ * \param relays The relays, the delay of which is reported.
+ * \param delay The delay.
+ * \return Relays with changed or previously unknown delay.
+ */
+RelayID EventCache::updateTimerDelay(TimerDelayType type, RelayID relays, quint16 delay)
+{
+    const unsigned int idx = delayIndex(type);
+    RelayID changed = RelayID::None;
+    for (unsigned int i = 0; i < 8; ++i) {
+        RelayID relay = from_number(i);
+        if ((relays & relay) == RelayID::None) {
+            continue;
+        }
+        if ((known_delays_[idx] & relay) == RelayID::None || delays_[idx][i] != delay) {
+            changed |= relay;
+        }
+        delays_[idx][i] = delay;
+    }
+    known_delays_[idx] |= relays;
+    return changed;
+}
+
+
+/*!
+ * \brief Forgets all stored values.
+ *
+ * It is used when the card is disconnected, because the last known values are no longer reliable.
+ */
+void EventCache::reset()
+{
+    has_relay_status_ = false;
+    current_relays_ = RelayID::None;
+    timed_relays_ = RelayID::None;
+    has_button_status_ = false;
+    button_state_ = RelayID::None;
+    known_delays_.fill(RelayID::None);
+}
+
+
+/*!
+ * \fn bool EventCache::hasRelayStatus() const
+ * \brief Tests if some relay status is known.
+ */
+
+/*!
+ * \fn RelayID EventCache::currentRelays() const
+ * \brief Last known switched on relays.
+ */
+
+/*!
+ * \fn RelayID EventCache::timedRelays() const
+ * \brief Last known timed relays.
+ */
+
+/*!
+ * \fn bool EventCache::hasButtonStatus() const
+ * \brief Tests if some button status is known.
+ */
+
+/*!
+ * \fn RelayID EventCache::buttonState() const
+ * \brief Last known pressed buttons.
+ */
+
+
+/*!
+ * \brief Relays with known timer delay of the specified type.
+ * \param type Timer delay type, TimerDelayType::Total or TimerDelayType::Remaining.
+ * \return The relays.
+ */
+RelayID EventCache::knownTimerDelays(TimerDelayType type) const
+{
+    return known_delays_[delayIndex(type)];
+}
+
+
+/*!
+ * \brief Last known timer delay.
+ * \param type Timer delay type, TimerDelayType::Total or TimerDelayType::Remaining.
+ * \param relay Relay number from 0 to 7.
+ * \return The delay. It is meaningful only if the relay is included in EventCache::knownTimerDelays().
+ */
+quint16 EventCache::timerDelay(TimerDelayType type, unsigned int relay) const
+{
+    return delays_[delayIndex(type)][relay];
+}
+
+
+// converts timer delay type to index to delay arrays
+unsigned int EventCache::delayIndex(TimerDelayType type)
+{
+    return type == TimerDelayType::Total ? 0u : 1u;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,92 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_cache.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventCache class which stores the last known card state.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_EVENT_CACHE_H_
+#define BIOMOLECULES_SPRELAY_CORE_EVENT_CACHE_H_
+
+#include <array>
+
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+#include "k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Stores the last known relay, button and timer state and computes relays changed by incoming events.
+/// \headerfile ""
+class EventCache
+{
+public:
+    EventCache();
+
+    RelayID updateRelayStatus(RelayID previous, RelayID current, RelayID timed);
+    RelayID updateButtonStatus(RelayID state, RelayID pressed, RelayID released);
+    RelayID updateTimerDelay(TimerDelayType type, RelayID relays, quint16 delay);
+    void reset();
+
+    bool hasRelayStatus() const { return has_relay_status_; }
+    RelayID currentRelays() const { return current_relays_; }
+    RelayID timedRelays() const { return timed_relays_; }
+    bool hasButtonStatus() const { return has_button_status_; }
+    RelayID buttonState() const { return button_state_; }
+    RelayID knownTimerDelays(TimerDelayType type) const;
+    quint16 timerDelay(TimerDelayType type, unsigned int relay) const;
+
+private:
+    static unsigned int delayIndex(TimerDelayType type);
+
+    bool has_relay_status_;
+    RelayID current_relays_;
+    RelayID timed_relays_;
+    bool has_button_status_;
+    RelayID button_state_;
+    std::array<RelayID, 2> known_delays_;
+    std::array<std::array<quint16, 8>, 2> delays_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_EVENT_CACHE_H_
@@ -0,0 +1,173 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_listeners.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventListeners class which calls card event listeners
+ *            directly.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "event_listeners.h"
+
+#include <algorithm>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// the list whose listeners are being called in the current thread
+thread_local const EventListeners* tls_dispatching = nullptr;
+
+}  // namespace
+
+
+/*!
+ * \class EventListeners
+ *
+ * The list is used by K8090 to call listeners registered by K8090::addEventListener() straight from the response
+ * decoding. The list is copied on write, the dispatching only takes the snapshot of the current list, so it doesn't
+ * allocate and the listeners are called without holding the lock. They can therefore add and remove listeners, the
+ * change takes effect from the next event. The dispatching of an empty list only reads an atomic flag.
+ *
+ * A listener removed from other thread than the one which is calling it is not called after
+ * EventListeners::remove() returns, so the resources used by the listener can be released then.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs empty list.
+ */
+EventListeners::EventListeners()
+    : listeners_{std::make_shared<const List>()}, next_id_{0}, empty_{true}, waiting_removals_{0}
+{}
+
+
+/*!
+ * \brief Adds listener.
+ * \param listener The listener.
+ * \return Identifier of the listener for EventListeners::remove().
+ */
+int EventListeners::add(Listener listener)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    std::shared_ptr<List> listeners = std::make_shared<List>(*listeners_);
+    listeners->emplace_back(++next_id_, std::move(listener));
+    listeners_ = std::move(listeners);
+    empty_.store(false, std::memory_order_release);
+    return next_id_;
+}
+
+
+/*!
+ * \brief Removes listener.
+ *
+ * When it is called from other thread than a listener of this list, it waits until the dispatches, which started
+ * before the removal, return. The caller must not hold any lock acquired by the listeners then. When it is called
+ * from a listener, it returns immediately and the listener can still be called by the other listeners' dispatches
+ * running in other threads.
+ *
+ * \param id Identifier returned by EventListeners::add().
+ * \return True if the listener was found.
+ */
+bool EventListeners::remove(int id)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+    std::shared_ptr<List> listeners = std::make_shared<List>(*listeners_);
+    auto it = std::find_if(listeners->begin(), listeners->end(),
+        [id](const std::pair<int, Listener>& listener) { return listener.first == id; });
+    if (it == listeners->end()) {
+        return false;
+    }
+    listeners->erase(it);
+    std::shared_ptr<const List> previous = std::move(listeners_);
+    listeners_ = std::move(listeners);
+    empty_.store(listeners_->empty(), std::memory_order_release);
+    if (tls_dispatching != this) {
+        // the dispatches share the previous snapshot until they return, new dispatches take the current one
+        waiting_removals_.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        dispatched_.wait(lock, [&previous] { return previous.use_count() == 1; });
+        waiting_removals_.fetch_sub(1);
+    }
+    return true;
+}
+
+
+/*!
+ * \brief Tests if there are no listeners.
+ * \return True if there are no listeners.
+ */
+bool EventListeners::empty() const
+{
+    return empty_.load(std::memory_order_acquire);
+}
+
+
+/*!
+ * \brief Calls all the listeners in the order of their addition.
+ * \param event The event.
+ */
+void EventListeners::dispatch(const CardEvent& event) const
+{
+    if (empty_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::shared_ptr<const List> listeners;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        listeners = listeners_;
+    }
+    const EventListeners* outer = tls_dispatching;
+    tls_dispatching = this;
+    for (const std::pair<int, Listener>& listener : *listeners) {
+        listener.second(event);
+    }
+    tls_dispatching = outer;
+    listeners.reset();
+    // pairs with the fence in remove(), either the removal sees the released snapshot or it is notified
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_removals_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        dispatched_.notify_all();
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
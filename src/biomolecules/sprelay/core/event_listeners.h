@@ -0,0 +1,89 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_listeners.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventListeners class which calls card event listeners
+ *            directly.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_EVENT_LISTENERS_H_
+#define BIOMOLECULES_SPRELAY_CORE_EVENT_LISTENERS_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Thread-safe list of card event listeners, which are called without Qt meta-object dispatch.
+/// \headerfile ""
+class EventListeners
+{
+public:
+    using Listener = std::function<void(const CardEvent&)>;
+
+    EventListeners();
+
+    int add(Listener listener);
+    bool remove(int id);
+    bool empty() const;
+    void dispatch(const CardEvent& event) const;
+
+private:
+    using List = std::vector<std::pair<int, Listener>>;
+
+    std::shared_ptr<const List> listeners_;
+    int next_id_;
+    std::atomic<bool> empty_;
+    std::atomic<int> waiting_removals_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable dispatched_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_EVENT_LISTENERS_H_
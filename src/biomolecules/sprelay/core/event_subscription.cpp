@@ -0,0 +1,144 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_subscription.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::EventSubscription class which delivers filtered card events.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "event_subscription.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/*!
+ * \class EventSubscription
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * The subscription is created by K8090::subscribe() and it emits only the events of requested types, which change
+ * some of the requested relays. Right after the subscription is created, the last known values are replayed to it, so
+ * the subscriber does not need to query the card. The replay is queued to the event loop of the thread which called
+ * K8090::subscribe(), so it is safe to connect to the subscription signals right after it is returned.
+ *
+ * The subscription is owned by K8090 and it is valid until K8090::unsubscribe() is called or until the K8090 object
+ * is destroyed.
+ *
+ * \code
+ * biomolecules::sprelay::core::k8090::EventSubscription* subscription =
+ *     k8090->subscribe(biomolecules::sprelay::core::k8090::EventType::RelayStatus,
+ *         biomolecules::sprelay::core::k8090::RelayID::One | biomolecules::sprelay::core::k8090::RelayID::Two);
+ * connect(subscription, &biomolecules::sprelay::core::k8090::EventSubscription::relayStatus,
+ *     this, &MyWidget::onRelayStatus);
+ * \endcode
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+// Constructs the subscription. It is used by impl_::SubscriptionList::add().
+EventSubscription::EventSubscription(EventType events, RelayID relays)
+    : events_{events}, relays_{relays}, active_{true}
+{}
+
+
+/*!
+ * \brief Destructor.
+ */
+EventSubscription::~EventSubscription() = default;
+
+
+/*!
+ * \brief Subscribed event types.
+ * \return The event types.
+ */
+EventType EventSubscription::events() const
+{
+    return events_;
+}
+
+
+/*!
+ * \brief Subscribed relays.
+ * \return The relays.
+ */
+RelayID EventSubscription::relays() const
+{
+    return relays_;
+}
+
+
+// signals
+/*!
+ * \fn void EventSubscription::relayStatus(k8090::RelayID previous, k8090::RelayID current, k8090::RelayID timed)
+ * \brief Emited when some of subscribed relays changes its state or its timed flag.
+ *
+ * The replayed last known value has the same previous and current relays. See K8090::relayStatus().
+ *
+ * \param previous Relays which were previously switched on.
+ * \param current Relays which are currently switched on.
+ * \param timed Timed relays.
+ */
+/*!
+ * \fn void EventSubscription::buttonStatus(k8090::RelayID state, k8090::RelayID pressed, k8090::RelayID released)
+ * \brief Emited when some of subscribed buttons is pressed or released.
+ *
+ * The replayed last known value has no pressed and released buttons. See K8090::buttonStatus().
+ *
+ * \param state Buttons which are pressed.
+ * \param pressed Buttons currently pressed.
+ * \param released Buttons currently released.
+ */
+/*!
+ * \fn void EventSubscription::totalTimerDelay(k8090::RelayID relay, quint16 delay)
+ * \brief Emited when total timer delay of subscribed relay changes.
+ *
+ * See K8090::totalTimerDelay().
+ *
+ * \param relay The relay.
+ * \param delay The delay.
+ */
+/*!
+ * \fn void EventSubscription::remainingTimerDelay(k8090::RelayID relay, quint16 delay)
+ * \brief Emited when remaining timer delay of subscribed relay changes.
+ *
+ * See K8090::remainingTimerDelay().
+ *
+ * \param relay The relay.
+ * \param delay The delay.
+ */
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
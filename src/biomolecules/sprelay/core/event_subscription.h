@@ -0,0 +1,99 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_subscription.h
+ * \ingroup   group_biomolecules_sprelay_core_public
+ * \brief     The biomolecules::sprelay::core::k8090::EventSubscription class which delivers filtered card events.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_EVENT_SUBSCRIPTION_H_
+#define BIOMOLECULES_SPRELAY_CORE_EVENT_SUBSCRIPTION_H_
+
+#include <atomic>
+
+#include <QObject>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+// forward declarations
+class K8090;
+namespace impl_ {
+class SubscriptionList;
+}  // namespace impl_
+
+/// The class which delivers K8090 events filtered by event type and relays.
+class SPRELAY_LIBRARY_EXPORT EventSubscription : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventSubscription(const EventSubscription&) = delete;
+    EventSubscription(EventSubscription&&) = delete;
+    EventSubscription& operator=(const EventSubscription&) = delete;
+    EventSubscription& operator=(EventSubscription&&) = delete;
+    ~EventSubscription() override;
+
+    k8090::EventType events() const;
+    k8090::RelayID relays() const;
+
+signals:
+    void relayStatus(biomolecules::sprelay::core::k8090::RelayID previous,
+        biomolecules::sprelay::core::k8090::RelayID current, biomolecules::sprelay::core::k8090::RelayID timed);
+    void buttonStatus(biomolecules::sprelay::core::k8090::RelayID state,
+        biomolecules::sprelay::core::k8090::RelayID pressed, biomolecules::sprelay::core::k8090::RelayID released);
+    void totalTimerDelay(biomolecules::sprelay::core::k8090::RelayID relay, quint16 delay);
+    void remainingTimerDelay(biomolecules::sprelay::core::k8090::RelayID relay, quint16 delay);
+
+private:
+    friend class K8090;
+    friend class impl_::SubscriptionList;
+    EventSubscription(k8090::EventType events, k8090::RelayID relays);
+
+    const k8090::EventType events_;
+    const k8090::RelayID relays_;
+    std::atomic<bool> active_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_EVENT_SUBSCRIPTION_H_
@@ -0,0 +1,192 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      execution_planner.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ExecutionPlanner class which simulates command scheduling.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "execution_planner.h"
+
+#include "concurent_command_queue.h"
+#include "k8090_utils.h"
+#include "queue_policy.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class ExecutionPlanner
+ *
+ * The planner reproduces the scheduling of K8090. The first enqueued command is sent directly, the other commands are
+ * stored in ConcurentCommandQueue, so they are merged and ordered by the scheduling policy in the same way as in the
+ * K8090 class. Commands without response are followed by implicit query commands, which test them, and the commands are
+ * spaced by the command delay. Commands, which wait for the card response, take the response delay.
+ *
+ * The command delay equal to zero is treated as immediate sending of the next command.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs the planner.
+ * \param command_delay Delay between commands in ms, see K8090::setCommandDelay().
+ * \param response_delay Estimated time in ms, in which the card responds to queries.
+ * \param card Descriptor of the simulated card, see card_descriptor().
+ * \param policy Scheduling policy of the simulated command queue, see QueuePolicy.
+ */
+ExecutionPlanner::ExecutionPlanner(
+    int command_delay, int response_delay, const CardDescriptor& card, SchedulingPolicy policy)
+    : command_delay_{command_delay},
+      factory_defaults_command_delay_{card.factory_defaults_delay_factor * command_delay},
+      response_delay_{response_delay},
+      pending_commands_{new ConcurentCommandQueue{card.priorities, QueuePolicy::create(policy)}},
+      has_first_{false},
+      first_command_{CommandID::None, RelayID::None, 0, 0},
+      time_{0}
+{}
+
+
+/*!
+ * \brief Destructor.
+ */
+ExecutionPlanner::~ExecutionPlanner() = default;
+
+
+/*!
+ * \brief Enqueues the command as if it were issued to K8090 with idle card.
+ * \param command The command.
+ */
+void ExecutionPlanner::enqueue(const CardCommand& command)
+{
+    if (!has_first_) {
+        has_first_ = true;
+        first_command_ = command;
+    } else {
+        pending_commands_->updateOrPush(command.id, command.mask, command.param1, command.param2);
+    }
+}
+
+
+/*!
+ * \brief Simulates sending of all enqueued commands.
+ *
+ * The enqueued commands are consumed, so the planner can be used for the next plan.
+ *
+ * \return The resulting command sequence with estimated send times and completion time.
+ */
+ExecutionPlan ExecutionPlanner::plan()
+{
+    ExecutionPlan plan{{}, 0};
+    time_ = 0;
+    if (!has_first_) {
+        return plan;
+    }
+    has_first_ = false;
+
+    CardCommand current = first_command_;
+    bool follow_up = false;
+    while (true) {
+        send(&plan, current, follow_up);
+        CardCommand query{CommandID::None, RelayID::None, 0, 0};
+        if (followUp(current, &query)) {
+            current = query;
+            follow_up = true;
+            continue;
+        }
+        if (pending_commands_->empty()) {
+            break;
+        }
+        Command command = pending_commands_->pop();
+        current = CardCommand{
+            command.id, static_cast<RelayID>(command.params[0]), command.params[1], command.params[2]};
+        follow_up = false;
+    }
+    plan.completion_time = time_;
+    return plan;
+}
+
+
+// stores the command to the plan and moves the time to the moment, when the next command can be sent, see
+// K8090::sendCommandHelper()
+void ExecutionPlanner::send(ExecutionPlan* plan, const CardCommand& command, bool follow_up)
+{
+    plan->commands.push_back(PlannedCommand{command, time_, follow_up});
+    switch (command.id) {
+        case CommandID::RelayOn:
+        case CommandID::RelayOff:
+        case CommandID::ToggleRelay:
+        case CommandID::QueryRelay:
+        case CommandID::SetButtonMode:
+        case CommandID::StartTimer:
+        case CommandID::SetTimer:
+            time_ += command_delay_;
+            break;
+        case CommandID::ResetFactoryDefaults:
+            time_ += factory_defaults_command_delay_;
+            break;
+        default:
+            time_ += response_delay_;
+    }
+}
+
+
+// creates query command which follows the command, see K8090::dequeueCommand()
+bool ExecutionPlanner::followUp(const CardCommand& command, CardCommand* query)
+{
+    switch (command.id) {
+        case CommandID::RelayOn:
+        case CommandID::RelayOff:
+        case CommandID::ToggleRelay:
+        case CommandID::StartTimer:
+        case CommandID::ResetFactoryDefaults:
+            *query = CardCommand{CommandID::QueryRelay, RelayID::None, 0, 0};
+            return true;
+        case CommandID::SetButtonMode:
+            *query = CardCommand{CommandID::ButtonMode, RelayID::None, 0, 0};
+            return true;
+        case CommandID::SetTimer:
+            *query = CardCommand{CommandID::Timer, command.mask, as_number(TimerDelayType::Total), 0};
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
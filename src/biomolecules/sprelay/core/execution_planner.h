@@ -0,0 +1,91 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      execution_planner.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ExecutionPlanner class which simulates command scheduling.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_EXECUTION_PLANNER_H_
+#define BIOMOLECULES_SPRELAY_CORE_EXECUTION_PLANNER_H_
+
+#include <memory>
+
+#include "card_traits.h"
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+// ConcurentCommandQueue forward declaration
+class ConcurentCommandQueue;
+
+/// \brief Simulates scheduling of commands by K8090 and estimates its duration without touching the card.
+/// \headerfile ""
+class ExecutionPlanner
+{
+public:
+    ExecutionPlanner(int command_delay, int response_delay,
+        const CardDescriptor& card = card_descriptor<K8090Traits>(),
+        SchedulingPolicy policy = SchedulingPolicy::Priority);
+    ExecutionPlanner(const ExecutionPlanner&) = delete;
+    ExecutionPlanner(ExecutionPlanner&&) = delete;
+    ExecutionPlanner& operator=(const ExecutionPlanner&) = delete;
+    ExecutionPlanner& operator=(ExecutionPlanner&&) = delete;
+    ~ExecutionPlanner();
+
+    void enqueue(const CardCommand& command);
+    ExecutionPlan plan();
+
+private:
+    void send(ExecutionPlan* plan, const CardCommand& command, bool follow_up);
+    static bool followUp(const CardCommand& command, CardCommand* query);
+
+    const int command_delay_;
+    const int factory_defaults_command_delay_;
+    const int response_delay_;
+    std::unique_ptr<ConcurentCommandQueue> pending_commands_;
+    bool has_first_;
+    CardCommand first_command_;
+    int time_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_EXECUTION_PLANNER_H_
@@ -0,0 +1,175 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      inrush_limiter.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::InrushLimiter class which limits the rate of relay closings.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "inrush_limiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <QMutex>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/*!
+ * \class InrushLimiter
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * The limiter allows at most InrushLimiter::maxClosings() relay closings within any time window of the
+ * InrushLimiter::window() length. It is used by K8090 to split relay on commands, so the inrush currents of the
+ * switched loads do not overload the power supply. The closings are granted as soon as possible, which finishes the
+ * whole transition in the minimum total time under the constraint.
+ *
+ * The per card limit and the global limit of several cards are combined by chaining. The card limiter is created with
+ * the shared global limiter and the closing is granted only if both of them allow it:
+ *
+ * \code
+ * using biomolecules::sprelay::core::k8090::InrushLimiter;
+ * auto global = std::make_shared<InrushLimiter>(4, 200);
+ * first_card->setInrushLimiter(std::make_shared<InrushLimiter>(2, 200, global));
+ * second_card->setInrushLimiter(std::make_shared<InrushLimiter>(2, 200, global));
+ * \endcode
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs the limiter.
+ * \param max_closings The maximum number of closings within the window.
+ * \param window_msec The window length in ms.
+ * \param global The limiter shared by several cards, which also has to grant the closings, or nullptr.
+ */
+InrushLimiter::InrushLimiter(int max_closings, int window_msec, std::shared_ptr<InrushLimiter> global)
+    : max_closings_{std::max(max_closings, 1)},
+      window_{std::max(window_msec, 0)},
+      global_{std::move(global)},
+      mutex_{new QMutex}
+{}
+
+
+/*!
+ * \brief Destructor.
+ */
+InrushLimiter::~InrushLimiter() = default;
+
+
+/*!
+ * \brief Current time of the monotonic clock in ms, which is used by K8090 for the reservations.
+ * \return The time.
+ */
+qint64 InrushLimiter::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+
+/*!
+ * \fn int InrushLimiter::maxClosings() const
+ * \brief The maximum number of closings within the window.
+ */
+
+/*!
+ * \fn int InrushLimiter::window() const
+ * \brief The window length in ms.
+ */
+
+
+/*!
+ * \brief Reserves closings, which can be performed now.
+ *
+ * The reservation is atomic also for the chained global limiter, so the cards sharing it can't exceed the global
+ * limit.
+ *
+ * \param count The number of requested closings.
+ * \param now The current time, see InrushLimiter::now().
+ * \return The number of granted closings, it can be less than count.
+ * \sa InrushLimiter::nextAvailable()
+ */
+int InrushLimiter::reserve(int count, qint64 now)
+{
+    QMutexLocker locker{mutex_.get()};
+    expire(now);
+    int granted = std::min(count, max_closings_ - static_cast<int>(closings_.size()));
+    // the global limiter is always locked after the card limiter, so the locking can't deadlock
+    if (global_ && granted > 0) {
+        granted = global_->reserve(granted, now);
+    }
+    for (int i = 0; i < granted; ++i) {
+        closings_.push_back(now);
+    }
+    return std::max(granted, 0);
+}
+
+
+/*!
+ * \brief Computes the earliest time, when the next closing can be granted.
+ * \param now The current time, see InrushLimiter::now().
+ * \return The time.
+ */
+qint64 InrushLimiter::nextAvailable(qint64 now)
+{
+    QMutexLocker locker{mutex_.get()};
+    expire(now);
+    qint64 next = now;
+    if (static_cast<int>(closings_.size()) >= max_closings_) {
+        // the window has to slide over the oldest closing, which exceeds the limit
+        next = closings_[closings_.size() - static_cast<std::size_t>(max_closings_)] + window_;
+    }
+    if (global_) {
+        next = std::max(next, global_->nextAvailable(now));
+    }
+    return next;
+}
+
+
+// forgets closings, which are out of the window
+void InrushLimiter::expire(qint64 now)
+{
+    while (!closings_.empty() && closings_.front() + window_ <= now) {
+        closings_.pop_front();
+    }
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
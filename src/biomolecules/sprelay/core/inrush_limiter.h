@@ -0,0 +1,89 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      inrush_limiter.h
+ * \brief     The biomolecules::sprelay::core::k8090::InrushLimiter class which limits the rate of relay closings.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_INRUSH_LIMITER_H_
+#define BIOMOLECULES_SPRELAY_CORE_INRUSH_LIMITER_H_
+
+#include <deque>
+#include <memory>
+
+#include <QtGlobal>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+// forward declarations
+class QMutex;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/// The class which limits the number of relays closed within a time window, see K8090::setInrushLimiter().
+class SPRELAY_LIBRARY_EXPORT InrushLimiter
+{
+public:
+    InrushLimiter(int max_closings, int window_msec, std::shared_ptr<InrushLimiter> global = nullptr);
+    InrushLimiter(const InrushLimiter&) = delete;
+    InrushLimiter(InrushLimiter&&) = delete;
+    InrushLimiter& operator=(const InrushLimiter&) = delete;
+    InrushLimiter& operator=(InrushLimiter&&) = delete;
+    ~InrushLimiter();
+
+    static qint64 now();
+
+    int maxClosings() const { return max_closings_; }
+    int window() const { return window_; }
+    int reserve(int count, qint64 now);
+    qint64 nextAvailable(qint64 now);
+
+private:
+    void expire(qint64 now);
+
+    const int max_closings_;
+    const int window_;
+    const std::shared_ptr<InrushLimiter> global_;
+    std::deque<qint64> closings_;
+    std::unique_ptr<QMutex> mutex_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_INRUSH_LIMITER_H_
@@ -37,25 +37,67 @@
 
 #include "k8090.h"
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <utility>
 
+#include <QAbstractEventDispatcher>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QMutex>
+#include <QSaveFile>
 #include <QStringBuilder>
+#include <QThread>
 #include <QTimer>
 
+#include "card_traits.h"
+#include "coalescing_window.h"
+#include "command_log.h"
 #include "command_queue.h"
 #include "concurent_command_queue.h"
+#include "connection_state.h"
+#include "dwell_filter.h"
+#include "event_cache.h"
+#include "event_listeners.h"
+#include "execution_planner.h"
+#include "inrush_limiter.h"
 #include "k8090_commands.h"
 #include "k8090_utils.h"
+#include "link_monitor.h"
+#include "logger.h"
+#include "precise_pulse.h"
+#include "program_interpreter.h"
+#include "queue_policy.h"
+#include "refresh_flight.h"
+#include "response_waiters.h"
 #include "serial_port_utils.h"
+#include "status_correlator.h"
+#include "subscription_list.h"
 #include "unified_serial_port.h"
+#include "wear_accounting.h"
 
 namespace biomolecules {
 namespace sprelay {
 namespace core {
 namespace k8090 {
 
+namespace {
+
+// parts of the card state requested by K8090::refreshRelaysInfo()
+const unsigned int kRefreshRelayStatus = 1u << 0u;
+const unsigned int kRefreshButtonModes = 1u << 1u;
+const unsigned int kRefreshTotalTimer = 1u << 2u;
+const unsigned int kRefreshRemainingTimer = 1u << 3u;
+const unsigned int kRefreshJumperStatus = 1u << 4u;
+const unsigned int kRefreshFirmwareVersion = 1u << 5u;
+const unsigned int kRefreshAll = kRefreshRelayStatus | kRefreshButtonModes | kRefreshTotalTimer
+    | kRefreshRemainingTimer | kRefreshJumperStatus | kRefreshFirmwareVersion;
+
+}  // namespace
+
 
 /*!
  * \class K8090
@@ -146,53 +188,118 @@ namespace k8090 {
  * \brief Product id for the automatic port identification.
  * \sa K8090::connectK8090()
  */
-const quint16 K8090::kProductID = impl_::kProductID;
+const quint16 K8090::kProductID = impl_::K8090Traits::kProductID;
 
 /*!
  * \brief Vendor id for the automatic port identification.
  * \sa K8090::connectK8090()
  */
-const quint16 K8090::kVendorID = impl_::kVendorID;
+const quint16 K8090::kVendorID = impl_::K8090Traits::kVendorID;
 
 // private
-// Shortest interval in ms from sending one command to sending a new one.
-const int K8090::kDefaultCommandDelay_ = 50;
-// Maximal time in ms to wait for response.
-const int K8090::kDefaultFailureDelay_ = 1000;
-// Maximal number of consecutive failures to disconnect realy;
-const int K8090::kDefaultMaxFailureCount_ = 3;
+// Interval in ms between storing of the relay wear file.
+const int K8090::kDefaultWearSaveInterval_ = 60000;
+// Delay in ms of the command log group commit. Commands enqueued in the same event loop iteration share the commit.
+const int K8090::kDefaultCommandLogCommitDelay_ = 0;
+// Estimated time in ms, in which the card responds to queries.
+const int K8090::kDefaultResponseDelay_ = 10;
+// Time in ms, during which the completed refresh satisfies new refresh requests. Zero disables it.
+const int K8090::kDefaultRefreshFreshness_ = 0;
 
 
 /*!
  * \brief Creates a new K8090 instance and sets the default values.
  * \param parent K8090 parent object in Qt ownership system.
  */
-K8090::K8090(QObject* parent)
+K8090::K8090(QObject* parent) : K8090{impl_::card_descriptor<impl_::K8090Traits>(), parent} {}
+
+
+/*!
+ * \brief Creates a new instance controlling Velleman %K8090 compatible card.
+ *
+ * Classes controlling other Velleman compatible cards define their own traits, see impl_::K8090Traits in the
+ * installed card_traits.h header, and pass their descriptor to this constructor. The command codes, priorities,
+ * response codes, relay count and timing defaults are then read from the descriptor at runtime, there is no branching
+ * on the card type.
+ *
+ * \param card The card descriptor created by impl_::card_descriptor().
+ * \param parent K8090 parent object in Qt ownership system.
+ */
+K8090::K8090(const impl_::CardDescriptor& card, QObject* parent)
     : QObject{parent},
+      card_{&card},
       com_port_name_mutex_{new QMutex},
       serial_port_{new UnifiedSerialPort},
-      pending_commands_{new impl_::ConcurentCommandQueue},
+      pending_commands_{new impl_::ConcurentCommandQueue{card.priorities}},
       current_command_{new impl_::Command},
       command_timer_{new QTimer},
       failure_timer_{new QTimer},
       failure_counter_{0},
-      connected_{false},
-      connecting_{false},
-      connected_mutex_{new QMutex},
-      command_delay_{kDefaultCommandDelay_},
-      factory_defaults_command_delay_{2 * kDefaultCommandDelay_},
-      command_delay_mutex_{new QMutex},
-      failure_delay_{kDefaultFailureDelay_},
-      failure_delay_mutex_{new QMutex},
-      failure_max_count_{kDefaultMaxFailureCount_},
-      failure_max_count_mutex_{new QMutex}
+      connection_state_{new impl_::ConnectionState},
+      lifecycle_mutex_{new QMutex},
+      scheduling_policy_{SchedulingPolicy::Priority},
+      command_delay_{card.command_delay},
+      factory_defaults_command_delay_{card.factory_defaults_delay_factor * card.command_delay},
+      failure_delay_{card.failure_delay},
+      failure_max_count_{card.max_failure_count},
+      subscriptions_{new impl_::SubscriptionList},
+      event_cache_{new impl_::EventCache},
+      wear_accounting_{
+          new impl_::WearAccounting{QDateTime::currentMSecsSinceEpoch() - impl_::WearAccounting::now()}},
+      wear_snapshot_{new impl_::WearAccounting{*wear_accounting_}},
+      wear_save_interval_{kDefaultWearSaveInterval_},
+      wear_timer_{new QTimer},
+      wear_mutex_{new QMutex},
+      command_log_{new impl_::CommandLog},
+      command_log_commit_delay_{kDefaultCommandLogCommitDelay_},
+      command_log_timer_{new QTimer},
+      command_log_statistics_{0, 0, 0, 0, 0},
+      command_log_mutex_{new QMutex{QMutex::Recursive}},
+      command_log_active_{false},
+      inrush_deferred_{RelayID::None},
+      inrush_timer_{new QTimer},
+      inrush_mutex_{new QMutex},
+      program_timer_{new QTimer},
+      response_waiters_{new impl_::ResponseWaiters},
+      event_listeners_{new impl_::EventListeners},
+      link_monitor_{new impl_::LinkMonitor},
+      status_correlator_{new impl_::StatusCorrelator},
+      refresh_flight_{new impl_::RefreshFlight{kDefaultRefreshFreshness_}},
+      coalescing_window_{new impl_::CoalescingWindow},
+      burst_timer_{new QElapsedTimer},
+      coalescing_timer_{new QTimer},
+      coalescing_mutex_{new QMutex},
+      dwell_filter_{new impl_::DwellFilter},
+      dwell_timer_{new QTimer},
+      dwell_mutex_{new QMutex},
+      precise_pulse_{new impl_::PrecisePulse},
+      pulse_timer_{new QTimer},
+      pulse_reserved_{false},
+      idle_mode_{false},
+      wakeup_measurement_{false},
+      logger_mutex_{new QMutex}
 {
     command_timer_->setSingleShot(true);
     failure_timer_->setSingleShot(true);
+    wear_timer_->setSingleShot(true);
+    command_log_timer_->setSingleShot(true);
+    inrush_timer_->setSingleShot(true);
+    program_timer_->setSingleShot(true);
+    coalescing_timer_->setSingleShot(true);
+    dwell_timer_->setSingleShot(true);
+    pulse_timer_->setSingleShot(true);
+    pulse_timer_->setTimerType(Qt::PreciseTimer);
 
     connect(serial_port_.get(), &UnifiedSerialPort::readyRead, this, &K8090::onReadyData);
     connect(command_timer_.get(), &QTimer::timeout, this, &K8090::dequeueCommand);
+    connect(coalescing_timer_.get(), &QTimer::timeout, this, &K8090::dequeueCommand);
     connect(failure_timer_.get(), &QTimer::timeout, this, &K8090::onCommandFailed);
+    connect(wear_timer_.get(), &QTimer::timeout, this, &K8090::saveRelayWear);
+    connect(command_log_timer_.get(), &QTimer::timeout, this, &K8090::commitCommandLog);
+    connect(inrush_timer_.get(), &QTimer::timeout, this, &K8090::releaseDeferredRelays);
+    connect(dwell_timer_.get(), &QTimer::timeout, this, &K8090::releaseDwellRelays);
+    connect(program_timer_.get(), &QTimer::timeout, this, &K8090::executeProgram);
+    connect(pulse_timer_.get(), &QTimer::timeout, this, &K8090::pulseOffDue);
     connect(this, &K8090::doDisconnect, this, &K8090::onDoDisconnect);
     connect(this, static_cast<void (K8090::*)(CommandID)>(&K8090::enqueueCommand),  // wrap
         this, [=](CommandID command_id) { this->onEnqueueCommand(command_id); });
@@ -217,6 +324,9 @@ K8090::K8090(QObject* parent)
 K8090::~K8090()
 {
     serial_port_->close();
+    wear_accounting_->invalidate(impl_::WearAccounting::now());
+    saveRelayWear();
+    writeCommandLog();
 }
 
 
@@ -274,9 +384,9 @@ void K8090::setComPortName(const QString& name)
  */
 void K8090::setCommandDelay(int msec)
 {
-    QMutexLocker command_delay_locker{command_delay_mutex_.get()};
-    command_delay_ = msec;
-    factory_defaults_command_delay_ = 2 * command_delay_;
+    // the delays are read by the K8090's thread for each sent command, so they are published without locking
+    command_delay_.store(msec, std::memory_order_relaxed);
+    factory_defaults_command_delay_.store(card_->factory_defaults_delay_factor * msec, std::memory_order_relaxed);
 }
 
 
@@ -291,8 +401,7 @@ void K8090::setCommandDelay(int msec)
  */
 void K8090::setFailureDelay(int msec)
 {
-    QMutexLocker failure_delay_locker{failure_delay_mutex_.get()};
-    failure_delay_ = msec;
+    failure_delay_.store(msec, std::memory_order_relaxed);
 }
 
 /*!
@@ -305,295 +414,968 @@ void K8090::setFailureDelay(int msec)
  */
 void K8090::setMaxFailureCount(int count)
 {
-    QMutexLocker failure_max_count_locker{failure_max_count_mutex_.get()};
-    failure_max_count_ = count;
+    failure_max_count_.store(count, std::memory_order_relaxed);
 }
 
 
 /*!
- * \brief Test if the relay is connected.
- * \return True if connected.
+ * \brief Sets the freshness window of the card info refresh.
+ *
+ * The refresh completed less than the specified time ago satisfies new K8090::refreshRelaysInfo() requests
+ * immediately without querying the card. The changes made by the card since the refresh are delivered by signals
+ * anyway, so the window only limits how often the card state is verified. Default value is 0, which disables the
+ * window, only the refresh in flight is shared.
+ *
+ * \param msec The window in ms.
+ * \remark reentrant, thread-safe
  */
-bool K8090::isConnected()
+void K8090::setRefreshFreshness(int msec)
 {
-    QMutexLocker connected_locker{connected_mutex_.get()};
-    return connected_;
+    refresh_flight_->setFreshness(msec);
 }
 
 
 /*!
- * \brief Gets a number of commands waiting for execution in queue.
- * \param id Queried command.
- * \return The number of commands in queue.(
+ * \brief Sets the maximal micro-batching window of command bursts.
+ *
+ * When the line is idle, the command is usually sent immediately and only the commands following it in the same
+ * burst are merged in the queue. With the window set, the first relay switching, button mode or timer command arriving
+ * at the idle line is held back for a short window, so the whole burst is merged into the minimal set of commands
+ * before the first one is sent. Queries are never held back.
+ *
+ * The window starts at the maximum and adapts to the observed bursts, it shrinks to 1 ms, if the commands come alone,
+ * and grows, if the bursts are longer. The current window is reported in K8090::linkStatistics(). The burst can be
+ * sent before the window closes by K8090::flushCommands(). Default value is 0, which disables the batching.
+ *
+ * \param max_msec The maximal window in ms.
+ * \remark reentrant, thread-safe
  */
-int K8090::pendingCommandCount(CommandID id)
+void K8090::setCoalescingWindow(int max_msec)
 {
-    // TODO(lumik): Replace this hack. Pending commands unique_ptr is reseted in doDisconnect method when
-    // connected_mutex_ is locked. Create new reset method of ConcurentCommandQueue and use it here instead.
-    QMutexLocker connected_locker{connected_mutex_.get()};
-    return pending_commands_->count(id);
+    QMutexLocker coalescing_locker{coalescing_mutex_.get()};
+    coalescing_window_->setMaxWindow(max_msec);
+    link_monitor_->setCoalescingWindow(coalescing_window_->window());
 }
 
 
-// public signals
-/*!
- * \fn void K8090::relayStatus(k8090::RelayID previous, k8090::RelayID current,
- *         k8090::RelayID timed)
- * \brief Emited when the Relay status event comes from the card.
- *
- * The Relay status event can come when the status of one or more ralays changes. The status can change because of
- * button push or release or in the reaction to K8090::switchRelayOn(), K8090::switchRelayOff(), K8090::toggleRelay(),
- * K8090::startTimer() or when the timer times out.
- *
- * You can get currently switched on or off relays for example by issuing these expressions:
- * \code
- * k8090::RelayID switched_on = (previous ^ current) & current;
- * k8090::RelayID switched_off = (previous ^ current) & previous;
- * \endcode
- *
- * See the Velleman %K8090 card manual for more details.
- *
- * \param previous Relays which were previously switched on.
- * \param current Relays which are currently switched on.
- * \param timed Timed relays.
- */
 /*!
- * \fn void K8090::buttonStatus(k8090::RelayID state, k8090::RelayID pressed,
- *         k8090::RelayID released)
- * \brief Emited when the button is physically pressed or released.
+ * \brief Hints that the burst of commands is complete, so it can be sent without waiting for the batching window.
  *
- * See the Velleman %K8090 card manual for more details.
+ * The commands requested before this call from the same thread are included in the burst.
  *
- * \param state Buttons which are pressed.
- * \param pressed Buttons currently pressed.
- * \param released Buttons currently released.
+ * \remark reentrant, thread-safe
+ * \sa K8090::setCoalescingWindow()
  */
+void K8090::flushCommands()
+{
+    QTimer::singleShot(0, this, [this]() { flushCoalescedCommands(); });
+}
+
+
 /*!
- * \fn void K8090::totalTimerDelay(k8090::RelayID relay, quint16 delay)
- * \brief Reports total timer delay.
+ * \brief Sets the minimal dwell time between transitions of each relay.
  *
- * This signal is emited as the reaction to the K8090::queryTotalTimerDelay(). If more relays is queried, the signal
- * is emited for each relay separately. See the Velleman %K8090 card manual for more details.
+ * When some relay is switched on or off within the dwell after its previous transition, the transition is deferred
+ * until the dwell expires. The later requests for the same relay replace the deferred one, so the flapping relay is
+ * switched to the latest requested state only, or not at all, if it is already in that state. Toggling is never
+ * deferred. The suppressed transitions and saved commands are reported in K8090::linkStatistics(). Default value is 0,
+ * which disables the filter.
  *
- * \param relay The relay.
- * \param delay The delay.
+ * \param msec The dwell in ms.
+ * \remark reentrant, thread-safe
  */
+void K8090::setRelayDwell(int msec)
+{
+    {
+        QMutexLocker dwell_locker{dwell_mutex_.get()};
+        dwell_filter_->setDwell(msec);
+    }
+    // the deferred relays are rescheduled for the new dwell
+    QMetaObject::invokeMethod(this, "releaseDwellRelays", Qt::QueuedConnection);
+}
+
+
 /*!
- * \fn void K8090::remainingTimerDelay(k8090::RelayID relay, quint16 delay)
- * \brief Reports current remaining timer delay.
+ * \brief Sets the policy, by which the command queue merges and orders commands.
  *
- * This signal is emited as the reaction to the K8090::queryRemainingTimerDelay(). If more relays is queried, the
- * signal is emited for each relay separately. See the Velleman %K8090 card manual for more details.
+ * The default SchedulingPolicy::Priority merges compatible commands and sends urgent commands first. The policy is
+ * applied to the commands issued after the change and it is kept over reconnections. K8090::planExecution() uses the
+ * same policy. The policies can be compared on recorded or generated traffic by impl_::QueueReplay.
  *
- * \param relay The relay.
- * \param delay The delay.
+ * \param policy The policy.
+ * \remark reentrant, thread-safe
  */
+void K8090::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    QMutexLocker lifecycle_locker{lifecycle_mutex_.get()};
+    scheduling_policy_ = policy;
+    pending_commands_->setPolicy(impl_::QueuePolicy::create(policy));
+}
+
+
 /*!
- * \fn void K8090::buttonModes(k8090::RelayID momentary, k8090::RelayID toggle,
- *         k8090::RelayID timed)
- * \brief Reports button modes.
- *
- * This signal is emited as the reaction to the K8090::queryButtonModes(). See the Velleman %K8090 card manual for
- * more details.
- *
- * \param momentary Relays in momentary mode.
- * \param toggle Relays in toggle mode.
- * \param timed Relays in timed mode.
+ * \brief Gets the scheduling policy set by K8090::setSchedulingPolicy().
+ * \return The policy.
+ * \remark reentrant, thread-safe
  */
+SchedulingPolicy K8090::schedulingPolicy()
+{
+    QMutexLocker lifecycle_locker{lifecycle_mutex_.get()};
+    return scheduling_policy_;
+}
+
+
 /*!
- * \fn void K8090::jumperStatus(bool on)
- * \brief Reports jumper status.
- *
- * This signal is emited as the reaction to the K8090::queryJumperStatus(). If jumper is set on, pushing of the
- * physical buttons no longer interacts with the relays but the button events are still emited. See the Velleman
- * %K8090 card manual for more details.
+ * \brief Enables the idle mode, in which the timers are armed only for pending deadlines.
  *
- * \param on True if the jumper is switched on.
- */
-/*!
- * \fn void K8090::firmwareVersion(int year, int week)
- * \brief Reports firmware version.
+ * All the timers are single shot and most of them are armed only when some deadline is pending, for example when a
+ * command waits in the queue, a relay dwell or a pulse runs or the command log waits for its commit. The idle mode
+ * removes the remaining wakeups, which are not needed when nothing happens:
  *
- * This signal is emited as the reaction to the K8090::queryFirmwareVersion(). It reports the year and week of
- * firmware compilation. See the Velleman %K8090 card manual for more details.
+ * - The delay after the query, which tests the last command, is not timed if no command waits for it. The next
+ *   command is then sent immediately, if the delay already elapsed, or the timer is armed for the rest of the delay.
+ * - The relay wear is not stored periodically while some relay is switched on. It is stored after the next relay
+ *   transition or disconnection, so the growing on-time can be lost if the application crashes.
  *
- * \param year The year.
- * \param week The week.
- */
-/*!
- * \fn void K8090::connected()
- * \brief Reports if the communication with the card was successfuly established.
+ * The mode is intended for battery-powered controllers, the wakeups can be measured by
+ * K8090::setWakeupMeasurement(). Default value is false.
  *
- * This signal is emited as the reaction to the K8090::connectK8090().
- */
-/*!
- * \fn void K8090::connectionFailed()
- * \brief Reports communication failure after 3 consecutive unsuccessful trials.
- */
-/*!
- * \fn void K8090::notConnected()
- * \brief Emited when you try to issue command on unconnected K8090 object.
- */
-/*!
- * \fn void K8090::disconnected()
- * \brief This signal is emited as the reaction to the K8090::disconnect().
- */
-/*!
- * \fn void K8090::doDisconnect(bool failure)
- * \brief A signal for internal usage to disconnect in K8090's thread.
- */
-/*!
- * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id)
- * \brief A signal for internal usage to enqueueCommand in K8090's thread.
- */
-/*!
- * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
- *     biomolecules::sprelay::core::k8090::RelayID mask)
- * \brief A signal for internal usage to enqueueCommand in K8090's thread.
- */
-/*!
- * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
- *     biomolecules::sprelay::core::k8090::RelayID mask, unsigned char param1)
- * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ * \param enabled True to enable the idle mode.
+ * \remark reentrant, thread-safe
  */
+void K8090::setIdleMode(bool enabled)
+{
+    idle_mode_.store(enabled, std::memory_order_relaxed);
+}
+
+
 /*!
- * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
- *     biomolecules::sprelay::core::k8090::RelayID mask, unsigned char param1, unsigned char param2)
- * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ * \brief Tests if the idle mode is enabled, see K8090::setIdleMode().
+ * \return True if enabled.
+ * \remark reentrant, thread-safe
  */
+bool K8090::isIdleMode()
+{
+    return idle_mode_.load(std::memory_order_relaxed);
+}
 
 
-// public slots
 /*!
- * \brief Connects to the relay card.
+ * \brief Enables counting of the event loop wakeups of the thread, in which the K8090 object lives.
  *
- * It emits K8090::connected() signal if the connection is established. It also gets initial relay state, emiting
- * K8090::relayStatus(), K8090::buttonModes(), K8090::totalTimerDelay(), K8090::remainingTimerDelay(),
- * K8090::jumperStatus() and K8090::firmwareVersion() signals.
+ * The wakeups are counted from the QAbstractEventDispatcher::awake() signal of the thread and reported in
+ * LinkStatistics::wakeups, the rate is obtained from the difference of two K8090::linkStatistics() snapshots. All the
+ * wakeups of the thread are counted, including the ones caused by other objects living in the same thread and by the
+ * sampling itself. The counting starts when the thread processes its events, so the thread has to run an event loop.
+ *
+ * \param enabled True to enable the measurement.
+ * \remark reentrant, thread-safe
  */
-void K8090::connectK8090()
+void K8090::setWakeupMeasurement(bool enabled)
 {
-    QMutexLocker connected_locker{connected_mutex_.get()};
-    if (connecting_) {
-        return;
-    }
-    connected_ = false;
-    bool card_found = false;
-    QMutexLocker com_port_name_locker{com_port_name_mutex_.get()};
-    for (const serial_utils::ComPortParams& params : UnifiedSerialPort::availablePorts()) {
-        if (params.port_name == com_port_name_ && params.product_identifier == kProductID
-            && params.vendor_identifier == kVendorID) {
-            card_found = true;
-        }
-    }
-    com_port_name_locker.unlock();
-
-    if (!card_found) {
-        connected_locker.unlock();
-        emit connectionFailed();
-        return;
-    }
+    wakeup_measurement_.store(enabled, std::memory_order_relaxed);
+    QMetaObject::invokeMethod(this, "measureWakeups", Qt::QueuedConnection);
+}
 
-    com_port_name_locker.relock();
-    serial_port_->setPortName(com_port_name_);
-    com_port_name_locker.unlock();
-    serial_port_->setBaudRate(QSerialPort::Baud19200);
-    serial_port_->setDataBits(QSerialPort::Data8);
-    serial_port_->setParity(QSerialPort::NoParity);
-    serial_port_->setStopBits(QSerialPort::OneStop);
-    serial_port_->setFlowControl(QSerialPort::NoFlowControl);
 
-    if (!serial_port_->isOpen()) {
-        if (!serial_port_->open(QIODevice::ReadWrite)) {
-            connected_locker.unlock();
-            emit connectionFailed();
-            return;
-        }
-    }
+/*!
+ * \brief Tests if the wakeup measurement is enabled, see K8090::setWakeupMeasurement().
+ * \return True if enabled.
+ * \remark reentrant, thread-safe
+ */
+bool K8090::isWakeupMeasurementEnabled()
+{
+    return wakeup_measurement_.load(std::memory_order_relaxed);
+}
 
-    connecting_ = true;
-    connected_locker.unlock();
 
-    emit enqueueCommand(CommandID::QueryRelay);
-    emit enqueueCommand(CommandID::ButtonMode);
-    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Total));
-    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Remaining));
-    emit enqueueCommand(CommandID::JumperStatus);
-    emit enqueueCommand(CommandID::FirmwareVersion);
+/*!
+ * \brief Test if the relay is connected.
+ * \return True if connected.
+ */
+bool K8090::isConnected()
+{
+    return connection_state_->isConnected();
 }
 
 
 /*!
- * \brief Disconnects card.
- *
- * The method disconnects card, releases serial port and emits K8090::disconnected().
+ * \brief Gets a number of commands waiting for execution in queue.
+ * \param id Queried command.
+ * \return The number of commands in queue.(
  */
-void K8090::disconnect()
+int K8090::pendingCommandCount(CommandID id)
 {
-    emit doDisconnect(false);
+    // TODO(lumik): Replace this hack. Pending commands unique_ptr is reseted in doDisconnect method when
+    // lifecycle_mutex_ is locked. Create new reset method of ConcurentCommandQueue and use it here instead.
+    QMutexLocker lifecycle_locker{lifecycle_mutex_.get()};
+    return pending_commands_->count(id);
 }
 
 
 /*!
- * \brief Refreshes info about card and relay states.
+ * \brief Subscribes to filtered card events.
  *
- * Emitins K8090::relayStatus(), K8090::buttonModes(), K8090::totalTimerDelay(), K8090::remainingTimerDelay(),
- * K8090::jumperStatus() and K8090::firmwareVersion() signals.
+ * The returned EventSubscription emits only events of the specified types, which change at least one of the
+ * specified relays. Relay status is delivered when some of the relays changes its state or its timed flag, button
+ * status when some of the buttons is pressed or released and timer delays when the delay of some of the relays
+ * changes. The last known values are replayed to the subscription after the next event loop iteration of the calling
+ * thread, so you can connect to its signals right after this method returns. All the events including the replayed
+ * ones are emitted from the K8090's thread, so they arrive in order.
+ *
+ * The subscription is owned by K8090. Use K8090::unsubscribe() to stop the delivery and to release it. The remaining
+ * subscriptions are deleted later from the event loops of their threads when the K8090 object is destroyed.
+ *
+ * \param events Subscribed event types.
+ * \param relays Subscribed relays.
+ * \return The subscription.
+ * \remark reentrant, thread-safe
  */
-void K8090::refreshRelaysInfo()
+EventSubscription* K8090::subscribe(EventType events, RelayID relays)
 {
-    emit enqueueCommand(CommandID::QueryRelay);
-    emit enqueueCommand(CommandID::ButtonMode);
-    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Total));
-    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Remaining));
-    emit enqueueCommand(CommandID::JumperStatus);
-    emit enqueueCommand(CommandID::FirmwareVersion);
+    EventSubscription* subscription = subscriptions_->add(events, relays);
+    // the replay passes through the event loop of the calling thread first, so the caller can connect to the signals
+    QTimer::singleShot(0, subscription, [this, subscription]() {
+        QTimer::singleShot(0, this, [this, subscription]() { replayEvents(subscription); });
+    });
+    return subscription;
 }
 
 
 /*!
- * \brief Switches specified relays on.
+ * \brief Cancels the subscription created by K8090::subscribe().
  *
- * If some button states is modified, the K8090::relayStatus() signal will be emited. If some
- * k8090::CommandID::RelayOff command is pending for execution, the relays required by this command are
- * excluded from it.
+ * No new event is delivered to the subscription after this method returns. If it is called from other thread than
+ * the K8090's one, the signal, which was being emitted at the same time, can still arrive. The subscription is deleted
+ * later from the event loop of its thread, so the slots connected to it are safe.
  *
- * \param relays The relays.
- * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ * \param subscription The subscription.
+ * \remark reentrant, thread-safe
  */
-void K8090::switchRelayOn(RelayID relays)
+void K8090::unsubscribe(EventSubscription* subscription)
 {
-    sendCommand(CommandID::RelayOn, relays);
+    subscriptions_->remove(subscription);
 }
 
 
 /*!
- * \brief Switches specified relays off.
+ * \brief Gets switching statistics of relays.
  *
- * If some button states is modified, the K8090::relayStatus() signal will be emited. If some
- * k8090::CommandID::RelayOn command is pending for execution, the relays required by this command are
- * excluded from it.
+ * The switch count, cumulative on-time and the last transition time of each relay are updated from every relay status
+ * received from the card. The on-time of currently switched on relays includes the time until now. If the relay wear
+ * file is set by K8090::setRelayWearFile(), the statistics are accumulated across application runs.
  *
- * \param relays The relays.
- * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ * The statistics are accumulated in the K8090's thread without locking, this method reads their snapshot published
+ * after each relay transition.
+ *
+ * \return The statistics indexed by relay number, one for each relay of the card.
+ * \remark reentrant, thread-safe
  */
-void K8090::switchRelayOff(RelayID relays)
+std::vector<RelayWear> K8090::relayWear()
 {
-    sendCommand(CommandID::RelayOff, relays);
+    std::array<RelayWear, 8> wear;
+    {
+        QMutexLocker wear_locker{wear_mutex_.get()};
+        wear = wear_snapshot_->snapshot(impl_::WearAccounting::now());
+    }
+    return std::vector<RelayWear>(wear.begin(), wear.begin() + card_->relay_count);
 }
 
 
 /*!
- * \brief Toggles specified relays.
+ * \brief Sets the file, where the relay wear statistics are persisted.
  *
- * The K8090::relayStatus() signal will be emited after command execution.
+ * If the file exists and contains valid statistics, they are loaded and the counting continues from them. The
+ * statistics are stored to the file at most once per save interval when they change or when some relay is switched
+ * on and also when the card is disconnected and when the K8090 object is destroyed. The file is small, it has 197
+ * bytes.
  *
- * \param relays The relays.
- * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ * \param file_name The file name or empty string to disable persistence.
+ * \param save_interval_msec The save interval in ms.
+ * \sa K8090::relayWear()
+ * \remark reentrant, thread-safe
  */
-void K8090::toggleRelay(RelayID relays)
+void K8090::setRelayWearFile(const QString& file_name, int save_interval_msec)
 {
-    sendCommand(CommandID::ToggleRelay, relays);
+    QMutexLocker wear_locker{wear_mutex_.get()};
+    wear_file_name_ = file_name;
+    wear_save_interval_ = save_interval_msec;
+    if (wear_file_name_.isEmpty()) {
+        return;
+    }
+    QFile file{wear_file_name_};
+    if (file.open(QIODevice::ReadOnly)) {
+        // the snapshot is updated at once, the accumulated statistics are loaded in the K8090's thread
+        QByteArray data = file.readAll();
+        if (wear_snapshot_->deserialize(data)) {
+            wear_loaded_ = data;
+            QMetaObject::invokeMethod(this, "loadRelayWear", Qt::QueuedConnection);
+        }
+    }
+}
+
+
+/*!
+ * \brief Sets the write-ahead log file, which makes the accepted commands survive a crash of the application.
+ *
+ * Each command, which changes the card state, is appended to the log, when it is accepted, and it is sent to the card
+ * only after the log is synchronized to the storage device. The commands accepted during the commit delay share one
+ * synchronization (group commit), so bursts of commands pay the synchronization cost only once. When all the commands
+ * are sent and the card becomes idle, they are acknowledged by a checkpoint with the last known relay state and the
+ * log is compacted. If the commit fails, the commands are sent anyway, it is reported by
+ * K8090::commandLogStatistics().
+ *
+ * If the file contains commands, which were not acknowledged, for example because the application crashed, they are
+ * replayed after the card is connected. The relay state is reconciled with the state queried from the card, so only
+ * the relays addressed by the recovered commands and differing from their expected state are switched. The other
+ * recovered commands are resent in their original order.
+ *
+ * \param file_name The file name or empty string to disable the log.
+ * \param commit_delay_msec The group commit delay in ms.
+ * \return False if the file cannot be opened.
+ * \sa K8090::commandLogStatistics()
+ * \remark reentrant, thread-safe
+ */
+bool K8090::setCommandLogFile(const QString& file_name, int commit_delay_msec)
+{
+    QMutexLocker command_log_locker{command_log_mutex_.get()};
+    writeCommandLog();
+    command_log_active_ = false;
+    command_log_file_.reset();
+    command_log_.reset(new impl_::CommandLog);
+    command_log_commit_delay_ = commit_delay_msec;
+    if (file_name.isEmpty()) {
+        return true;
+    }
+    std::unique_ptr<QFile> file{new QFile{file_name}};
+    if (!file->open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    // drop the torn tail, so new records follow the last valid one
+    int length = command_log_->recover(file->readAll());
+    if (!file->resize(length) || !file->seek(length)) {
+        command_log_->clearRecovered();
+        return false;
+    }
+    command_log_file_ = std::move(file);
+    command_log_active_ = true;
+    if (!command_log_->recoveredCommands().empty()) {
+        QMetaObject::invokeMethod(this, "replayCommandLog", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+
+/*!
+ * \brief Gets durability statistics of the command log.
+ *
+ * The cost of durability is the commit time divided by the number of commits, the number of logged commands divided
+ * by the number of commits is the average size of the group commit.
+ *
+ * \return The statistics.
+ * \sa K8090::setCommandLogFile()
+ * \remark reentrant, thread-safe
+ */
+CommandLogStatistics K8090::commandLogStatistics()
+{
+    QMutexLocker command_log_locker{command_log_mutex_.get()};
+    return command_log_statistics_;
+}
+
+
+/*!
+ * \brief Limits the number of relays closed within a time window.
+ *
+ * Relay on commands are split when they are sent, so the relays are closed as soon as the limiter allows them, which
+ * finishes the whole transition in the minimum total time. The relays which are already switched on are not counted.
+ * The deferred relays are switched on by additional relay on commands in the order of their numbers, switching them
+ * off cancels their deferred closing. The per card limit can be chained with a global limit shared by several cards,
+ * see InrushLimiter.
+ *
+ * \param limiter The limiter or nullptr to disable the limitation. The deferred relays are then switched on at once.
+ * \remark reentrant, thread-safe
+ */
+void K8090::setInrushLimiter(std::shared_ptr<InrushLimiter> limiter)
+{
+    {
+        QMutexLocker inrush_locker{inrush_mutex_.get()};
+        inrush_limiter_ = std::move(limiter);
+    }
+    if (!inrushLimiter()) {
+        QMetaObject::invokeMethod(this, "releaseDeferredRelays", Qt::QueuedConnection);
+    }
+}
+
+
+/*!
+ * \brief Gets the inrush limiter set by K8090::setInrushLimiter().
+ * \return The limiter or nullptr if the closings are not limited.
+ * \remark reentrant, thread-safe
+ */
+std::shared_ptr<InrushLimiter> K8090::inrushLimiter()
+{
+    QMutexLocker inrush_locker{inrush_mutex_.get()};
+    return inrush_limiter_;
+}
+
+
+/*!
+ * \brief Sets the logger, which records the connection lifecycle, the command failures, the unexpected responses, the
+ * command log replays and the merged commands.
+ *
+ * The records are only stored to the lock-free buffer of the logging thread and the logger writes them in its own
+ * thread, so the logging doesn't delay the commands. The records below SPRELAY_LOG_LEVEL are removed at compile time.
+ * The logger can be shared by several cards, see Logger.
+ *
+ * The K8090's thread logs through its own copy of the logger, so the logging doesn't lock. If the method is called
+ * from other thread, the copy is updated in the next event loop iteration of the K8090's thread.
+ *
+ * \param logger The logger or nullptr to disable the logging.
+ * \remark reentrant, thread-safe
+ */
+void K8090::setLogger(std::shared_ptr<Logger> logger)
+{
+    {
+        QMutexLocker logger_locker{logger_mutex_.get()};
+        logger_ = std::move(logger);
+    }
+    if (QThread::currentThread() == thread()) {
+        applyLogger();
+    } else {
+        QMetaObject::invokeMethod(this, "applyLogger", Qt::QueuedConnection);
+    }
+}
+
+
+/*!
+ * \brief Gets the logger set by K8090::setLogger().
+ * \return The logger or nullptr if the logging is disabled.
+ * \remark reentrant, thread-safe
+ */
+std::shared_ptr<Logger> K8090::logger()
+{
+    QMutexLocker logger_locker{logger_mutex_.get()};
+    return logger_;
+}
+
+
+/*!
+ * \brief Estimates execution of commands without sending them to the card.
+ *
+ * The commands are scheduled in the same way, as if they were issued at once to the connected idle card. They are
+ * merged and ordered by priority, the commands without response are followed by query commands, which test them, and
+ * the commands are spaced by the command delay set by K8090::setCommandDelay(). The plan can be used to fit the work
+ * into time budgets.
+ *
+ * \param commands The commands in the order, in which they would be issued.
+ * \param response_delay Estimated time in ms, in which the card responds to queries.
+ * \return The resulting command sequence and estimated completion time.
+ * \remark reentrant, thread-safe
+ */
+ExecutionPlan K8090::planExecution(const std::vector<CardCommand>& commands, int response_delay)
+{
+    impl_::ExecutionPlanner planner{command_delay_.load(std::memory_order_relaxed), response_delay, *card_,
+        schedulingPolicy()};
+    for (const CardCommand& command : commands) {
+        planner.enqueue(command);
+    }
+    return planner.plan();
+}
+
+
+/*!
+ * \brief Executes the relay program.
+ *
+ * The program is executed by interpreter in the thread of the K8090 object. Its commands are submitted directly into
+ * the command queue, so the steps are not delayed by signal delivery between threads. If another program is running,
+ * it is stopped. The end of the program is notified by the K8090::programFinished() signal. The program is stopped
+ * when the card is disconnected.
+ *
+ * \param program The program.
+ * \return False if the program is not valid or the card is not connected.
+ * \sa RelayProgram, K8090::stopProgram()
+ * \remark reentrant, thread-safe
+ */
+bool K8090::runProgram(const RelayProgram& program)
+{
+    if (!program.isValid()) {
+        return false;
+    }
+    if (!connection_state_->isConnected()) {
+        emit notConnected();
+        return false;
+    }
+    std::vector<ProgramStep> steps = program.steps();
+    QTimer::singleShot(0, this, [this, steps]() { startProgram(steps); });
+    return true;
+}
+
+
+/*!
+ * \brief Stops the running relay program.
+ *
+ * The commands already submitted into the command queue are still sent.
+ *
+ * \remark reentrant, thread-safe
+ */
+void K8090::stopProgram()
+{
+    QTimer::singleShot(0, this, [this]() { finishProgram(false); });
+}
+
+
+/*!
+ * \brief Runs scripted physical interaction with the virtual card.
+ *
+ * The simulated card executes the scenario button presses, jumper changes and timer expiries in its own timing and
+ * sends the same unsolicited button and relay status events as the real card, so they are interleaved with the
+ * command traffic. The previously running scenario is stopped, empty scenario only stops it. The scenario is stopped
+ * when the card is disconnected.
+ *
+ * \param scenario The scenario.
+ * \return False if the scenario is not valid or the card is not connected virtual card.
+ * \sa MockScenario
+ * \remark reentrant, thread-safe
+ */
+bool K8090::runMockScenario(const MockScenario& scenario)
+{
+    if (!scenario.isValid()) {
+        return false;
+    }
+    if (!connection_state_->isConnected()) {
+        emit notConnected();
+        return false;
+    }
+    if (!serial_port_->isMock()) {
+        return false;
+    }
+    std::vector<ScenarioEvent> events = scenario.events();
+    int period = scenario.period();
+    int repeat_count = scenario.repeatCount();
+    QTimer::singleShot(0, this, [this, events, period, repeat_count]() {
+        if (connection_state_->isConnected()) {
+            serial_port_->runMockScenario(events, period, repeat_count);
+        }
+    });
+    return true;
+}
+
+
+/*!
+ * \brief Switches the relays on for a precisely timed pulse.
+ *
+ * The card timers have one second resolution, see K8090::startRelayTimer(), so shorter pulses are timed by the host
+ * with a precise timer. The pulse edges are sent ahead of the queued commands as soon as the command delay allows and
+ * they bypass the dwell filter, the inrush limiter and the micro-batching window. The on edge measures the one-way
+ * latency of the line and the off edge is sent so, that it reaches the card the width after the on edge, see
+ * impl_::PrecisePulse. When the card confirms the off edge, the achieved width and its error are reported by the
+ * K8090::pulseFinished() signal. Only one pulse can run at once. The pulse is abandoned, when the card is
+ * disconnected.
+ *
+ * \param relays The relays.
+ * \param width_msec The pulse width in ms.
+ * \return False if the card is not connected, no relay or non-positive width is specified or another pulse is running.
+ * \remark reentrant, thread-safe
+ */
+bool K8090::pulseRelay(RelayID relays, int width_msec)
+{
+    if (!connection_state_->isConnected()) {
+        emit notConnected();
+        return false;
+    }
+    if (relays == RelayID::None || width_msec <= 0) {
+        return false;
+    }
+    // the pulse itself is owned by the K8090's thread, the other threads only reserve it
+    bool reserved = false;
+    if (!pulse_reserved_.compare_exchange_strong(reserved, true)) {
+        return false;
+    }
+    QTimer::singleShot(0, this, [this, relays, width_msec]() { startPulse(relays, width_msec); });
+    return true;
+}
+
+
+/*!
+ * \brief Waits for the card response without signal delivery.
+ *
+ * The matcher is tested with each response of the card in the thread of the K8090 object. When it returns true, the
+ * handler is called directly from the response processing in the same thread and the waiting ends. If the card is
+ * disconnected, the handler is called with the event, the CardEvent::response of which is ResponseID::None. The
+ * waiting should be started before the command, the response of which is awaited, is sent.
+ *
+ * It is the base of the asynchronous interface in k8090_coroutines.h, where the handler resumes suspended coroutine.
+ *
+ * \param matcher The predicate selecting the awaited response. It must not call K8090 methods.
+ * \param handler The handler of the awaited response.
+ * \remark reentrant, thread-safe
+ */
+void K8090::waitForResponse(ResponseMatcher matcher, ResponseHandler handler)
+{
+    response_waiters_->add(std::move(matcher), std::move(handler));
+}
+
+
+/*!
+ * \brief Adds the listener of all card events, which is called without signal delivery.
+ *
+ * The listener is called directly from the response decoding in the thread of the K8090 object with each response
+ * of the card, including the responses to physical button presses. There is no argument marshalling, event
+ * allocation nor event loop round trip, which are needed by the signals delivered through queued connections. The
+ * listeners are called after the signals are emitted, in the order of their addition, and they coexist with the
+ * signals and subscriptions.
+ *
+ * The listener runs in the K8090 thread, so it must be thread-safe and short, for example it can store the event into
+ * a lock-free queue. It can add and remove listeners.
+ *
+ * \param listener The listener.
+ * \return Identifier of the listener for K8090::removeEventListener().
+ * \remark reentrant, thread-safe
+ */
+int K8090::addEventListener(EventListener listener)
+{
+    return event_listeners_->add(std::move(listener));
+}
+
+
+/*!
+ * \brief Removes the listener added by K8090::addEventListener().
+ *
+ * When it is called from other thread than the K8090 thread, it waits until the listener's running call finishes, so
+ * the resources used by the listener can be released after it returns. It must not be called with a lock held,
+ * which the listeners acquire. When it is called from a listener, the change takes effect from the next event.
+ *
+ * \param id Identifier of the listener.
+ * \remark reentrant, thread-safe
+ */
+void K8090::removeEventListener(int id)
+{
+    event_listeners_->remove(id);
+}
+
+
+/*!
+ * \brief Takes the snapshot of the live link statistics.
+ *
+ * The statistics are updated by the K8090 thread with atomic operations only and the snapshot is taken without any
+ * lock, so it can be sampled periodically from other threads, for example by a diagnostics view, without slowing down
+ * the command processing. The latency percentiles are computed from all the latencies measured since the construction
+ * or the last K8090::resetLinkStatistics() call with 1 ms resolution.
+ *
+ * \return The statistics.
+ * \remark reentrant, thread-safe
+ */
+LinkStatistics K8090::linkStatistics() const
+{
+    return link_monitor_->snapshot();
+}
+
+
+/*!
+ * \brief Clears the counters and latencies reported by K8090::linkStatistics().
+ * \remark reentrant, thread-safe
+ */
+void K8090::resetLinkStatistics()
+{
+    QMutexLocker dwell_locker{dwell_mutex_.get()};
+    dwell_filter_->resetStatistics();
+    link_monitor_->reset();
+}
+
+
+/*!
+ * \brief Refreshes info about card and relay states and calls the handler when the refresh is finished.
+ *
+ * The refresh is single-flight. If some refresh is in flight, the request attaches to it without sending any query
+ * and all the attached handlers are completed by the same responses. Otherwise the queries are enqueued and the
+ * K8090::relayStatus(), K8090::buttonModes(), K8090::totalTimerDelay(), K8090::remainingTimerDelay(),
+ * K8090::jumperStatus() and K8090::firmwareVersion() signals are emitted.
+ *
+ * The handler is called with true in the thread of the K8090 object after all the responses are received and their
+ * signals are emitted. It is called with false, if some command fails during the refresh or the card is disconnected.
+ * If the last refresh is completed within the window set by K8090::setRefreshFreshness(), the handler is called
+ * immediately in the calling thread. If the card is not connected, it is called immediately with false.
+ *
+ * \param handler The handler, it can be empty.
+ * \remark reentrant, thread-safe
+ */
+void K8090::refreshRelaysInfo(RefreshHandler handler)
+{
+    if (!refresh_flight_->request(std::move(handler), kRefreshAll, connection_state_->isActive())) {
+        return;
+    }
+
+    emit enqueueCommand(CommandID::QueryRelay);
+    emit enqueueCommand(CommandID::ButtonMode);
+    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Total));
+    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Remaining));
+    emit enqueueCommand(CommandID::JumperStatus);
+    emit enqueueCommand(CommandID::FirmwareVersion);
+}
+
+
+// public signals
+/*!
+ * \fn void K8090::relayStatus(k8090::RelayID previous, k8090::RelayID current,
+ *         k8090::RelayID timed)
+ * \brief Emited when the Relay status event comes from the card.
+ *
+ * The Relay status event can come when the status of one or more ralays changes. The status can change because of
+ * button push or release or in the reaction to K8090::switchRelayOn(), K8090::switchRelayOff(), K8090::toggleRelay(),
+ * K8090::startTimer() or when the timer times out.
+ *
+ * You can get currently switched on or off relays for example by issuing these expressions:
+ * \code
+ * k8090::RelayID switched_on = (previous ^ current) & current;
+ * k8090::RelayID switched_off = (previous ^ current) & previous;
+ * \endcode
+ *
+ * See the Velleman %K8090 card manual for more details.
+ *
+ * \param previous Relays which were previously switched on.
+ * \param current Relays which are currently switched on.
+ * \param timed Timed relays.
+ */
+/*!
+ * \fn void K8090::buttonStatus(k8090::RelayID state, k8090::RelayID pressed,
+ *         k8090::RelayID released)
+ * \brief Emited when the button is physically pressed or released.
+ *
+ * See the Velleman %K8090 card manual for more details.
+ *
+ * \param state Buttons which are pressed.
+ * \param pressed Buttons currently pressed.
+ * \param released Buttons currently released.
+ */
+/*!
+ * \fn void K8090::totalTimerDelay(k8090::RelayID relay, quint16 delay)
+ * \brief Reports total timer delay.
+ *
+ * This signal is emited as the reaction to the K8090::queryTotalTimerDelay(). If more relays is queried, the signal
+ * is emited for each relay separately. See the Velleman %K8090 card manual for more details.
+ *
+ * \param relay The relay.
+ * \param delay The delay.
+ */
+/*!
+ * \fn void K8090::remainingTimerDelay(k8090::RelayID relay, quint16 delay)
+ * \brief Reports current remaining timer delay.
+ *
+ * This signal is emited as the reaction to the K8090::queryRemainingTimerDelay(). If more relays is queried, the
+ * signal is emited for each relay separately. See the Velleman %K8090 card manual for more details.
+ *
+ * \param relay The relay.
+ * \param delay The delay.
+ */
+/*!
+ * \fn void K8090::buttonModes(k8090::RelayID momentary, k8090::RelayID toggle,
+ *         k8090::RelayID timed)
+ * \brief Reports button modes.
+ *
+ * This signal is emited as the reaction to the K8090::queryButtonModes(). See the Velleman %K8090 card manual for
+ * more details.
+ *
+ * \param momentary Relays in momentary mode.
+ * \param toggle Relays in toggle mode.
+ * \param timed Relays in timed mode.
+ */
+/*!
+ * \fn void K8090::jumperStatus(bool on)
+ * \brief Reports jumper status.
+ *
+ * This signal is emited as the reaction to the K8090::queryJumperStatus(). If jumper is set on, pushing of the
+ * physical buttons no longer interacts with the relays but the button events are still emited. See the Velleman
+ * %K8090 card manual for more details.
+ *
+ * \param on True if the jumper is switched on.
+ */
+/*!
+ * \fn void K8090::firmwareVersion(int year, int week)
+ * \brief Reports firmware version.
+ *
+ * This signal is emited as the reaction to the K8090::queryFirmwareVersion(). It reports the year and week of
+ * firmware compilation. See the Velleman %K8090 card manual for more details.
+ *
+ * \param year The year.
+ * \param week The week.
+ */
+/*!
+ * \fn void K8090::programFinished(bool completed)
+ * \brief Emitted when the relay program started by K8090::runProgram() ends.
+ * \param completed True if all program steps were executed, false if the program was stopped.
+ */
+
+/*!
+ * \fn void K8090::connected()
+ * \brief Reports if the communication with the card was successfuly established.
+ *
+ * This signal is emited as the reaction to the K8090::connectK8090().
+ */
+/*!
+ * \fn void K8090::connectionFailed()
+ * \brief Reports communication failure after 3 consecutive unsuccessful trials.
+ */
+/*!
+ * \fn void K8090::notConnected()
+ * \brief Emited when you try to issue command on unconnected K8090 object.
+ */
+/*!
+ * \fn void K8090::disconnected()
+ * \brief This signal is emited as the reaction to the K8090::disconnect().
+ */
+/*!
+ * \fn void K8090::doDisconnect(bool failure)
+ * \brief A signal for internal usage to disconnect in K8090's thread.
+ */
+/*!
+ * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id)
+ * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ */
+/*!
+ * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
+ *     biomolecules::sprelay::core::k8090::RelayID mask)
+ * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ */
+/*!
+ * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
+ *     biomolecules::sprelay::core::k8090::RelayID mask, unsigned char param1)
+ * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ */
+/*!
+ * \fn void K8090::enqueueCommand(biomolecules::sprelay::core::k8090::CommandID command_id,
+ *     biomolecules::sprelay::core::k8090::RelayID mask, unsigned char param1, unsigned char param2)
+ * \brief A signal for internal usage to enqueueCommand in K8090's thread.
+ */
+
+
+// public slots
+/*!
+ * \brief Connects to the relay card.
+ *
+ * It emits K8090::connected() signal if the connection is established. It also gets initial relay state, emiting
+ * K8090::relayStatus(), K8090::buttonModes(), K8090::totalTimerDelay(), K8090::remainingTimerDelay(),
+ * K8090::jumperStatus() and K8090::firmwareVersion() signals.
+ */
+void K8090::connectK8090()
+{
+    QMutexLocker lifecycle_locker{lifecycle_mutex_.get()};
+    if (!connection_state_->transition(impl_::ConnectionEvent::Connect)) {
+        return;
+    }
+    bool card_found = false;
+    QMutexLocker com_port_name_locker{com_port_name_mutex_.get()};
+    for (const serial_utils::ComPortParams& params : UnifiedSerialPort::availablePorts()) {
+        if (params.port_name == com_port_name_ && params.product_identifier == card_->product_id
+            && params.vendor_identifier == card_->vendor_id) {
+            card_found = true;
+        }
+    }
+    com_port_name_locker.unlock();
+
+    if (!card_found) {
+        connection_state_->transition(impl_::ConnectionEvent::Disconnect);
+        lifecycle_locker.unlock();
+        logEvent<LogLevel::Error>(LogEvent::ConnectionFailed);
+        emit connectionFailed();
+        return;
+    }
+
+    com_port_name_locker.relock();
+    serial_port_->setPortName(com_port_name_);
+    com_port_name_locker.unlock();
+    serial_port_->setBaudRate(QSerialPort::Baud19200);
+    serial_port_->setDataBits(QSerialPort::Data8);
+    serial_port_->setParity(QSerialPort::NoParity);
+    serial_port_->setStopBits(QSerialPort::OneStop);
+    serial_port_->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!serial_port_->isOpen()) {
+        if (!serial_port_->open(QIODevice::ReadWrite)) {
+            connection_state_->transition(impl_::ConnectionEvent::Disconnect);
+            lifecycle_locker.unlock();
+            logEvent<LogLevel::Error>(LogEvent::ConnectionFailed);
+            emit connectionFailed();
+            return;
+        }
+    }
+    lifecycle_locker.unlock();
+
+    emit enqueueCommand(CommandID::QueryRelay);
+    emit enqueueCommand(CommandID::ButtonMode);
+    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Total));
+    emit enqueueCommand(CommandID::Timer, RelayID::All, as_number(impl_::TimerDelayType::Remaining));
+    emit enqueueCommand(CommandID::JumperStatus);
+    emit enqueueCommand(CommandID::FirmwareVersion);
+}
+
+
+/*!
+ * \brief Disconnects card.
+ *
+ * The method disconnects card, releases serial port and emits K8090::disconnected().
+ */
+void K8090::disconnect()
+{
+    emit doDisconnect(false);
+}
+
+
+/*!
+ * \brief Refreshes info about card and relay states.
+ *
+ * Emitins K8090::relayStatus(), K8090::buttonModes(), K8090::totalTimerDelay(), K8090::remainingTimerDelay(),
+ * K8090::jumperStatus() and K8090::firmwareVersion() signals. The refresh is single-flight, see
+ * K8090::refreshRelaysInfo(RefreshHandler).
+ */
+void K8090::refreshRelaysInfo()
+{
+    refreshRelaysInfo(RefreshHandler{});
+}
+
+
+/*!
+ * \brief Switches specified relays on.
+ *
+ * If some button states is modified, the K8090::relayStatus() signal will be emited. If some
+ * k8090::CommandID::RelayOff command is pending for execution, the relays required by this command are
+ * excluded from it.
+ *
+ * \param relays The relays.
+ * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ */
+void K8090::switchRelayOn(RelayID relays)
+{
+    sendCommand(CommandID::RelayOn, relays);
+}
+
+
+/*!
+ * \brief Switches specified relays off.
+ *
+ * If some button states is modified, the K8090::relayStatus() signal will be emited. If some
+ * k8090::CommandID::RelayOn command is pending for execution, the relays required by this command are
+ * excluded from it.
+ *
+ * \param relays The relays.
+ * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ */
+void K8090::switchRelayOff(RelayID relays)
+{
+    sendCommand(CommandID::RelayOff, relays);
+}
+
+
+/*!
+ * \brief Toggles specified relays.
+ *
+ * The K8090::relayStatus() signal will be emited after command execution.
+ *
+ * \param relays The relays.
+ * \sa K8090::relayStatus(), K8090::startRelayTimer()
+ */
+void K8090::toggleRelay(RelayID relays)
+{
+    sendCommand(CommandID::ToggleRelay, relays);
 }
 
 
@@ -750,46 +1532,69 @@ void K8090::queryFirmwareVersion()
 void K8090::onReadyData()
 {
     QByteArray data = serial_port_->readAll();
-    int n = data.size();
+    processResponses(data.constData(), data.size());
+}
+
+
+// Decodes the frames received from the card and processes them. The frames are decoded on the stack, so the response
+// processing doesn't allocate. It is called only from the K8090's thread.
+void K8090::processResponses(const char* data, int n)
+{
     for (int i = 0; i < n; i += 7) {
         if (n - i < 7) {
+            logEvent<LogLevel::Warning>(LogEvent::InvalidResponse, current_command_->id, RelayID::None, n - i);
             onCommandFailed();
             return;
         }
-        // TODO(lumik): switch to PIMPL and remove unnecessary heap usage
-        std::unique_ptr<impl_::CardMessage> response;
-        try {
-            response.reset(new impl_::CardMessage{data.constBegin() + i, data.constBegin() + i + 7});
-        } catch (const std::out_of_range&) {
-            onCommandFailed();
-            return;
-        }
-        if (!response->isValid()) {
+        const impl_::CardMessage response{data + i, data + i + 7};
+        if (!response.isValid()) {
+            logEvent<LogLevel::Warning>(LogEvent::InvalidResponse, current_command_->id, RelayID::None, 7);
             onCommandFailed();
             return;
         }
-        switch (response->commandByte()) {
-            case impl_::kResponses[as_number(ResponseID::ButtonMode)]:
-                buttonModeResponse(std::move(response));
+        // the event is prepared before the response processing, which resets the current command
+        CardEvent event{ResponseID::None, response.data[2], response.data[3], response.data[4],
+            current_command_->id == CommandID::Timer && (current_command_->params[1] & 1u) != 0u};
+        event.response = card_->response_ids[response.commandByte()];
+        // the response answers the last sent command, if it stops the failure check or the next command is sent and
+        // no failure is detected
+        const bool awaiting_response = failure_timer_->isActive();
+        const qint64 latency = link_monitor_->elapsedSinceSent();
+        const quint32 sent_commands = link_monitor_->sentCommands();
+        const quint32 failures = link_monitor_->failures();
+        const impl_::ResponseAction action = connection_state_->responseAction(event.response);
+        switch (event.response) {
+            case ResponseID::ButtonMode:
+                buttonModeResponse(response, action);
                 break;
-            case impl_::kResponses[as_number(ResponseID::Timer)]:
-                timerResponse(std::move(response));
+            case ResponseID::Timer:
+                timerResponse(response, action);
                 break;
-            case impl_::kResponses[as_number(ResponseID::ButtonStatus)]:
-                buttonStatusResponse(std::move(response));
+            case ResponseID::ButtonStatus:
+                buttonStatusResponse(response, action);
                 break;
-            case impl_::kResponses[as_number(ResponseID::RelayStatus)]:
-                relayStatusResponse(std::move(response));
+            case ResponseID::RelayStatus:
+                relayStatusResponse(response, action);
                 break;
-            case impl_::kResponses[as_number(ResponseID::JumperStatus)]:
-                jumperStatusResponse(std::move(response));
+            case ResponseID::JumperStatus:
+                jumperStatusResponse(response, action);
                 break;
-            case impl_::kResponses[as_number(ResponseID::FirmwareVersion)]:
-                firmwareVersionResponse(std::move(response));
+            case ResponseID::FirmwareVersion:
+                firmwareVersionResponse(response, action);
                 break;
             default:
+                logEvent<LogLevel::Warning>(LogEvent::UnexpectedResponse, current_command_->id,
+                    static_cast<RelayID>(response.data[2]), as_number(event.response));
                 onCommandFailed();
         }
+        if (awaiting_response && link_monitor_->failures() == failures
+            && (!failure_timer_->isActive() || link_monitor_->sentCommands() != sent_commands)) {
+            link_monitor_->recordLatency(latency);
+        }
+        if (event.response != ResponseID::None) {
+            response_waiters_->complete(event);
+            event_listeners_->dispatch(event);
+        }
     }
 }
 
@@ -809,7 +1614,10 @@ void K8090::dequeueCommand()
         case CommandID::ToggleRelay:
         case CommandID::StartTimer:
         case CommandID::ResetFactoryDefaults:
-            sendCommandHelper(CommandID::QueryRelay);
+            // the pulse edge is followed by the same query
+            if (!sendPulseEdge()) {
+                sendCommandHelper(CommandID::QueryRelay);
+            }
             return;
         case CommandID::SetButtonMode:
             sendCommandHelper(CommandID::ButtonMode);
@@ -821,119 +1629,671 @@ void K8090::dequeueCommand()
             break;
     }
 
-    if (!pending_commands_->empty()) {
-        impl_::Command command = pending_commands_->pop();
-        sendCommandHelper(command.id, static_cast<RelayID>(command.params[0]), command.params[1], command.params[2]);
+    // the pulse edges go ahead of the queued commands
+    if (sendPulseEdge()) {
+        return;
+    }
+    // the commands are sent after they are durable, commitCommandLog() dequeues them
+    if (command_log_active_) {
+        QMutexLocker command_log_locker{command_log_mutex_.get()};
+        if (command_log_->hasUncommittedCommands()) {
+            return;
+        }
+    }
+    if (!pending_commands_->empty()) {
+        impl_::Command command = pending_commands_->pop();
+        link_monitor_->commandDequeued(static_cast<int>(pending_commands_->size()));
+        sendCommandHelper(command.id, static_cast<RelayID>(command.params[0]), command.params[1], command.params[2]);
+    } else {
+        checkpointCommandLog();
+    }
+}
+
+
+void K8090::onCommandFailed()
+{
+    failure_timer_->stop();
+    CommandID failed = current_command_->id;
+    // the delay after the query can be untimed in the idle mode, the unanswered query is then cleared by
+    // dequeueCommand() when the rest of the delay elapses as in the normal mode
+    if (failed == CommandID::QueryRelay && !command_timer_->isActive()) {
+        scheduleNextCommand(commandDelayRemaining());
+    }
+    link_monitor_->commandFailed();
+    // the lost response would never complete the refresh
+    refresh_flight_->fail();
+    ++failure_counter_;
+    logEvent<LogLevel::Warning>(LogEvent::CommandFailed, failed, RelayID::None, failure_counter_);
+    if (failure_counter_ > failure_max_count_.load(std::memory_order_relaxed)) {
+        onDoDisconnect(true);
+    }
+}
+
+
+// This method should be called to do all the stuff needed to disconnect from the relay card
+// Stops timer, so it should be run in the K8090's thread. It is achieved by calling this method through signal slots
+// mechanism
+void K8090::onDoDisconnect(bool failure)
+{
+    QMutexLocker lifecycle_locker{lifecycle_mutex_.get()};
+    if (connection_state_->transition(impl_::ConnectionEvent::Disconnect)) {
+        serial_port_->close();
+        // erase all pending commands
+        pending_commands_.reset(
+            new impl_::ConcurentCommandQueue{card_->priorities, impl_::QueuePolicy::create(scheduling_policy_)});
+        link_monitor_->clearQueue();
+        // stop failure timers and erase failure counter
+        command_timer_->stop();
+        failure_timer_->stop();
+        failure_counter_ = 0;
+
+        lifecycle_locker.unlock();
+
+        inrush_timer_->stop();
+        {
+            QMutexLocker inrush_locker{inrush_mutex_.get()};
+            inrush_deferred_ = RelayID::None;
+        }
+        coalescing_timer_->stop();
+        dwell_timer_->stop();
+        {
+            QMutexLocker dwell_locker{dwell_mutex_.get()};
+            dwell_filter_->clear();
+        }
+        pulse_timer_->stop();
+        resetPulse();
+        // the dropped commands are not replayed after intentional disconnection
+        if (!failure) {
+            checkpointCommandLog();
+            writeCommandLog();
+        }
+        // last known values are no longer reliable
+        event_cache_->reset();
+        status_correlator_->clear();
+        wear_accounting_->invalidate(impl_::WearAccounting::now());
+        publishRelayWear();
+        saveRelayWear();
+        finishProgram(false);
+        response_waiters_->complete(CardEvent{ResponseID::None, 0, 0, 0, false});
+        refresh_flight_->invalidate();
+        refresh_flight_->fail();
+
+        if (failure) {
+            logEvent<LogLevel::Error>(LogEvent::ConnectionFailed, current_command_->id);
+            emit connectionFailed();
+        } else {
+            logEvent<LogLevel::Info>(LogEvent::Disconnected);
+            emit disconnected();
+        }
+    }
+}
+
+
+// Stores relay wear statistics to the wear file. It is called periodically by wear_timer_, which is armed only when
+// the statistics change or some relay is switched on and the idle mode is disabled, so there are no wake ups when the
+// relays are idle. It is called only from the K8090's thread, which owns the accumulated statistics.
+void K8090::saveRelayWear()
+{
+    QString file_name;
+    {
+        QMutexLocker wear_locker{wear_mutex_.get()};
+        file_name = wear_file_name_;
+    }
+    if (file_name.isEmpty()) {
+        return;
+    }
+    QByteArray data = wear_accounting_->serialize(impl_::WearAccounting::now());
+    bool switched_on = wear_accounting_->switchedOn() != RelayID::None;
+
+    QSaveFile file{file_name};
+    if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit()) {
+        wear_accounting_->clearDirty();
+    }
+    // on-time of switched on relays is growing, in the idle mode it is stored with the next transition
+    if (switched_on && !wear_timer_->isActive() && !isIdleMode()) {
+        QMutexLocker wear_locker{wear_mutex_.get()};
+        wear_timer_->start(wear_save_interval_);
+    }
+}
+
+
+// Group commit of the command log. It is called by command_log_timer_ and releases the commands, which waited for
+// the commit.
+void K8090::commitCommandLog()
+{
+    writeCommandLog();
+    if (isLineFree()) {
+        dequeueCommand();
+    } else {
+        resumeCommands();
+    }
+}
+
+
+// Switches on the relays deferred by the inrush limiter. They are already logged, so they bypass the command log. It
+// is called by inrush_timer_, when the limiter allows the next closing.
+void K8090::releaseDeferredRelays()
+{
+    QMutexLocker inrush_locker{inrush_mutex_.get()};
+    RelayID deferred = inrush_deferred_;
+    inrush_deferred_ = RelayID::None;
+    inrush_locker.unlock();
+    if (deferred == RelayID::None) {
+        return;
+    }
+    if (isLineFree() && pending_commands_->empty()) {
+        sendCommandHelper(CommandID::RelayOn, deferred);
+    } else {
+        pending_commands_->updateOrPush(CommandID::RelayOn, deferred, 0, 0);
+        resumeCommands();
+    }
+}
+
+
+// Switches the relays, the dwell of which expired, to their latest requested state. It is called only from the K8090's
+// thread.
+void K8090::releaseDwellRelays()
+{
+    QMutexLocker dwell_locker{dwell_mutex_.get()};
+    const qint64 now = impl_::DwellFilter::now();
+    RelayID on;
+    RelayID off;
+    dwell_filter_->release(now, event_cache_->currentRelays(), &on, &off);
+    link_monitor_->setDwellStatistics(dwell_filter_->suppressedTransitions(), dwell_filter_->savedCommands());
+    scheduleDwellRelease(now);
+    dwell_locker.unlock();
+
+    if (!connection_state_->isConnected()) {
+        return;
+    }
+    if (off != RelayID::None) {
+        {
+            QMutexLocker inrush_locker{inrush_mutex_.get()};
+            inrush_deferred_ &= ~off;
+        }
+        if (isLineFree() && pending_commands_->empty()) {
+            sendCommandHelper(CommandID::RelayOff, off);
+        } else {
+            pending_commands_->updateOrPush(CommandID::RelayOff, off, 0, 0);
+            resumeCommands();
+        }
+    }
+    if (on != RelayID::None) {
+        if (isLineFree() && pending_commands_->empty()) {
+            sendCommandHelper(CommandID::RelayOn, on);
+        } else {
+            pending_commands_->updateOrPush(CommandID::RelayOn, on, 0, 0);
+            resumeCommands();
+        }
+    }
+}
+
+
+// Reconciles the commands recovered from the command log with the card state queried during the connection. It is
+// called only from the K8090's thread.
+void K8090::replayCommandLog()
+{
+    if (!connection_state_->isConnected()) {
+        return;
+    }
+    QMutexLocker command_log_locker{command_log_mutex_.get()};
+    if (command_log_->recoveredCommands().empty() || !event_cache_->hasRelayStatus()) {
+        return;
+    }
+    RelayID current = event_cache_->currentRelays();
+    std::vector<CardCommand> commands = command_log_->recoveredCommands();
+    RelayID baseline = command_log_->hasRecoveredRelays() ? command_log_->recoveredRelays() : current;
+    command_log_->clearRecovered();
+    command_log_statistics_.replayed_commands += commands.size();
+    command_log_locker.unlock();
+
+    // factory defaults switch all relays off and overwrite the previous settings
+    auto reset = std::find_if(commands.rbegin(), commands.rend(),
+        [](const CardCommand& command) { return command.id == CommandID::ResetFactoryDefaults; });
+    if (reset != commands.rend()) {
+        commands.erase(commands.begin(), reset.base());
+        onEnqueueCommand(CommandID::ResetFactoryDefaults);
+        current = RelayID::None;
+        baseline = RelayID::None;
+    }
+    RelayID addressed = RelayID::None;
+    for (const CardCommand& command : commands) {
+        switch (command.id) {
+            case CommandID::RelayOn:
+            case CommandID::RelayOff:
+            case CommandID::ToggleRelay:
+                addressed |= command.mask;
+                break;
+            default:
+                onEnqueueCommand(command.id, command.mask, command.param1, command.param2);
+                break;
+        }
+    }
+    RelayID expected = (impl_::CommandLog::expectedRelays(baseline, commands) & addressed) | (current & ~addressed);
+    if ((expected & ~current) != RelayID::None) {
+        onEnqueueCommand(CommandID::RelayOn, expected & ~current);
+    }
+    if ((current & ~expected) != RelayID::None) {
+        onEnqueueCommand(CommandID::RelayOff, current & ~expected);
+    }
+    logEvent<LogLevel::Info>(LogEvent::Resync, CommandID::None, expected ^ current, static_cast<int>(commands.size()));
+}
+
+
+// general top level method which sends commands to card. It controlls, if the card is connected and then uses
+// enqueuCommand().
+void K8090::sendCommand(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+{
+    if (!connection_state_->isConnected()) {
+        emit notConnected();
+        return;
+    }
+    emit enqueueCommand(command_id, mask, param1, param2);
+}
+
+
+// Each command is sended through this method. It controlls if the command can be sended directly or enqueued for
+// delayed sending, because the virtual serial port interface of the card doesn't accept commands which are sended with
+// too small delay in between them.
+// This method must be used from the K8090's thread, so invoke it by emitting enqueCommand signal through lambda
+// expression - see connections in the constructor.
+void K8090::onEnqueueCommand(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+{
+    bool uncommitted = false;
+    if (command_log_active_) {
+        QMutexLocker command_log_locker{command_log_mutex_.get()};
+        if (command_log_file_ && impl_::CommandLog::isLogged(command_id)) {
+            command_log_->append(CardCommand{command_id, mask, param1, param2});
+            ++command_log_statistics_.logged_commands;
+            if (!command_log_timer_->isActive()) {
+                command_log_timer_->start(command_log_commit_delay_);
+            }
+        }
+        uncommitted = command_log_->hasUncommittedCommands();
+    }
+
+    // switching off cancels the deferred closing of the relays
+    if (command_id == CommandID::RelayOff) {
+        QMutexLocker inrush_locker{inrush_mutex_.get()};
+        inrush_deferred_ &= ~mask;
+    } else if (command_id == CommandID::ResetFactoryDefaults) {
+        QMutexLocker inrush_locker{inrush_mutex_.get()};
+        inrush_deferred_ = RelayID::None;
+    }
+
+    // transitions within the dwell are deferred and collapsed to the latest requested state
+    if (command_id == CommandID::RelayOn || command_id == CommandID::RelayOff || command_id == CommandID::ToggleRelay) {
+        RelayID passed = filterDwell(command_id, mask);
+        if (passed == RelayID::None && mask != RelayID::None) {
+            return;
+        }
+        mask = passed;
+    }
+
+    // Send command directly if it is sufficiently delayed from the previous one, there are no commands pending and
+    // there are no commands waiting for the command log commit.
+    bool idle = !uncommitted && isLineFree() && pending_commands_->empty();
+
+    QMutexLocker coalescing_locker{coalescing_mutex_.get()};
+    if (idle && coalescing_window_->enabled() && isCoalesced(command_id)) {
+        // hold the first command of the burst back, so the following commands are merged with it
+        int window = coalescing_window_->startBurst();
+        burst_timer_->start();
+        coalescing_locker.unlock();
+        link_monitor_->coalescingWindowOpened(window);
+        pending_commands_->updateOrPush(command_id, mask, param1, param2);
+        link_monitor_->commandEnqueued(false, static_cast<int>(pending_commands_->size()));
+        coalescing_timer_->start(window);
+        return;
+    }
+    if (burst_timer_->isValid()) {
+        coalescing_window_->commandArrived(burst_timer_->elapsed());
+    }
+    coalescing_locker.unlock();
+
+    if (idle) {
+        link_monitor_->commandEnqueued(false, 0);
+        sendCommandHelper(command_id, mask, param1, param2);
+    } else {  // send command undirectly
+        bool merged = pending_commands_->updateOrPush(command_id, mask, param1, param2);
+        link_monitor_->commandEnqueued(merged, static_cast<int>(pending_commands_->size()));
+        if (merged) {
+            logEvent<LogLevel::Debug>(
+                LogEvent::CommandMerged, command_id, mask, static_cast<int>(pending_commands_->size()));
+        }
+        // the uncommitted commands are released by commitCommandLog()
+        if (!uncommitted) {
+            resumeCommands();
+        }
+    }
+}
+
+
+// Performs relay program instructions until the program has to wait for delay or for relay status. The commands are
+// submitted directly into the command queue. It is called only from the K8090's thread.
+void K8090::executeProgram()
+{
+    if (!program_) {
+        return;
+    }
+    while (const ProgramStep* step = program_->next()) {
+        switch (step->opcode) {
+            case ProgramOpcode::Command:
+                onEnqueueCommand(step->command.id, step->command.mask, step->command.param1, step->command.param2);
+                // sending can fail and disconnect the card which stops the program
+                if (!program_) {
+                    return;
+                }
+                break;
+            case ProgramOpcode::Delay:
+                program_timer_->start(step->argument);
+                return;
+            case ProgramOpcode::WaitRelays:
+                if (!event_cache_->hasRelayStatus() || !program_->isSatisfied(event_cache_->currentRelays())) {
+                    // the program continues from programRelayStatus()
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    finishProgram(true);
+}
+
+
+// Sends the commands held back by the micro-batching window immediately. It is called only from the K8090's thread.
+void K8090::flushCoalescedCommands()
+{
+    {
+        QMutexLocker coalescing_locker{coalescing_mutex_.get()};
+        coalescing_window_->endBurst();
+    }
+    if (coalescing_timer_->isActive()) {
+        coalescing_timer_->stop();
+        dequeueCommand();
+    }
+}
+
+
+// constructs command
+void K8090::sendCommandHelper(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+{
+    // any sent command closes the micro-batching window
+    coalescing_timer_->stop();
+    if (command_id == CommandID::RelayOn) {
+        RelayID allowed = limitInrush(mask);
+        if (allowed == RelayID::None && mask != RelayID::None) {
+            // all the relays are deferred, continue with the next command
+            dequeueCommand();
+            return;
+        }
+        mask = allowed;
+    }
+    writeCommand(command_id, mask, param1, param2);
+}
+
+
+// Writes the command to the card and starts the timers, which control sending of the next command.
+void K8090::writeCommand(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+{
+    impl_::CardMessage cmd{impl_::kStxByte, card_->commands[as_number(command_id)], as_number(mask), param1, param2, 0,
+        impl_::kEtxByte};
+    cmd.checksumMessage();
+    // store current command for response testing. Commands with no response triggers query task after the command
+    // timer elapses, see the dequeuCommand() method.
+    current_command_->id = command_id;
+    current_command_->params[0] = as_number(mask);
+    current_command_->params[1] = param1;
+    current_command_->params[2] = param2;
+    // the query and toggle replies are recognized among the spontaneous relay status events, see relayStatusResponse()
+    status_correlator_->expect(command_id, mask, event_cache_->currentRelays(), event_cache_->hasRelayStatus());
+    // if command can be without response, do not start failure check, next command is sent when the responses for the
+    // command is processed
+    const int command_delay = command_delay_.load(std::memory_order_relaxed);
+    if (hasResponse(command_id)) {
+        failure_timer_->start(failure_delay_.load(std::memory_order_relaxed));
+        if (command_id == CommandID::QueryRelay) {
+            // in the idle mode the delay is timed only if some command waits for it, see resumeCommands()
+            if (!pending_commands_->empty() || !isIdleMode()) {
+                command_timer_->start(command_delay);
+            }
+        } else if (command_id == CommandID::ToggleRelay) {
+            // the delay is the fallback for the reply, which can't be distinguished from a spontaneous relay status,
+            // the confirmed reply stops it
+            command_timer_->start(command_delay);
+        }
+    } else if (command_delay != 0) {
+        // if there is some delay between commands specified and the command hasn't response, start the delay
+        if (command_id == CommandID::ResetFactoryDefaults) {
+            // reset factory defaults execution takes longer
+            command_timer_->start(factory_defaults_command_delay_.load(std::memory_order_relaxed));
+        } else {
+            command_timer_->start(command_delay);
+        }
+    }
+    link_monitor_->commandSent(command_timer_->isActive() ? command_timer_->interval() : 0);
+    sendToSerial(cmd.data.data(), static_cast<int>(cmd.data.size()));
+}
+
+
+// Tests if the next command can be sent now. In the idle mode the delay after the last query can be untimed, so the
+// line is free only after the delay elapses. It doesn't change anything, the callers, which leave the command to
+// dequeueCommand(), call resumeCommands(). It is called only from the K8090's thread.
+bool K8090::isLineFree()
+{
+    if (command_timer_->isActive() || current_command_->id != CommandID::None) {
+        return false;
+    }
+    return !isIdleMode() || commandDelayRemaining() <= 0;
+}
+
+
+// Gets the rest of the command delay after the last sent command in ms, it is negative if the delay elapsed.
+qint64 K8090::commandDelayRemaining()
+{
+    return command_delay_.load(std::memory_order_relaxed) - link_monitor_->elapsedSinceSent();
+}
+
+
+// Arms command_timer_ for the rest of the command delay, dequeueCommand() then sends the next command.
+void K8090::scheduleNextCommand(qint64 remaining)
+{
+    command_timer_->start(static_cast<int>(std::max(remaining, qint64{0})));
+}
+
+
+// Continues sending of the commands and pulse edges, which are waiting while the line is not busy and command_timer_
+// is not armed. It happens in the idle mode, where the delay after the query is timed only if some command waits for
+// it. It is called only from the K8090's thread.
+void K8090::resumeCommands()
+{
+    if (command_timer_->isActive() || current_command_->id != CommandID::None) {
+        return;
+    }
+    if (pending_commands_->empty() && precise_pulse_->pendingEdge() == CommandID::None) {
+        return;
+    }
+    scheduleNextCommand(commandDelayRemaining());
+}
+
+
+// Grants closing of relays by the inrush limiter. Relays, which are already switched on, are not limited. Relays, which
+// can't be closed now, are deferred until the limiter allows them, see releaseDeferredRelays(). It is called only from
+// the K8090's thread.
+RelayID K8090::limitInrush(RelayID mask)
+{
+    QMutexLocker inrush_locker{inrush_mutex_.get()};
+    if (!inrush_limiter_) {
+        return mask;
+    }
+    RelayID closing = mask & ~event_cache_->currentRelays();
+    int count = 0;
+    for (unsigned int i = 0; i < card_->relay_count; ++i) {
+        if ((closing & from_number(i)) != RelayID::None) {
+            ++count;
+        }
+    }
+    const qint64 now = InrushLimiter::now();
+    int granted = inrush_limiter_->reserve(count, now);
+    RelayID allowed = mask & ~closing;
+    for (unsigned int i = 0; i < card_->relay_count && granted > 0; ++i) {
+        if ((closing & from_number(i)) != RelayID::None) {
+            allowed |= from_number(i);
+            --granted;
+        }
+    }
+    RelayID deferred = closing & ~allowed;
+    if (deferred != RelayID::None) {
+        inrush_deferred_ |= deferred;
+        inrush_timer_->start(static_cast<int>(std::max(inrush_limiter_->nextAvailable(now) - now, qint64{0})));
+    }
+    return allowed;
+}
+
+
+// Passes the relays of switching command, which are not deferred by the dwell filter. It is called only from the
+// K8090's thread.
+RelayID K8090::filterDwell(CommandID command_id, RelayID mask)
+{
+    QMutexLocker dwell_locker{dwell_mutex_.get()};
+    if (!dwell_filter_->enabled() && dwell_filter_->deferred() == RelayID::None) {
+        return mask;
+    }
+    const qint64 now = impl_::DwellFilter::now();
+    RelayID passed = mask;
+    if (command_id == CommandID::ToggleRelay) {
+        dwell_filter_->toggle(mask, now);
+    } else {
+        passed = dwell_filter_->filter(command_id == CommandID::RelayOn, mask, now);
     }
+    link_monitor_->setDwellStatistics(dwell_filter_->suppressedTransitions(), dwell_filter_->savedCommands());
+    scheduleDwellRelease(now);
+    return passed;
 }
 
 
-void K8090::onCommandFailed()
+// Arms the dwell timer for the earliest deferred relay. It is called with the dwell mutex locked.
+void K8090::scheduleDwellRelease(qint64 now)
 {
-    failure_timer_->stop();
-    ++failure_counter_;
-    if (failure_counter_ > (QMutexLocker{failure_max_count_mutex_.get()}, failure_max_count_)) {
-        onDoDisconnect(true);
+    qint64 next = dwell_filter_->nextRelease();
+    if (next < 0) {
+        dwell_timer_->stop();
+    } else {
+        dwell_timer_->start(static_cast<int>(std::max(next - now, qint64{0})));
     }
 }
 
 
-// This method should be called to do all the stuff needed to disconnect from the relay card
-// Stops timer, so it should be run in the K8090's thread. It is achieved by calling this method through signal slots
-// mechanism
-void K8090::onDoDisconnect(bool failure)
+// Starts the pulse reserved by pulseRelay() and sends its on edge, if the line is free, otherwise dequeueCommand()
+// sends it. It is called only from the K8090's thread, which owns the pulse, so the pulse is not locked.
+void K8090::startPulse(RelayID relays, int width_msec)
 {
-    QMutexLocker connected_locker{connected_mutex_.get()};
-    if (connected_ || connecting_) {
-        serial_port_->close();
-        // erase all pending commands
-        pending_commands_.reset(new impl_::ConcurentCommandQueue);
-        // stop failure timers and erase failure counter
-        command_timer_->stop();
-        failure_timer_->stop();
-        failure_counter_ = 0;
+    // the card could be disconnected before the pulse was started
+    if (!connection_state_->isConnected()) {
+        resetPulse();
+        return;
+    }
+    // the pulse queued before a reconnection can be started first, it holds the reservation then
+    if (!precise_pulse_->start(relays, width_msec)) {
+        return;
+    }
+    if (isLineFree()) {
+        sendPulseEdge();
+    } else {
+        resumeCommands();
+    }
+}
 
-        connected_ = false;
-        connecting_ = false;
 
-        connected_locker.unlock();
+// Sends the off edge of the pulse, if the line is free, otherwise dequeueCommand() sends it. It is called by
+// pulse_timer_.
+void K8090::pulseOffDue()
+{
+    precise_pulse_->offDue();
+    if (isLineFree()) {
+        sendPulseEdge();
+    } else {
+        resumeCommands();
+    }
+}
 
-        if (failure) {
-            emit connectionFailed();
-        } else {
-            emit disconnected();
-        }
+
+// Connects or disconnects the wakeup counting to the event dispatcher of the K8090's thread. It is invoked by
+// setWakeupMeasurement() in the K8090's thread, because the dispatcher is created with the running event loop.
+void K8090::measureWakeups()
+{
+    QObject::disconnect(wakeup_connection_);
+    QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+    if (isWakeupMeasurementEnabled() && dispatcher != nullptr) {
+        impl_::LinkMonitor* link_monitor = link_monitor_.get();
+        wakeup_connection_ =
+            connect(dispatcher, &QAbstractEventDispatcher::awake, this, [link_monitor]() { link_monitor->wakeup(); });
     }
 }
 
 
-// general top level method which sends commands to card. It controlls, if the card is connected and then uses
-// enqueuCommand().
-void K8090::sendCommand(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+// Cancels the started pulse and releases the reservation made by pulseRelay().
+void K8090::resetPulse()
 {
-    if (QMutexLocker{connected_mutex_.get()}, !connected_) {
-        emit notConnected();
-        return;
+    precise_pulse_->reset();
+    pulse_reserved_ = false;
+}
+
+
+// Sends the pending pulse edge. The edges bypass the dwell filter and the inrush limiter, which would stretch the
+// pulse. It is called only from the K8090's thread, when the line is free.
+bool K8090::sendPulseEdge()
+{
+    CommandID edge = precise_pulse_->pendingEdge();
+    if (edge == CommandID::None) {
+        return false;
     }
-    emit enqueueCommand(command_id, mask, param1, param2);
+    RelayID relays = precise_pulse_->relays();
+    precise_pulse_->edgeSent(impl_::PrecisePulse::now());
+    link_monitor_->commandEnqueued(false, static_cast<int>(pending_commands_->size()));
+    // the edge closes the micro-batching window as any other sent command
+    coalescing_timer_->stop();
+    writeCommand(edge, relays, 0, 0);
+    return true;
 }
 
 
-// Each command is sended through this method. It controlls if the command can be sended directly or enqueued for
-// delayed sending, because the virtual serial port interface of the card doesn't accept commands which are sended with
-// too small delay in between them.
-// This method must be used from the K8090's thread, so invoke it by emitting enqueCommand signal through lambda
-// expression - see connections in the constructor.
-void K8090::onEnqueueCommand(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+// Confirms the pulse edges by the relay status, schedules the off edge and reports the finished pulse. It is called
+// only from the K8090's thread.
+void K8090::pulseRelayStatus(RelayID current)
 {
-    // Send command directly if it is sufficiently delayed from the previous one and there are no commands pending.
-    if ((!command_timer_->isActive()) && current_command_->id == CommandID::None && pending_commands_->empty()) {
-        sendCommandHelper(command_id, mask, param1, param2);
-    } else {  // send command undirectly
-        pending_commands_->updateOrPush(command_id, mask, param1, param2);
+    if (!precise_pulse_->isActive()) {
+        return;
+    }
+    qint64 delay = precise_pulse_->relayStatus(current, impl_::PrecisePulse::now());
+    if (delay >= 0) {
+        // the timer has ms resolution, so the delay is rounded
+        pulse_timer_->start(static_cast<int>((delay + 500) / 1000));
+    } else if (precise_pulse_->phase() == impl_::PulsePhase::Finished) {
+        RelayID relays = precise_pulse_->relays();
+        int width = static_cast<int>(precise_pulse_->achievedWidth());
+        int error = static_cast<int>(precise_pulse_->widthError());
+        resetPulse();
+        emit pulseFinished(relays, width, error);
     }
 }
 
 
-// constructs command
-void K8090::sendCommandHelper(CommandID command_id, RelayID mask, unsigned char param1, unsigned char param2)
+// helper method distinguishing commands, the bursts of which are merged by the micro-batching window
+bool K8090::isCoalesced(CommandID command_id)
 {
-    const int n = 7;  // Number of command bytes.
-    std::unique_ptr<unsigned char[]> cmd{new unsigned char[n]};
-    cmd[0] = impl_::kStxByte;
-    cmd[1] = impl_::kCommands[as_number(command_id)];
-    cmd[2] = as_number(mask);
-    cmd[3] = param1;
-    cmd[4] = param2;
-    cmd[5] = impl_::check_sum(cmd.get(), 5);
-    cmd[6] = impl_::kEtxByte;
-    // store current command for response testing. Commands with no response triggers query task after the command
-    // timer elapses, see the dequeuCommand() method.
-    current_command_->id = command_id;
-    current_command_->params[0] = as_number(mask);
-    current_command_->params[1] = param1;
-    current_command_->params[2] = param2;
-    // if command can be without response, do not start failure check, next command is sent when the responses for the
-    // command is processed
-    if (hasResponse(command_id)) {
-        failure_timer_->start((QMutexLocker{failure_delay_mutex_.get()}, failure_delay_));
-        if (command_id == CommandID::QueryRelay) {
-            command_timer_->start((QMutexLocker{command_delay_mutex_.get()}, command_delay_));
-        } else if (command_id == CommandID::ToggleRelay) {
-            // relay status can be response to many situations so it is better to not rely on right response and rather
-            // send the next command after command delays
-            command_timer_->start((QMutexLocker{command_delay_mutex_.get()}, command_delay_));
-        }
-    } else if (QMutexLocker{command_delay_mutex_.get()}, command_delay_ != 0) {
-        // if there is some delay between commands specified and the command hasn't response, start the delay
-        if (command_id == CommandID::ResetFactoryDefaults) {
-            // reset factory defaults execution takes longer
-            command_timer_->start((QMutexLocker{command_delay_mutex_.get()}, factory_defaults_command_delay_));
-        } else {
-            command_timer_->start((QMutexLocker{command_delay_mutex_.get()}, command_delay_));
-        }
+    switch (command_id) {
+        case CommandID::RelayOn:
+        case CommandID::RelayOff:
+        case CommandID::ToggleRelay:
+        case CommandID::SetButtonMode:
+        case CommandID::StartTimer:
+        case CommandID::SetTimer:
+            return true;
+        default:
+            return false;
     }
-    sendToSerial(std::move(cmd), n);
 }
 
 
@@ -954,8 +2314,10 @@ bool K8090::hasResponse(CommandID command_id)
 }
 
 
-// sends command to serial port
-void K8090::sendToSerial(std::unique_ptr<unsigned char[]> buffer, int n)
+// Sends command to serial port. The command, which was not written completely, is not answered by the card, so it is
+// failed. The failure is handled by failure_timer_ in the next event loop iteration, so it doesn't reenter the command
+// sending. It is called only from the K8090's thread.
+void K8090::sendToSerial(const unsigned char* buffer, int n)
 {
     if (!serial_port_->isOpen()) {
         if (!serial_port_->open(QIODevice::ReadWrite)) {
@@ -964,46 +2326,48 @@ void K8090::sendToSerial(std::unique_ptr<unsigned char[]> buffer, int n)
         }
     }
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    serial_port_->write(reinterpret_cast<char*>(buffer.get()), n);
+    qint64 written = serial_port_->write(reinterpret_cast<const char*>(buffer), n);
     serial_port_->flush();
+    if (written != n) {
+        failure_timer_->start(0);
+    }
 }
 
 
 // processes button mode response
-void K8090::buttonModeResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::buttonModeResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
     // button mode was not requested
     if (current_command_->id != CommandID::ButtonMode) {
+        logEvent<LogLevel::Warning>(LogEvent::UnexpectedResponse, current_command_->id,
+            static_cast<RelayID>(response.data[2]), as_number(ResponseID::ButtonMode));
         onCommandFailed();
         return;
     }
     // query button mode has no parameters. It is satisfactory only to remove one button mode request from the list
     current_command_->id = CommandID::None;
     failure_timer_->stop();
-    if (QMutexLocker{connected_mutex_.get()}, connected_) {
-        emit buttonModes(static_cast<RelayID>(response->data[2]), static_cast<RelayID>(response->data[3]),
-            static_cast<RelayID>(response->data[4]));
-        dequeueCommand();
-    } else if (QMutexLocker{connected_mutex_.get()}, connecting_) {
-        emit buttonModes(static_cast<RelayID>(response->data[2]), static_cast<RelayID>(response->data[3]),
-            static_cast<RelayID>(response->data[4]));
-        if (pending_commands_->empty()) {
-            connectionSuccessful();
-        } else {
-            dequeueCommand();
-        }
-    } else {
+    if (action == impl_::ResponseAction::Fail) {
         // TODO(lumik): this should not occur. Convert it to exception.
+        logEvent<LogLevel::Error>(LogEvent::ProtocolError, CommandID::ButtonMode, RelayID::None,
+            as_number(ResponseID::ButtonMode));
         onCommandFailed();
+        return;
     }
+    emit buttonModes(static_cast<RelayID>(response.data[2]), static_cast<RelayID>(response.data[3]),
+        static_cast<RelayID>(response.data[4]));
+    refresh_flight_->partReceived(kRefreshButtonModes);
+    continueAfterResponse(action);
 }
 
 
 // processes timer response
-void K8090::timerResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::timerResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
     // timer was not requested
     if (current_command_->id != CommandID::Timer) {
+        logEvent<LogLevel::Warning>(LogEvent::UnexpectedResponse, current_command_->id,
+            static_cast<RelayID>(response.data[2]), as_number(ResponseID::Timer));
         onCommandFailed();
         return;
     }
@@ -1013,7 +2377,7 @@ void K8090::timerResponse(std::unique_ptr<impl_::CardMessage> response)
     if ((static_cast<unsigned char>(~(current_command_->params[1])) & (1u << 0u)) != 0u) {
         // remove current response from the list of waiting to response commands.
         is_total = true;
-        current_command_->params[0] &= static_cast<unsigned char>(~response->data[2]);
+        current_command_->params[0] &= static_cast<unsigned char>(~response.data[2]);
         if (current_command_->params[0] == 0u) {
             current_command_->id = CommandID::None;
             failure_timer_->stop();
@@ -1023,7 +2387,7 @@ void K8090::timerResponse(std::unique_ptr<impl_::CardMessage> response)
         }
     } else {
         is_total = false;
-        current_command_->params[0] &= static_cast<unsigned char>(~response->data[2]);
+        current_command_->params[0] &= static_cast<unsigned char>(~response.data[2]);
         if (current_command_->params[0] == 0u) {
             current_command_->id = CommandID::None;
             failure_timer_->stop();
@@ -1032,32 +2396,41 @@ void K8090::timerResponse(std::unique_ptr<impl_::CardMessage> response)
             failure_timer_->start();
         }
     }
-    if (QMutexLocker{connected_mutex_.get()}, (connected_ || connecting_)) {
-        if (is_total) {
-            emit totalTimerDelay(static_cast<RelayID>(response->data[2]),
-                static_cast<quint16>(response->data[3] << 8u) | response->data[4]);
-        } else {
-            emit remainingTimerDelay(static_cast<RelayID>(response->data[2]),
-                static_cast<quint16>(response->data[3] << 8u) | response->data[4]);
-        }
-        if ((QMutexLocker{connected_mutex_.get()}, connecting_) && pending_commands_->empty()) {
-            connectionSuccessful();
-        } else if (should_dequeue_next) {
-            dequeueCommand();
-        }
-    } else {
+    if (action == impl_::ResponseAction::Fail) {
         // TODO(lumik): this should not occur, convert it to exception.
+        logEvent<LogLevel::Error>(LogEvent::ProtocolError, CommandID::Timer, RelayID::None,
+            as_number(ResponseID::Timer));
         onCommandFailed();
+        return;
+    }
+    auto relays = static_cast<RelayID>(response.data[2]);
+    auto delay = static_cast<quint16>(static_cast<quint16>(response.data[3] << 8u) | response.data[4]);
+    if (is_total) {
+        emit totalTimerDelay(relays, delay);
+        dispatchTimerDelay(impl_::TimerDelayType::Total, relays, delay);
+    } else {
+        emit remainingTimerDelay(relays, delay);
+        dispatchTimerDelay(impl_::TimerDelayType::Remaining, relays, delay);
+    }
+    if (should_dequeue_next) {
+        refresh_flight_->partReceived(is_total ? kRefreshTotalTimer : kRefreshRemainingTimer);
+    }
+    if (action == impl_::ResponseAction::Handshake && pending_commands_->empty()) {
+        connectionSuccessful();
+    } else if (should_dequeue_next) {
+        dequeueCommand();
     }
 }
 
 
 // processes button status response
-void K8090::buttonStatusResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::buttonStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
-    if (QMutexLocker{connected_mutex_.get()}, connected_) {
-        emit buttonStatus(static_cast<RelayID>(response->data[2]), static_cast<RelayID>(response->data[3]),
-            static_cast<RelayID>(response->data[4]));
+    if (action == impl_::ResponseAction::Deliver) {
+        emit buttonStatus(static_cast<RelayID>(response.data[2]), static_cast<RelayID>(response.data[3]),
+            static_cast<RelayID>(response.data[4]));
+        dispatchButtonStatus(static_cast<RelayID>(response.data[2]), static_cast<RelayID>(response.data[3]),
+            static_cast<RelayID>(response.data[4]));
     }
     // button status is emited only after user interaction with physical buttons on the relay, no query command is
     // connected with it
@@ -1065,18 +2438,25 @@ void K8090::buttonStatusResponse(std::unique_ptr<impl_::CardMessage> response)
 
 
 // processes relay status response
-void K8090::relayStatusResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::relayStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
+    auto previous = static_cast<RelayID>(response.data[2]);
+    auto current = static_cast<RelayID>(response.data[3]);
     // relay status can be a response to many commands. If status changes by the command, it is not necessary to query
+    bool confirmed = false;
+    // only the reply to the query is the fresh relay status awaited by the refresh, not a button press or timer expiry
+    bool queried = false;
     if (current_command_->id == CommandID::QueryRelay) {
-        current_command_->id = CommandID::None;
-        failure_timer_->stop();
+        impl_::StatusOrigin origin =
+            status_correlator_->classify(current_command_->id, previous, current, link_monitor_->elapsedSinceSent());
+        queried = origin != impl_::StatusOrigin::Unsolicited;
+        confirmed = completeStatusReply(origin);
     } else if (current_command_->id == CommandID::RelayOn) {
         // switch relay on
         // test if all required relays are on:
         bool match = true;
-        for (unsigned int i = 0; i < 8; ++i) {
-            if ((current_command_->params[0] & (1u << i) & static_cast<unsigned char>(~response->data[3])) != 0u) {
+        for (unsigned int i = 0; i < card_->relay_count; ++i) {
+            if ((current_command_->params[0] & (1u << i) & static_cast<unsigned char>(~response.data[3])) != 0u) {
                 match = false;
             }
         }
@@ -1090,8 +2470,8 @@ void K8090::relayStatusResponse(std::unique_ptr<impl_::CardMessage> response)
         // switch relay off
         // test if all required relays are off:
         bool match = true;
-        for (unsigned int i = 0; i < 8; ++i) {
-            if ((current_command_->params[0] & (1u << i) & response->data[3]) != 0u) {
+        for (unsigned int i = 0; i < card_->relay_count; ++i) {
+            if ((current_command_->params[0] & (1u << i) & response.data[3]) != 0u) {
                 match = false;
             }
         }
@@ -1102,14 +2482,13 @@ void K8090::relayStatusResponse(std::unique_ptr<impl_::CardMessage> response)
         // or user interaction directly with the card
         failure_timer_->stop();
     } else if (current_command_->id == CommandID::ToggleRelay) {
-        // TODO(lumik): consider the toggle relay testing
-        current_command_->id = CommandID::None;
-        failure_timer_->stop();
+        confirmed = completeStatusReply(status_correlator_->classify(
+            current_command_->id, previous, current, link_monitor_->elapsedSinceSent()));
     } else if (current_command_->id == CommandID::StartTimer) {
         // test if all required relays are on:
         bool match = true;
-        for (unsigned int i = 0; i < 8; ++i) {
-            if ((current_command_->params[0] & (1u << i) & static_cast<unsigned char>(~response->data[3])) != 0u) {
+        for (unsigned int i = 0; i < card_->relay_count; ++i) {
+            if ((current_command_->params[0] & (1u << i) & static_cast<unsigned char>(~response.data[3])) != 0u) {
                 match = false;
             }
         }
@@ -1122,7 +2501,7 @@ void K8090::relayStatusResponse(std::unique_ptr<impl_::CardMessage> response)
     } else if (current_command_->id == CommandID::ResetFactoryDefaults) {
         // test if all required relays are off:
         bool match = true;
-        if (response->data[3] != 0u) {
+        if (response.data[3] != 0u) {
             match = false;
         }
         if (match) {
@@ -1132,72 +2511,114 @@ void K8090::relayStatusResponse(std::unique_ptr<impl_::CardMessage> response)
         // or user interaction directly with the card
         failure_timer_->stop();
     }
-    if (QMutexLocker{connected_mutex_.get()}, connected_) {
-        emit relayStatus(static_cast<RelayID>(response->data[2]), static_cast<RelayID>(response->data[3]),
-            static_cast<RelayID>(response->data[4]));
-    } else if (QMutexLocker{connected_mutex_.get()}, connecting_) {
-        // Beware, if the relay status message is obtained from the card as the reaction to the user interaction with
-        // physical buttons, the relay status signal can be emited 2 times because of the message obtained as the
-        // reaction to query message.
-        emit relayStatus(static_cast<RelayID>(response->data[2]), static_cast<RelayID>(response->data[3]),
-            static_cast<RelayID>(response->data[4]));
-        if (pending_commands_->empty()) {
-            connectionSuccessful();
+    if (action == impl_::ResponseAction::Ignore) {
+        if (confirmed) {
+            resumeCommands();
         }
+        return;
+    }
+    // The spontaneous relay status is delivered as well, but it doesn't complete the awaited query, see
+    // StatusCorrelator. The relay status signal is then emitted for the event and for the reply, the subscriptions
+    // receive only the changes.
+    emit relayStatus(previous, current, static_cast<RelayID>(response.data[4]));
+    updateRelayWear(current);
+    pulseRelayStatus(current);
+    dispatchRelayStatus(previous, current, static_cast<RelayID>(response.data[4]));
+    if (queried) {
+        refresh_flight_->partReceived(kRefreshRelayStatus);
+    }
+    if (action == impl_::ResponseAction::Deliver) {
+        programRelayStatus(current);
+    } else if (pending_commands_->empty()) {
+        connectionSuccessful();
+    }
+    // the confirmed reply releases the next command at once, unless the handlers above have already sent one. The
+    // ambiguous relay status leaves the next command sending to the command delay, see sendCommandHelper().
+    if (confirmed && !command_timer_->isActive() && current_command_->id == CommandID::None) {
+        dequeueCommand();
+    }
+}
+
+
+// Completes the awaited query or toggle according to the origin of the relay status frame. The unsolicited frame
+// leaves the command awaited, the failure and command timers still guard it. The ambiguous frame completes the command
+// but the next one waits for the command delay. The confirmed reply stops the command delay and returns true, the
+// caller then sends the next command at once. It is called only from the K8090's thread.
+bool K8090::completeStatusReply(impl_::StatusOrigin origin)
+{
+    if (origin == impl_::StatusOrigin::Unsolicited) {
+        link_monitor_->unsolicitedStatus();
+        return false;
+    }
+    current_command_->id = CommandID::None;
+    status_correlator_->clear();
+    failure_timer_->stop();
+    if (origin == impl_::StatusOrigin::Reply) {
+        command_timer_->stop();
+        link_monitor_->replyConfirmed();
+        return true;
     }
-    // relay status can be also emited in reaction to on, off, toggle, start timer commands or physical button press,
-    // so it is better to leave the next command sending to timer. So it is treated in sendCommandHelper() method.
+    resumeCommands();
+    return false;
 }
 
 
 // processes jumper status response
-void K8090::jumperStatusResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::jumperStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
     if (current_command_->id != CommandID::JumperStatus) {
+        logEvent<LogLevel::Warning>(LogEvent::UnexpectedResponse, current_command_->id, RelayID::None,
+            as_number(ResponseID::JumperStatus));
         onCommandFailed();
         return;
     }
     current_command_->id = CommandID::None;
     failure_timer_->stop();
-    if (QMutexLocker{connected_mutex_.get()}, connected_) {
-        emit jumperStatus(static_cast<bool>(response->data[3]));
-        dequeueCommand();
-    } else if (QMutexLocker{connected_mutex_.get()}, connecting_) {
-        emit jumperStatus(static_cast<bool>(response->data[3]));
-        if (pending_commands_->empty()) {
-            connectionSuccessful();
-        } else {
-            dequeueCommand();
-        }
-    } else {
+    if (action == impl_::ResponseAction::Fail) {
         // TODO(lumik): this should not occur, convert it to exception.
+        logEvent<LogLevel::Error>(LogEvent::ProtocolError, CommandID::JumperStatus, RelayID::None,
+            as_number(ResponseID::JumperStatus));
         onCommandFailed();
+        return;
     }
+    emit jumperStatus(static_cast<bool>(response.data[3]));
+    refresh_flight_->partReceived(kRefreshJumperStatus);
+    continueAfterResponse(action);
 }
 
 
 // processes firmware version response
-void K8090::firmwareVersionResponse(std::unique_ptr<impl_::CardMessage> response)
+void K8090::firmwareVersionResponse(const impl_::CardMessage& response, impl_::ResponseAction action)
 {
     if (current_command_->id != CommandID::FirmwareVersion) {
+        logEvent<LogLevel::Warning>(LogEvent::UnexpectedResponse, current_command_->id, RelayID::None,
+            as_number(ResponseID::FirmwareVersion));
         onCommandFailed();
         return;
     }
     current_command_->id = CommandID::None;
     failure_timer_->stop();
-    if (QMutexLocker{connected_mutex_.get()}, connected_) {
-        emit firmwareVersion(2000 + static_cast<int>(response->data[3]), static_cast<int>(response->data[4]));
-        dequeueCommand();
-    } else if (QMutexLocker{connected_mutex_.get()}, connecting_) {
-        emit firmwareVersion(2000 + static_cast<int>(response->data[3]), static_cast<int>(response->data[4]));
-        if (pending_commands_->empty()) {
-            connectionSuccessful();
-        } else {
-            dequeueCommand();
-        }
-    } else {
+    if (action == impl_::ResponseAction::Fail) {
         // TODO(lumik): this should not occur, convert it to exception.
+        logEvent<LogLevel::Error>(LogEvent::ProtocolError, CommandID::FirmwareVersion, RelayID::None,
+            as_number(ResponseID::FirmwareVersion));
         onCommandFailed();
+        return;
+    }
+    emit firmwareVersion(2000 + static_cast<int>(response.data[3]), static_cast<int>(response.data[4]));
+    refresh_flight_->partReceived(kRefreshFirmwareVersion);
+    continueAfterResponse(action);
+}
+
+
+// Sends the next command after the query response or completes the connection, if the response is the last answer to
+// the initial queries.
+void K8090::continueAfterResponse(impl_::ResponseAction action)
+{
+    if (action == impl_::ResponseAction::Handshake && pending_commands_->empty()) {
+        connectionSuccessful();
+    } else {
+        dequeueCommand();
     }
 }
 
@@ -1206,12 +2627,251 @@ void K8090::firmwareVersionResponse(std::unique_ptr<impl_::CardMessage> response
 // that.
 void K8090::connectionSuccessful()
 {
-    {
-        QMutexLocker connected_locker{connected_mutex_.get()};
-        connecting_ = false;
-        connected_ = true;
+    if (!connection_state_->transition(impl_::ConnectionEvent::Establish)) {
+        return;
     }
+    logEvent<LogLevel::Info>(LogEvent::Connected);
     emit connected();
+    replayCommandLog();
+}
+
+
+// Replaces the running relay program by a new one. It is called only from the K8090's thread.
+void K8090::startProgram(const std::vector<ProgramStep>& steps)
+{
+    finishProgram(false);
+    // the card could be disconnected before the program was started
+    if (!connection_state_->isConnected()) {
+        emit programFinished(false);
+        return;
+    }
+    program_.reset(new impl_::ProgramInterpreter{steps});
+    executeProgram();
+}
+
+
+// Releases the running relay program and notifies about its end.
+void K8090::finishProgram(bool completed)
+{
+    if (!program_) {
+        return;
+    }
+    program_timer_->stop();
+    program_.reset();
+    emit programFinished(completed);
+}
+
+
+// Continues the relay program which waits for the relay status.
+void K8090::programRelayStatus(RelayID current)
+{
+    if (program_ && program_->isSatisfied(current)) {
+        executeProgram();
+    }
+}
+
+
+// Logs the event to the logger set by K8090::setLogger(). The calls with the level below SPRELAY_LOG_LEVEL are removed
+// by the compiler, so the debug records cost nothing in the default build. The logger is read without locking, so it
+// is called only from the K8090's thread.
+template<LogLevel level>
+void K8090::logEvent(LogEvent event, CommandID command, RelayID relays, int value)
+{
+    if (!Logger::isCompiledIn(level)) {
+        return;
+    }
+    Logger* logger = thread_logger_.get();
+    if (logger != nullptr && logger->isEnabled(level)) {
+        logger->log(level, event, command, relays, value);
+    }
+}
+
+
+// Updates the event cache and delivers relay status to matching subscriptions. The event cache is owned by the
+// K8090's thread and it is updated without locking. The subscriptions are collected by impl_::SubscriptionList, which
+// doesn't lock at all when there is no subscription, and the signals are emitted after its lock is released, so the
+// subscribers connected by direct connection can call K8090 from their slots.
+void K8090::dispatchRelayStatus(RelayID previous, RelayID current, RelayID timed)
+{
+    RelayID changed = event_cache_->updateRelayStatus(previous, current, timed);
+    std::vector<EventSubscription*> targets;
+    if (!subscriptions_->beginDispatch(EventType::RelayStatus, changed, &targets)) {
+        return;
+    }
+    for (EventSubscription* subscription : targets) {
+        if (subscription->active_) {
+            emit subscription->relayStatus(previous, current, timed);
+        }
+    }
+    subscriptions_->endDispatch(&targets);
+}
+
+
+// Updates the event cache and delivers button status to matching subscriptions.
+void K8090::dispatchButtonStatus(RelayID state, RelayID pressed, RelayID released)
+{
+    RelayID changed = event_cache_->updateButtonStatus(state, pressed, released);
+    std::vector<EventSubscription*> targets;
+    if (!subscriptions_->beginDispatch(EventType::ButtonStatus, changed, &targets)) {
+        return;
+    }
+    for (EventSubscription* subscription : targets) {
+        if (subscription->active_) {
+            emit subscription->buttonStatus(state, pressed, released);
+        }
+    }
+    subscriptions_->endDispatch(&targets);
+}
+
+
+// Updates the event cache and delivers timer delay to matching subscriptions.
+void K8090::dispatchTimerDelay(impl_::TimerDelayType type, RelayID relays, quint16 delay)
+{
+    const bool is_total = type == impl_::TimerDelayType::Total;
+    RelayID changed = event_cache_->updateTimerDelay(type, relays, delay);
+    const EventType event = is_total ? EventType::TotalTimerDelay : EventType::RemainingTimerDelay;
+    std::vector<EventSubscription*> targets;
+    if (!subscriptions_->beginDispatch(event, changed, &targets)) {
+        return;
+    }
+    for (EventSubscription* subscription : targets) {
+        if (!subscription->active_) {
+            continue;
+        }
+        if (is_total) {
+            emit subscription->totalTimerDelay(relays, delay);
+        } else {
+            emit subscription->remainingTimerDelay(relays, delay);
+        }
+    }
+    subscriptions_->endDispatch(&targets);
+}
+
+
+// Replays the last known values to a new subscription. It is invoked from the K8090's thread, which owns the event
+// cache, so the replayed values are emitted in order with the dispatched events. The subscription is not released
+// until the values are emitted.
+void K8090::replayEvents(EventSubscription* subscription)
+{
+    if (!subscriptions_->beginReplay(subscription)) {
+        return;
+    }
+
+    const impl_::EventCache cache = *event_cache_;
+    if ((subscription->events_ & EventType::RelayStatus) != EventType::None && cache.hasRelayStatus()) {
+        emit subscription->relayStatus(cache.currentRelays(), cache.currentRelays(), cache.timedRelays());
+    }
+    if ((subscription->events_ & EventType::ButtonStatus) != EventType::None && cache.hasButtonStatus()) {
+        emit subscription->buttonStatus(cache.buttonState(), RelayID::None, RelayID::None);
+    }
+    const bool replay_total = (subscription->events_ & EventType::TotalTimerDelay) != EventType::None;
+    const bool replay_remaining = (subscription->events_ & EventType::RemainingTimerDelay) != EventType::None;
+    for (unsigned int i = 0; i < card_->relay_count; ++i) {
+        RelayID relay = from_number(i);
+        if ((subscription->relays_ & relay) == RelayID::None) {
+            continue;
+        }
+        if (replay_total && (cache.knownTimerDelays(impl_::TimerDelayType::Total) & relay) != RelayID::None) {
+            emit subscription->totalTimerDelay(relay, cache.timerDelay(impl_::TimerDelayType::Total, i));
+        }
+        if (replay_remaining && (cache.knownTimerDelays(impl_::TimerDelayType::Remaining) & relay) != RelayID::None) {
+            emit subscription->remainingTimerDelay(relay, cache.timerDelay(impl_::TimerDelayType::Remaining, i));
+        }
+    }
+
+    subscriptions_->endReplay();
+}
+
+
+// Appends the checkpoint, which acknowledges the logged commands, when all of them are sent and the card is idle. It
+// is called only from the K8090's thread and it doesn't lock anything, when the command log is not set.
+void K8090::checkpointCommandLog()
+{
+    if (!command_log_active_) {
+        return;
+    }
+    {
+        // the deferred relays are not switched on yet
+        QMutexLocker inrush_locker{inrush_mutex_.get()};
+        if (inrush_deferred_ != RelayID::None) {
+            return;
+        }
+    }
+    QMutexLocker command_log_locker{command_log_mutex_.get()};
+    if (!command_log_file_ || !command_log_->hasUnacknowledgedCommands()) {
+        return;
+    }
+    command_log_->checkpoint(event_cache_->hasRelayStatus(), event_cache_->currentRelays());
+    if (!command_log_timer_->isActive()) {
+        command_log_timer_->start(command_log_commit_delay_);
+    }
+}
+
+
+// Writes the records collected since the last commit to the command log file and synchronizes it.
+void K8090::writeCommandLog()
+{
+    if (!command_log_active_) {
+        return;
+    }
+    QMutexLocker command_log_locker{command_log_mutex_.get()};
+    if (!command_log_file_ || !command_log_->hasPendingRecords()) {
+        return;
+    }
+    bool truncate = false;
+    QByteArray records = command_log_->takePendingRecords(&truncate);
+    QElapsedTimer commit_timer;
+    commit_timer.start();
+    bool committed = impl_::CommandLog::commit(command_log_file_.get(), records, truncate);
+    command_log_statistics_.commit_time += commit_timer.nsecsElapsed();
+    ++command_log_statistics_.commits;
+    if (!committed) {
+        ++command_log_statistics_.failed_commits;
+    }
+}
+
+
+// Updates relay wear statistics from the relay status and schedules their storing. The statistics are owned by the
+// K8090's thread, the lock is taken only to publish the snapshot when a relay transition is counted, the repeated
+// status is processed by plain integer arithmetic.
+void K8090::updateRelayWear(RelayID current)
+{
+    if (wear_accounting_->update(current, impl_::WearAccounting::now())) {
+        publishRelayWear();
+    }
+}
+
+
+// Publishes the snapshot of relay wear statistics read by relayWear() and arms the storing of the changed statistics.
+// It is called only from the K8090's thread.
+void K8090::publishRelayWear()
+{
+    QMutexLocker wear_locker{wear_mutex_.get()};
+    *wear_snapshot_ = *wear_accounting_;
+    if (wear_accounting_->isDirty() && !wear_file_name_.isEmpty() && !wear_timer_->isActive()) {
+        wear_timer_->start(wear_save_interval_);
+    }
+}
+
+
+// Loads the relay wear statistics read by setRelayWearFile() to the statistics owned by the K8090's thread.
+void K8090::loadRelayWear()
+{
+    QMutexLocker wear_locker{wear_mutex_.get()};
+    QByteArray data;
+    data.swap(wear_loaded_);
+    wear_locker.unlock();
+    if (!data.isEmpty() && wear_accounting_->deserialize(data)) {
+        publishRelayWear();
+    }
+}
+
+
+// Copies the logger set by setLogger() to the logger used in the K8090's thread.
+void K8090::applyLogger()
+{
+    QMutexLocker logger_locker{logger_mutex_.get()};
+    thread_logger_ = logger_;
 }
 
 }  // namespace k8090
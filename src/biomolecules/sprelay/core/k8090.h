@@ -38,18 +38,27 @@
 #ifndef BIOMOLECULES_SPRELAY_CORE_K8090_H_
 #define BIOMOLECULES_SPRELAY_CORE_K8090_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <queue>
+#include <utility>
+#include <vector>
 
 #include <QList>
 #include <QObject>
 
 #include "biomolecules/sprelay/sprelay_global.h"
 
+#include "event_subscription.h"
 #include "k8090_defines.h"
+#include "mock_scenario.h"
+#include "relay_program.h"
 #include "serial_port_defines.h"
 
 // forward declarations
+class QElapsedTimer;
+class QFile;
 class QMutex;
 class QTimer;
 
@@ -62,23 +71,75 @@ class UnifiedSerialPort;
 
 namespace k8090 {
 namespace impl_ {
+// CardDescriptor forward declaration
+struct CardDescriptor;
 // Command forward declaration
 struct Command;
 // command_queue forward declaration
 class ConcurentCommandQueue;
 // CardMessage forward declaration
 struct CardMessage;
+// CoalescingWindow forward declaration
+class CoalescingWindow;
+// ConnectionState forward declaration
+class ConnectionState;
+// DwellFilter forward declaration
+class DwellFilter;
+// EventCache forward declaration
+class EventCache;
+// EventListeners forward declaration
+class EventListeners;
+// LinkMonitor forward declaration
+class LinkMonitor;
+// WearAccounting forward declaration
+class WearAccounting;
+// CommandLog forward declaration
+class CommandLog;
+// RefreshFlight forward declaration
+class RefreshFlight;
+// ResponseWaiters forward declaration
+class ResponseWaiters;
+// ProgramInterpreter forward declaration
+class ProgramInterpreter;
+// PrecisePulse forward declaration
+class PrecisePulse;
+// StatusCorrelator forward declaration
+class StatusCorrelator;
+// SubscriptionList forward declaration
+class SubscriptionList;
+// TimerDelayType forward declaration
+enum struct TimerDelayType : unsigned char;
+// ResponseAction forward declaration
+enum struct ResponseAction : unsigned char;
+// StatusOrigin forward declaration
+enum struct StatusOrigin : unsigned char;
 }  // namespace impl_
 
+// forward declarations
+class InrushLimiter;
+class K8090AllocationTest;
+class Logger;
+
 /// The class that provides the interface for Velleman %K8090 relay card controlling through serial port.
 class SPRELAY_LIBRARY_EXPORT K8090 : public QObject
 {
     Q_OBJECT
+    // the allocation budgets of the send and response paths are tested on the private methods
+    friend class K8090AllocationTest;
 
 public:
     static const quint16 kProductID;
     static const quint16 kVendorID;
 
+    /// Predicate selecting the awaited response, see K8090::waitForResponse().
+    using ResponseMatcher = std::function<bool(const k8090::CardEvent&)>;
+    /// Handler of the awaited response, see K8090::waitForResponse().
+    using ResponseHandler = std::function<void(const k8090::CardEvent&)>;
+    /// Listener of all card events, see K8090::addEventListener().
+    using EventListener = std::function<void(const k8090::CardEvent&)>;
+    /// Handler of the refresh completion, see K8090::refreshRelaysInfo(RefreshHandler).
+    using RefreshHandler = std::function<void(bool completed)>;
+
     explicit K8090(QObject* parent = nullptr);
     K8090(const K8090&) = delete;
     K8090(K8090&&) = delete;
@@ -92,8 +153,43 @@ public:
     void setCommandDelay(int msec);
     void setFailureDelay(int msec);
     void setMaxFailureCount(int count);
+    void setRefreshFreshness(int msec);
+    void setCoalescingWindow(int max_msec);
+    void flushCommands();
+    void setRelayDwell(int msec);
+    void setSchedulingPolicy(k8090::SchedulingPolicy policy);
+    k8090::SchedulingPolicy schedulingPolicy();
+    void setIdleMode(bool enabled);
+    bool isIdleMode();
+    void setWakeupMeasurement(bool enabled);
+    bool isWakeupMeasurementEnabled();
     bool isConnected();
     int pendingCommandCount(k8090::CommandID id);
+    EventSubscription* subscribe(k8090::EventType events, k8090::RelayID relays = k8090::RelayID::All);
+    void unsubscribe(EventSubscription* subscription);
+    std::vector<k8090::RelayWear> relayWear();
+    void setRelayWearFile(const QString& file_name, int save_interval_msec = kDefaultWearSaveInterval_);
+    bool setCommandLogFile(const QString& file_name, int commit_delay_msec = kDefaultCommandLogCommitDelay_);
+    k8090::CommandLogStatistics commandLogStatistics();
+    void setInrushLimiter(std::shared_ptr<k8090::InrushLimiter> limiter);
+    std::shared_ptr<k8090::InrushLimiter> inrushLimiter();
+    void setLogger(std::shared_ptr<k8090::Logger> logger);
+    std::shared_ptr<k8090::Logger> logger();
+    k8090::ExecutionPlan planExecution(
+        const std::vector<k8090::CardCommand>& commands, int response_delay = kDefaultResponseDelay_);
+    bool runProgram(const k8090::RelayProgram& program);
+    void stopProgram();
+    bool runMockScenario(const k8090::MockScenario& scenario);
+    bool pulseRelay(k8090::RelayID relays, int width_msec);
+    void waitForResponse(ResponseMatcher matcher, ResponseHandler handler);
+    int addEventListener(EventListener listener);
+    void removeEventListener(int id);
+    k8090::LinkStatistics linkStatistics() const;
+    void resetLinkStatistics();
+    void refreshRelaysInfo(RefreshHandler handler);
+
+protected:
+    K8090(const impl_::CardDescriptor& card, QObject* parent);
 
 signals:
     void relayStatus(biomolecules::sprelay::core::k8090::RelayID previous,
@@ -106,6 +202,8 @@ signals:
         biomolecules::sprelay::core::k8090::RelayID toggle, biomolecules::sprelay::core::k8090::RelayID timed);
     void jumperStatus(bool on);
     void firmwareVersion(int year, int week);
+    void programFinished(bool completed);
+    void pulseFinished(biomolecules::sprelay::core::k8090::RelayID relays, int width_usec, int error_usec);
     void connected();
     void connectionFailed();
     void notConnected();
@@ -147,6 +245,16 @@ private slots:
     void dequeueCommand();
     void onCommandFailed();
     void onDoDisconnect(bool failure);
+    void saveRelayWear();
+    void loadRelayWear();
+    void applyLogger();
+    void commitCommandLog();
+    void replayCommandLog();
+    void releaseDeferredRelays();
+    void releaseDwellRelays();
+    void executeProgram();
+    void pulseOffDue();
+    void measureWakeups();
 
 private:
     void sendCommand(k8090::CommandID command_id, k8090::RelayID mask = k8090::RelayID::None, unsigned char param1 = 0,
@@ -155,25 +263,64 @@ private:
         unsigned char param1 = 0, unsigned char param2 = 0);
     void sendCommandHelper(k8090::CommandID command_id, k8090::RelayID mask = k8090::RelayID::None,
         unsigned char param1 = 0, unsigned char param2 = 0);
+    void writeCommand(k8090::CommandID command_id, k8090::RelayID mask, unsigned char param1, unsigned char param2);
+    bool isLineFree();
+    qint64 commandDelayRemaining();
+    void scheduleNextCommand(qint64 remaining);
+    void resumeCommands();
     bool hasResponse(k8090::CommandID command_id);
-    void sendToSerial(std::unique_ptr<unsigned char[]> buffer, int n);
-
-    void buttonModeResponse(std::unique_ptr<impl_::CardMessage> response);
-    void timerResponse(std::unique_ptr<impl_::CardMessage> response);
-    void buttonStatusResponse(std::unique_ptr<impl_::CardMessage> response);
-    void relayStatusResponse(std::unique_ptr<impl_::CardMessage> response);
-    void jumperStatusResponse(std::unique_ptr<impl_::CardMessage> response);
-    void firmwareVersionResponse(std::unique_ptr<impl_::CardMessage> response);
+    static bool isCoalesced(k8090::CommandID command_id);
+    void flushCoalescedCommands();
+    k8090::RelayID limitInrush(k8090::RelayID mask);
+    k8090::RelayID filterDwell(k8090::CommandID command_id, k8090::RelayID mask);
+    void scheduleDwellRelease(qint64 now);
+    void startPulse(k8090::RelayID relays, int width_msec);
+    bool sendPulseEdge();
+    void pulseRelayStatus(k8090::RelayID current);
+    void resetPulse();
+    void sendToSerial(const unsigned char* buffer, int n);
+    void processResponses(const char* data, int n);
+
+    void buttonModeResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    void timerResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    void buttonStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    void relayStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    bool completeStatusReply(impl_::StatusOrigin origin);
+    void jumperStatusResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    void firmwareVersionResponse(const impl_::CardMessage& response, impl_::ResponseAction action);
+    void continueAfterResponse(impl_::ResponseAction action);
     void connectionSuccessful();
 
+    void dispatchRelayStatus(k8090::RelayID previous, k8090::RelayID current, k8090::RelayID timed);
+    void dispatchButtonStatus(k8090::RelayID state, k8090::RelayID pressed, k8090::RelayID released);
+    void dispatchTimerDelay(impl_::TimerDelayType type, k8090::RelayID relays, quint16 delay);
+    void replayEvents(EventSubscription* subscription);
+    void updateRelayWear(k8090::RelayID current);
+    void publishRelayWear();
+    void checkpointCommandLog();
+    void writeCommandLog();
+    void startProgram(const std::vector<k8090::ProgramStep>& steps);
+    void finishProgram(bool completed);
+    void programRelayStatus(k8090::RelayID current);
+    template<k8090::LogLevel level>
+    void logEvent(k8090::LogEvent event, k8090::CommandID command = k8090::CommandID::None,
+        k8090::RelayID relays = k8090::RelayID::None, int value = 0);
+
     static inline unsigned char lowByte(quint16 delay) { return delay & 0xFFu; }
     static inline unsigned char highByte(quint16 delay) { return static_cast<quint16>(delay >> 8u) & 0xFFu; }
 
-    static const int kDefaultCommandDelay_;
-    static const int kDefaultFailureDelay_;
-    static const int kDefaultMaxFailureCount_;
+    static const int kDefaultWearSaveInterval_;
+    static const int kDefaultCommandLogCommitDelay_;
+    static const int kDefaultResponseDelay_;
+    static const int kDefaultRefreshFreshness_;
 
+    const impl_::CardDescriptor* card_;
 
+    // Lock order: lifecycle_mutex_ is locked before com_port_name_mutex_ and before the internal lock of
+    // pending_commands_, inrush_mutex_ is locked before the InrushLimiter's lock. command_log_mutex_ is recursive,
+    // because setCommandLogFile() writes the pending records with it locked. The other mutexes are leaves and no
+    // mutex is held while signals are emitted or handlers and listeners are called. The helpers owning their own locks
+    // (subscriptions_, response_waiters_, event_listeners_, refresh_flight_) are called with no K8090 mutex held.
     QString com_port_name_;
     std::unique_ptr<QMutex> com_port_name_mutex_;
     std::unique_ptr<UnifiedSerialPort> serial_port_;
@@ -183,16 +330,70 @@ private:
     std::unique_ptr<QTimer> command_timer_;
     std::unique_ptr<QTimer> failure_timer_;
     int failure_counter_;
-    bool connected_;
-    bool connecting_;
-    std::unique_ptr<QMutex> connected_mutex_;
-    int command_delay_;
-    int factory_defaults_command_delay_;
-    std::unique_ptr<QMutex> command_delay_mutex_;
-    int failure_delay_;
-    std::unique_ptr<QMutex> failure_delay_mutex_;
-    int failure_max_count_;
-    std::unique_ptr<QMutex> failure_max_count_mutex_;
+    std::unique_ptr<impl_::ConnectionState> connection_state_;
+    std::unique_ptr<QMutex> lifecycle_mutex_;
+    k8090::SchedulingPolicy scheduling_policy_;
+    std::atomic<int> command_delay_;
+    std::atomic<int> factory_defaults_command_delay_;
+    std::atomic<int> failure_delay_;
+    std::atomic<int> failure_max_count_;
+
+    std::unique_ptr<impl_::SubscriptionList> subscriptions_;
+    std::unique_ptr<impl_::EventCache> event_cache_;
+
+    std::unique_ptr<impl_::WearAccounting> wear_accounting_;
+    std::unique_ptr<impl_::WearAccounting> wear_snapshot_;
+    QByteArray wear_loaded_;
+    QString wear_file_name_;
+    int wear_save_interval_;
+    std::unique_ptr<QTimer> wear_timer_;
+    std::unique_ptr<QMutex> wear_mutex_;
+
+    std::unique_ptr<impl_::CommandLog> command_log_;
+    std::unique_ptr<QFile> command_log_file_;
+    int command_log_commit_delay_;
+    std::unique_ptr<QTimer> command_log_timer_;
+    k8090::CommandLogStatistics command_log_statistics_;
+    std::unique_ptr<QMutex> command_log_mutex_;
+    std::atomic<bool> command_log_active_;
+
+    std::shared_ptr<k8090::InrushLimiter> inrush_limiter_;
+    k8090::RelayID inrush_deferred_;
+    std::unique_ptr<QTimer> inrush_timer_;
+    std::unique_ptr<QMutex> inrush_mutex_;
+
+    std::unique_ptr<impl_::ProgramInterpreter> program_;
+    std::unique_ptr<QTimer> program_timer_;
+
+    std::unique_ptr<impl_::ResponseWaiters> response_waiters_;
+
+    std::unique_ptr<impl_::EventListeners> event_listeners_;
+
+    std::unique_ptr<impl_::LinkMonitor> link_monitor_;
+    std::unique_ptr<impl_::StatusCorrelator> status_correlator_;
+
+    std::unique_ptr<impl_::RefreshFlight> refresh_flight_;
+
+    std::unique_ptr<impl_::CoalescingWindow> coalescing_window_;
+    std::unique_ptr<QElapsedTimer> burst_timer_;
+    std::unique_ptr<QTimer> coalescing_timer_;
+    std::unique_ptr<QMutex> coalescing_mutex_;
+
+    std::unique_ptr<impl_::DwellFilter> dwell_filter_;
+    std::unique_ptr<QTimer> dwell_timer_;
+    std::unique_ptr<QMutex> dwell_mutex_;
+
+    std::unique_ptr<impl_::PrecisePulse> precise_pulse_;
+    std::unique_ptr<QTimer> pulse_timer_;
+    std::atomic<bool> pulse_reserved_;
+
+    std::atomic<bool> idle_mode_;
+    std::atomic<bool> wakeup_measurement_;
+    QMetaObject::Connection wakeup_connection_;
+
+    std::shared_ptr<k8090::Logger> logger_;
+    std::unique_ptr<QMutex> logger_mutex_;
+    std::shared_ptr<k8090::Logger> thread_logger_;  // the copy of logger_ used only in the K8090's thread
 };
 
 }  // namespace k8090
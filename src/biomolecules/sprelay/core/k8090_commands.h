@@ -363,6 +363,7 @@ const quint16 kProductID = 32912;
 const quint16 kVendorID = 4303;
 
 const char* const kMockPortName = "MOCKCOM";
+const char* const kThreadedMockPortName = "THREADEDMOCKCOM";
 
 }  // namespace impl_
 }  // namespace k8090
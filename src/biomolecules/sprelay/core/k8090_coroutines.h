@@ -0,0 +1,371 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      k8090_coroutines.h
+ * \brief     Optional C++20 coroutine interface to biomolecules::sprelay::core::k8090::K8090.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_K8090_COROUTINES_H_
+#define BIOMOLECULES_SPRELAY_CORE_K8090_COROUTINES_H_
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "k8090_coroutines.h requires C++20 coroutine support."
+#endif
+
+#include <array>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#include <QtGlobal>
+
+#include "k8090.h"
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/// Result of awaited command confirmed by relay status.
+struct RelayStatusResult
+{
+    bool ok;           ///< False if the card is not connected or it was disconnected.
+    RelayID previous;  ///< Relays which were previously switched on.
+    RelayID current;   ///< Relays which are currently switched on.
+    RelayID timed;     ///< Timed relays.
+};
+
+
+/// Result of awaited button mode command or query.
+struct ButtonModesResult
+{
+    bool ok;            ///< False if the card is not connected or it was disconnected.
+    RelayID momentary;  ///< Buttons with momentary mode.
+    RelayID toggle;     ///< Buttons with toggle mode.
+    RelayID timed;      ///< Buttons with timed mode.
+};
+
+
+/// Result of awaited timer delay command or query.
+struct TimerDelaysResult
+{
+    bool ok;                         ///< False if the card is not connected or it was disconnected.
+    RelayID relays;                  ///< Relays with reported delay.
+    std::array<quint16, 8> delays;  ///< Delays indexed by relay number, valid only for reported relays.
+};
+
+
+/// Result of awaited jumper status query.
+struct JumperStatusResult
+{
+    bool ok;  ///< False if the card is not connected or it was disconnected.
+    bool on;  ///< True if the jumper is set.
+};
+
+
+/// Result of awaited firmware version query.
+struct FirmwareVersionResult
+{
+    bool ok;   ///< False if the card is not connected or it was disconnected.
+    int year;  ///< Firmware year.
+    int week;  ///< Firmware week.
+};
+
+
+/// \brief Awaitable which sends command and resumes the coroutine with the response collected into TResult.
+/// \headerfile ""
+template<typename TResult>
+class CardAwaiter
+{
+public:
+    /// Collects the event into the result and returns true, when the result is complete.
+    using Collector = std::function<bool(TResult*, const CardEvent&)>;
+
+    /*!
+     * \brief Constructs the awaiter.
+     * \param card The card.
+     * \param send Function sending the command.
+     * \param collect Function collecting the responses.
+     */
+    CardAwaiter(K8090* card, std::function<void()> send, Collector collect)
+        : card_{card}, send_{std::move(send)}, collect_{std::move(collect)}, result_{}
+    {}
+
+    /// The command is always sent, so the coroutine is suspended.
+    bool await_ready() const noexcept { return false; }
+
+    /*!
+     * \brief Starts waiting for the response and sends the command.
+     *
+     * The coroutine is resumed directly from the response processing in the thread of the K8090 object.
+     *
+     * \param handle The suspended coroutine.
+     * \return False if the card is not connected and the coroutine continues immediately.
+     */
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        if (!card_->isConnected()) {
+            return false;
+        }
+        // the awaiter can be destroyed by the resumed coroutine before this method returns, so only locals are used
+        // after the waiting is started
+        K8090* card = card_;
+        std::function<void()> send = std::move(send_);
+        card->waitForResponse([this](const CardEvent& event) { return collect_(&result_, event); },
+            [this, handle](const CardEvent& event) {
+                result_.ok = event.response != ResponseID::None;
+                handle.resume();
+            });
+        send();
+        return true;
+    }
+
+    /// Returns the collected result.
+    TResult await_resume() const { return result_; }
+
+private:
+    K8090* card_;
+    std::function<void()> send_;
+    Collector collect_;
+    TResult result_;
+};
+
+
+/// \brief Fire-and-forget coroutine type, which can be used for card routines.
+/// \headerfile ""
+struct CardTask
+{
+    /// Promise of the eagerly started coroutine, which destroys itself when it finishes.
+    struct promise_type
+    {
+        CardTask get_return_object() noexcept { return CardTask{}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+
+/// \brief Coroutine interface to K8090, which provides awaitables for all commands and queries.
+/// \headerfile ""
+class AsyncK8090
+{
+public:
+    /*!
+     * \brief Constructs the interface.
+     * \param card The connected card, it must outlive the interface and all awaitables.
+     */
+    explicit AsyncK8090(K8090* card) : card_{card} {}
+
+    /// Switches the relays on and resumes when they are reported switched on.
+    CardAwaiter<RelayStatusResult> switchOn(RelayID relays)
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card, relays]() { card->switchRelayOn(relays); },
+            [relays](RelayStatusResult* result, const CardEvent& event) {
+                return collectRelayStatus(result, event) && (result->current & relays) == relays;
+            }};
+    }
+
+    /// Switches the relays off and resumes when they are reported switched off.
+    CardAwaiter<RelayStatusResult> switchOff(RelayID relays)
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card, relays]() { card->switchRelayOff(relays); },
+            [relays](RelayStatusResult* result, const CardEvent& event) {
+                return collectRelayStatus(result, event) && (result->current & relays) == RelayID::None;
+            }};
+    }
+
+    /// Toggles the relays and resumes with the relay status reporting their transition.
+    CardAwaiter<RelayStatusResult> toggle(RelayID relays)
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card, relays]() { card->toggleRelay(relays); },
+            [relays](RelayStatusResult* result, const CardEvent& event) {
+                return collectRelayStatus(result, event)
+                    && ((result->previous ^ result->current) & relays) != RelayID::None;
+            }};
+    }
+
+    /// Starts the relay timers and resumes when the relays are reported switched on.
+    CardAwaiter<RelayStatusResult> startTimer(RelayID relays, quint16 delay = 0)
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card, relays, delay]() { card->startRelayTimer(relays, delay); },
+            [relays](RelayStatusResult* result, const CardEvent& event) {
+                return collectRelayStatus(result, event) && (result->current & relays) == relays;
+            }};
+    }
+
+    /// Sets the relay timer delays and resumes with the total delays queried after the command.
+    CardAwaiter<TimerDelaysResult> setTimerDelay(RelayID relays, quint16 delay)
+    {
+        K8090* card = card_;
+        return CardAwaiter<TimerDelaysResult>{card,
+            [card, relays, delay]() { card->setRelayTimerDelay(relays, delay); },
+            [relays](TimerDelaysResult* result, const CardEvent& event) {
+                return collectTimerDelays(result, event, false, relays);
+            }};
+    }
+
+    /// Sets the button modes and resumes with the button modes queried after the command.
+    CardAwaiter<ButtonModesResult> setButtonMode(RelayID momentary, RelayID toggle, RelayID timed)
+    {
+        K8090* card = card_;
+        return CardAwaiter<ButtonModesResult>{card,
+            [card, momentary, toggle, timed]() { card->setButtonMode(momentary, toggle, timed); }, &collectButtonModes};
+    }
+
+    /// Resets factory defaults and resumes when all relays are reported switched off.
+    CardAwaiter<RelayStatusResult> resetFactoryDefaults()
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card]() { card->resetFactoryDefaults(); },
+            [](RelayStatusResult* result, const CardEvent& event) {
+                return collectRelayStatus(result, event) && result->current == RelayID::None;
+            }};
+    }
+
+    /// Queries the relay status.
+    CardAwaiter<RelayStatusResult> queryRelayStatus()
+    {
+        K8090* card = card_;
+        return CardAwaiter<RelayStatusResult>{card, [card]() { card->queryRelayStatus(); }, &collectRelayStatus};
+    }
+
+    /// Queries total timer delays and resumes when all relays are reported.
+    CardAwaiter<TimerDelaysResult> queryTotalTimerDelay(RelayID relays)
+    {
+        K8090* card = card_;
+        return CardAwaiter<TimerDelaysResult>{card, [card, relays]() { card->queryTotalTimerDelay(relays); },
+            [relays](TimerDelaysResult* result, const CardEvent& event) {
+                return collectTimerDelays(result, event, false, relays);
+            }};
+    }
+
+    /// Queries remaining timer delays and resumes when all relays are reported.
+    CardAwaiter<TimerDelaysResult> queryRemainingTimerDelay(RelayID relays)
+    {
+        K8090* card = card_;
+        return CardAwaiter<TimerDelaysResult>{card, [card, relays]() { card->queryRemainingTimerDelay(relays); },
+            [relays](TimerDelaysResult* result, const CardEvent& event) {
+                return collectTimerDelays(result, event, true, relays);
+            }};
+    }
+
+    /// Queries the button modes.
+    CardAwaiter<ButtonModesResult> queryButtonModes()
+    {
+        K8090* card = card_;
+        return CardAwaiter<ButtonModesResult>{card, [card]() { card->queryButtonModes(); }, &collectButtonModes};
+    }
+
+    /// Queries the jumper status.
+    CardAwaiter<JumperStatusResult> queryJumperStatus()
+    {
+        K8090* card = card_;
+        return CardAwaiter<JumperStatusResult>{card, [card]() { card->queryJumperStatus(); },
+            [](JumperStatusResult* result, const CardEvent& event) {
+                if (event.response != ResponseID::JumperStatus) {
+                    return false;
+                }
+                result->on = event.param1 != 0;
+                return true;
+            }};
+    }
+
+    /// Queries the firmware version.
+    CardAwaiter<FirmwareVersionResult> queryFirmwareVersion()
+    {
+        K8090* card = card_;
+        return CardAwaiter<FirmwareVersionResult>{card, [card]() { card->queryFirmwareVersion(); },
+            [](FirmwareVersionResult* result, const CardEvent& event) {
+                if (event.response != ResponseID::FirmwareVersion) {
+                    return false;
+                }
+                result->year = 2000 + static_cast<int>(event.param1);
+                result->week = static_cast<int>(event.param2);
+                return true;
+            }};
+    }
+
+private:
+    static bool collectRelayStatus(RelayStatusResult* result, const CardEvent& event)
+    {
+        if (event.response != ResponseID::RelayStatus) {
+            return false;
+        }
+        result->previous = static_cast<RelayID>(event.mask);
+        result->current = static_cast<RelayID>(event.param1);
+        result->timed = static_cast<RelayID>(event.param2);
+        return true;
+    }
+
+    static bool collectButtonModes(ButtonModesResult* result, const CardEvent& event)
+    {
+        if (event.response != ResponseID::ButtonMode) {
+            return false;
+        }
+        result->momentary = static_cast<RelayID>(event.mask);
+        result->toggle = static_cast<RelayID>(event.param1);
+        result->timed = static_cast<RelayID>(event.param2);
+        return true;
+    }
+
+    static bool collectTimerDelays(TimerDelaysResult* result, const CardEvent& event, bool remaining, RelayID relays)
+    {
+        if (event.response != ResponseID::Timer || event.remaining_delay != remaining) {
+            return false;
+        }
+        for (unsigned int i = 0; i < 8; ++i) {
+            if ((event.mask & (1u << i)) != 0u) {
+                result->delays[i] = static_cast<quint16>((event.param1 << 8u) | event.param2);
+            }
+        }
+        result->relays |= static_cast<RelayID>(event.mask);
+        return (result->relays & relays) == relays;
+    }
+
+    K8090* card_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_K8090_COROUTINES_H_
@@ -40,6 +40,7 @@
 #define BIOMOLECULES_SPRELAY_CORE_K8090_DEFINES_H_
 
 #include <type_traits>
+#include <vector>
 
 #include <QMetaType>
 
@@ -95,6 +96,186 @@ enum struct RelayID : unsigned char {
 };
 
 
+/// Scoped enumeration listing event types, which can be subscribed by K8090::subscribe().
+enum struct EventType : unsigned int {
+    None = 0u,                       ///< No event.
+    RelayStatus = 1u << 0u,          ///< Relay status event.
+    ButtonStatus = 1u << 1u,         ///< Button status event.
+    TotalTimerDelay = 1u << 2u,      ///< Total timer delay report.
+    RemainingTimerDelay = 1u << 3u,  ///< Remaining timer delay report.
+    All = 0xFu                       ///< All events.
+};
+
+
+/// Wear and on-time statistics of one relay, see K8090::relayWear().
+struct RelayWear
+{
+    quint64 switch_count;    ///< The number of relay transitions.
+    qint64 on_time;          ///< Cumulative time in ms, the relay was switched on.
+    qint64 last_transition;  ///< Time of the last transition in ms since epoch or 0 if it is unknown.
+};
+
+
+/// Durability statistics of the command log, see K8090::commandLogStatistics().
+struct CommandLogStatistics
+{
+    quint64 logged_commands;    ///< The number of commands appended to the log.
+    quint64 commits;            ///< The number of group commits, each of them synchronizes the log file once.
+    quint64 failed_commits;     ///< The number of commits, which failed to write or synchronize the log file.
+    qint64 commit_time;         ///< Cumulative time in ns spent by the commits.
+    quint64 replayed_commands;  ///< The number of recovered commands, which were reconciled with the card.
+};
+
+
+/// Live statistics of the link to the card, see K8090::linkStatistics().
+///
+/// The counters are modulo 2^32, so rates computed from differences of two snapshots stay correct when they wrap.
+struct LinkStatistics
+{
+    int queue_depth;            ///< The number of commands waiting in the queue.
+    quint32 enqueued_commands;  ///< The number of requested commands including the merged ones.
+    quint32 merged_commands;    ///< The number of requested commands merged into already pending commands.
+    quint32 sent_commands;      ///< The number of commands sent to the card including the follow-up queries.
+    quint32 failures;           ///< The number of missing, invalid or unexpected responses.
+    int command_delay;          ///< The delay in ms after the last sent command before the next one can be sent.
+    quint32 latency_samples;    ///< The number of measured latencies between a command and its response.
+    int latency_p50;            ///< Median latency in ms.
+    int latency_p90;            ///< 90th percentile of latency in ms.
+    int latency_p99;            ///< 99th percentile of latency in ms.
+    int latency_max;            ///< Maximum latency in ms.
+    int coalescing_window;      ///< The current micro-batching window in ms, 0 if the batching is disabled.
+    quint32 coalesced_bursts;   ///< The number of command bursts held back by the micro-batching window.
+    quint32 dwell_suppressed_transitions;  ///< The number of relay transitions suppressed by the dwell filter.
+    quint32 dwell_saved_commands;          ///< The number of commands not sent thanks to the dwell filter.
+    quint32 wakeups;  ///< Event loop wakeups of the K8090 thread counted by K8090::setWakeupMeasurement().
+    quint32 confirmed_replies;     ///< Relay status replies, which released the next command without the delay.
+    quint32 unsolicited_statuses;  ///< Relay status events, which didn't answer the awaited query or toggle.
+};
+
+
+/// Command with its parameters as it is sent to the card, see K8090::planExecution().
+struct CardCommand
+{
+    CommandID id;          ///< The command id.
+    RelayID mask;          ///< The mask parameter, usually the relays.
+    unsigned char param1;  ///< The first parameter, see the Velleman %K8090 card manual.
+    unsigned char param2;  ///< The second parameter, see the Velleman %K8090 card manual.
+};
+
+
+/// One command of ExecutionPlan.
+struct PlannedCommand
+{
+    CardCommand command;  ///< The command as it would be sent to the card.
+    int send_time;        ///< Time in ms from the start of the execution, when the command would be sent.
+    bool follow_up;       ///< True if the command is implicit query testing the previous command.
+};
+
+
+/// Estimated execution of commands, see K8090::planExecution().
+struct ExecutionPlan
+{
+    std::vector<PlannedCommand> commands;  ///< The commands in the order, in which they would be sent.
+    int completion_time;                   ///< Estimated time in ms, when the card would be ready for next command.
+};
+
+
+/// Response of the card delivered to K8090::waitForResponse() handlers.
+struct CardEvent
+{
+    ResponseID response;   ///< The response id or ResponseID::None, if the card was disconnected.
+    unsigned char mask;    ///< The mask byte of the response, see the Velleman %K8090 card manual.
+    unsigned char param1;  ///< The first parameter byte of the response.
+    unsigned char param2;  ///< The second parameter byte of the response.
+    bool remaining_delay;  ///< True if ResponseID::Timer response contains remaining timer delay.
+};
+
+
+/// Scoped enumeration listing instructions of compiled RelayProgram.
+enum struct ProgramOpcode : unsigned char {
+    Command,     ///< Enqueues the command.
+    WaitRelays,  ///< Waits until the relays are in the required state.
+    Delay,       ///< Waits for the specified time.
+    Loop         ///< Jumps back to the loop start until the loop count is exhausted.
+};
+
+
+/// One instruction of compiled RelayProgram.
+struct ProgramStep
+{
+    ProgramOpcode opcode;  ///< The instruction.
+    CardCommand command;   ///< The command of ProgramOpcode::Command instruction.
+    RelayID relays;        ///< The relays tested by ProgramOpcode::WaitRelays instruction.
+    RelayID state;         ///< The required state of the relays tested by ProgramOpcode::WaitRelays instruction.
+    int argument;          ///< Delay in ms of ProgramOpcode::Delay or index of the loop start of ProgramOpcode::Loop.
+    int count;             ///< Number of ProgramOpcode::Loop repetitions, zero means infinite loop.
+};
+
+
+/// Simulated physical interaction with the card, see MockScenario.
+enum struct ScenarioAction : unsigned char {
+    PressButtons,    ///< Presses the buttons on the card.
+    ReleaseButtons,  ///< Releases the pressed buttons.
+    SetJumper,       ///< Sets the jumper, the buttons then only report their status and don't control the relays.
+    ClearJumper,     ///< Removes the jumper.
+    ExpireTimers     ///< Expires the running timers of the relays immediately.
+};
+
+
+/// One event of MockScenario.
+struct ScenarioEvent
+{
+    int time;               ///< Time of the event in ms from the start of the scenario or its repetition.
+    ScenarioAction action;  ///< The simulated interaction.
+    RelayID relays;         ///< The buttons or relays affected by the interaction.
+};
+
+
+/// Scheduling policy of the command queue, see K8090::setSchedulingPolicy().
+enum struct SchedulingPolicy : unsigned char {
+    Priority,  ///< Merges compatible commands and sends them by card priorities, the default.
+    Fifo,      ///< Merges compatible commands and sends them in the order, in which they were issued.
+    NoMerge    ///< Sends every issued command by card priorities without merging.
+};
+
+
+/// Severity of LogRecord, see Logger.
+enum struct LogLevel : unsigned char {
+    Debug,    ///< Frequent events useful only for tracing, e.g. merged commands.
+    Info,     ///< Connection lifecycle and resynchronization events.
+    Warning,  ///< Failed commands and unexpected responses, which are recovered.
+    Error,    ///< Protocol violations and failures, which break the connection.
+    None      ///< Disables logging, no record has this level.
+};
+
+
+/// Event reported by LogRecord, see Logger.
+enum struct LogEvent : unsigned char {
+    Connected,           ///< The connection to the card was established.
+    ConnectionFailed,    ///< The card was not found, the port couldn't be opened or the link failed.
+    Disconnected,        ///< The card was intentionally disconnected.
+    CommandFailed,       ///< The command failed, the value is the number of consecutive failures.
+    InvalidResponse,     ///< Truncated or corrupted response, the value is the number of received bytes.
+    UnexpectedResponse,  ///< The response doesn't answer the sent command, the value is the ResponseID.
+    ProtocolError,       ///< The response came in the connection state, in which it can't occur.
+    Resync,              ///< The recovered commands were replayed, the value is their number.
+    CommandMerged,       ///< The command was merged into a pending command, the value is the queue depth.
+    RecordsDropped       ///< Full thread buffers dropped records, the value is their number.
+};
+
+
+/// One record of Logger.
+struct LogRecord
+{
+    qint64 time;        ///< Time of the event in ms since the epoch.
+    LogLevel level;     ///< The severity.
+    LogEvent event;     ///< The event.
+    CommandID command;  ///< The command related to the event or CommandID::None.
+    RelayID relays;     ///< The relays related to the event or RelayID::None.
+    int value;          ///< Event specific value, see LogEvent.
+};
+
+
 /// Converts number to RelayID scoped enumeration.
 constexpr RelayID from_number(unsigned int number)
 {
@@ -130,6 +311,16 @@ struct EnableBitmaskOperators<biomolecules::sprelay::core::k8090::RelayID>
                                          ///< biomolecules::sprelay::core::k8090::RelayID
 };
 
+/// \ingroup group_biomolecules_sprelay_core_public
+/// \brief Struct specialization which enables bitwise operators for biomolecules::sprelay::core::k8090::EventType
+/// enumeration. See the \ref group_enum_flags "enum_flags" documentation for more details.
+template<>
+struct EnableBitmaskOperators<biomolecules::sprelay::core::k8090::EventType>
+{
+    static constexpr bool value = true;  ///< The `true` value enables bitmask operators on
+                                         ///< biomolecules::sprelay::core::k8090::EventType
+};
+
 }  // namespace enum_flags
 }  // namespace lumik
 
@@ -160,6 +351,15 @@ Q_DECLARE_METATYPE(biomolecules::sprelay::core::k8090::RelayID)
  * of particular relays.
  */
 
+/*!
+ * \enum biomolecules::sprelay::core::k8090::EventType
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * Bitwise operators are enabled for this enum by specializing
+ * lumik::enum_flags::EnableBitmaskOperators<biomolecules::sprelay::core::k8090::EventType> structure, so the value of
+ * k8090::EventType type can be also a combination of particular event types.
+ */
+
 /*!
  * \fn constexpr RelayID biomolecules::sprelay::core::k8090::from_number(unsigned int number)
  * \ingroup group_biomolecules_sprelay_core_public
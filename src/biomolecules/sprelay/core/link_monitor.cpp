@@ -0,0 +1,338 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      link_monitor.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LinkMonitor class which collects live statistics of
+ *            the card link.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "link_monitor.h"
+
+#include <algorithm>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class LinkMonitor
+ *
+ * The K8090 thread updates the statistics with relaxed atomic operations only, so the monitor adds no locking to the
+ * command processing. Other threads read them with LinkMonitor::snapshot(). The fields of the snapshot are read
+ * independently of each other, which is sufficient for diagnostics.
+ *
+ * The latencies between commands and their responses are stored in a histogram with 1 ms wide buckets, the last
+ * bucket collects all the longer latencies. The percentiles are computed from the histogram when the snapshot is
+ * taken.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \var LinkMonitor::kLatencyBuckets
+ * \brief The number of latency histogram buckets, the longest distinguished latency is one less in ms.
+ */
+
+
+/*!
+ * \brief Constructs the monitor with all the statistics cleared.
+ */
+LinkMonitor::LinkMonitor()
+    : queue_depth_{0},
+      enqueued_commands_{0},
+      merged_commands_{0},
+      sent_commands_{0},
+      failures_{0},
+      command_delay_{0},
+      coalescing_window_{0},
+      coalesced_bursts_{0},
+      dwell_suppressed_transitions_{0},
+      dwell_saved_commands_{0},
+      wakeups_{0},
+      confirmed_replies_{0},
+      unsolicited_statuses_{0}
+{
+    for (std::atomic<quint32>& bucket : latency_histogram_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+/*!
+ * \brief Records the command requested by the user.
+ *
+ * The commands sent directly without the queue are recorded too, they are not merged.
+ *
+ * \param merged True if the command was merged into some already pending command.
+ * \param queue_depth The number of commands in the queue after the command was accepted.
+ */
+void LinkMonitor::commandEnqueued(bool merged, int queue_depth)
+{
+    enqueued_commands_.fetch_add(1, std::memory_order_relaxed);
+    if (merged) {
+        merged_commands_.fetch_add(1, std::memory_order_relaxed);
+    }
+    queue_depth_.store(queue_depth, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the command removed from the queue.
+ * \param queue_depth The number of commands remaining in the queue.
+ */
+void LinkMonitor::commandDequeued(int queue_depth)
+{
+    queue_depth_.store(queue_depth, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the command sent to the card.
+ * \param command_delay The delay in ms before the next command can be sent.
+ */
+void LinkMonitor::commandSent(int command_delay)
+{
+    sent_commands_.fetch_add(1, std::memory_order_relaxed);
+    command_delay_.store(command_delay, std::memory_order_relaxed);
+    sent_timer_.start();
+}
+
+
+/*!
+ * \brief Time elapsed since the last command was sent.
+ *
+ * It can be called only from the K8090 thread.
+ *
+ * \return The time in ms.
+ */
+qint64 LinkMonitor::elapsedSinceSent() const
+{
+    return sent_timer_.isValid() ? sent_timer_.elapsed() : 0;
+}
+
+
+/*!
+ * \brief Records the latency between a command and its response.
+ * \param latency The latency in ms.
+ */
+void LinkMonitor::recordLatency(qint64 latency)
+{
+    int bucket = latency < kLatencyBuckets - 1 ? static_cast<int>(std::max(latency, qint64{0})) : kLatencyBuckets - 1;
+    latency_histogram_[static_cast<std::size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the failed command, the response of which is missing, invalid or unexpected.
+ */
+void LinkMonitor::commandFailed()
+{
+    failures_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records that the queue was dropped, for example when the card was disconnected.
+ */
+void LinkMonitor::clearQueue()
+{
+    queue_depth_.store(0, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the changed micro-batching window.
+ * \param window The window in ms, 0 if the batching is disabled.
+ */
+void LinkMonitor::setCoalescingWindow(int window)
+{
+    coalescing_window_.store(window, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the command burst held back by the micro-batching window.
+ * \param window The window in ms.
+ */
+void LinkMonitor::coalescingWindowOpened(int window)
+{
+    coalesced_bursts_.fetch_add(1, std::memory_order_relaxed);
+    coalescing_window_.store(window, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the statistics of the dwell filter.
+ *
+ * The dwell filter keeps its own counters, the monitor only publishes them.
+ *
+ * \param suppressed_transitions The number of suppressed relay transitions.
+ * \param saved_commands The number of commands, which were not sent.
+ */
+void LinkMonitor::setDwellStatistics(quint32 suppressed_transitions, quint32 saved_commands)
+{
+    dwell_suppressed_transitions_.store(suppressed_transitions, std::memory_order_relaxed);
+    dwell_saved_commands_.store(saved_commands, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the wakeup of the event loop of the K8090 thread.
+ */
+void LinkMonitor::wakeup()
+{
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the relay status, which was confirmed as the reply to the awaited command.
+ */
+void LinkMonitor::replyConfirmed()
+{
+    confirmed_replies_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Records the relay status, which was sent by the card spontaneously while a reply was awaited.
+ */
+void LinkMonitor::unsolicitedStatus()
+{
+    unsolicited_statuses_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Clears the counters and the latency histogram.
+ *
+ * The queue depth, the command delay and the micro-batching window describe the current state, so they are kept. It
+ * can be called from any thread, the updates made concurrently by the K8090 thread can be partially lost.
+ */
+void LinkMonitor::reset()
+{
+    enqueued_commands_.store(0, std::memory_order_relaxed);
+    merged_commands_.store(0, std::memory_order_relaxed);
+    sent_commands_.store(0, std::memory_order_relaxed);
+    failures_.store(0, std::memory_order_relaxed);
+    coalesced_bursts_.store(0, std::memory_order_relaxed);
+    dwell_suppressed_transitions_.store(0, std::memory_order_relaxed);
+    dwell_saved_commands_.store(0, std::memory_order_relaxed);
+    wakeups_.store(0, std::memory_order_relaxed);
+    confirmed_replies_.store(0, std::memory_order_relaxed);
+    unsolicited_statuses_.store(0, std::memory_order_relaxed);
+    for (std::atomic<quint32>& bucket : latency_histogram_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+/*!
+ * \fn quint32 LinkMonitor::sentCommands() const
+ * \brief The number of sent commands.
+ */
+
+
+/*!
+ * \fn quint32 LinkMonitor::failures() const
+ * \brief The number of failed commands.
+ */
+
+
+/*!
+ * \brief Takes the snapshot of the statistics without locking.
+ * \return The statistics.
+ */
+LinkStatistics LinkMonitor::snapshot() const
+{
+    LinkStatistics statistics;
+    statistics.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+    statistics.enqueued_commands = enqueued_commands_.load(std::memory_order_relaxed);
+    statistics.merged_commands = merged_commands_.load(std::memory_order_relaxed);
+    statistics.sent_commands = sent_commands_.load(std::memory_order_relaxed);
+    statistics.failures = failures_.load(std::memory_order_relaxed);
+    statistics.command_delay = command_delay_.load(std::memory_order_relaxed);
+    statistics.coalescing_window = coalescing_window_.load(std::memory_order_relaxed);
+    statistics.coalesced_bursts = coalesced_bursts_.load(std::memory_order_relaxed);
+    statistics.dwell_suppressed_transitions = dwell_suppressed_transitions_.load(std::memory_order_relaxed);
+    statistics.dwell_saved_commands = dwell_saved_commands_.load(std::memory_order_relaxed);
+    statistics.wakeups = wakeups_.load(std::memory_order_relaxed);
+    statistics.confirmed_replies = confirmed_replies_.load(std::memory_order_relaxed);
+    statistics.unsolicited_statuses = unsolicited_statuses_.load(std::memory_order_relaxed);
+
+    std::array<quint32, kLatencyBuckets> histogram;
+    quint32 samples = 0;
+    statistics.latency_max = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        histogram[i] = latency_histogram_[i].load(std::memory_order_relaxed);
+        samples += histogram[i];
+        if (histogram[i] != 0) {
+            statistics.latency_max = static_cast<int>(i);
+        }
+    }
+    statistics.latency_samples = samples;
+    statistics.latency_p50 = percentile(histogram, samples, 500);
+    statistics.latency_p90 = percentile(histogram, samples, 900);
+    statistics.latency_p99 = percentile(histogram, samples, 990);
+    return statistics;
+}
+
+
+// returns the smallest latency, which is not exceeded by the specified fraction of samples in permilles
+int LinkMonitor::percentile(const std::array<quint32, kLatencyBuckets>& histogram, quint32 samples, int permille)
+{
+    if (samples == 0) {
+        return 0;
+    }
+    // rank of the sample rounded up, at least the first sample
+    quint64 rank = (static_cast<quint64>(samples) * static_cast<quint64>(permille) + 999) / 1000;
+    if (rank == 0) {
+        rank = 1;
+    }
+    quint64 count = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        count += histogram[i];
+        if (count >= rank) {
+            return static_cast<int>(i);
+        }
+    }
+    return kLatencyBuckets - 1;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
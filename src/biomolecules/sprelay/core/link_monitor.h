@@ -0,0 +1,112 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      link_monitor.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LinkMonitor class which collects live statistics of
+ *            the card link.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_LINK_MONITOR_H_
+#define BIOMOLECULES_SPRELAY_CORE_LINK_MONITOR_H_
+
+#include <array>
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Collects link statistics in the K8090 thread and provides their lock-free snapshots to other threads.
+/// \headerfile ""
+class LinkMonitor
+{
+public:
+    static const int kLatencyBuckets = 512;
+
+    LinkMonitor();
+    LinkMonitor(const LinkMonitor&) = delete;
+    LinkMonitor& operator=(const LinkMonitor&) = delete;
+
+    void commandEnqueued(bool merged, int queue_depth);
+    void commandDequeued(int queue_depth);
+    void commandSent(int command_delay);
+    qint64 elapsedSinceSent() const;
+    void recordLatency(qint64 latency);
+    void commandFailed();
+    void clearQueue();
+    void setCoalescingWindow(int window);
+    void coalescingWindowOpened(int window);
+    void setDwellStatistics(quint32 suppressed_transitions, quint32 saved_commands);
+    void wakeup();
+    void replyConfirmed();
+    void unsolicitedStatus();
+    void reset();
+
+    quint32 sentCommands() const { return sent_commands_.load(std::memory_order_relaxed); }
+    quint32 failures() const { return failures_.load(std::memory_order_relaxed); }
+    LinkStatistics snapshot() const;
+
+private:
+    static int percentile(const std::array<quint32, kLatencyBuckets>& histogram, quint32 samples, int permille);
+
+    std::atomic<int> queue_depth_;
+    std::atomic<quint32> enqueued_commands_;
+    std::atomic<quint32> merged_commands_;
+    std::atomic<quint32> sent_commands_;
+    std::atomic<quint32> failures_;
+    std::atomic<int> command_delay_;
+    std::array<std::atomic<quint32>, kLatencyBuckets> latency_histogram_;
+    std::atomic<int> coalescing_window_;
+    std::atomic<quint32> coalesced_bursts_;
+    std::atomic<quint32> dwell_suppressed_transitions_;
+    std::atomic<quint32> dwell_saved_commands_;
+    std::atomic<quint32> wakeups_;
+    std::atomic<quint32> confirmed_replies_;
+    std::atomic<quint32> unsolicited_statuses_;
+    QElapsedTimer sent_timer_;  // used only in the K8090 thread
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_LINK_MONITOR_H_
@@ -0,0 +1,151 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      log_buffer.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LogBuffer class which passes log records from one thread
+ *            to the log writer.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "log_buffer.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class LogBuffer
+ *
+ * The buffer is a ring of records with power of two capacity and the same monotonic read and write positions as
+ * SpscByteChannel. Logger creates one buffer for each logging thread, so the thread is the only producer and the
+ * writer thread of the logger is the only consumer. Logging is then only a copy of the record and a release store
+ * without any lock, so it doesn't stall the logging thread even when the writer is busy with the file.
+ *
+ * \remark thread-safe for one producer and one consumer
+ */
+
+
+/*!
+ * \brief Constructor.
+ * \param capacity Requested capacity in records. It is rounded up to the nearest power of two.
+ */
+LogBuffer::LogBuffer(std::size_t capacity)
+    : mask_{roundUpToPowerOfTwo(capacity) - 1},
+      buffer_{new LogRecord[mask_ + 1]},
+      head_{0},
+      tail_{0}
+{}
+
+
+/*!
+ * \fn std::size_t LogBuffer::capacity() const
+ * \brief The maximum number of records stored in the buffer.
+ */
+
+/*!
+ * \fn bool LogBuffer::empty() const
+ * \brief Tests if there are no records to read.
+ *
+ * The result is exact only when called from the producer or the consumer thread, otherwise it is a snapshot.
+ */
+
+
+/*!
+ * \brief The number of records waiting to be read.
+ *
+ * The result is exact only when called from the producer or the consumer thread, otherwise it is a snapshot.
+ *
+ * \return The number of records.
+ */
+std::size_t LogBuffer::size() const
+{
+    std::size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+}
+
+
+/*!
+ * \brief Appends the record.
+ *
+ * Only the producer thread can call this method.
+ *
+ * \param record The record.
+ * \return False if the buffer is full and the record was dropped.
+ */
+bool LogBuffer::push(const LogRecord& record)
+{
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == capacity()) {
+        return false;
+    }
+    buffer_[tail & mask_] = record;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+/*!
+ * \brief Moves all records available in the buffer to the end of the vector.
+ *
+ * Only the consumer thread can call this method.
+ *
+ * \param records The vector.
+ * \return The number of moved records.
+ */
+std::size_t LogBuffer::readAll(std::vector<LogRecord>* records)
+{
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    for (std::size_t i = head; i != tail; ++i) {
+        records->push_back(buffer_[i & mask_]);
+    }
+    head_.store(tail, std::memory_order_release);
+    return tail - head;
+}
+
+
+// returns the smallest power of two which is not less than the value
+std::size_t LogBuffer::roundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1u;
+    }
+    return result;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
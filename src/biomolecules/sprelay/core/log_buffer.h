@@ -0,0 +1,88 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      log_buffer.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LogBuffer class which passes log records from one thread
+ *            to the log writer.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_LOG_BUFFER_H_
+#define BIOMOLECULES_SPRELAY_CORE_LOG_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Bounded lock-free single-producer single-consumer queue of log records.
+/// \headerfile ""
+class LogBuffer
+{
+public:
+    explicit LogBuffer(std::size_t capacity);
+    LogBuffer(const LogBuffer&) = delete;
+    LogBuffer(LogBuffer&&) = delete;
+    LogBuffer& operator=(const LogBuffer&) = delete;
+    LogBuffer& operator=(LogBuffer&&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    bool push(const LogRecord& record);
+    std::size_t readAll(std::vector<LogRecord>* records);
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t value);
+
+    const std::size_t mask_;
+    std::unique_ptr<LogRecord[]> buffer_;
+    std::atomic<std::size_t> head_;  // next record to read, advanced by the consumer only
+    std::atomic<std::size_t> tail_;  // next record to write, advanced by the producer only
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_LOG_BUFFER_H_
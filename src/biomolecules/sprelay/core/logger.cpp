@@ -0,0 +1,389 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      logger.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::Logger class which writes log records in a background thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "logger.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QTextStream>
+#include <QWaitCondition>
+
+#include "log_buffer.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+// source of unique logger ids, which pair the thread buffers with their loggers
+std::atomic<quint64> next_logger_id{0};
+
+// buffers of the current thread paired with the ids of their loggers
+thread_local std::vector<std::pair<quint64, std::shared_ptr<impl_::LogBuffer>>> thread_buffers;
+
+QString levelName(LogLevel level)
+{
+    static const char* const names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "NONE"};
+    return QString::fromLatin1(names[as_number(level)]);
+}
+
+QString eventName(LogEvent event)
+{
+    static const char* const names[] = {"Connected", "ConnectionFailed", "Disconnected", "CommandFailed",
+        "InvalidResponse", "UnexpectedResponse", "ProtocolError", "Resync", "CommandMerged", "RecordsDropped"};
+    return QString::fromLatin1(names[as_number(event)]);
+}
+
+QString commandName(CommandID command)
+{
+    static const char* const names[] = {"RelayOn", "RelayOff", "ToggleRelay", "QueryRelay", "SetButtonMode",
+        "ButtonMode", "StartTimer", "SetTimer", "Timer", "ResetFactoryDefaults", "JumperStatus", "FirmwareVersion",
+        "None"};
+    return QString::fromLatin1(names[as_number(command)]);
+}
+
+}  // unnamed namespace
+
+/*!
+ * \def SPRELAY_LOG_LEVEL
+ * \ingroup group_biomolecules_sprelay_core_public
+ * \brief The lowest LogLevel as a number, which is compiled in.
+ *
+ * The library is compiled with the value of the `SPRELAY_LOG_LEVEL` CMake cache variable, which defaults to
+ * LogLevel::Info. The logging calls in the library below this level are removed by the compiler, see
+ * Logger::isCompiledIn(). The value is a part of the interface of the `sprelay_globals` CMake target, so the code
+ * linked to the library sees the same value in the inline functions of the public headers.
+ */
+
+
+/*!
+ * \class Logger
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * Each thread logging through the logger gets its own lock-free LogBuffer at its first record, so Logger::log() only
+ * copies the record to the buffer and no lock is shared by the logging threads. The first record after the buffers
+ * are drained wakes the writer thread up. The writer then waits for the flush interval, so the whole burst of records
+ * is collected, merges the records of all threads by time and passes them to the sink. When no record is logged, the
+ * writer sleeps without any timer.
+ *
+ * The levels are filtered twice. The levels below SPRELAY_LOG_LEVEL are removed at compile time and the levels below
+ * Logger::level() are skipped at run time by a single relaxed atomic load. If the writer can't keep up and the buffer
+ * of a thread is full, the new records of the thread are dropped and reported by LogEvent::RecordsDropped record.
+ *
+ * The logger is usually shared by several cards:
+ *
+ * \code
+ * using biomolecules::sprelay::core::k8090::Logger;
+ * std::shared_ptr<Logger> logger = Logger::createFileLogger("sprelay.log");
+ * first_card->setLogger(logger);
+ * second_card->setLogger(logger);
+ * \endcode
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Default interval in ms, during which the writer collects the records before it passes them to the sink.
+ */
+const int Logger::kDefaultFlushInterval = 100;
+
+/*!
+ * \brief Default capacity of the buffer of one thread in records.
+ */
+const std::size_t Logger::kDefaultBufferCapacity = 1024;
+
+
+/*!
+ * \brief Constructs the logger and starts its writer thread.
+ * \param sink The receiver of the records.
+ * \param level The lowest logged level.
+ * \param flush_interval_msec The interval in ms, during which the writer collects the records of a burst.
+ * \param buffer_capacity The capacity of the buffer of one thread in records.
+ */
+Logger::Logger(Sink sink, LogLevel level, int flush_interval_msec, std::size_t buffer_capacity)
+    : id_{next_logger_id.fetch_add(1)},
+      sink_{std::move(sink)},
+      flush_interval_{std::max(flush_interval_msec, 0)},
+      buffer_capacity_{std::max<std::size_t>(buffer_capacity, 1)},
+      level_{level},
+      pending_{false},
+      dropped_{0},
+      reported_dropped_{0},
+      buffers_mutex_{new QMutex},
+      stopping_{false},
+      flush_requests_{0},
+      flushed_requests_{0},
+      writer_mutex_{new QMutex},
+      writer_condition_{new QWaitCondition},
+      flushed_condition_{new QWaitCondition}
+{
+    writer_ = std::thread{&Logger::run, this};
+}
+
+
+/*!
+ * \brief Destructor.
+ *
+ * Passes the remaining records to the sink and stops the writer thread.
+ */
+Logger::~Logger()
+{
+    {
+        QMutexLocker writer_locker{writer_mutex_.get()};
+        stopping_ = true;
+        writer_condition_->wakeOne();
+    }
+    writer_.join();
+}
+
+
+/*!
+ * \brief Creates the logger, which appends the records as text lines to the file, see Logger::format().
+ * \param file_name The file name.
+ * \param level The lowest logged level.
+ * \return The logger or nullptr, if the file can't be opened.
+ */
+std::shared_ptr<Logger> Logger::createFileLogger(const QString& file_name, LogLevel level)
+{
+    auto file = std::make_shared<QFile>(file_name);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return nullptr;
+    }
+    // the file is used only from the writer thread
+    return std::make_shared<Logger>(
+        [file](const std::vector<LogRecord>& records) {
+            QTextStream stream{file.get()};
+            for (const LogRecord& record : records) {
+                stream << format(record) << '\n';
+            }
+            stream.flush();
+            file->flush();
+        },
+        level);
+}
+
+
+/*!
+ * \fn constexpr bool Logger::isCompiledIn(LogLevel level)
+ * \brief Tests if the level is not removed at compile time, see SPRELAY_LOG_LEVEL.
+ */
+
+
+/*!
+ * \brief Formats the record as one line of text.
+ *
+ * The line contains the local time, the level, the event and the related command, relays and value, e.g.
+ * `2026-10-18T10:15:02.125 WARNING CommandFailed command=RelayOn relays=0x03 value=2`.
+ *
+ * \param record The record.
+ * \return The line without the line break.
+ */
+QString Logger::format(const LogRecord& record)
+{
+    QString line = QString("%1 %2 %3")
+                       .arg(QDateTime::fromMSecsSinceEpoch(record.time).toString("yyyy-MM-dd'T'hh:mm:ss.zzz"),
+                           levelName(record.level), eventName(record.event));
+    if (record.command != CommandID::None) {
+        line += QString(" command=%1").arg(commandName(record.command));
+    }
+    if (record.relays != RelayID::None) {
+        line += QString(" relays=0x%1").arg(static_cast<unsigned int>(as_number(record.relays)), 2, 16, QChar('0'));
+    }
+    line += QString(" value=%1").arg(record.value);
+    return line;
+}
+
+
+/*!
+ * \fn LogLevel Logger::level() const
+ * \brief The lowest logged level.
+ */
+
+/*!
+ * \fn bool Logger::isEnabled(LogLevel level) const
+ * \brief Tests if the records of the level are logged.
+ */
+
+/*!
+ * \fn quint64 Logger::droppedRecords() const
+ * \brief The number of records dropped, because the buffer of their thread was full.
+ */
+
+
+/*!
+ * \brief Sets the lowest logged level.
+ *
+ * The levels removed at compile time by SPRELAY_LOG_LEVEL can't be enabled.
+ *
+ * \param level The level.
+ */
+void Logger::setLevel(LogLevel level)
+{
+    level_.store(level, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \brief Logs the event.
+ *
+ * The record is only stored to the buffer of the calling thread, the sink receives it later in the writer thread.
+ *
+ * \param level The level.
+ * \param event The event.
+ * \param command The related command.
+ * \param relays The related relays.
+ * \param value Event specific value, see LogEvent.
+ */
+void Logger::log(LogLevel level, LogEvent event, CommandID command, RelayID relays, int value)
+{
+    if (!isEnabled(level)) {
+        return;
+    }
+    if (!threadBuffer()->push(LogRecord{QDateTime::currentMSecsSinceEpoch(), level, event, command, relays, value})) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // only the first record after the drain wakes the writer up, the following records are collected with it
+    if (!pending_.exchange(true)) {
+        QMutexLocker writer_locker{writer_mutex_.get()};
+        writer_condition_->wakeOne();
+    }
+}
+
+
+/*!
+ * \brief Waits until the records logged by the calling thread are passed to the sink.
+ */
+void Logger::flush()
+{
+    QMutexLocker writer_locker{writer_mutex_.get()};
+    quint64 request = ++flush_requests_;
+    writer_condition_->wakeOne();
+    while (flushed_requests_ < request) {
+        flushed_condition_->wait(writer_mutex_.get());
+    }
+}
+
+
+// Returns the buffer of the calling thread. It is created at the first record logged by the thread.
+impl_::LogBuffer* Logger::threadBuffer()
+{
+    for (const auto& entry : thread_buffers) {
+        if (entry.first == id_) {
+            return entry.second.get();
+        }
+    }
+    // the buffers of destroyed loggers are owned only by the thread
+    thread_buffers.erase(std::remove_if(thread_buffers.begin(), thread_buffers.end(),
+                             [](const std::pair<quint64, std::shared_ptr<impl_::LogBuffer>>& entry) {
+                                 return entry.second.use_count() == 1;
+                             }),
+        thread_buffers.end());
+    auto buffer = std::make_shared<impl_::LogBuffer>(buffer_capacity_);
+    (QMutexLocker{buffers_mutex_.get()}, buffers_.push_back(buffer));
+    thread_buffers.emplace_back(id_, buffer);
+    return buffer.get();
+}
+
+
+// The loop of the writer thread. It sleeps until some record is logged, then it waits for the flush interval and
+// drains the buffers. The flush request and the destruction interrupt the waiting.
+void Logger::run()
+{
+    QMutexLocker writer_locker{writer_mutex_.get()};
+    while (true) {
+        while (!stopping_ && flush_requests_ == flushed_requests_ && !pending_.load()) {
+            writer_condition_->wait(writer_mutex_.get());
+        }
+        if (!stopping_ && flush_requests_ == flushed_requests_ && flush_interval_ > 0) {
+            writer_condition_->wait(writer_mutex_.get(), static_cast<unsigned long>(flush_interval_));
+        }
+        bool stopping = stopping_;
+        quint64 flush_requests = flush_requests_;
+        writer_locker.unlock();
+        drain();
+        writer_locker.relock();
+        flushed_requests_ = flush_requests;
+        flushed_condition_->wakeAll();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+
+// Passes the records of all thread buffers to the sink. It is called only from the writer thread.
+void Logger::drain()
+{
+    // the records logged after the reset wake the writer up again, the exchange synchronizes with the records logged
+    // before it
+    pending_.exchange(false);
+    std::vector<LogRecord> records;
+    QMutexLocker buffers_locker{buffers_mutex_.get()};
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+        // the buffer of a finished thread is owned only by the logger, so it is read for the last time
+        bool finished = it->use_count() == 1;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        (*it)->readAll(&records);
+        it = finished ? buffers_.erase(it) : it + 1;
+    }
+    buffers_locker.unlock();
+
+    quint64 dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        records.push_back(LogRecord{QDateTime::currentMSecsSinceEpoch(), LogLevel::Warning, LogEvent::RecordsDropped,
+            CommandID::None, RelayID::None, static_cast<int>(dropped - reported_dropped_)});
+        reported_dropped_ = dropped;
+    }
+    if (records.empty() || !sink_) {
+        return;
+    }
+    // the records of different threads are merged by time
+    std::stable_sort(records.begin(), records.end(),
+        [](const LogRecord& first, const LogRecord& second) { return first.time < second.time; });
+    sink_(records);
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,133 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      logger.h
+ * \brief     The biomolecules::sprelay::core::k8090::Logger class which writes log records in a background thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_LOGGER_H_
+#define BIOMOLECULES_SPRELAY_CORE_LOGGER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <QString>
+#include <QtGlobal>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_defines.h"
+
+#ifndef SPRELAY_LOG_LEVEL
+#define SPRELAY_LOG_LEVEL 1
+#endif
+
+// forward declarations
+class QMutex;
+class QWaitCondition;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+// forward declarations
+namespace impl_ {
+class LogBuffer;
+}  // namespace impl_
+
+/// The class which collects log records of many threads and passes them to a sink in a background thread, see
+/// K8090::setLogger().
+class SPRELAY_LIBRARY_EXPORT Logger
+{
+public:
+    /// Receiver of the written records, it is called in the writer thread.
+    using Sink = std::function<void(const std::vector<LogRecord>& records)>;
+
+    static const int kDefaultFlushInterval;
+    static const std::size_t kDefaultBufferCapacity;
+
+    explicit Logger(Sink sink, LogLevel level = LogLevel::Info, int flush_interval_msec = kDefaultFlushInterval,
+        std::size_t buffer_capacity = kDefaultBufferCapacity);
+    Logger(const Logger&) = delete;
+    Logger(Logger&&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    Logger& operator=(Logger&&) = delete;
+    ~Logger();
+
+    static std::shared_ptr<Logger> createFileLogger(const QString& file_name, LogLevel level = LogLevel::Info);
+    static constexpr bool isCompiledIn(LogLevel level) { return as_number(level) >= SPRELAY_LOG_LEVEL; }
+    static QString format(const LogRecord& record);
+
+    LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+    void setLevel(LogLevel level);
+    bool isEnabled(LogLevel level) const { return isCompiledIn(level) && level >= this->level(); }
+    void log(LogLevel level, LogEvent event, CommandID command = CommandID::None, RelayID relays = RelayID::None,
+        int value = 0);
+    void flush();
+    quint64 droppedRecords() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    impl_::LogBuffer* threadBuffer();
+    void run();
+    void drain();
+
+    const quint64 id_;
+    const Sink sink_;
+    const int flush_interval_;
+    const std::size_t buffer_capacity_;
+    std::atomic<LogLevel> level_;
+    std::atomic<bool> pending_;
+    std::atomic<quint64> dropped_;
+    quint64 reported_dropped_;
+    std::vector<std::shared_ptr<impl_::LogBuffer>> buffers_;
+    std::unique_ptr<QMutex> buffers_mutex_;
+    bool stopping_;
+    quint64 flush_requests_;
+    quint64 flushed_requests_;
+    std::unique_ptr<QMutex> writer_mutex_;
+    std::unique_ptr<QWaitCondition> writer_condition_;
+    std::unique_ptr<QWaitCondition> flushed_condition_;
+    std::thread writer_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_LOGGER_H_
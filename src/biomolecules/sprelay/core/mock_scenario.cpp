@@ -0,0 +1,245 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      mock_scenario.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::MockScenario class which scripts physical interaction with the
+ *            virtual card.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "mock_scenario.h"
+
+#include <algorithm>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/*!
+ * \class MockScenario
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * The real card sends unsolicited button and relay status events when somebody presses its buttons or when a relay
+ * timer expires. The virtual card only reacts to commands, so the scenario supplies this physical interaction. It is
+ * executed by K8090::runMockScenario() and the events are interleaved with the command traffic, so it can be used to
+ * test and benchmark the card control under realistic event load. The builder methods return reference to the
+ * scenario, so they can be chained:
+ *
+ * \code
+ * using biomolecules::sprelay::core::k8090::RelayID;
+ * biomolecules::sprelay::core::k8090::MockScenario scenario;
+ * scenario.pressButtons(0, RelayID::One, 50)
+ *     .expireTimers(20, RelayID::Two)
+ *     .setJumper(100, true)
+ *     .pressButtons(120, RelayID::Three, 20)
+ *     .setJumper(150, false)
+ *     .repeat(200, 10);
+ * k8090->runMockScenario(scenario);
+ * \endcode
+ *
+ * The events are kept sorted by their time, the events with the same time are executed in the order in which they
+ * were added. The scenario is valid only if the times are not negative and the repetition period is not shorter
+ * than the scenario duration.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs empty scenario which is executed once.
+ */
+MockScenario::MockScenario() : period_{0}, repeat_count_{1}, valid_{true} {}
+
+
+/*!
+ * \brief Appends button press.
+ *
+ * The pressed buttons control the relays according to their button mode as on the real card, see
+ * K8090::setButtonMode().
+ *
+ * \param time The time of the press in ms.
+ * \param buttons The buttons.
+ * \param hold The time in ms after which the buttons are released, zero means the buttons are not released.
+ * \return Reference to the scenario.
+ */
+MockScenario& MockScenario::pressButtons(int time, RelayID buttons, int hold)
+{
+    if (hold < 0) {
+        valid_ = false;
+    }
+    append(time, ScenarioAction::PressButtons, buttons);
+    if (hold > 0) {
+        append(time + hold, ScenarioAction::ReleaseButtons, buttons);
+    }
+    return *this;
+}
+
+
+/*!
+ * \brief Appends button release.
+ * \param time The time of the release in ms.
+ * \param buttons The buttons.
+ * \return Reference to the scenario.
+ */
+MockScenario& MockScenario::releaseButtons(int time, RelayID buttons)
+{
+    return append(time, ScenarioAction::ReleaseButtons, buttons);
+}
+
+
+/*!
+ * \brief Appends jumper change.
+ *
+ * While the jumper is set, the buttons only report their status and don't control the relays. The new jumper status
+ * is reported by K8090::refreshRelaysInfo().
+ *
+ * \param time The time of the change in ms.
+ * \param on True if the jumper is set.
+ * \return Reference to the scenario.
+ */
+MockScenario& MockScenario::setJumper(int time, bool on)
+{
+    return append(time, on ? ScenarioAction::SetJumper : ScenarioAction::ClearJumper, RelayID::None);
+}
+
+
+/*!
+ * \brief Appends expiry of relay timers.
+ *
+ * The running timers of the relays expire immediately and the relays are switched off. The relays without running
+ * timer are not affected.
+ *
+ * \param time The time of the expiry in ms.
+ * \param relays The relays.
+ * \return Reference to the scenario.
+ */
+MockScenario& MockScenario::expireTimers(int time, RelayID relays)
+{
+    return append(time, ScenarioAction::ExpireTimers, relays);
+}
+
+
+/*!
+ * \brief Repeats the scenario.
+ * \param period The time in ms between starts of the repetitions, it can't be shorter than MockScenario::duration().
+ * \param count The number of executions, zero means the scenario is repeated until it is stopped.
+ * \return Reference to the scenario.
+ */
+MockScenario& MockScenario::repeat(int period, int count)
+{
+    if (period <= 0 || count < 0) {
+        valid_ = false;
+    }
+    period_ = period;
+    repeat_count_ = count;
+    return *this;
+}
+
+
+/*!
+ * \brief Tests if the scenario can be executed.
+ * \return True if the scenario is valid.
+ */
+bool MockScenario::isValid() const
+{
+    return valid_ && (repeat_count_ == 1 || period_ >= duration());
+}
+
+
+/*!
+ * \brief Tests if the scenario contains some event.
+ * \return True if the scenario is empty.
+ */
+bool MockScenario::isEmpty() const
+{
+    return events_.empty();
+}
+
+
+/*!
+ * \brief The time of the last event.
+ * \return The duration in ms.
+ */
+int MockScenario::duration() const
+{
+    return events_.empty() ? 0 : events_.back().time;
+}
+
+
+/*!
+ * \brief The time between starts of the repetitions.
+ * \return The period in ms, zero if the scenario is not repeated.
+ */
+int MockScenario::period() const
+{
+    return period_;
+}
+
+
+/*!
+ * \brief The number of executions.
+ * \return The count, zero means the scenario is repeated until it is stopped.
+ */
+int MockScenario::repeatCount() const
+{
+    return repeat_count_;
+}
+
+
+/*!
+ * \brief The events sorted by their time.
+ * \return The events.
+ */
+const std::vector<ScenarioEvent>& MockScenario::events() const
+{
+    return events_;
+}
+
+
+// inserts the event after all events with the same or lower time
+MockScenario& MockScenario::append(int time, ScenarioAction action, RelayID relays)
+{
+    if (time < 0) {
+        valid_ = false;
+    }
+    ScenarioEvent event{time, action, relays};
+    auto position = std::upper_bound(events_.begin(), events_.end(), event,
+        [](const ScenarioEvent& lhs, const ScenarioEvent& rhs) { return lhs.time < rhs.time; });
+    events_.insert(position, event);
+    return *this;
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
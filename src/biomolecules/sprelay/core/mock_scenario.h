@@ -0,0 +1,87 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      mock_scenario.h
+ * \brief     The biomolecules::sprelay::core::k8090::MockScenario class which scripts physical interaction with the
+ *            virtual card.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_MOCK_SCENARIO_H_
+#define BIOMOLECULES_SPRELAY_CORE_MOCK_SCENARIO_H_
+
+#include <vector>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/// The class which schedules button presses, jumper changes and timer expiries executed by the virtual card.
+class SPRELAY_LIBRARY_EXPORT MockScenario
+{
+public:
+    MockScenario();
+
+    MockScenario& pressButtons(int time, k8090::RelayID buttons, int hold = 0);
+    MockScenario& releaseButtons(int time, k8090::RelayID buttons);
+    MockScenario& setJumper(int time, bool on);
+    MockScenario& expireTimers(int time, k8090::RelayID relays);
+    MockScenario& repeat(int period, int count = 0);
+
+    bool isValid() const;
+    bool isEmpty() const;
+    int duration() const;
+    int period() const;
+    int repeatCount() const;
+    const std::vector<k8090::ScenarioEvent>& events() const;
+
+private:
+    MockScenario& append(int time, k8090::ScenarioAction action, k8090::RelayID relays);
+
+    std::vector<k8090::ScenarioEvent> events_;
+    int period_;
+    int repeat_count_;
+    bool valid_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_MOCK_SCENARIO_H_
@@ -37,6 +37,7 @@
 
 #include "mock_serial_port.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <random>
@@ -167,7 +168,11 @@ MockSerialPort::MockSerialPort(QObject* parent)
       active_timers_{k8090::as_number(k8090::RelayID::None)},
       jumper_status_{0},
       firmware_version_{16, 6},
-      delay_timer_mapper_{new QSignalMapper}
+      delay_timer_mapper_{new QSignalMapper},
+      scenario_period_{0},
+      scenario_repeat_count_{1},
+      scenario_cycle_{0},
+      scenario_index_{0}
 {
     std::uniform_int_distribution<int> distribution{
         std::numeric_limits<quint16>::min(), std::numeric_limits<quint16>::max()};
@@ -182,6 +187,8 @@ MockSerialPort::MockSerialPort(QObject* parent)
         this, &MockSerialPort::delayTimeout);
     response_timer_.setSingleShot(true);
     connect(&response_timer_, &QTimer::timeout, this, &MockSerialPort::addToBuffer);
+    scenario_timer_.setSingleShot(true);
+    connect(&scenario_timer_, &QTimer::timeout, this, &MockSerialPort::scenarioTimeout);
 }
 
 
@@ -300,10 +307,14 @@ bool MockSerialPort::open(QIODevice::OpenMode mode)
 
 /*!
  * \brief Closes the port.
+ *
+ * The running scenario is stopped, see MockSerialPort::runScenario().
+ *
  * \sa MockSerialPort::open()
  */
 void MockSerialPort::close()
 {
+    stopScenario();
     open_ = false;
     buffer_.clear();
 }
@@ -385,6 +396,49 @@ void MockSerialPort::clearError()
 }
 
 
+/*!
+ * \brief Runs scripted physical interaction with the card.
+ *
+ * The events simulate button presses, jumper changes and timer expiries, see k8090::MockScenario. They are executed
+ * at their times measured from the call of this method and the card sends the same unsolicited button and relay
+ * status responses as the real card, so they are interleaved with responses to the commands. The previously running
+ * scenario is stopped.
+ *
+ * \param events The events sorted by their time.
+ * \param period The time in ms between starts of the repetitions, zero means the events are executed only once.
+ * \param repeat_count The number of executions, zero means the events are repeated until the scenario is stopped.
+ * \sa MockSerialPort::stopScenario()
+ */
+void MockSerialPort::runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count)
+{
+    stopScenario();
+    if (events.empty() || period < 0 || repeat_count < 0) {
+        return;
+    }
+    scenario_events_ = events;
+    scenario_period_ = period;
+    scenario_repeat_count_ = period > 0 ? repeat_count : 1;
+    scenario_cycle_ = 0;
+    scenario_index_ = 0;
+    scenario_clock_.start();
+    scheduleScenarioEvent();
+}
+
+
+/*!
+ * \brief Stops the running scenario.
+ *
+ * The buttons stay in their current state.
+ *
+ * \sa MockSerialPort::runScenario()
+ */
+void MockSerialPort::stopScenario()
+{
+    scenario_timer_.stop();
+    scenario_events_.clear();
+}
+
+
 /*!
  * \fn MockSerialPort::readyRead()
  * \brief Emited, when some data comes through serial port.
@@ -461,6 +515,29 @@ void MockSerialPort::delayTimeout(int i)
 }
 
 
+// Executes all scenario events which are due, so the late timer doesn't shift the following events, and schedules the
+// next event.
+void MockSerialPort::scenarioTimeout()
+{
+    qint64 elapsed = scenario_clock_.elapsed();
+    while (!scenario_events_.empty()) {
+        const k8090::ScenarioEvent& event = scenario_events_[scenario_index_];
+        if (static_cast<qint64>(scenario_cycle_) * scenario_period_ + event.time > elapsed) {
+            scheduleScenarioEvent();
+            return;
+        }
+        playScenarioEvent(event);
+        if (++scenario_index_ == scenario_events_.size()) {
+            scenario_index_ = 0;
+            ++scenario_cycle_;
+            if (scenario_repeat_count_ != 0 && scenario_cycle_ >= scenario_repeat_count_) {
+                scenario_events_.clear();
+            }
+        }
+    }
+}
+
+
 // checks port parameters validity
 bool MockSerialPort::verifyPortParameters()
 {
@@ -829,6 +906,130 @@ void MockSerialPort::firmwareVersion()
     }
 }
 
+
+// simulated physical interaction //
+// ******************************* //
+// The scenario events change the card state as the physical interaction with the real card would and insert the
+// unsolicited button and relay status responses to the response queue.
+
+// starts scenario_timer_ to the time of the current scenario event
+void MockSerialPort::scheduleScenarioEvent()
+{
+    qint64 due = static_cast<qint64>(scenario_cycle_) * scenario_period_ + scenario_events_[scenario_index_].time;
+    scenario_timer_.start(static_cast<int>(std::max<qint64>(0, due - scenario_clock_.elapsed())));
+}
+
+
+// dispatches the scenario event
+void MockSerialPort::playScenarioEvent(const k8090::ScenarioEvent& event)
+{
+    switch (event.action) {
+        case k8090::ScenarioAction::PressButtons:
+            pressButtons(as_number(event.relays));
+            break;
+        case k8090::ScenarioAction::ReleaseButtons:
+            releaseButtons(as_number(event.relays));
+            break;
+        case k8090::ScenarioAction::SetJumper:
+            jumper_status_ = 1;
+            break;
+        case k8090::ScenarioAction::ClearJumper:
+            jumper_status_ = 0;
+            break;
+        case k8090::ScenarioAction::ExpireTimers:
+            expireTimers(as_number(event.relays));
+            break;
+    }
+}
+
+
+// presses the buttons, momentary buttons switch their relays on, toggle buttons toggle them and timed buttons start
+// their timers with default delay, the set jumper disables the relay control
+void MockSerialPort::pressButtons(unsigned char buttons)
+{
+    buttons &= static_cast<unsigned char>(~pressed_);
+    if (buttons == 0u) {
+        return;
+    }
+    pressed_ |= buttons;
+    storeResponse(k8090::ResponseID::ButtonStatus, pressed_, buttons, 0);
+    if (jumper_status_ != 0u) {
+        return;
+    }
+
+    unsigned char previous = on_;
+    unsigned char previous_timers = active_timers_;
+    on_ |= buttons & momentary_;
+    on_ ^= buttons & toggle_;
+    unsigned char timed = buttons & timed_;
+    for (unsigned int i = 0; i < 8; ++i) {
+        if ((timed & (1u << i)) != 0u) {
+            delay_timer_delays_[i] = default_delays_[i] * 1000;
+            delay_timers_[i].start(delay_timer_delays_[i]);
+        }
+    }
+    active_timers_ |= timed;
+    on_ |= timed;
+    if (previous != on_ || previous_timers != active_timers_) {
+        storeResponse(k8090::ResponseID::RelayStatus, previous, on_, active_timers_);
+    }
+}
+
+
+// releases the buttons, momentary buttons switch their relays off
+void MockSerialPort::releaseButtons(unsigned char buttons)
+{
+    buttons &= pressed_;
+    if (buttons == 0u) {
+        return;
+    }
+    pressed_ &= static_cast<unsigned char>(~buttons);
+    storeResponse(k8090::ResponseID::ButtonStatus, pressed_, 0, buttons);
+    if (jumper_status_ != 0u) {
+        return;
+    }
+
+    unsigned char previous = on_;
+    on_ &= static_cast<unsigned char>(~(buttons & momentary_));
+    if (previous != on_) {
+        storeResponse(k8090::ResponseID::RelayStatus, previous, on_, active_timers_);
+    }
+}
+
+
+// times out running timers of the relays immediately in one relay status event
+void MockSerialPort::expireTimers(unsigned char relays)
+{
+    relays &= active_timers_;
+    if (relays == 0u) {
+        return;
+    }
+    for (unsigned int i = 0; i < 8; ++i) {
+        if ((relays & (1u << i)) != 0u) {
+            delay_timers_[i].stop();
+        }
+    }
+    active_timers_ &= static_cast<unsigned char>(~relays);
+    unsigned char previous = on_;
+    on_ &= static_cast<unsigned char>(~relays);
+    storeResponse(k8090::ResponseID::RelayStatus, previous, on_, active_timers_);
+}
+
+
+// inserts the response to the queue with responses and starts the response timer
+void MockSerialPort::storeResponse(
+    k8090::ResponseID response_id, unsigned char param1, unsigned char param2, unsigned char param3)
+{
+    std::unique_ptr<unsigned char[]> response{new unsigned char[7]{
+        k8090::impl_::kStxByte, k8090::impl_::kResponses[as_number(response_id)], param1, param2, param3, 0,
+        k8090::impl_::kEtxByte}};
+    response[5] = k8090::impl_::check_sum(response.get(), 5);
+    stored_responses_.push(std::move(response));
+    if (!response_timer_.isActive()) {
+        response_timer_.start(getRandomDelay());
+    }
+}
+
 }  // namespace core
 }  // namespace sprelay
 }  // namespace biomolecules
@@ -39,11 +39,13 @@
 #define BIOMOLECULES_SPRELAY_CORE_MOCK_SERIAL_PORT_H_
 
 #include <array>
+#include <cstddef>
 #include <memory>
 #include <queue>
 #include <vector>
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QIODevice>
 #include <QObject>
 #include <QSerialPort>
@@ -51,6 +53,8 @@
 #include <QString>
 #include <QTimer>
 
+#include "k8090_defines.h"
+
 
 namespace biomolecules {
 namespace sprelay {
@@ -92,12 +96,16 @@ public:
     QSerialPort::SerialPortError error();
     void clearError();
 
+    void runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count);
+    void stopScenario();
+
 signals:
     void readyRead();
 
 private slots:
     void addToBuffer();
     void delayTimeout(int i);
+    void scenarioTimeout();
 
 private:
     static const int kMinResponseDelayMs_;
@@ -131,6 +139,14 @@ private:
     void jumperStatus();
     void firmwareVersion();
 
+    // simulated physical interaction
+    void scheduleScenarioEvent();
+    void playScenarioEvent(const k8090::ScenarioEvent& event);
+    void pressButtons(unsigned char buttons);
+    void releaseButtons(unsigned char buttons);
+    void expireTimers(unsigned char relays);
+    void storeResponse(k8090::ResponseID response_id, unsigned char param1, unsigned char param2, unsigned char param3);
+
     qint32 baud_rate_;
     QSerialPort::DataBits data_bits_;
     QSerialPort::Parity parity_;
@@ -157,6 +173,13 @@ private:
     std::queue<std::unique_ptr<unsigned char[]>> stored_responses_;
     QByteArray buffer_;
     QTimer response_timer_;
+    std::vector<k8090::ScenarioEvent> scenario_events_;
+    int scenario_period_;
+    int scenario_repeat_count_;
+    int scenario_cycle_;
+    std::size_t scenario_index_;
+    QElapsedTimer scenario_clock_;
+    QTimer scenario_timer_;
 };
 
 }  // namespace core
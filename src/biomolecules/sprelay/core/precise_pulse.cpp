@@ -0,0 +1,248 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      precise_pulse.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::PrecisePulse class which times latency-compensated pulses.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "precise_pulse.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class PrecisePulse
+ *
+ * The card timers have one second resolution, so shorter pulses have to be timed by the host. Each edge reaches the
+ * card one one-way latency after it is sent and the card reports the change by relay status, which comes back after
+ * another one-way latency. The pulse measures the one-way latency of its on edge as a half of the time between
+ * sending the edge and its confirmation. The switching moment of the edge is estimated as the middle of this interval
+ * and the off edge is due one one-way latency before the card should switch the relays off, i.e. the width after the
+ * on edge was sent.
+ *
+ * The achieved width is the difference of the estimated switching moments of the off and on edges. Its error
+ * includes the delay of edges, which had to wait for the line, and the difference of latencies of both edges.
+ *
+ * All times are in µs, see PrecisePulse::now().
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs idle pulse.
+ */
+PrecisePulse::PrecisePulse()
+    : phase_{PulsePhase::Idle},
+      relays_{RelayID::None},
+      width_{0},
+      on_sent_{0},
+      on_confirmed_{0},
+      off_sent_{0},
+      off_confirmed_{0},
+      one_way_latency_{0}
+{}
+
+
+/*!
+ * \brief Current time of the monotonic clock in µs.
+ * \return The time.
+ */
+qint64 PrecisePulse::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+
+/*!
+ * \brief Starts a new pulse, the on edge is then pending.
+ * \param relays The pulsed relays.
+ * \param width_msec The pulse width in ms.
+ * \return False if the other pulse is running, no relay is specified or the width is not positive.
+ */
+bool PrecisePulse::start(RelayID relays, int width_msec)
+{
+    if (isActive() || relays == RelayID::None || width_msec <= 0) {
+        return false;
+    }
+    reset();
+    phase_ = PulsePhase::OnPending;
+    relays_ = relays;
+    width_ = qint64{width_msec} * 1000;
+    return true;
+}
+
+
+/*!
+ * \brief The edge, which waits for the line.
+ * \return CommandID::RelayOn or CommandID::RelayOff or CommandID::None if no edge is waiting.
+ */
+CommandID PrecisePulse::pendingEdge() const
+{
+    switch (phase_) {
+        case PulsePhase::OnPending:
+            return CommandID::RelayOn;
+        case PulsePhase::OffPending:
+            return CommandID::RelayOff;
+        default:
+            return CommandID::None;
+    }
+}
+
+
+/*!
+ * \brief Records sending of the pending edge.
+ * \param now The current time.
+ */
+void PrecisePulse::edgeSent(qint64 now)
+{
+    if (phase_ == PulsePhase::OnPending) {
+        on_sent_ = now;
+        phase_ = PulsePhase::OnSent;
+    } else if (phase_ == PulsePhase::OffPending) {
+        off_sent_ = now;
+        phase_ = PulsePhase::OffSent;
+    }
+}
+
+
+/*!
+ * \brief Processes the relay status reported by the card.
+ *
+ * The status confirms the sent on edge, if all the pulsed relays are on, and the sent off edge, if all of them are
+ * off. Other statuses are ignored.
+ *
+ * \param current The relays, which are switched on.
+ * \param now The current time.
+ * \return The delay in µs, after which the off edge is due, if the status confirms the on edge, otherwise -1.
+ */
+qint64 PrecisePulse::relayStatus(RelayID current, qint64 now)
+{
+    if (phase_ == PulsePhase::OnSent && (current & relays_) == relays_) {
+        on_confirmed_ = now;
+        one_way_latency_ = (on_confirmed_ - on_sent_) / 2;
+        phase_ = PulsePhase::Holding;
+        return std::max(on_sent_ + width_ - now, qint64{0});
+    }
+    if (phase_ == PulsePhase::OffSent && (current & relays_) == RelayID::None) {
+        off_confirmed_ = now;
+        phase_ = PulsePhase::Finished;
+    }
+    return -1;
+}
+
+
+/*!
+ * \brief Marks the off edge as pending, when the scheduled delay elapses.
+ */
+void PrecisePulse::offDue()
+{
+    if (phase_ == PulsePhase::Holding) {
+        phase_ = PulsePhase::OffPending;
+    }
+}
+
+
+/*!
+ * \brief Stops the pulse and forgets its measurements.
+ */
+void PrecisePulse::reset()
+{
+    phase_ = PulsePhase::Idle;
+    relays_ = RelayID::None;
+    width_ = 0;
+    on_sent_ = 0;
+    on_confirmed_ = 0;
+    off_sent_ = 0;
+    off_confirmed_ = 0;
+    one_way_latency_ = 0;
+}
+
+
+/*!
+ * \fn PulsePhase PrecisePulse::phase() const
+ * \brief The phase of the pulse.
+ */
+
+/*!
+ * \fn bool PrecisePulse::isActive() const
+ * \brief Tests if the pulse is started and not finished.
+ */
+
+/*!
+ * \fn RelayID PrecisePulse::relays() const
+ * \brief The pulsed relays.
+ */
+
+/*!
+ * \fn qint64 PrecisePulse::width() const
+ * \brief The requested width in µs.
+ */
+
+/*!
+ * \fn qint64 PrecisePulse::oneWayLatency() const
+ * \brief The one-way latency in µs measured on the on edge. It is known after the on edge is confirmed.
+ */
+
+
+/*!
+ * \brief The achieved width of the finished pulse.
+ * \return The width in µs or 0 if the pulse is not finished.
+ */
+qint64 PrecisePulse::achievedWidth() const
+{
+    if (phase_ != PulsePhase::Finished) {
+        return 0;
+    }
+    // the switching moments are estimated as the middle of the sending and the confirmation of the edges
+    return (off_sent_ + off_confirmed_ - on_sent_ - on_confirmed_) / 2;
+}
+
+
+/*!
+ * \fn qint64 PrecisePulse::widthError() const
+ * \brief Difference between the achieved and the requested width in µs, meaningful only for the finished pulse.
+ */
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
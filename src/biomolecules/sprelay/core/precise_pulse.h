@@ -0,0 +1,105 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      precise_pulse.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::PrecisePulse class which times latency-compensated pulses.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_PRECISE_PULSE_H_
+#define BIOMOLECULES_SPRELAY_CORE_PRECISE_PULSE_H_
+
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// Phase of the precise pulse.
+enum struct PulsePhase : unsigned char {
+    Idle,          ///< No pulse is running.
+    OnPending,     ///< The on edge waits for the line.
+    OnSent,        ///< The on edge is sent and waits for the confirmation by relay status.
+    Holding,       ///< The relays are on and the off edge is scheduled.
+    OffPending,    ///< The off edge waits for the line.
+    OffSent,       ///< The off edge is sent and waits for the confirmation by relay status.
+    Finished       ///< Both edges are confirmed and the achieved width is known.
+};
+
+
+/// \brief Times the edges of a relay pulse and compensates the command latency.
+/// \headerfile ""
+class PrecisePulse
+{
+public:
+    PrecisePulse();
+
+    static qint64 now();
+
+    bool start(RelayID relays, int width_msec);
+    CommandID pendingEdge() const;
+    void edgeSent(qint64 now);
+    qint64 relayStatus(RelayID current, qint64 now);
+    void offDue();
+    void reset();
+
+    PulsePhase phase() const { return phase_; }
+    bool isActive() const { return phase_ != PulsePhase::Idle && phase_ != PulsePhase::Finished; }
+    RelayID relays() const { return relays_; }
+    qint64 width() const { return width_; }
+    qint64 oneWayLatency() const { return one_way_latency_; }
+    qint64 achievedWidth() const;
+    qint64 widthError() const { return achievedWidth() - width_; }
+
+private:
+    PulsePhase phase_;
+    RelayID relays_;
+    qint64 width_;
+    qint64 on_sent_;
+    qint64 on_confirmed_;
+    qint64 off_sent_;
+    qint64 off_confirmed_;
+    qint64 one_way_latency_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_PRECISE_PULSE_H_
@@ -0,0 +1,133 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      program_interpreter.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ProgramInterpreter class which executes compiled relay
+ *            programs.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "program_interpreter.h"
+
+#include <utility>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class ProgramInterpreter
+ *
+ * The interpreter is used by K8090 to execute RelayProgram in its thread. Loop instructions are resolved internally,
+ * the other instructions are returned by ProgramInterpreter::next() one by one and the caller performs them. The
+ * instruction which is currently performed is kept, so the caller can test, if the program waits for relay status.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs the interpreter.
+ * \param steps Valid compiled program, see RelayProgram::isValid().
+ */
+ProgramInterpreter::ProgramInterpreter(std::vector<ProgramStep> steps)
+    : steps_(std::move(steps)), counters_(steps_.size(), 0), program_counter_{0}, current_{nullptr}
+{}
+
+
+/*!
+ * \brief Moves to the next instruction.
+ *
+ * Loops are resolved internally, so only ProgramOpcode::Command, ProgramOpcode::WaitRelays and ProgramOpcode::Delay
+ * instructions are returned.
+ *
+ * \return The next instruction or nullptr if the program is finished.
+ */
+const ProgramStep* ProgramInterpreter::next()
+{
+    while (program_counter_ < steps_.size()) {
+        const ProgramStep& step = steps_[program_counter_];
+        if (step.opcode == ProgramOpcode::Loop) {
+            if (step.count == 0 || ++counters_[program_counter_] < step.count) {
+                program_counter_ = static_cast<std::size_t>(step.argument);
+            } else {
+                // reset the counter, so the nested loop is repeated in the next iteration of the outer loop
+                counters_[program_counter_] = 0;
+                ++program_counter_;
+            }
+            continue;
+        }
+        ++program_counter_;
+        current_ = &step;
+        return current_;
+    }
+    current_ = nullptr;
+    return current_;
+}
+
+
+/*!
+ * \brief Tests if the current instruction is ProgramOpcode::WaitRelays.
+ * \return True if the program waits for relay status.
+ */
+bool ProgramInterpreter::isWaiting() const
+{
+    return current_ != nullptr && current_->opcode == ProgramOpcode::WaitRelays;
+}
+
+
+/*!
+ * \brief Tests if the relay status satisfies the current ProgramOpcode::WaitRelays instruction.
+ * \param current Relays which are currently switched on.
+ * \return True if the program waits for relay status and the tested relays are in the required state.
+ */
+bool ProgramInterpreter::isSatisfied(RelayID current) const
+{
+    return isWaiting() && ((current ^ current_->state) & current_->relays) == RelayID::None;
+}
+
+
+/*!
+ * \brief Tests if all instructions were performed.
+ * \return True if the program is finished.
+ */
+bool ProgramInterpreter::isFinished() const
+{
+    return current_ == nullptr && program_counter_ >= steps_.size();
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,78 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      program_interpreter.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ProgramInterpreter class which executes compiled relay
+ *            programs.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_PROGRAM_INTERPRETER_H_
+#define BIOMOLECULES_SPRELAY_CORE_PROGRAM_INTERPRETER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Walks through compiled RelayProgram, resolves its loops and keeps track of the current instruction.
+/// \headerfile ""
+class ProgramInterpreter
+{
+public:
+    explicit ProgramInterpreter(std::vector<ProgramStep> steps);
+
+    const ProgramStep* next();
+    bool isWaiting() const;
+    bool isSatisfied(RelayID current) const;
+    bool isFinished() const;
+
+private:
+    std::vector<ProgramStep> steps_;
+    std::vector<int> counters_;
+    std::size_t program_counter_;
+    const ProgramStep* current_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_PROGRAM_INTERPRETER_H_
@@ -0,0 +1,216 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_policy.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueuePolicy interface and its built-in implementations.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "queue_policy.h"
+
+#include <QtGlobal>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class QueuePolicy
+ *
+ * The policy is consulted by ConcurentCommandQueue::updateOrPush() for each enqueued command. It assigns the command
+ * priority, which orders the queue together with the time stamp, see command_queue::CommandQueue, decides whether the
+ * command can be merged into a compatible pending command and whether CommandID::RelayOn and CommandID::RelayOff
+ * opposites cancel each other. Policies can be compared on recorded or generated traffic by QueueReplay.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Creates the built-in policy.
+ * \param policy The policy type.
+ * \return The policy.
+ */
+std::shared_ptr<const QueuePolicy> QueuePolicy::create(SchedulingPolicy policy)
+{
+    switch (policy) {
+        case SchedulingPolicy::Fifo:
+            return std::make_shared<FifoQueuePolicy>();
+        case SchedulingPolicy::NoMerge:
+            return std::make_shared<NoMergeQueuePolicy>();
+        case SchedulingPolicy::Priority:
+        default:
+            return std::make_shared<PriorityQueuePolicy>();
+    }
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+QueuePolicy::~QueuePolicy() = default;
+
+
+/*!
+ * \fn SchedulingPolicy QueuePolicy::type() const
+ * \brief The policy type used in reports.
+ */
+
+/*!
+ * \fn int QueuePolicy::priority(CommandID command_id, const int* priorities) const
+ * \brief Priority of a newly enqueued command.
+ * \param command_id The command id.
+ * \param priorities Card priorities indexed by CommandID, see CardDescriptor.
+ * \return The priority. Commands with higher priority are sent first, equal priorities are sent in the order of
+ *         arrival.
+ */
+
+/*!
+ * \fn bool QueuePolicy::merges(CommandID command_id) const
+ * \brief Tests if the command can be merged into a compatible pending command, see Command::isCompatible().
+ */
+
+/*!
+ * \fn bool QueuePolicy::cancelsOpposites() const
+ * \brief Tests if CommandID::RelayOn and CommandID::RelayOff commands remove their relays from pending opposites.
+ */
+
+
+/*!
+ * \class PriorityQueuePolicy
+ *
+ * It is the default policy used by K8090. Urgent commands such as relay switching overtake queries and the burst of
+ * compatible commands is sent as one command.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Card priority of the command.
+ * \param command_id The command id.
+ * \param priorities Card priorities indexed by CommandID.
+ * \return The priority.
+ */
+int PriorityQueuePolicy::priority(CommandID command_id, const int* priorities) const
+{
+    return priorities[as_number(command_id)];
+}
+
+
+/*!
+ * \brief All commands are merged.
+ * \param command_id The command id.
+ * \return True.
+ */
+bool PriorityQueuePolicy::merges(CommandID command_id) const
+{
+    Q_UNUSED(command_id)
+    return true;
+}
+
+
+/*!
+ * \class FifoQueuePolicy
+ *
+ * Commands keep the order, in which they were issued, so queries can't be starved by a stream of relay commands. The
+ * merged command keeps the position of the pending command, into which it is merged.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief All commands get the same priority.
+ * \param command_id The command id.
+ * \param priorities Card priorities indexed by CommandID, unused.
+ * \return Zero.
+ */
+int FifoQueuePolicy::priority(CommandID command_id, const int* priorities) const
+{
+    Q_UNUSED(command_id)
+    Q_UNUSED(priorities)
+    return 0;
+}
+
+
+/*!
+ * \brief All commands are merged.
+ * \param command_id The command id.
+ * \return True.
+ */
+bool FifoQueuePolicy::merges(CommandID command_id) const
+{
+    Q_UNUSED(command_id)
+    return true;
+}
+
+
+/*!
+ * \class NoMergeQueuePolicy
+ *
+ * Every issued command is sent to the card. It is the baseline, which shows the savings of merging.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Card priority of the command.
+ * \param command_id The command id.
+ * \param priorities Card priorities indexed by CommandID.
+ * \return The priority.
+ */
+int NoMergeQueuePolicy::priority(CommandID command_id, const int* priorities) const
+{
+    return priorities[as_number(command_id)];
+}
+
+
+/*!
+ * \brief No command is merged.
+ * \param command_id The command id.
+ * \return False.
+ */
+bool NoMergeQueuePolicy::merges(CommandID command_id) const
+{
+    Q_UNUSED(command_id)
+    return false;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
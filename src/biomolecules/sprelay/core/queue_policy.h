@@ -0,0 +1,114 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_policy.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueuePolicy interface and its built-in implementations.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_QUEUE_POLICY_H_
+#define BIOMOLECULES_SPRELAY_CORE_QUEUE_POLICY_H_
+
+#include <memory>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Decides how ConcurentCommandQueue merges and orders enqueued commands.
+/// \headerfile ""
+class QueuePolicy
+{
+public:
+    static std::shared_ptr<const QueuePolicy> create(SchedulingPolicy policy);
+
+    QueuePolicy() = default;
+    QueuePolicy(const QueuePolicy&) = delete;
+    QueuePolicy(QueuePolicy&&) = delete;
+    QueuePolicy& operator=(const QueuePolicy&) = delete;
+    QueuePolicy& operator=(QueuePolicy&&) = delete;
+    virtual ~QueuePolicy();
+
+    virtual SchedulingPolicy type() const = 0;
+    virtual int priority(CommandID command_id, const int* priorities) const = 0;
+    virtual bool merges(CommandID command_id) const = 0;
+    virtual bool cancelsOpposites() const = 0;
+};
+
+
+/// \brief Merges compatible commands and orders them by card priorities, see SchedulingPolicy::Priority.
+/// \headerfile ""
+class PriorityQueuePolicy : public QueuePolicy
+{
+public:
+    SchedulingPolicy type() const override { return SchedulingPolicy::Priority; }
+    int priority(CommandID command_id, const int* priorities) const override;
+    bool merges(CommandID command_id) const override;
+    bool cancelsOpposites() const override { return true; }
+};
+
+
+/// \brief Merges compatible commands and orders them by their arrival, see SchedulingPolicy::Fifo.
+/// \headerfile ""
+class FifoQueuePolicy : public QueuePolicy
+{
+public:
+    SchedulingPolicy type() const override { return SchedulingPolicy::Fifo; }
+    int priority(CommandID command_id, const int* priorities) const override;
+    bool merges(CommandID command_id) const override;
+    bool cancelsOpposites() const override { return true; }
+};
+
+
+/// \brief Orders commands by card priorities without merging them, see SchedulingPolicy::NoMerge.
+/// \headerfile ""
+class NoMergeQueuePolicy : public QueuePolicy
+{
+public:
+    SchedulingPolicy type() const override { return SchedulingPolicy::NoMerge; }
+    int priority(CommandID command_id, const int* priorities) const override;
+    bool merges(CommandID command_id) const override;
+    bool cancelsOpposites() const override { return false; }
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_QUEUE_POLICY_H_
@@ -0,0 +1,310 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_replay.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueueReplay class which compares queue policies.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "queue_replay.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include "concurent_command_queue.h"
+#include "queue_policy.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// name of the policy in reports
+const char* policy_name(SchedulingPolicy policy)
+{
+    switch (policy) {
+        case SchedulingPolicy::Priority:
+            return "priority";
+        case SchedulingPolicy::Fifo:
+            return "fifo";
+        case SchedulingPolicy::NoMerge:
+            return "no-merge";
+    }
+    return "unknown";
+}
+
+}  // namespace
+
+
+/*!
+ * \class QueueReplay
+ *
+ * The replay simulates the line of K8090. The commands of the workload are enqueued into ConcurentCommandQueue at
+ * their times and one command is taken from the queue each command delay, while the queue is not empty. The commands
+ * issued while the line is busy can be merged and reordered by the policy. Implicit queries and card responses are not
+ * simulated, so the results of different policies differ only by the queue behavior.
+ *
+ * The issued command is served by the first sent command with the same id, which covers all its relays. Issued
+ * commands, which are never served, were cancelled by opposite commands or absorbed by later commands, e.g. two
+ * toggles of the same relay, and they are counted as dropped. The fairness is Jain's index of response times, i.e. the
+ * latency plus the command delay, of the served commands. It is 1 if all commands wait equally and it decreases, when
+ * some commands are starved by others.
+ *
+ * Example of the comparison:
+ *
+ * \code
+ * QueueReplay replay{QueueReplay::generateWorkload(1000, 20, 1), 50};
+ * qDebug().noquote() << QueueReplay::report(replay.compare(
+ *     {SchedulingPolicy::Priority, SchedulingPolicy::Fifo, SchedulingPolicy::NoMerge}));
+ * \endcode
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Generates a random workload with a mix of relay switching commands and queries.
+ *
+ * The same seed generates the same workload with the same standard library, so the workload can be replayed
+ * repeatedly through different policies.
+ *
+ * \param count Number of commands.
+ * \param mean_interval Mean interval in ms between the commands.
+ * \param seed Seed of the random generator.
+ * \return The workload.
+ */
+std::vector<ReplayRequest> QueueReplay::generateWorkload(int count, int mean_interval, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    std::uniform_int_distribution<int> interval_distribution{0, 2 * std::max(mean_interval, 0)};
+    std::uniform_int_distribution<int> kind_distribution{0, 19};
+    std::uniform_int_distribution<unsigned int> relay_distribution{0, 7};
+
+    std::vector<ReplayRequest> workload;
+    workload.reserve(static_cast<std::size_t>(std::max(count, 0)));
+    int time = 0;
+    for (int i = 0; i < count; ++i) {
+        time += interval_distribution(generator);
+        RelayID relays = from_number(relay_distribution(generator)) | from_number(relay_distribution(generator));
+        int kind = kind_distribution(generator);
+        CardCommand command{CommandID::RelayOn, relays, 0, 0};
+        if (kind >= 19) {
+            command = CardCommand{CommandID::Timer, relays, 0, 0};
+        } else if (kind >= 18) {
+            command = CardCommand{CommandID::ButtonMode, RelayID::None, 0, 0};
+        } else if (kind >= 16) {
+            command = CardCommand{CommandID::QueryRelay, RelayID::None, 0, 0};
+        } else if (kind >= 14) {
+            command.id = CommandID::ToggleRelay;
+        } else if (kind >= 7) {
+            command.id = CommandID::RelayOff;
+        }
+        workload.push_back(ReplayRequest{time, command});
+    }
+    return workload;
+}
+
+
+/*!
+ * \brief Creates a workload from recorded commands, e.g. the commands recovered from the command log.
+ * \param commands The commands in the order, in which they were issued.
+ * \param interval Interval in ms between the commands.
+ * \return The workload.
+ */
+std::vector<ReplayRequest> QueueReplay::fromCommands(const std::vector<CardCommand>& commands, int interval)
+{
+    std::vector<ReplayRequest> workload;
+    workload.reserve(commands.size());
+    int time = 0;
+    for (const CardCommand& command : commands) {
+        workload.push_back(ReplayRequest{time, command});
+        time += interval;
+    }
+    return workload;
+}
+
+
+/*!
+ * \brief Formats the results as a table with one policy per row.
+ * \param results The results.
+ * \return The table.
+ */
+QString QueueReplay::report(const std::vector<ReplayResult>& results)
+{
+    QString table = QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                        .arg(QString("policy"), -10)
+                        .arg(QString("requests"), 9)
+                        .arg(QString("wire"), 9)
+                        .arg(QString("dropped"), 9)
+                        .arg(QString("mean[ms]"), 9)
+                        .arg(QString("max[ms]"), 9)
+                        .arg(QString("fairness"), 9)
+                        .arg(QString("time[ms]"), 9);
+    for (const ReplayResult& result : results) {
+        table += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                     .arg(QString::fromLatin1(policy_name(result.policy)), -10)
+                     .arg(result.requests, 9)
+                     .arg(result.wire_commands, 9)
+                     .arg(result.dropped, 9)
+                     .arg(result.mean_latency, 9, 'f', 1)
+                     .arg(result.max_latency, 9)
+                     .arg(result.fairness, 9, 'f', 3)
+                     .arg(result.duration, 9);
+    }
+    return table;
+}
+
+
+/*!
+ * \brief Constructs the replay.
+ * \param workload The workload. It is sorted by the command times.
+ * \param command_delay Delay between sent commands in ms, see K8090::setCommandDelay().
+ * \param card Descriptor of the simulated card, which provides command priorities, see card_descriptor().
+ */
+QueueReplay::QueueReplay(std::vector<ReplayRequest> workload, int command_delay, const CardDescriptor& card)
+    : workload_{std::move(workload)}, command_delay_{std::max(command_delay, 0)}, priorities_{card.priorities}
+{
+    std::stable_sort(workload_.begin(), workload_.end(),
+        [](const ReplayRequest& lhs, const ReplayRequest& rhs) { return lhs.time < rhs.time; });
+}
+
+
+/*!
+ * \fn const std::vector<ReplayRequest>& QueueReplay::workload() const
+ * \brief The replayed workload sorted by the command times.
+ */
+
+
+/*!
+ * \brief Replays the workload through the built-in policy.
+ * \param policy The policy.
+ * \return The result.
+ */
+ReplayResult QueueReplay::run(SchedulingPolicy policy) const
+{
+    return run(QueuePolicy::create(policy));
+}
+
+
+/*!
+ * \brief Replays the workload through the policy.
+ * \param policy The policy. PriorityQueuePolicy is used if it is nullptr.
+ * \return The result.
+ */
+ReplayResult QueueReplay::run(std::shared_ptr<const QueuePolicy> policy) const
+{
+    ConcurentCommandQueue queue{priorities_, std::move(policy)};
+    ReplayResult result{queue.policy()->type(), static_cast<int>(workload_.size()), 0, 0, 0.0, 0, 1.0, 0};
+
+    std::vector<std::size_t> outstanding;
+    std::vector<int> latencies;
+    latencies.reserve(workload_.size());
+    std::size_t next = 0;
+    int now = 0;
+    while (next < workload_.size() || !queue.empty()) {
+        // the idle line waits for the next command
+        if (queue.empty() && workload_[next].time > now) {
+            now = workload_[next].time;
+        }
+        for (; next < workload_.size() && workload_[next].time <= now; ++next) {
+            const CardCommand& command = workload_[next].command;
+            queue.updateOrPush(command.id, command.mask, command.param1, command.param2);
+            outstanding.push_back(next);
+        }
+
+        Command sent = queue.pop();
+        ++result.wire_commands;
+        std::size_t kept = 0;
+        for (std::size_t idx : outstanding) {
+            if (serves(sent, workload_[idx].command)) {
+                latencies.push_back(now - workload_[idx].time);
+            } else {
+                outstanding[kept++] = idx;
+            }
+        }
+        outstanding.resize(kept);
+        now += command_delay_;
+    }
+    result.duration = now;
+    result.dropped = static_cast<int>(outstanding.size());
+
+    if (!latencies.empty()) {
+        double sum = 0.0;
+        double response_sum = 0.0;
+        double response_square_sum = 0.0;
+        for (int latency : latencies) {
+            double response = latency + command_delay_;
+            sum += latency;
+            response_sum += response;
+            response_square_sum += response * response;
+            result.max_latency = std::max(result.max_latency, latency);
+        }
+        result.mean_latency = sum / latencies.size();
+        if (response_square_sum > 0.0) {
+            result.fairness = response_sum * response_sum / (latencies.size() * response_square_sum);
+        }
+    }
+    return result;
+}
+
+
+/*!
+ * \brief Replays the workload through several built-in policies.
+ * \param policies The policies.
+ * \return The results in the order of the policies.
+ */
+std::vector<ReplayResult> QueueReplay::compare(const std::vector<SchedulingPolicy>& policies) const
+{
+    std::vector<ReplayResult> results;
+    results.reserve(policies.size());
+    for (SchedulingPolicy policy : policies) {
+        results.push_back(run(policy));
+    }
+    return results;
+}
+
+
+// tests if the sent command serves the issued command
+bool QueueReplay::serves(const Command& sent, const CardCommand& request)
+{
+    return sent.id == request.id && (as_number(request.mask) & ~sent.params[0]) == 0;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
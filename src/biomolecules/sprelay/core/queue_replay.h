@@ -0,0 +1,112 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_replay.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueueReplay class which compares queue policies.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_QUEUE_REPLAY_H_
+#define BIOMOLECULES_SPRELAY_CORE_QUEUE_REPLAY_H_
+
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "card_traits.h"
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+// QueuePolicy forward declaration
+class QueuePolicy;
+
+/// One command of the replayed workload.
+struct ReplayRequest
+{
+    int time;             ///< Time in ms, when the command is issued.
+    CardCommand command;  ///< The issued command.
+};
+
+
+/// Result of the workload replay through one policy.
+struct ReplayResult
+{
+    SchedulingPolicy policy;  ///< The policy.
+    int requests;             ///< Number of issued commands.
+    int wire_commands;        ///< Number of commands sent to the card.
+    int dropped;              ///< Number of issued commands cancelled or absorbed by later commands.
+    double mean_latency;      ///< Mean time in ms between issuing and sending of the served commands.
+    int max_latency;          ///< Maximal time in ms between issuing and sending of the served commands.
+    double fairness;          ///< Jain's fairness index of response times of the served commands.
+    int duration;             ///< Time in ms, when the last command is sent and the line gets idle.
+};
+
+
+/// \brief Replays a workload through command queue policies and compares their results.
+/// \headerfile ""
+class QueueReplay
+{
+public:
+    static std::vector<ReplayRequest> generateWorkload(int count, int mean_interval, unsigned int seed);
+    static std::vector<ReplayRequest> fromCommands(const std::vector<CardCommand>& commands, int interval);
+    static QString report(const std::vector<ReplayResult>& results);
+
+    QueueReplay(std::vector<ReplayRequest> workload, int command_delay,
+        const CardDescriptor& card = card_descriptor<K8090Traits>());
+
+    const std::vector<ReplayRequest>& workload() const { return workload_; }
+    ReplayResult run(SchedulingPolicy policy) const;
+    ReplayResult run(std::shared_ptr<const QueuePolicy> policy) const;
+    std::vector<ReplayResult> compare(const std::vector<SchedulingPolicy>& policies) const;
+
+private:
+    static bool serves(const Command& sent, const CardCommand& request);
+
+    std::vector<ReplayRequest> workload_;
+    const int command_delay_;
+    const int* priorities_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_QUEUE_REPLAY_H_
@@ -0,0 +1,424 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      redundant_k8090.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::RedundantK8090 class which controls a redundant pair of cards.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "redundant_k8090.h"
+
+#include <initializer_list>
+#include <utility>
+
+#include <QTimer>
+
+#include "k8090.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/*!
+ * \class RedundantK8090
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * Critical setups can wire two cards in parallel. The class sends the commands to the active card, which is the
+ * primary card at the beginning, and keeps the standby card synchronized to the same desired relay state. The
+ * desired state follows the relay status reported by the active card, so relays switched by card buttons or timers
+ * are mirrored too. The standby card is reconciled at a low rate, see RedundantK8090::setReconciliationInterval(),
+ * each reconciliation sends at most one command to it. Relays which have to be switched on are reconciled first and
+ * relays which have to be switched off at the next reconciliation.
+ *
+ * Both cards are configured to report failure at the first missing response by default, see
+ * RedundantK8090::setMaxFailureCount(), so the failure of the active card is detected within one failure delay. The
+ * command flow is then switched to the standby card, the whole desired state is pushed to it at once and
+ * RedundantK8090::failedOver() is emitted when the card confirms the state. The failed card is not used until
+ * RedundantK8090::connectK8090() is called again.
+ *
+ * \code
+ * auto redundant_k8090 = new biomolecules::sprelay::core::k8090::RedundantK8090{this};
+ * redundant_k8090->setComPortNames("COM3", "COM4");
+ * connect(redundant_k8090, &biomolecules::sprelay::core::k8090::RedundantK8090::failedOver,
+ *     this, &MyWidget::onFailedOver);
+ * redundant_k8090->connectK8090();
+ * \endcode
+ *
+ * \remark reentrant
+ */
+
+
+// initialization of static member variables
+
+// private
+// Interval in ms between standby card reconciliations.
+const int RedundantK8090::kDefaultReconciliationInterval_ = 2000;
+// Number of consecutive missing responses tolerated by the cards before the failover.
+const int RedundantK8090::kDefaultMaxFailureCount_ = 0;
+
+
+/*!
+ * \brief Creates the pair of cards.
+ *
+ * The max failure count of both cards is set to 0, so the first missing response fails the card over. Use
+ * RedundantK8090::setMaxFailureCount() to tolerate occasional missing responses at the cost of slower failover.
+ *
+ * \param parent RedundantK8090 parent object in Qt ownership system.
+ */
+RedundantK8090::RedundantK8090(QObject* parent)
+    : QObject{parent},
+      primary_{new K8090},
+      standby_{new K8090},
+      active_{primary_.get()},
+      backup_{standby_.get()},
+      reconciliation_timer_{new QTimer},
+      desired_{RelayID::None},
+      backup_known_{false},
+      backup_relays_{RelayID::None},
+      failed_over_{false},
+      confirming_failover_{false}
+{
+    for (K8090* card : {primary_.get(), standby_.get()}) {
+        card->setMaxFailureCount(kDefaultMaxFailureCount_);
+        connect(card, &K8090::relayStatus, this, [=](RelayID previous, RelayID current, RelayID timed) {
+            this->onRelayStatus(card, previous, current, timed);
+        });
+        connect(card, &K8090::connected, this, [=]() { this->onConnected(card); });
+        connect(card, &K8090::connectionFailed, this, [=]() { this->onConnectionFailed(card); });
+    }
+    reconciliation_timer_->setInterval(kDefaultReconciliationInterval_);
+    connect(reconciliation_timer_.get(), &QTimer::timeout, this, &RedundantK8090::reconcileStandby);
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+RedundantK8090::~RedundantK8090() = default;
+
+
+/*!
+ * \brief Sets serial port names of both cards.
+ * \param primary The port of the primary card.
+ * \param standby The port of the standby card.
+ */
+void RedundantK8090::setComPortNames(const QString& primary, const QString& standby)
+{
+    primary_->setComPortName(primary);
+    standby_->setComPortName(standby);
+}
+
+
+/*!
+ * \brief Sets the interval between standby card reconciliations.
+ * \param msec The interval in ms.
+ */
+void RedundantK8090::setReconciliationInterval(int msec)
+{
+    reconciliation_timer_->setInterval(msec);
+}
+
+
+/*!
+ * \brief Sets max failure count of both cards.
+ *
+ * The active card fails over when the number of its consecutive missing responses overflows the count, see
+ * K8090::setMaxFailureCount(). The default is 0.
+ *
+ * \param count The failure count.
+ */
+void RedundantK8090::setMaxFailureCount(int count)
+{
+    primary_->setMaxFailureCount(count);
+    standby_->setMaxFailureCount(count);
+}
+
+
+/*!
+ * \brief The primary card.
+ *
+ * It can be used to configure the card, e.g. its failure delay. The card is owned by RedundantK8090.
+ */
+K8090* RedundantK8090::primaryCard()
+{
+    return primary_.get();
+}
+
+
+/*!
+ * \brief The standby card.
+ *
+ * It can be used to configure the card, e.g. its failure delay. The card is owned by RedundantK8090.
+ */
+K8090* RedundantK8090::standbyCard()
+{
+    return standby_.get();
+}
+
+
+/*!
+ * \brief The card, which currently receives the commands.
+ */
+K8090* RedundantK8090::activeCard()
+{
+    return active_;
+}
+
+
+/*!
+ * \brief Tests if the command flow was switched to the standby card.
+ */
+bool RedundantK8090::isFailedOver() const
+{
+    return failed_over_;
+}
+
+
+/*!
+ * \brief The relay state, which is kept on both cards.
+ */
+RelayID RedundantK8090::desiredRelays() const
+{
+    return desired_;
+}
+
+
+/*!
+ * \fn void RedundantK8090::relayStatus(biomolecules::sprelay::core::k8090::RelayID previous,
+ *     biomolecules::sprelay::core::k8090::RelayID current, biomolecules::sprelay::core::k8090::RelayID timed)
+ * \brief Relay status reported by the active card, see K8090::relayStatus().
+ */
+
+/*!
+ * \fn void RedundantK8090::connected()
+ * \brief Emitted when the primary card is connected.
+ */
+
+/*!
+ * \fn void RedundantK8090::connectionFailed()
+ * \brief Emitted when the active card fails and there is no connected standby card to switch to.
+ */
+
+/*!
+ * \fn void RedundantK8090::standbyFailed()
+ * \brief Emitted when the standby card fails before failover, the commands are then sent only to the active card.
+ */
+
+/*!
+ * \fn void RedundantK8090::failedOver(qint64 latency)
+ * \brief Emitted when the standby card took over the command flow and confirmed the desired relay state.
+ * \param latency Time in ms from the detection of the active card failure to the confirmation.
+ */
+
+
+/*!
+ * \brief Connects both cards.
+ *
+ * The primary card becomes the active one again if the pair failed over before.
+ */
+void RedundantK8090::connectK8090()
+{
+    reconciliation_timer_->stop();
+    active_ = primary_.get();
+    backup_ = standby_.get();
+    backup_known_ = false;
+    failed_over_ = false;
+    confirming_failover_ = false;
+    primary_->connectK8090();
+    standby_->connectK8090();
+}
+
+
+/*!
+ * \brief Disconnects both cards.
+ */
+void RedundantK8090::disconnect()
+{
+    reconciliation_timer_->stop();
+    primary_->disconnect();
+    standby_->disconnect();
+}
+
+
+/*!
+ * \brief Switches specified relays on.
+ * \param relays The relays.
+ */
+void RedundantK8090::switchRelayOn(RelayID relays)
+{
+    desired_ |= relays;
+    active_->switchRelayOn(relays);
+}
+
+
+/*!
+ * \brief Switches specified relays off.
+ * \param relays The relays.
+ */
+void RedundantK8090::switchRelayOff(RelayID relays)
+{
+    desired_ &= ~relays;
+    active_->switchRelayOff(relays);
+}
+
+
+/*!
+ * \brief Toggles specified relays.
+ * \param relays The relays.
+ */
+void RedundantK8090::toggleRelay(RelayID relays)
+{
+    desired_ ^= relays;
+    active_->toggleRelay(relays);
+}
+
+
+/*!
+ * \brief Queries relay status of the active card.
+ */
+void RedundantK8090::queryRelayStatus()
+{
+    active_->queryRelayStatus();
+}
+
+
+// private slots
+
+// Brings the standby card closer to the desired state. The relays are switched on first and off at the next
+// reconciliation, which starts from the relay status reported by the card. If the state of the card is already
+// desired, its relay status is queried, so the reconciliation sends one command at most.
+void RedundantK8090::reconcileStandby()
+{
+    if (!backup_->isConnected()) {
+        return;
+    }
+    if (!backup_known_) {
+        backup_->queryRelayStatus();
+        return;
+    }
+    RelayID on = desired_ & ~backup_relays_;
+    RelayID off = backup_relays_ & ~desired_;
+    if (on != RelayID::None) {
+        backup_->switchRelayOn(on);
+    } else if (off != RelayID::None) {
+        backup_->switchRelayOff(off);
+    } else {
+        backup_->queryRelayStatus();
+    }
+}
+
+
+// private
+
+// The desired state follows the active card. During failover, it is kept until the new active card confirms it.
+void RedundantK8090::onRelayStatus(K8090* card, RelayID previous, RelayID current, RelayID timed)
+{
+    if (card == active_) {
+        if (!confirming_failover_) {
+            desired_ = current;
+        } else if (current == desired_) {
+            confirming_failover_ = false;
+            emit failedOver(failover_clock_.elapsed());
+        }
+        emit relayStatus(previous, current, timed);
+    } else if (!failed_over_) {
+        backup_known_ = true;
+        backup_relays_ = current;
+    }
+}
+
+
+void RedundantK8090::onConnected(K8090* card)
+{
+    if (card == active_) {
+        emit connected();
+    } else {
+        backup_known_ = false;
+    }
+    if (!failed_over_ && active_->isConnected() && backup_->isConnected()) {
+        reconciliation_timer_->start();
+    }
+}
+
+
+void RedundantK8090::onConnectionFailed(K8090* card)
+{
+    if (card == active_) {
+        if (!failed_over_ && backup_->isConnected()) {
+            failOver();
+        } else {
+            reconciliation_timer_->stop();
+            emit connectionFailed();
+        }
+    } else if (!failed_over_) {
+        reconciliation_timer_->stop();
+        emit standbyFailed();
+    }
+}
+
+
+// switches the command flow to the standby card and pushes the desired state to it
+void RedundantK8090::failOver()
+{
+    failover_clock_.start();
+    reconciliation_timer_->stop();
+    // the state of unknown standby card is overwritten completely
+    RelayID known = backup_known_ ? backup_relays_ : ~desired_ & RelayID::All;
+    std::swap(active_, backup_);
+    failed_over_ = true;
+    confirming_failover_ = true;
+    backup_known_ = false;
+    pushDesiredState(active_, known);
+}
+
+
+// sends all the commands needed to switch the card from the known state to the desired one
+void RedundantK8090::pushDesiredState(K8090* card, RelayID known)
+{
+    RelayID on = desired_ & ~known;
+    RelayID off = known & ~desired_;
+    if (on != RelayID::None) {
+        card->switchRelayOn(on);
+    }
+    if (off != RelayID::None) {
+        card->switchRelayOff(off);
+    }
+    if (on == RelayID::None && off == RelayID::None) {
+        card->queryRelayStatus();
+    }
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,131 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      redundant_k8090.h
+ * \brief     The biomolecules::sprelay::core::k8090::RedundantK8090 class which controls a redundant pair of cards.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_REDUNDANT_K8090_H_
+#define BIOMOLECULES_SPRELAY_CORE_REDUNDANT_K8090_H_
+
+#include <memory>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_defines.h"
+
+// forward declarations
+class QTimer;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+// forward declarations
+class K8090;
+
+/// The class which drives two Velleman %K8090 cards wired in parallel as a primary card and a hot standby.
+class SPRELAY_LIBRARY_EXPORT RedundantK8090 : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RedundantK8090(QObject* parent = nullptr);
+    RedundantK8090(const RedundantK8090&) = delete;
+    RedundantK8090(RedundantK8090&&) = delete;
+    RedundantK8090& operator=(const RedundantK8090&) = delete;
+    RedundantK8090& operator=(RedundantK8090&&) = delete;
+    ~RedundantK8090() override;
+
+    void setComPortNames(const QString& primary, const QString& standby);
+    void setReconciliationInterval(int msec);
+    void setMaxFailureCount(int count);
+    K8090* primaryCard();
+    K8090* standbyCard();
+    K8090* activeCard();
+    bool isFailedOver() const;
+    k8090::RelayID desiredRelays() const;
+
+signals:
+    void relayStatus(biomolecules::sprelay::core::k8090::RelayID previous,
+        biomolecules::sprelay::core::k8090::RelayID current, biomolecules::sprelay::core::k8090::RelayID timed);
+    void connected();
+    void connectionFailed();
+    void standbyFailed();
+    void failedOver(qint64 latency);
+
+public slots:
+    void connectK8090();
+    void disconnect();
+    void switchRelayOn(biomolecules::sprelay::core::k8090::RelayID relays);
+    void switchRelayOff(biomolecules::sprelay::core::k8090::RelayID relays);
+    void toggleRelay(biomolecules::sprelay::core::k8090::RelayID relays);
+    void queryRelayStatus();
+
+private slots:
+    void reconcileStandby();
+
+private:
+    void onRelayStatus(K8090* card, k8090::RelayID previous, k8090::RelayID current, k8090::RelayID timed);
+    void onConnected(K8090* card);
+    void onConnectionFailed(K8090* card);
+    void failOver();
+    void pushDesiredState(K8090* card, k8090::RelayID known);
+
+    static const int kDefaultReconciliationInterval_;
+    static const int kDefaultMaxFailureCount_;
+
+    std::unique_ptr<K8090> primary_;
+    std::unique_ptr<K8090> standby_;
+    K8090* active_;
+    K8090* backup_;
+    std::unique_ptr<QTimer> reconciliation_timer_;
+    k8090::RelayID desired_;
+    bool backup_known_;
+    k8090::RelayID backup_relays_;
+    bool failed_over_;
+    bool confirming_failover_;
+    QElapsedTimer failover_clock_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_REDUNDANT_K8090_H_
@@ -0,0 +1,205 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      refresh_flight.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::RefreshFlight class which shares the card info refresh in
+ *            flight.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "refresh_flight.h"
+
+#include <utility>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class RefreshFlight
+ *
+ * It is used by K8090 to implement K8090::refreshRelaysInfo(). The refresh consists of parts marked by bits of the
+ * mask passed to RefreshFlight::request(), which are received by RefreshFlight::partReceived() in the K8090's thread.
+ * The requests made while the refresh is in flight attach their handlers to it. The handlers are called after the lock
+ * is released, so they can request another refresh. The parts received when no refresh is in flight only read an
+ * atomic.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs the state without refresh in flight.
+ * \param freshness The freshness window in ms, see RefreshFlight::setFreshness().
+ */
+RefreshFlight::RefreshFlight(int freshness) : pending_{0}, freshness_{freshness} {}
+
+
+/*!
+ * \brief Sets the freshness window.
+ *
+ * The refresh completed less than the specified time ago satisfies new requests immediately. The value 0 disables the
+ * window.
+ *
+ * \param msec The window in ms.
+ */
+void RefreshFlight::setFreshness(int msec)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    freshness_ = msec;
+}
+
+
+/*!
+ * \brief Requests the refresh.
+ *
+ * If the refresh is in flight, the handler is attached to it. If the last refresh is fresh, the handler is called
+ * immediately with true. Otherwise the refresh starts, if the card is connected, or the handler is called immediately
+ * with false.
+ *
+ * \param handler The handler, it can be empty.
+ * \param parts The mask of parts, which must be received to complete the refresh.
+ * \param connected True if the card is connected.
+ * \return True if the refresh queries should be sent, that is unless the handler was attached or the last refresh is
+ * fresh.
+ */
+bool RefreshFlight::request(Handler handler, unsigned int parts, bool connected)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (pending_.load(std::memory_order_relaxed) != 0u) {
+        if (handler) {
+            handlers_.push_back(std::move(handler));
+        }
+        return false;
+    }
+    if (freshness_ > 0 && age_.isValid() && age_.elapsed() <= freshness_) {
+        lock.unlock();
+        if (handler) {
+            handler(true);
+        }
+        return false;
+    }
+    if (connected) {
+        pending_.store(parts, std::memory_order_release);
+        if (handler) {
+            handlers_.push_back(std::move(handler));
+        }
+        return true;
+    }
+    lock.unlock();
+    if (handler) {
+        handler(false);
+    }
+    return true;
+}
+
+
+/*!
+ * \brief Tests if the refresh is in flight.
+ * \return True if the refresh is in flight.
+ */
+bool RefreshFlight::pending() const
+{
+    return pending_.load(std::memory_order_acquire) != 0u;
+}
+
+
+/*!
+ * \brief Marks the part as received and completes the refresh with true, if all its parts are received.
+ *
+ * The part can be also received as the response to some other query, it is fresh as well.
+ *
+ * \param part The bit of the received part.
+ */
+void RefreshFlight::partReceived(unsigned int part)
+{
+    if (pending_.load(std::memory_order_acquire) == 0u) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        const unsigned int pending = pending_.load(std::memory_order_relaxed);
+        if (pending == 0u || (pending & ~part) != 0u) {
+            pending_.store(pending & ~part, std::memory_order_release);
+            return;
+        }
+        age_.start();
+    }
+    finish(true);
+}
+
+
+/*!
+ * \brief Completes the refresh in flight with false.
+ */
+void RefreshFlight::fail()
+{
+    if (pending_.load(std::memory_order_acquire) == 0u) {
+        return;
+    }
+    finish(false);
+}
+
+
+/*!
+ * \brief Invalidates the last refresh, so the next request is not satisfied by the freshness window.
+ */
+void RefreshFlight::invalidate()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    age_.invalidate();
+}
+
+
+// Releases the refresh and calls the attached handlers outside the lock.
+void RefreshFlight::finish(bool completed)
+{
+    std::vector<Handler> handlers;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (!completed && pending_.load(std::memory_order_relaxed) == 0u) {
+            return;
+        }
+        pending_.store(0, std::memory_order_release);
+        handlers.swap(handlers_);
+    }
+    for (const Handler& handler : handlers) {
+        handler(completed);
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,87 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      refresh_flight.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::RefreshFlight class which shares the card info refresh in
+ *            flight.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_REFRESH_FLIGHT_H_
+#define BIOMOLECULES_SPRELAY_CORE_REFRESH_FLIGHT_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QElapsedTimer>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Thread-safe single-flight state of the card info refresh.
+/// \headerfile ""
+class RefreshFlight
+{
+public:
+    using Handler = std::function<void(bool completed)>;
+
+    explicit RefreshFlight(int freshness = 0);
+
+    void setFreshness(int msec);
+    bool request(Handler handler, unsigned int parts, bool connected);
+    bool pending() const;
+    void partReceived(unsigned int part);
+    void fail();
+    void invalidate();
+
+private:
+    void finish(bool completed);
+
+    std::atomic<unsigned int> pending_;
+    std::vector<Handler> handlers_;
+    QElapsedTimer age_;
+    int freshness_;
+    std::mutex mutex_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_REFRESH_FLIGHT_H_
@@ -0,0 +1,276 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      relay_program.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::RelayProgram class which compiles sequences of relay operations.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "relay_program.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/*!
+ * \class RelayProgram
+ * \ingroup group_biomolecules_sprelay_core_public
+ *
+ * The program is compiled into a flat sequence of ProgramStep instructions and executed by K8090::runProgram() in the
+ * thread of the K8090 object. Commands are submitted directly into the command queue, so there is no signal round
+ * trip between the steps. The builder methods return reference to the program, so they can be chained:
+ *
+ * \code
+ * using biomolecules::sprelay::core::k8090::RelayID;
+ * biomolecules::sprelay::core::k8090::RelayProgram program;
+ * program.beginLoop(3)
+ *     .switchRelayOn(RelayID::One)
+ *     .waitForRelays(RelayID::One, RelayID::One)
+ *     .startRelayTimer(RelayID::Two, 5)
+ *     .delay(500)
+ *     .switchRelayOff(RelayID::One)
+ *     .waitForRelays(RelayID::One, RelayID::None)
+ *     .endLoop();
+ * k8090->runProgram(program);
+ * \endcode
+ *
+ * The program is valid only if the loops are balanced, the delays and loop counts are not negative and each infinite
+ * loop contains some delay, so it can't block the K8090 thread.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructs empty program.
+ */
+RelayProgram::RelayProgram() : valid_{true} {}
+
+
+/*!
+ * \brief Appends switch relay on command.
+ * \param relays The relays.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::switchRelayOn(RelayID relays)
+{
+    return command(CardCommand{CommandID::RelayOn, relays, 0, 0});
+}
+
+
+/*!
+ * \brief Appends switch relay off command.
+ * \param relays The relays.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::switchRelayOff(RelayID relays)
+{
+    return command(CardCommand{CommandID::RelayOff, relays, 0, 0});
+}
+
+
+/*!
+ * \brief Appends toggle relay command.
+ * \param relays The relays.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::toggleRelay(RelayID relays)
+{
+    return command(CardCommand{CommandID::ToggleRelay, relays, 0, 0});
+}
+
+
+/*!
+ * \brief Appends set button mode command.
+ * \param momentary Buttons with momentary mode.
+ * \param toggle Buttons with toggle mode.
+ * \param timed Buttons with timed mode.
+ * \return Reference to the program.
+ * \sa K8090::setButtonMode()
+ */
+RelayProgram& RelayProgram::setButtonMode(RelayID momentary, RelayID toggle, RelayID timed)
+{
+    return command(CardCommand{CommandID::SetButtonMode, momentary, as_number(toggle), as_number(timed)});
+}
+
+
+/*!
+ * \brief Appends start relay timer command.
+ * \param relays The relays.
+ * \param delay The delay in seconds, zero means the default delay.
+ * \return Reference to the program.
+ * \sa K8090::startRelayTimer()
+ */
+RelayProgram& RelayProgram::startRelayTimer(RelayID relays, quint16 delay)
+{
+    return command(CardCommand{CommandID::StartTimer, relays, static_cast<unsigned char>(delay >> 8u),
+        static_cast<unsigned char>(delay & 0xFFu)});
+}
+
+
+/*!
+ * \brief Appends set relay timer delay command.
+ * \param relays The relays.
+ * \param delay The delay in seconds.
+ * \return Reference to the program.
+ * \sa K8090::setRelayTimerDelay()
+ */
+RelayProgram& RelayProgram::setRelayTimerDelay(RelayID relays, quint16 delay)
+{
+    return command(CardCommand{CommandID::SetTimer, relays, static_cast<unsigned char>(delay >> 8u),
+        static_cast<unsigned char>(delay & 0xFFu)});
+}
+
+
+/*!
+ * \brief Appends general command.
+ * \param command The command.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::command(const CardCommand& command)
+{
+    return append(ProgramOpcode::Command, command, RelayID::None, RelayID::None, 0, 0);
+}
+
+
+/*!
+ * \brief Appends wait until the relays are in the required state.
+ *
+ * The wait is satisfied by the last relay status received from the card. If the relays are already in the required
+ * state, the program continues immediately.
+ *
+ * \param relays The tested relays.
+ * \param state The required state, the relays included in it should be on, the other should be off.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::waitForRelays(RelayID relays, RelayID state)
+{
+    return append(ProgramOpcode::WaitRelays, CardCommand{CommandID::None, RelayID::None, 0, 0}, relays, state, 0, 0);
+}
+
+
+/*!
+ * \brief Appends delay.
+ * \param msec The delay in ms.
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::delay(int msec)
+{
+    if (msec < 0) {
+        valid_ = false;
+    }
+    return append(ProgramOpcode::Delay, CardCommand{CommandID::None, RelayID::None, 0, 0}, RelayID::None,
+        RelayID::None, msec, 0);
+}
+
+
+/*!
+ * \brief Starts loop, which ends by RelayProgram::endLoop().
+ * \param count The number of repetitions, zero means infinite loop, which can be stopped by K8090::stopProgram().
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::beginLoop(int count)
+{
+    if (count < 0) {
+        valid_ = false;
+    }
+    loop_starts_.push_back(static_cast<int>(steps_.size()));
+    // the count is stored until the loop is closed
+    loop_counts_.push_back(count);
+    return *this;
+}
+
+
+/*!
+ * \brief Ends the loop started by RelayProgram::beginLoop().
+ * \return Reference to the program.
+ */
+RelayProgram& RelayProgram::endLoop()
+{
+    if (loop_starts_.empty()) {
+        valid_ = false;
+        return *this;
+    }
+    int start = loop_starts_.back();
+    int count = loop_counts_.back();
+    loop_starts_.pop_back();
+    loop_counts_.pop_back();
+    if (count == 0) {
+        // infinite loop without delay would block the K8090 thread
+        bool has_delay = false;
+        for (std::size_t i = static_cast<std::size_t>(start); i < steps_.size(); ++i) {
+            if (steps_[i].opcode == ProgramOpcode::Delay && steps_[i].argument > 0) {
+                has_delay = true;
+                break;
+            }
+        }
+        if (!has_delay) {
+            valid_ = false;
+        }
+    }
+    return append(ProgramOpcode::Loop, CardCommand{CommandID::None, RelayID::None, 0, 0}, RelayID::None,
+        RelayID::None, start, count);
+}
+
+
+/*!
+ * \brief Tests if the program can be executed.
+ * \return True if the program is valid.
+ */
+bool RelayProgram::isValid() const
+{
+    return valid_ && loop_starts_.empty();
+}
+
+
+/*!
+ * \brief Gets the compiled program.
+ * \return The program instructions.
+ */
+const std::vector<ProgramStep>& RelayProgram::steps() const
+{
+    return steps_;
+}
+
+
+// appends one instruction
+RelayProgram& RelayProgram::append(
+    ProgramOpcode opcode, const CardCommand& command, RelayID relays, RelayID state, int argument, int count)
+{
+    steps_.push_back(ProgramStep{opcode, command, relays, state, argument, count});
+    return *this;
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
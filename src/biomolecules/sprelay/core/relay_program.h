@@ -0,0 +1,90 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      relay_program.h
+ * \brief     The biomolecules::sprelay::core::k8090::RelayProgram class which compiles sequences of relay operations.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_RELAY_PROGRAM_H_
+#define BIOMOLECULES_SPRELAY_CORE_RELAY_PROGRAM_H_
+
+#include <vector>
+
+#include <QtGlobal>
+
+#include "biomolecules/sprelay/sprelay_global.h"
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+/// The class which compiles sequence of relay operations, waits, delays and loops executed by K8090::runProgram().
+class SPRELAY_LIBRARY_EXPORT RelayProgram
+{
+public:
+    RelayProgram();
+
+    RelayProgram& switchRelayOn(k8090::RelayID relays);
+    RelayProgram& switchRelayOff(k8090::RelayID relays);
+    RelayProgram& toggleRelay(k8090::RelayID relays);
+    RelayProgram& setButtonMode(k8090::RelayID momentary, k8090::RelayID toggle, k8090::RelayID timed);
+    RelayProgram& startRelayTimer(k8090::RelayID relays, quint16 delay = 0);
+    RelayProgram& setRelayTimerDelay(k8090::RelayID relays, quint16 delay);
+    RelayProgram& command(const k8090::CardCommand& command);
+    RelayProgram& waitForRelays(k8090::RelayID relays, k8090::RelayID state);
+    RelayProgram& delay(int msec);
+    RelayProgram& beginLoop(int count = 0);
+    RelayProgram& endLoop();
+
+    bool isValid() const;
+    const std::vector<k8090::ProgramStep>& steps() const;
+
+private:
+    RelayProgram& append(k8090::ProgramOpcode opcode, const k8090::CardCommand& command, k8090::RelayID relays,
+        k8090::RelayID state, int argument, int count);
+
+    std::vector<k8090::ProgramStep> steps_;
+    std::vector<int> loop_starts_;
+    std::vector<int> loop_counts_;
+    bool valid_;
+};
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_RELAY_PROGRAM_H_
@@ -0,0 +1,123 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      response_waiters.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ResponseWaiters class which completes waiting for card
+ *            responses.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "response_waiters.h"
+
+#include <vector>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class ResponseWaiters
+ *
+ * The list is used by K8090 to implement K8090::waitForResponse(). The waiters can be added from any thread, they are
+ * completed from the K8090's thread by each response of the card. The handlers of the matched waiters are called
+ * after the lock is released, so they can add new waiters. Completing an empty list only reads an atomic flag.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs empty list.
+ */
+ResponseWaiters::ResponseWaiters() : empty_{true} {}
+
+
+/*!
+ * \brief Adds waiter.
+ * \param matcher The predicate selecting the awaited response. It is called with the list locked.
+ * \param handler The handler of the awaited response.
+ */
+void ResponseWaiters::add(Matcher matcher, Handler handler)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    waiters_.emplace_back(std::move(matcher), std::move(handler));
+    empty_.store(false, std::memory_order_release);
+}
+
+
+/*!
+ * \brief Tests if nobody waits.
+ * \return True if there are no waiters.
+ */
+bool ResponseWaiters::empty() const
+{
+    return empty_.load(std::memory_order_acquire);
+}
+
+
+/*!
+ * \brief Completes the waiters matching the event.
+ *
+ * The matched waiters are removed and their handlers are called in the order of addition. The event, the
+ * CardEvent::response of which is ResponseID::None, completes all the waiters.
+ *
+ * \param event The event.
+ */
+void ResponseWaiters::complete(const CardEvent& event)
+{
+    if (empty_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::vector<Handler> handlers;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto it = waiters_.begin(); it != waiters_.end();) {
+            if (event.response == ResponseID::None || it->first(event)) {
+                handlers.push_back(std::move(it->second));
+                it = waiters_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        empty_.store(waiters_.empty(), std::memory_order_release);
+    }
+    for (const Handler& handler : handlers) {
+        handler(event);
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
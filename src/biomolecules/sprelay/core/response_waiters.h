@@ -0,0 +1,82 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      response_waiters.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ResponseWaiters class which completes waiting for card
+ *            responses.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_RESPONSE_WAITERS_H_
+#define BIOMOLECULES_SPRELAY_CORE_RESPONSE_WAITERS_H_
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Thread-safe list of handlers waiting for card responses selected by matchers.
+/// \headerfile ""
+class ResponseWaiters
+{
+public:
+    using Matcher = std::function<bool(const CardEvent&)>;
+    using Handler = std::function<void(const CardEvent&)>;
+
+    ResponseWaiters();
+
+    void add(Matcher matcher, Handler handler);
+    bool empty() const;
+    void complete(const CardEvent& event);
+
+private:
+    std::list<std::pair<Matcher, Handler>> waiters_;
+    std::atomic<bool> empty_;
+    std::mutex mutex_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_RESPONSE_WAITERS_H_
@@ -39,6 +39,7 @@
 #ifndef BIOMOLECULES_SPRELAY_CORE_SERIAL_PORT_DEFINES_H_
 #define BIOMOLECULES_SPRELAY_CORE_SERIAL_PORT_DEFINES_H_
 
+#include <QMetaType>
 #include <QString>
 
 namespace biomolecules {
@@ -61,6 +62,9 @@ struct ComPortParams
 }  // namespace sprelay
 }  // namespace biomolecules
 
+// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+Q_DECLARE_METATYPE(biomolecules::sprelay::core::serial_utils::ComPortParams)
+
 /*!
  * \struct biomolecules::sprelay::core::serial_utils::ComPortParams
  * \ingroup group_biomolecules_sprelay_core_public
@@ -0,0 +1,171 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      spsc_byte_channel.cpp
+ * \brief     The biomolecules::sprelay::core::SpscByteChannel class which passes bytes between two threads without
+ *            locks.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "spsc_byte_channel.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+/*!
+ * \class SpscByteChannel
+ *
+ * The channel is a ring buffer with power of two capacity. The read and write positions grow monotonically and are
+ * masked only when the buffer is accessed, so the full and the empty buffer can be distinguished without a spare
+ * byte. Exactly one thread may call SpscByteChannel::write() and exactly one (possibly other) thread may call
+ * SpscByteChannel::readAll(). The producer publishes the written bytes by the release store of the write position and
+ * the consumer frees the space by the release store of the read position, so no mutex is needed.
+ *
+ * It is used by ThreadedMockSerialPort to move bytes between the thread of the host and the thread of the simulated
+ * card.
+ *
+ * \remark thread-safe for one producer and one consumer
+ */
+
+
+/*!
+ * \brief Default capacity in bytes.
+ */
+const std::size_t SpscByteChannel::kDefaultCapacity = 4096;
+
+
+/*!
+ * \brief Constructor.
+ * \param capacity Requested capacity in bytes. It is rounded up to the nearest power of two.
+ */
+SpscByteChannel::SpscByteChannel(std::size_t capacity)
+    : mask_{roundUpToPowerOfTwo(capacity) - 1},
+      buffer_{new char[mask_ + 1]},
+      head_{0},
+      tail_{0}
+{}
+
+
+/*!
+ * \fn std::size_t SpscByteChannel::capacity() const
+ * \brief The maximum number of bytes stored in the channel.
+ */
+
+/*!
+ * \fn bool SpscByteChannel::empty() const
+ * \brief Tests if there are no bytes to read.
+ *
+ * The result is exact only when called from the producer or the consumer thread, otherwise it is a snapshot.
+ */
+
+
+/*!
+ * \brief The number of bytes waiting to be read.
+ *
+ * The result is exact only when called from the producer or the consumer thread, otherwise it is a snapshot.
+ *
+ * \return The number of bytes.
+ */
+std::size_t SpscByteChannel::size() const
+{
+    std::size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+}
+
+
+/*!
+ * \brief Writes bytes to the channel.
+ *
+ * Only the producer thread can call this method. If the channel has not enough space, only the leading part of the
+ * data is written.
+ *
+ * \param data The data.
+ * \param size The size of the data.
+ * \return The number of written bytes.
+ */
+std::size_t SpscByteChannel::write(const char* data, std::size_t size)
+{
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t head = head_.load(std::memory_order_acquire);
+    std::size_t n = std::min(size, capacity() - (tail - head));
+    if (n == 0) {
+        return 0;
+    }
+    std::size_t offset = tail & mask_;
+    std::size_t first = std::min(n, capacity() - offset);
+    std::memcpy(&buffer_[offset], data, first);
+    std::memcpy(&buffer_[0], data + first, n - first);
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+
+/*!
+ * \brief Reads all bytes available in the channel.
+ *
+ * Only the consumer thread can call this method.
+ *
+ * \return The data.
+ */
+QByteArray SpscByteChannel::readAll()
+{
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    std::size_t n = tail - head;
+    if (n == 0) {
+        return QByteArray{};
+    }
+    std::size_t offset = head & mask_;
+    std::size_t first = std::min(n, capacity() - offset);
+    QByteArray data{&buffer_[offset], static_cast<int>(first)};
+    data.append(&buffer_[0], static_cast<int>(n - first));
+    head_.store(tail, std::memory_order_release);
+    return data;
+}
+
+
+// returns the smallest power of two which is not less than the value
+std::size_t SpscByteChannel::roundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1u;
+    }
+    return result;
+}
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,83 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      spsc_byte_channel.h
+ * \brief     The biomolecules::sprelay::core::SpscByteChannel class which passes bytes between two threads without
+ *            locks.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_SPSC_BYTE_CHANNEL_H_
+#define BIOMOLECULES_SPRELAY_CORE_SPSC_BYTE_CHANNEL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include <QByteArray>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+/// \brief Bounded lock-free single-producer single-consumer byte queue.
+/// \headerfile ""
+class SpscByteChannel
+{
+public:
+    static const std::size_t kDefaultCapacity;
+
+    explicit SpscByteChannel(std::size_t capacity = kDefaultCapacity);
+    SpscByteChannel(const SpscByteChannel&) = delete;
+    SpscByteChannel& operator=(const SpscByteChannel&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    std::size_t write(const char* data, std::size_t size);
+    QByteArray readAll();
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t value);
+
+    const std::size_t mask_;
+    std::unique_ptr<char[]> buffer_;
+    std::atomic<std::size_t> head_;  // next position to read, advanced by the consumer only
+    std::atomic<std::size_t> tail_;  // next position to write, advanced by the producer only
+};
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_SPSC_BYTE_CHANNEL_H_
@@ -0,0 +1,166 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      status_correlator.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::StatusCorrelator class which distinguishes relay status
+ *            replies from spontaneous relay status events.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "status_correlator.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class StatusCorrelator
+ *
+ * The card sends the relay status frame as the reply to the query and toggle commands, but also spontaneously, when a
+ * relay is switched by a physical button or by an expired timer. K8090 therefore used to wait the full command delay
+ * after these commands before it sent the next one. The correlator remembers the awaited command and classifies each
+ * status frame by its masks and timing:
+ *
+ * - The reply to CommandID::QueryRelay reports the same previous and current relays, a frame with a transition is a
+ *   spontaneous event.
+ * - The reply to CommandID::ToggleRelay changes exactly the toggled relays, a frame with other changes is a
+ *   spontaneous event. If the previous relays differ from the relays known when the command was sent, the frame can't
+ *   be confirmed.
+ * - The frame received sooner than StatusCorrelator::kMinReplyTime after the command was sent left the card before
+ *   the card could receive the command, so it can't be confirmed either.
+ *
+ * The confirmed reply lets K8090 send the next command at once, the ambiguous frame keeps the previous behaviour with
+ * the full delay and the spontaneous event doesn't complete the awaited command.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief The shortest time in ms between the sent command and its reply.
+ *
+ * The command frame alone takes more than 3 ms at 19200 Bd.
+ */
+const int StatusCorrelator::kMinReplyTime = 2;
+
+
+/*!
+ * \brief Constructs the correlator, which awaits no reply.
+ */
+StatusCorrelator::StatusCorrelator()
+    : expected_{CommandID::None},
+      mask_{RelayID::None},
+      known_relays_{RelayID::None},
+      known_{false}
+{}
+
+
+/*!
+ * \brief Remembers the sent command.
+ *
+ * Only CommandID::QueryRelay and CommandID::ToggleRelay are awaited, other commands clear the expectation.
+ *
+ * \param command The sent command.
+ * \param mask The relays of the command.
+ * \param known_relays The relays switched on, when the command was sent.
+ * \param known True if the known_relays are valid.
+ */
+void StatusCorrelator::expect(CommandID command, RelayID mask, RelayID known_relays, bool known)
+{
+    if (command != CommandID::QueryRelay && command != CommandID::ToggleRelay) {
+        clear();
+        return;
+    }
+    expected_ = command;
+    mask_ = mask;
+    known_relays_ = known_relays;
+    known_ = known;
+}
+
+
+/*!
+ * \brief Forgets the awaited command.
+ */
+void StatusCorrelator::clear()
+{
+    expected_ = CommandID::None;
+    mask_ = RelayID::None;
+    known_relays_ = RelayID::None;
+    known_ = false;
+}
+
+
+/*!
+ * \fn CommandID StatusCorrelator::expected() const
+ * \brief The awaited command or CommandID::None.
+ */
+
+
+/*!
+ * \brief Classifies the relay status frame.
+ * \param current_command The command, which is still awaiting its response. If it is not the expected command, the
+ * expectation is outdated and the frame is ambiguous.
+ * \param previous The previous relays reported by the frame.
+ * \param current The current relays reported by the frame.
+ * \param elapsed Time in ms since the command was sent.
+ * \return The origin of the frame.
+ */
+StatusOrigin StatusCorrelator::classify(
+    CommandID current_command, RelayID previous, RelayID current, qint64 elapsed) const
+{
+    if (expected_ == CommandID::None || current_command != expected_) {
+        return StatusOrigin::Ambiguous;
+    }
+    if (expected_ == CommandID::QueryRelay) {
+        if (previous != current) {
+            return StatusOrigin::Unsolicited;
+        }
+    } else {
+        if ((previous ^ current) != mask_) {
+            return StatusOrigin::Unsolicited;
+        }
+        if (known_ && previous != known_relays_) {
+            return StatusOrigin::Ambiguous;
+        }
+    }
+    if (elapsed < kMinReplyTime) {
+        return StatusOrigin::Ambiguous;
+    }
+    return StatusOrigin::Reply;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,86 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      status_correlator.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::StatusCorrelator class which distinguishes relay status
+ *            replies from spontaneous relay status events.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_STATUS_CORRELATOR_H_
+#define BIOMOLECULES_SPRELAY_CORE_STATUS_CORRELATOR_H_
+
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// Origin of relay status frame determined by StatusCorrelator.
+enum struct StatusOrigin : unsigned char {
+    Reply,       ///< The frame certainly answers the awaited command.
+    Ambiguous,   ///< The frame probably answers the awaited command, but it can't be confirmed.
+    Unsolicited  ///< The frame is a spontaneous event, the awaited reply is still to come.
+};
+
+/// \brief Classifies relay status frames as replies to the query and toggle commands or as spontaneous events.
+/// \headerfile ""
+class StatusCorrelator
+{
+public:
+    static const int kMinReplyTime;
+
+    StatusCorrelator();
+
+    void expect(CommandID command, RelayID mask, RelayID known_relays, bool known);
+    void clear();
+    CommandID expected() const { return expected_; }
+    StatusOrigin classify(CommandID current_command, RelayID previous, RelayID current, qint64 elapsed) const;
+
+private:
+    CommandID expected_;
+    RelayID mask_;
+    RelayID known_relays_;
+    bool known_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_STATUS_CORRELATOR_H_
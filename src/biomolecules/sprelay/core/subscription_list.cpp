@@ -0,0 +1,223 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      subscription_list.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::SubscriptionList class which collects event subscriptions
+ *            for dispatching.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "subscription_list.h"
+
+#include <algorithm>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class SubscriptionList
+ *
+ * The list is used by K8090 to implement K8090::subscribe(). The subscriptions are added and removed from any thread
+ * and they are collected for dispatching in the K8090's thread, which emits their signals after the lock is released.
+ * The collected subscriptions are not released until the dispatching ends, the subscriptions removed meanwhile are
+ * only deactivated and they are purged then. The dispatching without subscriptions only reads an atomic.
+ *
+ * \remark reentrant, thread-safe
+ */
+
+
+/*!
+ * \brief Constructs empty list.
+ */
+SubscriptionList::SubscriptionList() : count_{0}, dispatch_depth_{0} {}
+
+
+/*!
+ * \brief Destructor.
+ *
+ * The remaining subscriptions are deleted later from the event loops of their threads.
+ */
+SubscriptionList::~SubscriptionList()
+{
+    for (EventSubscription* subscription : subscriptions_) {
+        subscription->deleteLater();
+    }
+}
+
+
+/*!
+ * \brief Creates the subscription.
+ * \param events Subscribed event types.
+ * \param relays Subscribed relays.
+ * \return The subscription owned by the list.
+ */
+EventSubscription* SubscriptionList::add(EventType events, RelayID relays)
+{
+    auto* subscription = new EventSubscription{events, relays};
+    std::lock_guard<std::mutex> lock{mutex_};
+    subscriptions_.push_back(subscription);
+    count_.fetch_add(1, std::memory_order_release);
+    return subscription;
+}
+
+
+/*!
+ * \brief Deactivates the subscription and deletes it later from the event loop of its thread.
+ *
+ * The subscription collected by the running dispatching is released when the dispatching ends. Unknown subscriptions
+ * are ignored.
+ *
+ * \param subscription The subscription.
+ */
+void SubscriptionList::remove(EventSubscription* subscription)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto it = std::find(subscriptions_.begin(), subscriptions_.end(), subscription);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+    subscription->active_ = false;
+    if (dispatch_depth_ == 0) {
+        subscriptions_.erase(it);
+        count_.fetch_sub(1, std::memory_order_release);
+        subscription->deleteLater();
+    }
+}
+
+
+/*!
+ * \brief Collects the active subscriptions, which match the event and the changed relays.
+ *
+ * The targets reuse the storage of the previous dispatching, so the dispatching doesn't allocate. If it returns true,
+ * SubscriptionList::endDispatch() must be called after the signals are emitted.
+ *
+ * \param event The event type.
+ * \param changed The relays changed by the event.
+ * \param targets Empty vector, which receives the subscriptions.
+ * \return False if there is nothing to deliver.
+ */
+bool SubscriptionList::beginDispatch(EventType event, RelayID changed, std::vector<EventSubscription*>* targets)
+{
+    if (changed == RelayID::None || count_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock{mutex_};
+    targets->swap(targets_);
+    for (EventSubscription* subscription : subscriptions_) {
+        if (subscription->active_ && (subscription->events_ & event) != EventType::None
+            && (subscription->relays_ & changed) != RelayID::None) {
+            targets->push_back(subscription);
+        }
+    }
+    if (targets->empty()) {
+        targets->swap(targets_);
+        return false;
+    }
+    ++dispatch_depth_;
+    return true;
+}
+
+
+/*!
+ * \brief Finishes the dispatching started by SubscriptionList::beginDispatch().
+ *
+ * The subscriptions removed during the dispatching are released.
+ *
+ * \param targets The vector filled by SubscriptionList::beginDispatch().
+ */
+void SubscriptionList::endDispatch(std::vector<EventSubscription*>* targets)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    targets->clear();
+    if (targets->capacity() > targets_.capacity()) {
+        targets->swap(targets_);
+    }
+    if (--dispatch_depth_ == 0) {
+        purge();
+    }
+}
+
+
+/*!
+ * \brief Holds the subscription for replaying the last known values.
+ *
+ * The subscription can be already released, so it is not dereferenced before it is found. If it returns true,
+ * SubscriptionList::endReplay() must be called after the values are emitted.
+ *
+ * \param subscription The subscription.
+ * \return False if the subscription is not active.
+ */
+bool SubscriptionList::beginReplay(EventSubscription* subscription)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto it = std::find(subscriptions_.begin(), subscriptions_.end(), subscription);
+    if (it == subscriptions_.end() || !subscription->active_) {
+        return false;
+    }
+    ++dispatch_depth_;
+    return true;
+}
+
+
+/*!
+ * \brief Finishes the replay started by SubscriptionList::beginReplay().
+ */
+void SubscriptionList::endReplay()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (--dispatch_depth_ == 0) {
+        purge();
+    }
+}
+
+
+// Releases subscriptions removed during dispatching. It must be called with the mutex locked.
+void SubscriptionList::purge()
+{
+    for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
+        if ((*it)->active_) {
+            ++it;
+        } else {
+            (*it)->deleteLater();
+            it = subscriptions_.erase(it);
+            count_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
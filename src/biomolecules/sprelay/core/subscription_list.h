@@ -0,0 +1,87 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      subscription_list.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::SubscriptionList class which collects event subscriptions
+ *            for dispatching.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_SUBSCRIPTION_LIST_H_
+#define BIOMOLECULES_SPRELAY_CORE_SUBSCRIPTION_LIST_H_
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "event_subscription.h"
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Thread-safe list of event subscriptions, which can be cancelled during dispatching.
+/// \headerfile ""
+class SubscriptionList
+{
+public:
+    SubscriptionList();
+    ~SubscriptionList();
+
+    EventSubscription* add(EventType events, RelayID relays);
+    void remove(EventSubscription* subscription);
+    bool beginDispatch(EventType event, RelayID changed, std::vector<EventSubscription*>* targets);
+    void endDispatch(std::vector<EventSubscription*>* targets);
+    bool beginReplay(EventSubscription* subscription);
+    void endReplay();
+
+private:
+    void purge();
+
+    std::list<EventSubscription*> subscriptions_;
+    std::atomic<int> count_;
+    int dispatch_depth_;
+    std::vector<EventSubscription*> targets_;
+    std::mutex mutex_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_SUBSCRIPTION_LIST_H_
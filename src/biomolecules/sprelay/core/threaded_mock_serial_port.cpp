@@ -0,0 +1,568 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      threaded_mock_serial_port.cpp
+ * \brief     The biomolecules::sprelay::core::ThreadedMockSerialPort class which runs the simulated K8090 card on its
+ *            own thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "threaded_mock_serial_port.h"
+
+#include <utility>
+
+#include <QMetaObject>
+#include <QTimer>
+
+#include "mock_serial_port.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+/*!
+ * \struct MockCardChannels
+ *
+ * MockCardChannels::to_card is written by the host thread and read by the card thread, MockCardChannels::to_host
+ * the other way round. The pending flags coalesce wake-ups, so a burst of writes or responses is delivered by one
+ * queued call.
+ */
+
+
+/*!
+ * \class MockCardWorker
+ *
+ * The worker lives in the card thread. It creates the MockSerialPort there, so the timers of the simulated card run
+ * in the card thread too. Configuration slots are called by ThreadedMockSerialPort with blocking queued connection,
+ * the data are moved through MockCardChannels.
+ */
+
+
+// delay after which the worker tries again to deliver responses, which do not fit into full channel
+const int MockCardWorker::kRetryDelayMs_ = 1;
+
+
+/*!
+ * \brief Constructor.
+ * \param channels Channels shared with the host.
+ * \param host The object, the notifyReadyRead() slot of which is called when the responses are available.
+ */
+MockCardWorker::MockCardWorker(std::shared_ptr<MockCardChannels> channels, QObject* host)
+    : channels_{std::move(channels)}, host_{host}, retry_scheduled_{false}
+{}
+
+
+/*!
+ * \brief Destructor.
+ *
+ * Defined to enable forward declarations.
+ */
+MockCardWorker::~MockCardWorker() = default;
+
+
+/*!
+ * \brief Creates the simulated card. It has to be called in the card thread.
+ */
+void MockCardWorker::createPort()
+{
+    port_.reset(new MockSerialPort);
+    connect(port_.get(), &MockSerialPort::readyRead, this, &MockCardWorker::collectResponse);
+}
+
+
+/*!
+ * \brief Destroys the simulated card. It has to be called in the card thread.
+ */
+void MockCardWorker::destroyPort()
+{
+    port_.reset();
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setPortName().
+ * \param com_port_name The port name.
+ */
+void MockCardWorker::setPortName(const QString& com_port_name)
+{
+    port_->setPortName(com_port_name);
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setBaudRate().
+ * \param baud_rate The baud rate.
+ * \return True if successful.
+ */
+bool MockCardWorker::setBaudRate(qint32 baud_rate)
+{
+    return port_->setBaudRate(baud_rate);
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setDataBits().
+ * \param data_bits The QSerialPort::DataBits value.
+ * \return True if successful.
+ */
+bool MockCardWorker::setDataBits(int data_bits)
+{
+    return port_->setDataBits(static_cast<QSerialPort::DataBits>(data_bits));
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setParity().
+ * \param parity The QSerialPort::Parity value.
+ * \return True if successful.
+ */
+bool MockCardWorker::setParity(int parity)
+{
+    return port_->setParity(static_cast<QSerialPort::Parity>(parity));
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setStopBits().
+ * \param stop_bits The QSerialPort::StopBits value.
+ * \return True if successful.
+ */
+bool MockCardWorker::setStopBits(int stop_bits)
+{
+    return port_->setStopBits(static_cast<QSerialPort::StopBits>(stop_bits));
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::setFlowControl().
+ * \param flow_control The QSerialPort::FlowControl value.
+ * \return True if successful.
+ */
+bool MockCardWorker::setFlowControl(int flow_control)
+{
+    return port_->setFlowControl(static_cast<QSerialPort::FlowControl>(flow_control));
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::isOpen().
+ * \return True if open.
+ */
+bool MockCardWorker::isOpen()
+{
+    return port_->isOpen();
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::open().
+ * \param mode The QIODevice::OpenMode value.
+ * \return True if successful.
+ */
+bool MockCardWorker::open(int mode)
+{
+    bool result = port_->open(QIODevice::OpenMode{QFlag{mode}});
+    channels_->open.store(port_->isOpen(), std::memory_order_release);
+    return result;
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::close() and discards the bytes, which were not delivered to the card yet.
+ */
+void MockCardWorker::close()
+{
+    channels_->open.store(false, std::memory_order_release);
+    port_->close();
+    channels_->to_card.readAll();
+    pending_.clear();
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::error().
+ * \return The QSerialPort::SerialPortError value.
+ */
+int MockCardWorker::error()
+{
+    return port_->error();
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::clearError().
+ */
+void MockCardWorker::clearError()
+{
+    port_->clearError();
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::runScenario(). It has to be called in the card thread.
+ * \param events The events sorted by their time.
+ * \param period The time in ms between starts of the repetitions.
+ * \param repeat_count The number of executions.
+ */
+void MockCardWorker::runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count)
+{
+    port_->runScenario(events, period, repeat_count);
+}
+
+
+/*!
+ * \brief Calls MockSerialPort::stopScenario().
+ */
+void MockCardWorker::stopScenario()
+{
+    port_->stopScenario();
+}
+
+
+/*!
+ * \brief Moves the bytes written by the host to the simulated card.
+ */
+void MockCardWorker::transfer()
+{
+    // clear the flag before reading, so the bytes written after the read schedule a new transfer
+    channels_->transfer_pending.store(false, std::memory_order_release);
+    QByteArray data = channels_->to_card.readAll();
+    if (!data.isEmpty() && port_) {
+        port_->write(data.constData(), data.size());
+    }
+}
+
+
+// moves the responses of the simulated card to the channel for the host
+void MockCardWorker::collectResponse()
+{
+    pending_.append(port_->readAll());
+    if (!retry_scheduled_) {
+        flushToHost();
+    }
+}
+
+
+// writes as much of pending responses as possible and wakes up the host
+void MockCardWorker::flushToHost()
+{
+    retry_scheduled_ = false;
+    if (!pending_.isEmpty()) {
+        std::size_t n =
+            channels_->to_host.write(pending_.constData(), static_cast<std::size_t>(pending_.size()));
+        pending_.remove(0, static_cast<int>(n));
+        if (n != 0 && !channels_->ready_read_pending.exchange(true, std::memory_order_acq_rel)) {
+            QMetaObject::invokeMethod(host_, "notifyReadyRead", Qt::QueuedConnection);
+        }
+    }
+    if (!pending_.isEmpty()) {
+        retry_scheduled_ = true;
+        QTimer::singleShot(kRetryDelayMs_, this, SLOT(flushToHost()));
+    }
+}
+
+
+/*!
+ * \class ThreadedMockSerialPort
+ *
+ * The class has the same interface as MockSerialPort, but the simulated card is running on a dedicated thread. The
+ * bytes are passed between threads through two SpscByteChannel objects, so the data path does not take any lock and
+ * the responses are delivered asynchronously as from a real card. Configuration calls (port parameters, open, close
+ * and errors) are rare and they block until the card thread processes them.
+ *
+ * It is selected in UnifiedSerialPort by the UnifiedSerialPort::kThreadedMockPortName port name.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Constructor.
+ *
+ * Starts the card thread and creates the simulated card in it.
+ *
+ * \param parent Parent object in Qt ownership system.
+ */
+ThreadedMockSerialPort::ThreadedMockSerialPort(QObject* parent)
+    : QObject{parent},
+      channels_{std::make_shared<MockCardChannels>()},
+      worker_{new MockCardWorker{channels_, this}},
+      unflushed_{false}
+{
+    worker_->moveToThread(&thread_);
+    thread_.start();
+    QMetaObject::invokeMethod(worker_.get(), "createPort", Qt::BlockingQueuedConnection);
+}
+
+
+/*!
+ * \brief Destructor.
+ *
+ * Destroys the simulated card in its thread and stops the thread.
+ */
+ThreadedMockSerialPort::~ThreadedMockSerialPort()
+{
+    QMetaObject::invokeMethod(worker_.get(), "destroyPort", Qt::BlockingQueuedConnection);
+    thread_.quit();
+    thread_.wait();
+}
+
+
+/*!
+ * \brief Sets port name.
+ * \param com_port_name The port name.
+ */
+void ThreadedMockSerialPort::setPortName(const QString& com_port_name)
+{
+    QMetaObject::invokeMethod(
+        worker_.get(), "setPortName", Qt::BlockingQueuedConnection, Q_ARG(QString, com_port_name));
+}
+
+
+/*!
+ * \brief Sets baud rate.
+ * \param baud_rate The baud rate.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::setBaudRate(qint32 baud_rate)
+{
+    return invokeBool("setBaudRate", baud_rate);
+}
+
+
+/*!
+ * \brief Sets data bits.
+ * \param data_bits The data bits.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::setDataBits(QSerialPort::DataBits data_bits)
+{
+    return invokeBool("setDataBits", data_bits);
+}
+
+
+/*!
+ * \brief Sets parity.
+ * \param parity The parity.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::setParity(QSerialPort::Parity parity)
+{
+    return invokeBool("setParity", parity);
+}
+
+
+/*!
+ * \brief Sets stop bits.
+ * \param stop_bits The stop bits.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::setStopBits(QSerialPort::StopBits stop_bits)
+{
+    return invokeBool("setStopBits", stop_bits);
+}
+
+
+/*!
+ * \brief Sets flow control.
+ * \param flow_control The flow control.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::setFlowControl(QSerialPort::FlowControl flow_control)
+{
+    return invokeBool("setFlowControl", flow_control);
+}
+
+
+/*!
+ * \brief Tests if the port is open.
+ * \return True if open.
+ */
+bool ThreadedMockSerialPort::isOpen()
+{
+    return channels_->open.load(std::memory_order_acquire);
+}
+
+
+/*!
+ * \brief Opens the port.
+ * \param mode Open mode.
+ * \return True if successful.
+ */
+bool ThreadedMockSerialPort::open(QIODevice::OpenMode mode)
+{
+    return invokeBool("open", static_cast<int>(mode));
+}
+
+
+/*!
+ * \brief Closes the port.
+ *
+ * The data, which were not delivered yet, are discarded.
+ */
+void ThreadedMockSerialPort::close()
+{
+    QMetaObject::invokeMethod(worker_.get(), "close", Qt::BlockingQueuedConnection);
+    channels_->to_host.readAll();
+}
+
+
+/*!
+ * \brief Reads all data delivered from the card thread.
+ * \return The data.
+ * \sa ThreadedMockSerialPort::readyRead()
+ */
+QByteArray ThreadedMockSerialPort::readAll()
+{
+    return channels_->to_host.readAll();
+}
+
+
+/*!
+ * \brief Writes data to the card thread.
+ *
+ * The method only stores the data to the channel and wakes up the card thread if it was not woken up yet. If the
+ * channel is full, only its free space is written.
+ *
+ * \param data The data.
+ * \param max_size The size of data.
+ * \return The number of written bytes, which can be less than max_size, or -1 in the case of error.
+ */
+qint64 ThreadedMockSerialPort::write(const char* data, qint64 max_size)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+    std::size_t n = channels_->to_card.write(data, static_cast<std::size_t>(max_size));
+    if (n > 0) {
+        unflushed_ = true;
+    }
+    if (!channels_->transfer_pending.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(worker_.get(), "transfer", Qt::QueuedConnection);
+    }
+    return static_cast<qint64>(n);
+}
+
+
+/*!
+ * \brief Flushes the buffer.
+ *
+ * The data are handed over to the card thread in ThreadedMockSerialPort::write(), so it only reports them.
+ *
+ * \return True if any data was handed over since the last flush.
+ */
+bool ThreadedMockSerialPort::flush()
+{
+    bool flushed = unflushed_;
+    unflushed_ = false;
+    return flushed;
+}
+
+
+/*!
+ * \brief Holds the error status of the serial port.
+ * \return The error code.
+ */
+QSerialPort::SerialPortError ThreadedMockSerialPort::error()
+{
+    int result = QSerialPort::NoError;
+    QMetaObject::invokeMethod(worker_.get(), "error", Qt::BlockingQueuedConnection, Q_RETURN_ARG(int, result));
+    return static_cast<QSerialPort::SerialPortError>(result);
+}
+
+
+/*!
+ * \brief Clears error.
+ */
+void ThreadedMockSerialPort::clearError()
+{
+    QMetaObject::invokeMethod(worker_.get(), "clearError", Qt::BlockingQueuedConnection);
+}
+
+
+/*!
+ * \brief Runs scripted physical interaction with the card.
+ *
+ * The scenario is handed over to the card thread and the method returns immediately.
+ *
+ * \param events The events sorted by their time.
+ * \param period The time in ms between starts of the repetitions, zero means the events are executed only once.
+ * \param repeat_count The number of executions, zero means the events are repeated until the scenario is stopped.
+ * \sa MockSerialPort::runScenario()
+ */
+void ThreadedMockSerialPort::runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count)
+{
+    MockCardWorker* worker = worker_.get();
+    QTimer::singleShot(
+        0, worker, [worker, events, period, repeat_count] { worker->runScenario(events, period, repeat_count); });
+}
+
+
+/*!
+ * \brief Stops the running scenario.
+ */
+void ThreadedMockSerialPort::stopScenario()
+{
+    QMetaObject::invokeMethod(worker_.get(), "stopScenario", Qt::BlockingQueuedConnection);
+}
+
+
+/*!
+ * \fn ThreadedMockSerialPort::readyRead()
+ * \brief Emited, when some data comes from the card thread.
+ *
+ * The signal is emited in the thread of this object. The data can be readed with ThreadedMockSerialPort::readAll()
+ * method.
+ */
+
+
+// called from the card thread through queued connection when the responses are available
+void ThreadedMockSerialPort::notifyReadyRead()
+{
+    channels_->ready_read_pending.store(false, std::memory_order_release);
+    if (!channels_->to_host.empty()) {
+        emit readyRead();
+    }
+}
+
+
+// calls the card thread method with one int argument and bool return value and waits for the result
+bool ThreadedMockSerialPort::invokeBool(const char* method, int value)
+{
+    bool result = false;
+    QMetaObject::invokeMethod(
+        worker_.get(), method, Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, result), Q_ARG(int, value));
+    return result;
+}
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,180 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      threaded_mock_serial_port.h
+ * \brief     The biomolecules::sprelay::core::ThreadedMockSerialPort class which runs the simulated K8090 card on its
+ *            own thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_THREADED_MOCK_SERIAL_PORT_H_
+#define BIOMOLECULES_SPRELAY_CORE_THREADED_MOCK_SERIAL_PORT_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QObject>
+#include <QSerialPort>
+#include <QString>
+#include <QThread>
+
+#include "k8090_defines.h"
+#include "serial_port_utils.h"
+#include "spsc_byte_channel.h"
+
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+// forward declarations
+class MockSerialPort;
+
+
+/// \brief Byte channels and wake-up flags shared by ThreadedMockSerialPort and its card thread.
+/// \headerfile ""
+struct MockCardChannels
+{
+    MockCardChannels() : open{false}, transfer_pending{false}, ready_read_pending{false} {}
+
+    SpscByteChannel to_card;
+    SpscByteChannel to_host;
+    std::atomic<bool> open;
+    std::atomic<bool> transfer_pending;
+    std::atomic<bool> ready_read_pending;
+};
+
+
+/// \brief Owns biomolecules::sprelay::core::MockSerialPort inside the card thread of ThreadedMockSerialPort.
+/// \headerfile ""
+class MockCardWorker : public QObject
+{
+    Q_OBJECT
+public:
+    MockCardWorker(std::shared_ptr<MockCardChannels> channels, QObject* host);
+    MockCardWorker(const MockCardWorker&) = delete;
+    MockCardWorker(MockCardWorker&&) = delete;
+    MockCardWorker& operator=(const MockCardWorker&) = delete;
+    MockCardWorker& operator=(MockCardWorker&&) = delete;
+    ~MockCardWorker() override;
+
+    void runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count);
+
+public slots:
+    void createPort();
+    void destroyPort();
+    void setPortName(const QString& com_port_name);
+    bool setBaudRate(qint32 baud_rate);
+    bool setDataBits(int data_bits);
+    bool setParity(int parity);
+    bool setStopBits(int stop_bits);
+    bool setFlowControl(int flow_control);
+    bool isOpen();
+    bool open(int mode);
+    void close();
+    int error();
+    void clearError();
+    void stopScenario();
+    void transfer();
+
+private slots:
+    void collectResponse();
+    void flushToHost();
+
+private:
+    static const int kRetryDelayMs_;
+
+    std::shared_ptr<MockCardChannels> channels_;
+    QObject* host_;
+    std::unique_ptr<MockSerialPort, serial_utils::MockSerialPortDeleter> port_;
+    QByteArray pending_;
+    bool retry_scheduled_;
+};
+
+
+/// \brief Class which simulates the K8090 card on a dedicated thread, so the responses arrive asynchronously.
+/// \headerfile ""
+class ThreadedMockSerialPort : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ThreadedMockSerialPort(QObject* parent = nullptr);
+    ThreadedMockSerialPort(const ThreadedMockSerialPort&) = delete;
+    ThreadedMockSerialPort(ThreadedMockSerialPort&&) = delete;
+    ThreadedMockSerialPort& operator=(const ThreadedMockSerialPort&) = delete;
+    ThreadedMockSerialPort& operator=(ThreadedMockSerialPort&&) = delete;
+    ~ThreadedMockSerialPort() override;
+
+    void setPortName(const QString& com_port_name);
+    bool setBaudRate(qint32 baud_rate);
+    bool setDataBits(QSerialPort::DataBits data_bits);
+    bool setParity(QSerialPort::Parity parity);
+    bool setStopBits(QSerialPort::StopBits stop_bits);
+    bool setFlowControl(QSerialPort::FlowControl flow_control);
+
+    bool isOpen();
+    bool open(QIODevice::OpenMode mode);
+    void close();
+
+    QByteArray readAll();
+    qint64 write(const char* data, qint64 max_size);
+    bool flush();
+
+    QSerialPort::SerialPortError error();
+    void clearError();
+
+    void runScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count);
+    void stopScenario();
+
+signals:
+    void readyRead();
+
+private slots:
+    void notifyReadyRead();
+
+private:
+    bool invokeBool(const char* method, int value);
+
+    std::shared_ptr<MockCardChannels> channels_;
+    QThread thread_;
+    std::unique_ptr<MockCardWorker> worker_;
+    bool unflushed_;
+};
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_THREADED_MOCK_SERIAL_PORT_H_
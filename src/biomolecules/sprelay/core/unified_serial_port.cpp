@@ -44,6 +44,7 @@
 
 #include "k8090_commands.h"
 #include "mock_serial_port.h"
+#include "threaded_mock_serial_port.h"
 
 namespace biomolecules {
 namespace sprelay {
@@ -54,7 +55,9 @@ namespace core {
  * \class UnifiedSerialPort
  * The port can be switched by port name. The mock serial port is used as port with name
  * UnifiedSerialPort::kMockPortName. The mock port is added to the list of available serial ports which can be
- * obtained by the UnifiedSerialPort::availablePorts() method.
+ * obtained by the UnifiedSerialPort::availablePorts() method. The port with name
+ * UnifiedSerialPort::kThreadedMockPortName is the same simulated card running on its own thread (see
+ * ThreadedMockSerialPort), so its responses arrive asynchronously as from a real card.
  *
  * Parameters, as port name, baud rate, data bits, parity, stop bits and flow control are set to port only if some
  * port is openned. Otherwise, they are stored only for later use when the port is opened. When the port is switched
@@ -71,6 +74,12 @@ namespace core {
 const char* UnifiedSerialPort::kMockPortName = k8090::impl_::kMockPortName;
 
 
+/*!
+ * \brief The name of mock com port running the simulated card on its own thread.
+ */
+const char* UnifiedSerialPort::kThreadedMockPortName = k8090::impl_::kThreadedMockPortName;
+
+
 /*!
  * \brief Returns a list of available serial ports extended with mock serial port.
  * \return The ports list.
@@ -98,6 +107,10 @@ QList<serial_utils::ComPortParams> UnifiedSerialPort::availablePorts()
     com_port_params.product_identifier = MockSerialPort::kProductID;
     com_port_params.vendor_identifier = MockSerialPort::kVendorID;
     com_port_params_list.append(com_port_params);
+    // add threaded mock port
+    com_port_params.port_name = kThreadedMockPortName;
+    com_port_params.description = "Mock K8090 card serial port running on its own thread.";
+    com_port_params_list.append(com_port_params);
     return com_port_params_list;
 }
 
@@ -139,6 +152,8 @@ void UnifiedSerialPort::setPortName(const QString& port_name)
         serial_port_->setPortName(port_name);
     } else if (isMockImpl()) {
         mock_serial_port_->setPortName(port_name);
+    } else if (isThreadedMockImpl()) {
+        threaded_mock_serial_port_->setPortName(port_name);
     }
 }
 
@@ -159,6 +174,9 @@ bool UnifiedSerialPort::setBaudRate(qint32 baud_rate)
     if (isMockImpl()) {
         return mock_serial_port_->setBaudRate(baud_rate);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->setBaudRate(baud_rate);
+    }
     return true;
 }
 
@@ -179,6 +197,9 @@ bool UnifiedSerialPort::setDataBits(QSerialPort::DataBits data_bits)
     if (isMockImpl()) {
         return mock_serial_port_->setDataBits(data_bits);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->setDataBits(data_bits);
+    }
     return true;
 }
 
@@ -199,6 +220,9 @@ bool UnifiedSerialPort::setParity(QSerialPort::Parity parity)
     if (isMockImpl()) {
         return mock_serial_port_->setParity(parity);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->setParity(parity);
+    }
     return true;
 }
 
@@ -219,6 +243,9 @@ bool UnifiedSerialPort::setStopBits(QSerialPort::StopBits stop_bits)
     if (isMockImpl()) {
         return mock_serial_port_->setStopBits(stop_bits);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->setStopBits(stop_bits);
+    }
     return true;
 }
 
@@ -239,6 +266,9 @@ bool UnifiedSerialPort::setFlowControl(QSerialPort::FlowControl flow_control)
     if (isMockImpl()) {
         return mock_serial_port_->setFlowControl(flow_control);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->setFlowControl(flow_control);
+    }
     return true;
 }
 
@@ -256,6 +286,9 @@ bool UnifiedSerialPort::isOpen()
     if (isMockImpl()) {
         return mock_serial_port_->isOpen();
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->isOpen();
+    }
     return false;
 }
 
@@ -281,6 +314,13 @@ bool UnifiedSerialPort::open(QIODevice::OpenMode mode)
             }
             return mock_serial_port_->open(mode);
         }
+        // change to threaded mock serial port
+        if (!port_name_pristine_ && port_name_ == kThreadedMockPortName) {
+            if (!createThreadedMockPort()) {
+                return false;
+            }
+            return threaded_mock_serial_port_->open(mode);
+        }
         // change only port name
         return serial_port_->open(mode);
     }
@@ -293,6 +333,12 @@ bool UnifiedSerialPort::open(QIODevice::OpenMode mode)
         }
         return mock_serial_port_->open(mode);
     }
+    if (!port_name_pristine_ && port_name_ == kThreadedMockPortName) {
+        if (!threaded_mock_serial_port_ && !createThreadedMockPort()) {
+            return false;
+        }
+        return threaded_mock_serial_port_->open(mode);
+    }
     // creating new serial port
     if (!createSerialPort()) {
         return false;
@@ -311,6 +357,8 @@ void UnifiedSerialPort::close()
         serial_port_->close();
     } else if (isMockImpl()) {
         mock_serial_port_->close();
+    } else if (isThreadedMockImpl()) {
+        threaded_mock_serial_port_->close();
     }
 }
 
@@ -330,6 +378,9 @@ QByteArray UnifiedSerialPort::readAll()
     if (isMockImpl()) {
         return mock_serial_port_->readAll();
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->readAll();
+    }
     return QByteArray{};
 }
 
@@ -349,6 +400,9 @@ qint64 UnifiedSerialPort::write(const char* data, qint64 max_size)
     if (isMockImpl()) {
         return mock_serial_port_->write(data, max_size);
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->write(data, max_size);
+    }
     return -1;
 }
 
@@ -367,6 +421,9 @@ bool UnifiedSerialPort::flush()
     if (isMockImpl()) {
         return mock_serial_port_->flush();
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->flush();
+    }
     return false;
 }
 
@@ -384,6 +441,9 @@ QSerialPort::SerialPortError UnifiedSerialPort::error()
     if (isMockImpl()) {
         return mock_serial_port_->error();
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->error();
+    }
     return QSerialPort::NoError;
 }
 
@@ -398,14 +458,44 @@ void UnifiedSerialPort::clearError()
     if (isRealImpl()) {
         return serial_port_->clearError();
     }
+    if (isThreadedMockImpl()) {
+        return threaded_mock_serial_port_->clearError();
+    }
     return mock_serial_port_->clearError();
 }
 
 
+/*!
+ * \brief Runs scripted physical interaction with the simulated card.
+ *
+ * Empty events stop the running scenario. The real card is not affected.
+ *
+ * \param events The events sorted by their time.
+ * \param period The time in ms between starts of the repetitions, zero means the events are executed only once.
+ * \param repeat_count The number of executions, zero means the events are repeated until the scenario is stopped.
+ * \return True if the port is mock.
+ * \sa MockSerialPort::runScenario()
+ */
+bool UnifiedSerialPort::runMockScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count)
+{
+    QMutexLocker serial_port_locker{serial_port_mutex_.get()};
+    if (isMockImpl()) {
+        mock_serial_port_->runScenario(events, period, repeat_count);
+        return true;
+    }
+    if (isThreadedMockImpl()) {
+        threaded_mock_serial_port_->runScenario(events, period, repeat_count);
+        return true;
+    }
+    return false;
+}
+
+
 /*!
  * \brief Tests if the serial port is mock now.
  *
- * The port can be mock only when some port is created with UnifiedSerialPort::open() method.
+ * The port can be mock only when some port is created with UnifiedSerialPort::open() method. Both the mock port
+ * and the threaded mock port are treated as mock.
  *
  * \return True if mock.
  * \sa UnifiedSerialPort::isReal()
@@ -413,7 +503,7 @@ void UnifiedSerialPort::clearError()
 bool UnifiedSerialPort::isMock()
 {
     QMutexLocker serial_port_locker{serial_port_mutex_.get()};
-    return isMockImpl();
+    return isMockImpl() || isThreadedMockImpl();
 }
 
 
@@ -447,6 +537,13 @@ bool UnifiedSerialPort::isMockImpl()
 }
 
 
+// tests if the threaded mock port is used
+bool UnifiedSerialPort::isThreadedMockImpl()
+{
+    return threaded_mock_serial_port_ != nullptr;
+}
+
+
 // isReal() implementation
 bool UnifiedSerialPort::isRealImpl()
 {
@@ -460,6 +557,7 @@ bool UnifiedSerialPort::createSerialPort()
 {
     serial_port_.reset(new QSerialPort);
     mock_serial_port_.reset();
+    threaded_mock_serial_port_.reset();
     connect(serial_port_.get(), &QSerialPort::readyRead, this, &UnifiedSerialPort::readyRead);
     return setupPort(serial_port_.get());
 }
@@ -471,11 +569,24 @@ bool UnifiedSerialPort::createMockPort()
 {
     mock_serial_port_.reset(new MockSerialPort);
     serial_port_.reset();
+    threaded_mock_serial_port_.reset();
     connect(mock_serial_port_.get(), &MockSerialPort::readyRead, this, &UnifiedSerialPort::readyRead);
     return setupPort(mock_serial_port_.get());
 }
 
 
+// helper method which resets private variables to represent mock serial port running on its own thread
+// !!! Beare, it is not threa-safe, you have to treat thread-safety externaly !!!
+bool UnifiedSerialPort::createThreadedMockPort()
+{
+    threaded_mock_serial_port_.reset(new ThreadedMockSerialPort);
+    serial_port_.reset();
+    mock_serial_port_.reset();
+    connect(threaded_mock_serial_port_.get(), &ThreadedMockSerialPort::readyRead, this, &UnifiedSerialPort::readyRead);
+    return setupPort(threaded_mock_serial_port_.get());
+}
+
+
 // moves port parameters to the newly created one
 // !!! Beare, it is not threa-safe, you have to treat thread-safety externaly !!!
 template<typename TSerialPort>
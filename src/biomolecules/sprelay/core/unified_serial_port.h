@@ -40,6 +40,7 @@
 #define BIOMOLECULES_SPRELAY_CORE_UNIFIED_SERIAL_PORT_H_
 
 #include <memory>
+#include <vector>
 
 #include <QByteArray>
 #include <QIODevice>
@@ -47,6 +48,7 @@
 #include <QSerialPort>
 #include <QString>
 
+#include "k8090_defines.h"
 #include "serial_port_defines.h"
 #include "serial_port_utils.h"
 
@@ -61,6 +63,7 @@ namespace core {
 
 // forward declarations
 class MockSerialPort;
+class ThreadedMockSerialPort;
 
 
 /// \brief Class which unifies QSerialPort and biomolecules::sprelay::core::MockSerialPort and can internaly switch
@@ -72,6 +75,7 @@ class UnifiedSerialPort : public QObject
 
 public:
     static const char* kMockPortName;
+    static const char* kThreadedMockPortName;
 
     static QList<serial_utils::ComPortParams> availablePorts();
 
@@ -100,6 +104,8 @@ public:
     QSerialPort::SerialPortError error();
     void clearError();
 
+    bool runMockScenario(const std::vector<k8090::ScenarioEvent>& events, int period, int repeat_count);
+
     bool isMock();
     bool isReal();
 
@@ -108,14 +114,17 @@ signals:
 
 private:
     bool isMockImpl();
+    bool isThreadedMockImpl();
     bool isRealImpl();
     bool createSerialPort();
     bool createMockPort();
+    bool createThreadedMockPort();
     template<typename TSerialPort>
     bool setupPort(TSerialPort* serial_port);
 
     std::unique_ptr<QSerialPort> serial_port_;
     std::unique_ptr<MockSerialPort, serial_utils::MockSerialPortDeleter> mock_serial_port_;
+    std::unique_ptr<ThreadedMockSerialPort> threaded_mock_serial_port_;
     std::unique_ptr<QMutex> serial_port_mutex_;
     QString port_name_;
     bool port_name_pristine_;
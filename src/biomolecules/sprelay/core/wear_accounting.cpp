@@ -0,0 +1,282 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      wear_accounting.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::WearAccounting class which counts relay switching and
+ *            on-time.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "wear_accounting.h"
+
+#include <chrono>
+
+#include <QDataStream>
+#include <QIODevice>
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/*!
+ * \class WearAccounting
+ *
+ * The accounting is updated by K8090 from each decoded relay status frame. The relays which changed their state since
+ * the last known status have their switch count increased and the last transition time updated. The time, for which
+ * the relay was switched on, is accumulated when the relay is switched off, the time of currently switched on relays
+ * is added in reports. The times are monotonic in miliseconds, see WearAccounting::now(), so reading them needs no
+ * wall-clock system call, and only integer arithmetic is used, so the update is cheap enough to be done in the decode
+ * path. The last transition time is reported in miliseconds since epoch, the monotonic time is converted by the
+ * offset passed to the constructor.
+ *
+ * The state can be stored in the compact binary form by WearAccounting::serialize() and restored by
+ * WearAccounting::deserialize().
+ *
+ * \remark reentrant
+ */
+
+// initialization of static member variables
+
+// Magic bytes identifying the wear file.
+const char WearAccounting::kMagic_[4] = {'S', 'P', 'R', 'W'};
+// Version of the wear file format.
+const quint8 WearAccounting::kVersion_ = 1;
+
+
+/*!
+ * \brief Constructs accounting with zero counters and unknown relay state.
+ * \param epoch_offset The difference between the time in ms since epoch and WearAccounting::now(). It is added to the
+ * last transition times.
+ */
+WearAccounting::WearAccounting(qint64 epoch_offset)
+    : epoch_offset_{epoch_offset}, has_state_{false}, state_{RelayID::None}, dirty_{false}, wear_{}, on_since_{}
+{}
+
+
+/*!
+ * \brief Monotonic time used by the accounting.
+ * \return The time in ms.
+ */
+qint64 WearAccounting::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+
+/*!
+ * \brief Updates the counters from the relay status.
+ *
+ * The first status after construction or WearAccounting::invalidate() only initializes the relay state, no transition
+ * is counted.
+ *
+ * \param current Relays which are currently switched on.
+ * \param now Current time, see WearAccounting::now().
+ * \return True if the state of the accounting changed, false if the status repeats the known relay state.
+ */
+bool WearAccounting::update(RelayID current, qint64 now)
+{
+    if (!has_state_) {
+        has_state_ = true;
+        state_ = current;
+        for (unsigned int i = 0; i < 8; ++i) {
+            on_since_[i] = now;
+        }
+        return true;
+    }
+    auto transitions = as_number(state_ ^ current);
+    if (transitions == 0u) {
+        return false;
+    }
+    auto on = as_number(current);
+    for (unsigned int i = 0; i < 8; ++i) {
+        if ((transitions & (1u << i)) == 0u) {
+            continue;
+        }
+        ++wear_[i].switch_count;
+        wear_[i].last_transition = now + epoch_offset_;
+        if ((on & (1u << i)) != 0u) {
+            on_since_[i] = now;
+        } else if (now > on_since_[i]) {
+            wear_[i].on_time += now - on_since_[i];
+        }
+    }
+    state_ = current;
+    dirty_ = true;
+    return true;
+}
+
+
+/*!
+ * \brief Closes on-time intervals of switched on relays and forgets the relay state.
+ *
+ * It is used when the connection with the card is lost, the transitions which happen until the next relay status are
+ * not counted.
+ *
+ * \param now Current time, see WearAccounting::now().
+ */
+void WearAccounting::invalidate(qint64 now)
+{
+    if (!has_state_) {
+        return;
+    }
+    auto on = as_number(state_);
+    for (unsigned int i = 0; i < 8; ++i) {
+        if ((on & (1u << i)) != 0u && now > on_since_[i]) {
+            wear_[i].on_time += now - on_since_[i];
+            dirty_ = true;
+        }
+    }
+    has_state_ = false;
+    state_ = RelayID::None;
+}
+
+
+/*!
+ * \brief Gets the wear of the relay.
+ * \param relay Relay number from 0 to 7.
+ * \param now Current time, see WearAccounting::now(), it is used to add on-time of switched on relay.
+ * \return The wear.
+ */
+RelayWear WearAccounting::wear(unsigned int relay, qint64 now) const
+{
+    RelayWear relay_wear = wear_[relay];
+    if (has_state_ && (as_number(state_) & (1u << relay)) != 0u && now > on_since_[relay]) {
+        relay_wear.on_time += now - on_since_[relay];
+    }
+    return relay_wear;
+}
+
+
+/*!
+ * \brief Gets the wear of all relays.
+ * \param now Current time, see WearAccounting::now(), it is used to add on-time of switched on relays.
+ * \return The wear of relays indexed by relay number.
+ */
+std::array<RelayWear, 8> WearAccounting::snapshot(qint64 now) const
+{
+    std::array<RelayWear, 8> relay_wear;
+    for (unsigned int i = 0; i < 8; ++i) {
+        relay_wear[i] = wear(i, now);
+    }
+    return relay_wear;
+}
+
+
+/*!
+ * \fn RelayID WearAccounting::switchedOn() const
+ * \brief Relays, which are switched on and the on-time of which is growing.
+ */
+
+/*!
+ * \fn bool WearAccounting::isDirty() const
+ * \brief Tests if the counters changed since the last WearAccounting::clearDirty().
+ */
+
+/*!
+ * \fn void WearAccounting::clearDirty()
+ * \brief Marks the counters as stored.
+ */
+
+
+/*!
+ * \brief Stores counters in compact binary form.
+ *
+ * The format consists of 4 magic bytes, version byte and switch count, on-time and last transition time of each
+ * relay, all stored as big endian 64-bit integers.
+ *
+ * \param now Current time, see WearAccounting::now(), it is used to add on-time of switched on relays.
+ * \return The serialized counters.
+ */
+QByteArray WearAccounting::serialize(qint64 now) const
+{
+    QByteArray data;
+    QDataStream stream{&data, QIODevice::WriteOnly};
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.writeRawData(kMagic_, sizeof(kMagic_));
+    stream << kVersion_;
+    for (unsigned int i = 0; i < 8; ++i) {
+        RelayWear relay_wear = wear(i, now);
+        stream << relay_wear.switch_count << relay_wear.on_time << relay_wear.last_transition;
+    }
+    return data;
+}
+
+
+/*!
+ * \brief Restores counters stored by WearAccounting::serialize().
+ *
+ * The relay state is forgotten and it is obtained from the next relay status, so the on-time of switched on relays
+ * is not counted twice.
+ *
+ * \param data The serialized counters.
+ * \return True if the data were valid and the counters were restored, false otherwise. The counters are not modified
+ * when the data are invalid.
+ */
+bool WearAccounting::deserialize(const QByteArray& data)
+{
+    QDataStream stream{data};
+    stream.setByteOrder(QDataStream::BigEndian);
+    char magic[sizeof(kMagic_)];
+    if (stream.readRawData(magic, sizeof(magic)) != sizeof(magic)) {
+        return false;
+    }
+    for (unsigned int i = 0; i < sizeof(kMagic_); ++i) {
+        if (magic[i] != kMagic_[i]) {
+            return false;
+        }
+    }
+    quint8 version;
+    stream >> version;
+    if (version != kVersion_) {
+        return false;
+    }
+    std::array<RelayWear, 8> relay_wear;
+    for (unsigned int i = 0; i < 8; ++i) {
+        stream >> relay_wear[i].switch_count >> relay_wear[i].on_time >> relay_wear[i].last_transition;
+    }
+    if (stream.status() != QDataStream::Ok || !stream.atEnd()) {
+        return false;
+    }
+    wear_ = relay_wear;
+    has_state_ = false;
+    state_ = RelayID::None;
+    dirty_ = false;
+    return true;
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,93 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      wear_accounting.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::WearAccounting class which counts relay switching and
+ *            on-time.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_WEAR_ACCOUNTING_H_
+#define BIOMOLECULES_SPRELAY_CORE_WEAR_ACCOUNTING_H_
+
+#include <array>
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#include "k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+/// \brief Maintains per-relay switch counts, cumulative on-time and last transition time.
+/// \headerfile ""
+class WearAccounting
+{
+public:
+    explicit WearAccounting(qint64 epoch_offset = 0);
+
+    static qint64 now();
+
+    bool update(RelayID current, qint64 now);
+    void invalidate(qint64 now);
+    RelayWear wear(unsigned int relay, qint64 now) const;
+    std::array<RelayWear, 8> snapshot(qint64 now) const;
+    RelayID switchedOn() const { return has_state_ ? state_ : RelayID::None; }
+    bool isDirty() const { return dirty_; }
+    void clearDirty() { dirty_ = false; }
+
+    QByteArray serialize(qint64 now) const;
+    bool deserialize(const QByteArray& data);
+
+private:
+    static const char kMagic_[4];
+    static const quint8 kVersion_;
+
+    qint64 epoch_offset_;
+    bool has_state_;
+    RelayID state_;
+    bool dirty_;
+    std::array<RelayWear, 8> wear_;
+    std::array<qint64, 8> on_since_;
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_WEAR_ACCOUNTING_H_
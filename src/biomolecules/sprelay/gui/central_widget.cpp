@@ -48,12 +48,16 @@
 #include <QLayout>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QSettings>
 #include <QSignalMapper>
 #include <QSpinBox>
 #include <QStringBuilder>
+#include <QThread>
 #include <QTimer>
+#include <QVariant>
 
 #include "indicator_button.h"
+#include "port_enumerator.h"
 
 namespace biomolecules {
 namespace sprelay {
@@ -141,18 +145,48 @@ namespace gui {
  * }
  * \endcode
  *
+ * In the fast start mode, which is used by the `sprelay` application, the serial ports are enumerated in a worker
+ * thread after the widget is shown and the rarely used mode and timer panels are constructed only when the user asks
+ * for them. The widget also remembers the last successfully connected port in QSettings and connects to it
+ * automatically, when it is found between the enumerated ports. The application should set the organization and
+ * application names (see QCoreApplication::setOrganizationName()) before the widget is created.
+ *
+ * The remaining delays of the running relay timers are polled from the card. If the idle mode of the card is enabled
+ * (see biomolecules::sprelay::core::k8090::K8090::setIdleMode()), they are queried only once and counted down locally
+ * while the timer panel is shown, so the widget wakes the process only when the shown values change.
+ *
  * \remarks reentrant
  * \sa biomolecules::sprelay::core::k8090::K8090
  */
 
+// initialization of static member variables
+// QSettings key of the last successfully connected port.
+const char* const CentralWidget::kLastPortKey_ = "last_port";
+
+
 /*!
  * \brief Constructor.
  * \param k8090 External K8090 object. If not provided the internal one would be created.
  * \param com_port_name Predefined COM port name.
  * \param parent The widget's parent object in Qt ownership system.
+ * \param fast_start Enables the fast start mode, see the detailed description.
  */
-CentralWidget::CentralWidget(core::k8090::K8090* k8090, QString com_port_name, QWidget* parent)
-    : QWidget{parent}, com_port_name_{std::move(com_port_name)}, refresh_delay_timer_{new QTimer}
+CentralWidget::CentralWidget(core::k8090::K8090* k8090, QString com_port_name, QWidget* parent, bool fast_start)
+    : QWidget{parent},
+      com_port_name_{std::move(com_port_name)},
+      fast_start_{fast_start},
+      mode_panel_constructed_{false},
+      timer_panel_constructed_{false},
+      momentary_modes_{core::k8090::RelayID::None},
+      toggle_modes_{core::k8090::RelayID::None},
+      timed_modes_{core::k8090::RelayID::None},
+      timed_relays_{core::k8090::RelayID::None},
+      total_delays_{},
+      remaining_delays_{},
+      show_modes_button_{nullptr},
+      show_timers_button_{nullptr},
+      refresh_delay_timer_{new QTimer},
+      port_enumerator_{nullptr}
 {
     // gets K8090 class from the user or sets it to the private one.
     if (k8090 != nullptr) {
@@ -165,12 +199,19 @@ CentralWidget::CentralWidget(core::k8090::K8090* k8090, QString com_port_name, Q
     refresh_delay_timer_->setSingleShot(true);
     connect(refresh_delay_timer_.get(), &QTimer::timeout, this, &CentralWidget::onRefreshTimersDelay);
     connected_ = k8090_->isConnected();
+    if (fast_start_ && com_port_name_.isEmpty()) {
+        com_port_name_ = QSettings{}.value(kLastPortKey_).toString();
+    }
 
     constructGui();
 
     // erase gui element states
     connectionStatusChanged();
 
+    if (fast_start_) {
+        startPortEnumeration();
+    }
+
     // poll the relay for its state if the provide K8090 was already connected.
     if (k8090_->isConnected()) {
         onRefreshRelaysButtonClicked();
@@ -181,7 +222,19 @@ CentralWidget::CentralWidget(core::k8090::K8090* k8090, QString com_port_name, Q
 /*!
  * \brief The destructor.
  */
-CentralWidget::~CentralWidget() = default;
+CentralWidget::~CentralWidget()
+{
+    if (port_thread_) {
+        port_thread_->quit();
+        port_thread_->wait();
+    }
+}
+
+
+/*!
+ * \fn void CentralWidget::portsInitialized()
+ * \brief Emitted in the fast start mode, when the serial ports are enumerated and the ports combo box is filled.
+ */
 
 
 void CentralWidget::onConnectButtonClicked()
@@ -383,11 +436,34 @@ void CentralWidget::onTimerSpinBoxValueChanged(int relay)
 }
 
 
+void CentralWidget::onShowModesButtonClicked()
+{
+    // the button can't be deleted directly in its own click handler
+    show_modes_button_->hide();
+    show_modes_button_->deleteLater();
+    show_modes_button_ = nullptr;
+    constructModePanel();
+}
+
+
+void CentralWidget::onShowTimersButtonClicked()
+{
+    show_timers_button_->hide();
+    show_timers_button_->deleteLater();
+    show_timers_button_ = nullptr;
+    constructTimerPanel();
+    // in the idle mode the remaining delays are not refreshed while they are not shown
+    if (timed_relays_ != core::k8090::RelayID::None && !refresh_delay_timer_->isActive()) {
+        queryTimersDelay();
+        scheduleTimersRefresh();
+    }
+}
+
+
 void CentralWidget::onRelayStatus(
     core::k8090::RelayID previous, core::k8090::RelayID current, core::k8090::RelayID timed)
 {
     Q_UNUSED(previous)
-    bool is_timed = false;
     for (int i = 0; i < kNRelays; ++i) {
         if (static_cast<bool>(core::k8090::from_number(i) & current)) {
             relay_on_buttons_arr_[i]->setState(true);
@@ -395,15 +471,14 @@ void CentralWidget::onRelayStatus(
             relay_on_buttons_arr_[i]->setState(false);
             onRemainingTimerDelay(core::k8090::from_number(i), 0);
         }
-        if (static_cast<bool>(core::k8090::from_number(i) & timed)) {
-            is_timed = true;
-            start_timer_buttons_arr_[i]->setState(true);
-        } else {
-            start_timer_buttons_arr_[i]->setState(false);
+        if (timer_panel_constructed_) {
+            start_timer_buttons_arr_[i]->setState(static_cast<bool>(core::k8090::from_number(i) & timed));
         }
     }
-    if (is_timed && !refresh_delay_timer_->isActive()) {
-        onRefreshTimersDelay();
+    timed_relays_ = timed;
+    if (timed_relays_ != core::k8090::RelayID::None && !refresh_delay_timer_->isActive()) {
+        queryTimersDelay();
+        scheduleTimersRefresh();
     }
 }
 
@@ -427,7 +502,10 @@ void CentralWidget::onTotalTimerDelay(core::k8090::RelayID relay, quint16 delay)
 {
     for (int i = 0; i < kNRelays; ++i) {
         if (static_cast<bool>(core::k8090::from_number(i) & relay)) {
-            default_timer_labels_arr_[i]->setText(tr("%1").arg(delay));
+            total_delays_[i] = delay;
+            if (timer_panel_constructed_) {
+                default_timer_labels_arr_[i]->setText(tr("%1").arg(delay));
+            }
         }
     }
 }
@@ -437,10 +515,9 @@ void CentralWidget::onRemainingTimerDelay(core::k8090::RelayID relay, quint16 de
 {
     for (int i = 0; i < kNRelays; ++i) {
         if (static_cast<bool>(core::k8090::from_number(i) & relay)) {
-            if (start_timer_buttons_arr_[i]->state()) {
-                remaining_time_labels_arr_[i]->setText(tr("%1").arg(delay));
-            } else {
-                remaining_time_labels_arr_[i]->setText(tr("%1").arg(0));
+            remaining_delays_[i] = static_cast<bool>(core::k8090::from_number(i) & timed_relays_) ? delay : 0;
+            if (timer_panel_constructed_) {
+                remaining_time_labels_arr_[i]->setText(tr("%1").arg(remaining_delays_[i]));
             }
         }
     }
@@ -450,6 +527,12 @@ void CentralWidget::onRemainingTimerDelay(core::k8090::RelayID relay, quint16 de
 void CentralWidget::onButtonModes(
     core::k8090::RelayID momentary, core::k8090::RelayID toggle, core::k8090::RelayID timed)
 {
+    momentary_modes_ = momentary;
+    toggle_modes_ = toggle;
+    timed_modes_ = timed;
+    if (!mode_panel_constructed_) {
+        return;
+    }
     for (int i = 0; i < kNRelays; ++i) {
         if (static_cast<bool>(core::k8090::from_number(i) & momentary)) {
             momentary_buttons_arr_[i]->setState(true);
@@ -484,6 +567,9 @@ void CentralWidget::onFirmwareVersion(int year, int week)
 
 void CentralWidget::onConnected()
 {
+    if (fast_start_) {
+        QSettings{}.setValue(kLastPortKey_, k8090_->comPortName());
+    }
     if (!connected_) {
         connected_ = true;
         connectionStatusChanged();
@@ -520,16 +606,34 @@ void CentralWidget::onDisconnected()
 
 void CentralWidget::onRefreshTimersDelay()
 {
-    bool is_timed = false;
-    for (int i = 0; i < kNRelays; ++i) {
-        if (start_timer_buttons_arr_[i]->state()) {
-            is_timed = true;
-            k8090_->queryRemainingTimerDelay(core::k8090::from_number(i));
-        }
+    if (k8090_->isIdleMode()) {
+        countDownTimersDelay();
+    } else {
+        queryTimersDelay();
     }
-    if (is_timed && !refresh_delay_timer_->isActive()) {
-        refresh_delay_timer_->start(kRefreshTimersRateMs_);
+    scheduleTimersRefresh();
+}
+
+
+void CentralWidget::onPortsEnumerated(const QList<core::serial_utils::ComPortParams>& ports)
+{
+    port_thread_->quit();
+    initializePortsCombobox(ports);
+    connect_button_->setEnabled(true);
+    refresh_ports_button_->setEnabled(true);
+
+    // connect automatically to the last used port if the card is still there
+    if (!connected_ && com_port_name_ == QSettings{}.value(kLastPortKey_).toString()) {
+        for (const core::serial_utils::ComPortParams& com_port_params : ports) {
+            if (com_port_params.port_name == com_port_name_
+                && com_port_params.product_identifier == core::k8090::K8090::kProductID
+                && com_port_params.vendor_identifier == core::k8090::K8090::kVendorID) {
+                onConnectButtonClicked();
+                break;
+            }
+        }
     }
+    emit portsInitialized();
 }
 
 
@@ -538,6 +642,15 @@ void CentralWidget::constructGui()
     createUiElements();
     connectGui();
     makeLayout();
+    if (fast_start_) {
+        show_modes_button_ = createShowPanelButton(relay_mode_settings_box_);
+        connect(show_modes_button_, &QPushButton::clicked, this, &CentralWidget::onShowModesButtonClicked);
+        show_timers_button_ = createShowPanelButton(relay_timers_settings_box_);
+        connect(show_timers_button_, &QPushButton::clicked, this, &CentralWidget::onShowTimersButtonClicked);
+    } else {
+        constructModePanel();
+        constructTimerPanel();
+    }
 }
 
 
@@ -547,7 +660,13 @@ void CentralWidget::createUiElements()
     connect_button_ = new IndicatorButton{tr("Connect"), this};
     refresh_ports_button_ = new QPushButton{tr("Refresh Ports"), this};
     ports_combo_box_ = new QComboBox(this);
-    initializePortsCombobox();
+    if (fast_start_) {
+        // the ports are enumerated later in the worker thread
+        connect_button_->setEnabled(false);
+        refresh_ports_button_->setEnabled(false);
+    } else {
+        initializePortsCombobox(core::k8090::K8090::availablePorts());
+    }
 
     // relays
     // globals
@@ -561,24 +680,13 @@ void CentralWidget::createUiElements()
         relay_on_buttons_arr_[i] = new IndicatorButton{this};
         relay_off_buttons_arr_[i] = new QPushButton{this};
         toggle_relay_buttons_arr_[i] = new QPushButton{this};
-        momentary_buttons_arr_[i] = new IndicatorButton{this};
-        toggle_mode_buttons_arr_[i] = new IndicatorButton{this};
-        timed_buttons_arr_[i] = new IndicatorButton{this};
-        default_timer_labels_arr_[i] = new QLabel{"0", this};
-        remaining_time_labels_arr_[i] = new QLabel{"0", this};
-        set_default_timer_buttons_arr_[i] = new QPushButton{this};
-        start_timer_buttons_arr_[i] = new IndicatorButton{this};
-        timer_spin_box_arr_[i] = new QSpinBox{this};
-        timer_spin_box_arr_[i]->setMinimum(0);
-        timer_spin_box_arr_[i]->setMaximum(std::numeric_limits<std::uint16_t>::max());
     }
 }
 
 
-void CentralWidget::initializePortsCombobox()
+void CentralWidget::initializePortsCombobox(const QList<core::serial_utils::ComPortParams>& com_port_params_list)
 {
     int index = 0;
-    QList<core::serial_utils::ComPortParams> com_port_params_list = core::k8090::K8090::availablePorts();
     bool current_port_found = false;
     // fill combo box
     for (const core::serial_utils::ComPortParams& com_port_params : com_port_params_list) {
@@ -605,6 +713,20 @@ void CentralWidget::initializePortsCombobox()
 }
 
 
+// enumerates serial ports in the worker thread, the result is processed by onPortsEnumerated()
+void CentralWidget::startPortEnumeration()
+{
+    qRegisterMetaType<QList<core::serial_utils::ComPortParams>>();
+    port_thread_.reset(new QThread);
+    port_enumerator_ = new PortEnumerator;
+    port_enumerator_->moveToThread(port_thread_.get());
+    connect(port_thread_.get(), &QThread::started, port_enumerator_, &PortEnumerator::enumerate);
+    connect(port_thread_.get(), &QThread::finished, port_enumerator_, &QObject::deleteLater);
+    connect(port_enumerator_, &PortEnumerator::portsEnumerated, this, &CentralWidget::onPortsEnumerated);
+    port_thread_->start();
+}
+
+
 void CentralWidget::connectGui()
 {
     // reactions on user interaction with gui
@@ -627,7 +749,7 @@ void CentralWidget::connectGui()
     set_default_timer_mapper_ = std::unique_ptr<QSignalMapper>{new QSignalMapper};
     start_timer_mapper_ = std::unique_ptr<QSignalMapper>{new QSignalMapper};
     timer_spin_box_mapper_ = std::unique_ptr<QSignalMapper>{new QSignalMapper};
-    for (int i = 0; i < 8; ++i) {
+    for (int i = 0; i < kNRelays; ++i) {
         connect(relay_on_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
             relay_on_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
         relay_on_mapper_->setMapping(relay_on_buttons_arr_[i], i);
@@ -637,24 +759,6 @@ void CentralWidget::connectGui()
         connect(toggle_relay_buttons_arr_[i], &QPushButton::clicked,  // wrap
             toggle_relay_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
         toggle_relay_mapper_->setMapping(toggle_relay_buttons_arr_[i], i);
-        connect(momentary_buttons_arr_[i], &QPushButton::clicked,  // wrap
-            momentary_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        momentary_mapper_->setMapping(momentary_buttons_arr_[i], i);
-        connect(timed_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
-            timed_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        toggle_mode_mapper_->setMapping(toggle_mode_buttons_arr_[i], i);
-        connect(set_default_timer_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
-            set_default_timer_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        timed_mapper_->setMapping(timed_buttons_arr_[i], i);
-        connect(toggle_mode_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
-            toggle_mode_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        set_default_timer_mapper_->setMapping(set_default_timer_buttons_arr_[i], i);
-        connect(start_timer_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
-            start_timer_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        start_timer_mapper_->setMapping(start_timer_buttons_arr_[i], i);
-        connect(timer_spin_box_arr_[i], static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),  // wrap
-            timer_spin_box_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
-        timer_spin_box_mapper_->setMapping(timer_spin_box_arr_[i], i);
     }
     connect(relay_on_mapper_.get(), static_cast<void (QSignalMapper::*)(int)>(&QSignalMapper::mapped),  // wrap
         this, &CentralWidget::onRelayOnButtonClicked);
@@ -762,10 +866,46 @@ void CentralWidget::makeLayout()
         power_grid_layout->addWidget(toggle_relay_buttons_arr_[i], 2, i + 1, Qt::AlignHCenter);
     }
 
-    // relays mode settings
+    // relays mode and timers settings, their content is created by constructModePanel() and constructTimerPanel()
     relay_mode_settings_box_ = new QGroupBox{tr("Relays mode settings"), this};
     relays_grid_v_layout->addWidget(relay_mode_settings_box_);
-    auto mode_grid_layout = new QGridLayout{relay_mode_settings_box_};
+    new QVBoxLayout{relay_mode_settings_box_};
+    relay_timers_settings_box_ = new QGroupBox{tr("Relay timers settings"), this};
+    relays_grid_v_layout->addWidget(relay_timers_settings_box_);
+    new QVBoxLayout{relay_timers_settings_box_};
+
+    relay_grid_layouts_ << button_status_grid_layout << relay_number_grid_layout << power_grid_layout;
+    alignRelayLabels();
+
+    relays_grid_v_layout->addStretch();
+    main_layout->addStretch();
+}
+
+
+// creates the relays mode settings panel, it is called on demand in the fast start mode
+void CentralWidget::constructModePanel()
+{
+    for (int i = 0; i < kNRelays; ++i) {
+        momentary_buttons_arr_[i] = new IndicatorButton{this};
+        toggle_mode_buttons_arr_[i] = new IndicatorButton{this};
+        timed_buttons_arr_[i] = new IndicatorButton{this};
+
+        connect(momentary_buttons_arr_[i], &QPushButton::clicked,  // wrap
+            momentary_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        momentary_mapper_->setMapping(momentary_buttons_arr_[i], i);
+        connect(toggle_mode_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
+            toggle_mode_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        toggle_mode_mapper_->setMapping(toggle_mode_buttons_arr_[i], i);
+        connect(timed_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
+            timed_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        timed_mapper_->setMapping(timed_buttons_arr_[i], i);
+    }
+
+    // next two lines have to follow each other to preserve RAII
+    auto mode_grid_layout = new QGridLayout;
+    static_cast<QBoxLayout*>(relay_mode_settings_box_->layout())->addLayout(mode_grid_layout);
+    // now mode_grid_layout has its parent => owner of the memory
+    mode_grid_layout->setContentsMargins(0, 0, 0, 0);
     mode_grid_layout->addWidget(new QLabel(tr("Momentary:"), this), 0, 0);
     mode_grid_layout->addWidget(new QLabel(tr("Toggle:"), this), 1, 0);
     mode_grid_layout->addWidget(new QLabel(tr("Timed:"), this), 2, 0);
@@ -774,11 +914,43 @@ void CentralWidget::makeLayout()
         mode_grid_layout->addWidget(toggle_mode_buttons_arr_[i], 1, i + 1, Qt::AlignHCenter);
         mode_grid_layout->addWidget(timed_buttons_arr_[i], 2, i + 1, Qt::AlignHCenter);
     }
+    relay_grid_layouts_ << mode_grid_layout;
+    alignRelayLabels();
 
-    // relay timers settings
-    relay_timers_settings_box_ = new QGroupBox{tr("Relay timers settings"), this};
-    relays_grid_v_layout->addWidget(relay_timers_settings_box_);
-    auto timer_grid_layout = new QGridLayout{relay_timers_settings_box_};
+    mode_panel_constructed_ = true;
+    onButtonModes(momentary_modes_, toggle_modes_, timed_modes_);
+}
+
+
+// creates the relay timers settings panel, it is called on demand in the fast start mode
+void CentralWidget::constructTimerPanel()
+{
+    for (int i = 0; i < kNRelays; ++i) {
+        default_timer_labels_arr_[i] = new QLabel{tr("%1").arg(total_delays_[i]), this};
+        remaining_time_labels_arr_[i] = new QLabel{tr("%1").arg(remaining_delays_[i]), this};
+        set_default_timer_buttons_arr_[i] = new QPushButton{this};
+        start_timer_buttons_arr_[i] = new IndicatorButton{this};
+        start_timer_buttons_arr_[i]->setState(static_cast<bool>(core::k8090::from_number(i) & timed_relays_));
+        timer_spin_box_arr_[i] = new QSpinBox{this};
+        timer_spin_box_arr_[i]->setMinimum(0);
+        timer_spin_box_arr_[i]->setMaximum(std::numeric_limits<std::uint16_t>::max());
+
+        connect(set_default_timer_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
+            set_default_timer_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        set_default_timer_mapper_->setMapping(set_default_timer_buttons_arr_[i], i);
+        connect(start_timer_buttons_arr_[i], &IndicatorButton::clicked,  // wrap
+            start_timer_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        start_timer_mapper_->setMapping(start_timer_buttons_arr_[i], i);
+        connect(timer_spin_box_arr_[i], static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),  // wrap
+            timer_spin_box_mapper_.get(), static_cast<void (QSignalMapper::*)()>(&QSignalMapper::map));
+        timer_spin_box_mapper_->setMapping(timer_spin_box_arr_[i], i);
+    }
+
+    // next two lines have to follow each other to preserve RAII
+    auto timer_grid_layout = new QGridLayout;
+    static_cast<QBoxLayout*>(relay_timers_settings_box_->layout())->addLayout(timer_grid_layout);
+    // now timer_grid_layout has its parent => owner of the memory
+    timer_grid_layout->setContentsMargins(0, 0, 0, 0);
     timer_grid_layout->addWidget(new QLabel(tr("Default timer (s):"), this), 0, 0);
     timer_grid_layout->addWidget(new QLabel(tr("Remaining time (s):"), this), 1, 0);
     timer_grid_layout->addWidget(new QLabel(tr("Default:"), this), 2, 0);
@@ -791,13 +963,28 @@ void CentralWidget::makeLayout()
         timer_grid_layout->addWidget(start_timer_buttons_arr_[i], 3, i + 1, Qt::AlignHCenter);
         timer_grid_layout->addWidget(timer_spin_box_arr_[i], 4, i + 1, Qt::AlignHCenter);
     }
+    relay_grid_layouts_ << timer_grid_layout;
+    alignRelayLabels();
+
+    timer_panel_constructed_ = true;
+}
 
-    const int layout_no = 5;
-    std::array<QGridLayout*, layout_no> grid_layouts = {
-        button_status_grid_layout, relay_number_grid_layout, power_grid_layout, mode_grid_layout, timer_grid_layout};
+
+// creates button, which constructs the panel inside the box on demand
+QPushButton* CentralWidget::createShowPanelButton(QGroupBox* box)
+{
+    auto button = new QPushButton{tr("Show"), this};
+    box->layout()->addWidget(button);
+    return button;
+}
+
+
+// sets the same width of the first column in all relay grid layouts
+void CentralWidget::alignRelayLabels()
+{
     int relay_label_min_width = std::numeric_limits<int>::min();
     int relay_label_width;
-    for (const auto& grid_layout : grid_layouts) {
+    for (const auto& grid_layout : relay_grid_layouts_) {
         for (int j = 0; j < grid_layout->rowCount(); ++j) {
             relay_label_width = grid_layout->itemAtPosition(j, 0)->sizeHint().width();
             if (relay_label_width > relay_label_min_width) {
@@ -805,12 +992,50 @@ void CentralWidget::makeLayout()
             }
         }
     }
-    for (auto& grid_layout : grid_layouts) {
+    for (auto& grid_layout : relay_grid_layouts_) {
         grid_layout->setColumnMinimumWidth(0, relay_label_min_width);
     }
+}
 
-    relays_grid_v_layout->addStretch();
-    main_layout->addStretch();
+
+// queries the remaining delays of the running relay timers
+void CentralWidget::queryTimersDelay()
+{
+    for (int i = 0; i < kNRelays; ++i) {
+        if (static_cast<bool>(core::k8090::from_number(i) & timed_relays_)) {
+            k8090_->queryRemainingTimerDelay(core::k8090::from_number(i));
+        }
+    }
+}
+
+
+// Arms refresh_delay_timer_ while some relay timer runs. The remaining delays are polled from the card, in the idle
+// mode they are queried only once and then counted down locally with their resolution of one second and only when the
+// timer panel is shown, so the widget doesn't wake the process without a reason.
+void CentralWidget::scheduleTimersRefresh()
+{
+    if (timed_relays_ == core::k8090::RelayID::None || refresh_delay_timer_->isActive()) {
+        return;
+    }
+    if (!k8090_->isIdleMode()) {
+        refresh_delay_timer_->start(kRefreshTimersRateMs_);
+    } else if (connected_ && timer_panel_constructed_) {
+        refresh_delay_timer_->start(kCountDownRateMs_);
+    }
+}
+
+
+// counts the remaining delays down by one second, the card reports the relay status when the timer elapses
+void CentralWidget::countDownTimersDelay()
+{
+    for (int i = 0; i < kNRelays; ++i) {
+        if (static_cast<bool>(core::k8090::from_number(i) & timed_relays_) && remaining_delays_[i] > 0) {
+            --remaining_delays_[i];
+            if (timer_panel_constructed_) {
+                remaining_time_labels_arr_[i]->setText(tr("%1").arg(remaining_delays_[i]));
+            }
+        }
+    }
 }
 
 
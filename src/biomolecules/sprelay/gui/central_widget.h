@@ -43,6 +43,7 @@
 #include <array>
 #include <memory>
 
+#include <QList>
 #include <QString>
 #include <QWidget>
 
@@ -51,11 +52,13 @@
 
 // forward declarations
 class QComboBox;
+class QGridLayout;
 class QGroupBox;
 class QLabel;
 class QPushButton;
 class QSignalMapper;
 class QSpinBox;
+class QThread;
 class QTimer;
 
 namespace biomolecules {
@@ -69,6 +72,7 @@ struct ComPortParams;
 namespace gui {
 class IndicatorButton;
 class IndicatorLight;
+class PortEnumerator;
 
 /// Widget which controlls Velleman %K8090 card.
 class SPRELAY_EXPORT CentralWidget : public QWidget
@@ -77,7 +81,8 @@ class SPRELAY_EXPORT CentralWidget : public QWidget
 public:
     explicit CentralWidget(core::k8090::K8090* k8090 = nullptr,
         QString com_port_name = QString{},
-        QWidget* parent = nullptr);
+        QWidget* parent = nullptr,
+        bool fast_start = false);
     CentralWidget(const CentralWidget&) = delete;
     CentralWidget(CentralWidget&&) = delete;
     CentralWidget& operator=(const CentralWidget&) = delete;
@@ -85,6 +90,7 @@ public:
     ~CentralWidget() override;
 
 signals:
+    void portsInitialized();
 
 public slots:
 
@@ -104,6 +110,8 @@ private slots:
     void onSetDefaultTimerButtonClicked(int relay);
     void onStartTimerButtonClicked(int relay);
     void onTimerSpinBoxValueChanged(int relay);
+    void onShowModesButtonClicked();
+    void onShowTimersButtonClicked();
 
 private slots:
     // reactions to signals from the relay
@@ -124,21 +132,43 @@ private slots:
 
     // other slots
     void onRefreshTimersDelay();
+    void onPortsEnumerated(const QList<biomolecules::sprelay::core::serial_utils::ComPortParams>& ports);
 
 
 private:
     static const int kNRelays = 8;
     static const int kRefreshTimersRateMs_ = 300;
+    static const int kCountDownRateMs_ = 1000;
+    static const char* const kLastPortKey_;
     void constructGui();
     void createUiElements();
-    void initializePortsCombobox();
+    void initializePortsCombobox(const QList<core::serial_utils::ComPortParams>& com_port_params_list);
+    void startPortEnumeration();
     void connectGui();
     void makeLayout();
+    void constructModePanel();
+    void constructTimerPanel();
+    QPushButton* createShowPanelButton(QGroupBox* box);
+    void alignRelayLabels();
+    void queryTimersDelay();
+    void scheduleTimersRefresh();
+    void countDownTimersDelay();
     void connectionStatusChanged();
 
     core::k8090::K8090* k8090_;
     QString com_port_name_;
     bool connected_;
+    bool fast_start_;
+    bool mode_panel_constructed_;
+    bool timer_panel_constructed_;
+
+    // cached card state which is needed by lazily constructed panels
+    core::k8090::RelayID momentary_modes_;
+    core::k8090::RelayID toggle_modes_;
+    core::k8090::RelayID timed_modes_;
+    core::k8090::RelayID timed_relays_;
+    std::array<quint16, kNRelays> total_delays_;
+    std::array<quint16, kNRelays> remaining_delays_;
 
     // GUI elements
     // port settings
@@ -161,13 +191,17 @@ private:
     std::array<IndicatorButton*, kNRelays> relay_on_buttons_arr_;
     std::array<QPushButton*, kNRelays> relay_off_buttons_arr_;
     std::array<QPushButton*, kNRelays> toggle_relay_buttons_arr_;
+    // relay grid layouts with aligned relay labels
+    QList<QGridLayout*> relay_grid_layouts_;
     // mode settings
     QGroupBox* relay_mode_settings_box_;
+    QPushButton* show_modes_button_;
     std::array<IndicatorButton*, kNRelays> momentary_buttons_arr_;
     std::array<IndicatorButton*, kNRelays> toggle_mode_buttons_arr_;
     std::array<IndicatorButton*, kNRelays> timed_buttons_arr_;
     // timer settings
     QGroupBox* relay_timers_settings_box_;
+    QPushButton* show_timers_button_;
     std::array<QLabel*, kNRelays> default_timer_labels_arr_;
     std::array<QLabel*, kNRelays> remaining_time_labels_arr_;
     std::array<QPushButton*, kNRelays> set_default_timer_buttons_arr_;
@@ -186,6 +220,10 @@ private:
     std::unique_ptr<QSignalMapper> timer_spin_box_mapper_;
 
     std::unique_ptr<QTimer> refresh_delay_timer_;
+
+    // port enumeration in fast start mode
+    std::unique_ptr<QThread> port_thread_;
+    PortEnumerator* port_enumerator_;
 };
 
 }  // namespace gui
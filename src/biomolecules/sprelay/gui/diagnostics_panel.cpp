@@ -0,0 +1,245 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      diagnostics_panel.cpp
+ * \brief     The biomolecules::sprelay::gui::DiagnosticsPanel class which shows live statistics of the card link.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "diagnostics_panel.h"
+
+#include <QCheckBox>
+#include <QGridLayout>
+#include <QHideEvent>
+#include <QLabel>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QTimer>
+
+#include "biomolecules/sprelay/core/k8090.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/*!
+ * \class DiagnosticsPanel
+ *
+ * The panel shows the queue depth, the number of commands sent per second, the ratio of requested commands merged
+ * into already pending ones, the latency percentiles, the failure count, the currently effective delay between
+ * commands, the micro-batching window and the savings of the relay dwell filter. The rates and the merge ratio are
+ * computed from the difference of two consecutive samples, the latency percentiles cover all the latencies since the
+ * last reset.
+ *
+ * The panel also switches the idle mode of the card (see core::k8090::K8090::setIdleMode()) and the measurement of the
+ * event loop wakeups (see core::k8090::K8090::setWakeupMeasurement()). The measured rate includes the wakeups caused
+ * by the sampling of the panel itself.
+ *
+ * The statistics are sampled with low fixed rate from the lock-free snapshot returned by
+ * core::k8090::K8090::linkStatistics(), so the panel never blocks the K8090 thread. The sampling runs only while the
+ * panel is visible.
+ *
+ * \remarks reentrant
+ */
+
+
+/*!
+ * \brief Constructs the panel.
+ * \param k8090 The card, the statistics of which are shown.
+ * \param parent The widget's parent object in Qt ownership system.
+ */
+DiagnosticsPanel::DiagnosticsPanel(core::k8090::K8090* k8090, QWidget* parent)
+    : QWidget{parent}, k8090_{k8090}, sample_timer_{new QTimer}, previous_{}, has_previous_{false}
+{
+    queue_depth_label_ = new QLabel{this};
+    command_rate_label_ = new QLabel{this};
+    merge_ratio_label_ = new QLabel{this};
+    latency_label_ = new QLabel{this};
+    failures_label_ = new QLabel{this};
+    command_delay_label_ = new QLabel{this};
+    coalescing_window_label_ = new QLabel{this};
+    dwell_label_ = new QLabel{this};
+    wakeup_rate_label_ = new QLabel{this};
+    idle_mode_check_box_ = new QCheckBox{tr("Idle mode"), this};
+    idle_mode_check_box_->setChecked(k8090_->isIdleMode());
+    measure_wakeups_check_box_ = new QCheckBox{tr("Measure wakeups"), this};
+    measure_wakeups_check_box_->setChecked(k8090_->isWakeupMeasurementEnabled());
+    reset_button_ = new QPushButton{tr("Reset"), this};
+
+    auto layout = new QGridLayout;
+    layout->addWidget(new QLabel{tr("Queue depth:"), this}, 0, 0);
+    layout->addWidget(queue_depth_label_, 0, 1);
+    layout->addWidget(new QLabel{tr("Commands per second:"), this}, 1, 0);
+    layout->addWidget(command_rate_label_, 1, 1);
+    layout->addWidget(new QLabel{tr("Merge ratio:"), this}, 2, 0);
+    layout->addWidget(merge_ratio_label_, 2, 1);
+    layout->addWidget(new QLabel{tr("Latency p50 / p90 / p99:"), this}, 3, 0);
+    layout->addWidget(latency_label_, 3, 1);
+    layout->addWidget(new QLabel{tr("Failures:"), this}, 4, 0);
+    layout->addWidget(failures_label_, 4, 1);
+    layout->addWidget(new QLabel{tr("Command delay:"), this}, 5, 0);
+    layout->addWidget(command_delay_label_, 5, 1);
+    layout->addWidget(new QLabel{tr("Batching window:"), this}, 6, 0);
+    layout->addWidget(coalescing_window_label_, 6, 1);
+    layout->addWidget(new QLabel{tr("Dwell suppressed:"), this}, 7, 0);
+    layout->addWidget(dwell_label_, 7, 1);
+    layout->addWidget(new QLabel{tr("Wakeups per second:"), this}, 8, 0);
+    layout->addWidget(wakeup_rate_label_, 8, 1);
+    layout->addWidget(idle_mode_check_box_, 9, 0, 1, 2);
+    layout->addWidget(measure_wakeups_check_box_, 10, 0, 1, 2);
+    layout->addWidget(reset_button_, 11, 0, 1, 2);
+    setLayout(layout);
+
+    connect(sample_timer_.get(), &QTimer::timeout, this, &DiagnosticsPanel::sample);
+    connect(reset_button_, &QPushButton::clicked, this, &DiagnosticsPanel::onResetButtonClicked);
+    connect(idle_mode_check_box_, &QCheckBox::toggled, this, &DiagnosticsPanel::onIdleModeToggled);
+    connect(measure_wakeups_check_box_, &QCheckBox::toggled, this, &DiagnosticsPanel::onMeasureWakeupsToggled);
+    sample();
+}
+
+
+/*!
+ * \brief The destructor.
+ */
+DiagnosticsPanel::~DiagnosticsPanel() = default;
+
+
+/*!
+ * \brief Starts the sampling when the panel is shown.
+ * \param event The show event.
+ */
+void DiagnosticsPanel::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    has_previous_ = false;
+    sample();
+    sample_timer_->start(kSampleIntervalMs_);
+}
+
+
+/*!
+ * \brief Stops the sampling when the panel is hidden.
+ * \param event The hide event.
+ */
+void DiagnosticsPanel::hideEvent(QHideEvent* event)
+{
+    sample_timer_->stop();
+    QWidget::hideEvent(event);
+}
+
+
+// takes the statistics snapshot and updates the labels
+void DiagnosticsPanel::sample()
+{
+    core::k8090::LinkStatistics statistics = k8090_->linkStatistics();
+    qint64 elapsed = 0;
+    if (sample_clock_.isValid()) {
+        elapsed = sample_clock_.restart();
+    } else {
+        sample_clock_.start();
+    }
+
+    queue_depth_label_->setText(tr("%1").arg(statistics.queue_depth));
+    failures_label_->setText(tr("%1").arg(statistics.failures));
+    command_delay_label_->setText(tr("%1 ms").arg(statistics.command_delay));
+    if (statistics.coalescing_window == 0) {
+        coalescing_window_label_->setText(tr("off"));
+    } else {
+        coalescing_window_label_->setText(tr("%1 ms").arg(statistics.coalescing_window));
+    }
+    dwell_label_->setText(tr("%1 transitions, %2 commands")
+                              .arg(statistics.dwell_suppressed_transitions)
+                              .arg(statistics.dwell_saved_commands));
+    if (statistics.latency_samples == 0) {
+        latency_label_->setText(tr("-"));
+    } else {
+        latency_label_->setText(tr("%1 / %2 / %3 ms (max %4 ms)")
+                                    .arg(statistics.latency_p50)
+                                    .arg(statistics.latency_p90)
+                                    .arg(statistics.latency_p99)
+                                    .arg(statistics.latency_max));
+    }
+
+    // the counters wrap modulo 2^32, so their differences are correct
+    if (has_previous_ && elapsed > 0) {
+        quint32 sent = statistics.sent_commands - previous_.sent_commands;
+        quint32 enqueued = statistics.enqueued_commands - previous_.enqueued_commands;
+        quint32 merged = statistics.merged_commands - previous_.merged_commands;
+        command_rate_label_->setText(tr("%1").arg(1000.0 * sent / elapsed, 0, 'f', 1));
+        if (measure_wakeups_check_box_->isChecked()) {
+            quint32 wakeups = statistics.wakeups - previous_.wakeups;
+            wakeup_rate_label_->setText(tr("%1").arg(1000.0 * wakeups / elapsed, 0, 'f', 1));
+        } else {
+            wakeup_rate_label_->setText(tr("off"));
+        }
+        if (enqueued == 0) {
+            merge_ratio_label_->setText(tr("-"));
+        } else {
+            merge_ratio_label_->setText(tr("%1 %").arg(100.0 * merged / enqueued, 0, 'f', 1));
+        }
+    } else {
+        command_rate_label_->setText(tr("-"));
+        merge_ratio_label_->setText(tr("-"));
+        wakeup_rate_label_->setText(measure_wakeups_check_box_->isChecked() ? tr("-") : tr("off"));
+    }
+    previous_ = statistics;
+    has_previous_ = true;
+}
+
+
+// clears the statistics of the card
+void DiagnosticsPanel::onResetButtonClicked()
+{
+    k8090_->resetLinkStatistics();
+    has_previous_ = false;
+    sample();
+}
+
+
+// switches the idle mode of the card
+void DiagnosticsPanel::onIdleModeToggled(bool checked)
+{
+    k8090_->setIdleMode(checked);
+}
+
+
+// starts or stops counting of the wakeups, the rate is computed from the next two samples
+void DiagnosticsPanel::onMeasureWakeupsToggled(bool checked)
+{
+    k8090_->setWakeupMeasurement(checked);
+    has_previous_ = false;
+    sample();
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
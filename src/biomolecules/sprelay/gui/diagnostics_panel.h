@@ -0,0 +1,118 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      diagnostics_panel.h
+ * \brief     The biomolecules::sprelay::gui::DiagnosticsPanel class which shows live statistics of the card link.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_GUI_DIAGNOSTICS_PANEL_H_
+#define BIOMOLECULES_SPRELAY_GUI_DIAGNOSTICS_PANEL_H_
+
+#include <memory>
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+// forward declarations
+class QCheckBox;
+class QHideEvent;
+class QLabel;
+class QPushButton;
+class QShowEvent;
+class QTimer;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+// forward declarations
+class K8090;
+}  // namespace k8090
+}  // namespace core
+
+namespace gui {
+
+/// \brief Widget which periodically samples and shows biomolecules::sprelay::core::k8090::K8090::linkStatistics().
+/// \headerfile ""
+class DiagnosticsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsPanel(core::k8090::K8090* k8090, QWidget* parent = nullptr);
+    DiagnosticsPanel(const DiagnosticsPanel&) = delete;
+    DiagnosticsPanel(DiagnosticsPanel&&) = delete;
+    DiagnosticsPanel& operator=(const DiagnosticsPanel&) = delete;
+    DiagnosticsPanel& operator=(DiagnosticsPanel&&) = delete;
+    ~DiagnosticsPanel() override;
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void sample();
+    void onResetButtonClicked();
+    void onIdleModeToggled(bool checked);
+    void onMeasureWakeupsToggled(bool checked);
+
+private:
+    static const int kSampleIntervalMs_ = 500;
+
+    core::k8090::K8090* k8090_;
+    std::unique_ptr<QTimer> sample_timer_;
+    QElapsedTimer sample_clock_;
+    core::k8090::LinkStatistics previous_;
+    bool has_previous_;
+
+    QLabel* queue_depth_label_;
+    QLabel* command_rate_label_;
+    QLabel* merge_ratio_label_;
+    QLabel* latency_label_;
+    QLabel* failures_label_;
+    QLabel* command_delay_label_;
+    QLabel* coalescing_window_label_;
+    QLabel* dwell_label_;
+    QLabel* wakeup_rate_label_;
+    QCheckBox* idle_mode_check_box_;
+    QCheckBox* measure_wakeups_check_box_;
+    QPushButton* reset_button_;
+};
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_GUI_DIAGNOSTICS_PANEL_H_
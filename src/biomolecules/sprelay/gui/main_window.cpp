@@ -37,9 +37,14 @@
 
 #include "main_window.h"
 
+#include <QDockWidget>
 #include <QString>
 
+#include "biomolecules/sprelay/core/k8090.h"
+
 #include "central_widget.h"
+#include "diagnostics_panel.h"
+#include "timeline_widget.h"
 
 namespace biomolecules {
 namespace sprelay {
@@ -49,12 +54,25 @@ namespace gui {
  * \brief Constructs the MainWindow
  *
  * The core of application functionality is inside biomolecules::sprelay::gui::CentralWidget which is created inside
- * the MainWindow.
+ * the MainWindow in the fast start mode. The live statistics of the card link are shown by
+ * biomolecules::sprelay::gui::DiagnosticsPanel in a dock widget, which can be closed when it is not needed. The
+ * relay history is plotted by biomolecules::sprelay::gui::TimelineWidget in another dock widget.
  */
 MainWindow::MainWindow()
 {
-    central_widget_ = new CentralWidget(nullptr, QString(), this);
+    k8090_ = new core::k8090::K8090{this};
+    central_widget_ = new CentralWidget(k8090_, QString(), this, true);
     setCentralWidget(central_widget_);
+
+    auto diagnostics_dock = new QDockWidget{tr("Diagnostics"), this};
+    diagnostics_panel_ = new DiagnosticsPanel{k8090_, diagnostics_dock};
+    diagnostics_dock->setWidget(diagnostics_panel_);
+    addDockWidget(Qt::RightDockWidgetArea, diagnostics_dock);
+
+    auto timeline_dock = new QDockWidget{tr("Timeline"), this};
+    timeline_widget_ = new TimelineWidget{k8090_, timeline_dock};
+    timeline_dock->setWidget(timeline_widget_);
+    addDockWidget(Qt::BottomDockWidgetArea, timeline_dock);
 }
 
 
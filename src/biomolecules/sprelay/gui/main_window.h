@@ -42,8 +42,16 @@
 
 namespace biomolecules {
 namespace sprelay {
+namespace core {
+namespace k8090 {
+class K8090;
+}  // namespace k8090
+}  // namespace core
+
 namespace gui {
 class CentralWidget;
+class DiagnosticsPanel;
+class TimelineWidget;
 
 /// \brief The application's main window.
 /// \headerfile ""
@@ -60,7 +68,10 @@ public:
     ~MainWindow() override;
 
 private:
+    core::k8090::K8090* k8090_;
     CentralWidget* central_widget_;
+    DiagnosticsPanel* diagnostics_panel_;
+    TimelineWidget* timeline_widget_;
 };
 
 }  // namespace gui
@@ -0,0 +1,81 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      port_enumerator.cpp
+ * \brief     The biomolecules::sprelay::gui::PortEnumerator class which lists serial ports in a worker thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "port_enumerator.h"
+
+#include "biomolecules/sprelay/core/k8090.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/*!
+ * \class PortEnumerator
+ *
+ * The enumeration of serial ports can take seconds on machines with many USB serial devices. The CentralWidget
+ * moves the enumerator to a worker thread, so the window can be shown before the ports are known.
+ *
+ * \remarks reentrant
+ */
+
+
+/*!
+ * \brief Constructs the enumerator.
+ * \param parent The object's parent in Qt ownership system.
+ */
+PortEnumerator::PortEnumerator(QObject* parent) : QObject{parent} {}
+
+
+/*!
+ * \fn void PortEnumerator::portsEnumerated(
+ *     const QList<biomolecules::sprelay::core::serial_utils::ComPortParams>& ports)
+ * \brief Emitted when the enumeration finishes.
+ * \param ports Available serial ports.
+ */
+
+
+/*!
+ * \brief Lists available serial ports and emits PortEnumerator::portsEnumerated().
+ */
+void PortEnumerator::enumerate()
+{
+    emit portsEnumerated(core::k8090::K8090::availablePorts());
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,70 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      port_enumerator.h
+ * \brief     The biomolecules::sprelay::gui::PortEnumerator class which lists serial ports in a worker thread.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_GUI_PORT_ENUMERATOR_H_
+#define BIOMOLECULES_SPRELAY_GUI_PORT_ENUMERATOR_H_
+
+#include <QList>
+#include <QObject>
+
+#include "biomolecules/sprelay/core/serial_port_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/// \brief Worker object, which lists available serial ports in the thread it lives in.
+/// \headerfile ""
+class PortEnumerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PortEnumerator(QObject* parent = nullptr);
+
+signals:
+    void portsEnumerated(const QList<biomolecules::sprelay::core::serial_utils::ComPortParams>& ports);
+
+public slots:
+    void enumerate();
+};
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_GUI_PORT_ENUMERATOR_H_
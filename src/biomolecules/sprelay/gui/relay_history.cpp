@@ -0,0 +1,241 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      relay_history.cpp
+ * \brief     The biomolecules::sprelay::gui::RelayHistory class which stores the relay and button history.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "relay_history.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/*!
+ * \class RelayHistory
+ *
+ * The history stores only the transitions of each relay and the button presses and releases, each with a timestamp
+ * in milliseconds supplied by the caller. The timestamps have to be nondecreasing. Each relay keeps at most
+ * RelayHistory::capacity() transitions and the same number of button events, the oldest ones are discarded.
+ *
+ * The history is queried for time ranges rather than for individual events. RelayHistory::levels() returns the
+ * minimum and the maximum of the relay state inside the range, which is all the TimelineWidget needs to draw one
+ * pixel column regardless of how many transitions fall into it. Each query costs two binary searches, so drawing
+ * hours of history costs the same as drawing a few seconds.
+ *
+ * \remark reentrant
+ */
+
+
+/*!
+ * \brief Default maximal number of transitions and button events stored per relay.
+ */
+const std::size_t RelayHistory::kDefaultCapacity = 100000;
+
+/*!
+ * \brief RelayHistory::levels() flag marking that the relay was switched off in the range.
+ */
+const unsigned char RelayHistory::kOff = 0x01;
+
+/*!
+ * \brief RelayHistory::levels() flag marking that the relay was switched on in the range.
+ */
+const unsigned char RelayHistory::kOn = 0x02;
+
+/*!
+ * \brief RelayHistory::buttonEvents() flag marking that the button was pressed in the range.
+ */
+const unsigned char RelayHistory::kPressed = 0x01;
+
+/*!
+ * \brief RelayHistory::buttonEvents() flag marking that the button was released in the range.
+ */
+const unsigned char RelayHistory::kReleased = 0x02;
+
+
+/*!
+ * \brief Constructs empty history.
+ * \param capacity Maximal number of transitions and button events stored per relay.
+ */
+RelayHistory::RelayHistory(std::size_t capacity)
+    : capacity_{std::max<std::size_t>(capacity, 1)}, has_relay_status_{false}, current_{core::k8090::RelayID::None}
+{}
+
+
+/*!
+ * \brief Records relay status.
+ *
+ * The first status records the state of all relays, the following ones record only the relays which changed.
+ *
+ * \param time The time of the status in milliseconds.
+ * \param current Relays which are currently switched on.
+ */
+void RelayHistory::addRelayStatus(qint64 time, core::k8090::RelayID current)
+{
+    core::k8090::RelayID changed = core::k8090::RelayID::All;
+    if (has_relay_status_) {
+        changed = current_ ^ current;
+    }
+    for (unsigned int i = 0; i < 8; ++i) {
+        core::k8090::RelayID relay = core::k8090::from_number(i);
+        if ((changed & relay) != core::k8090::RelayID::None) {
+            append(&transitions_[i], time, (current & relay) != core::k8090::RelayID::None, capacity_);
+        }
+    }
+    has_relay_status_ = true;
+    current_ = current;
+}
+
+
+/*!
+ * \brief Records button presses and releases.
+ * \param time The time of the status in milliseconds.
+ * \param pressed Buttons which were pressed.
+ * \param released Buttons which were released.
+ */
+void RelayHistory::addButtonStatus(qint64 time, core::k8090::RelayID pressed, core::k8090::RelayID released)
+{
+    for (unsigned int i = 0; i < 8; ++i) {
+        core::k8090::RelayID button = core::k8090::from_number(i);
+        if ((pressed & button) != core::k8090::RelayID::None) {
+            append(&buttons_[i], time, true, capacity_);
+        }
+        if ((released & button) != core::k8090::RelayID::None) {
+            append(&buttons_[i], time, false, capacity_);
+        }
+    }
+}
+
+
+/*!
+ * \brief Forgets the whole history.
+ */
+void RelayHistory::clear()
+{
+    has_relay_status_ = false;
+    current_ = core::k8090::RelayID::None;
+    for (auto& events : transitions_) {
+        events.clear();
+    }
+    for (auto& events : buttons_) {
+        events.clear();
+    }
+}
+
+
+/*!
+ * \fn std::size_t RelayHistory::capacity() const
+ * \brief Maximal number of transitions and button events stored per relay.
+ */
+
+/*!
+ * \fn std::size_t RelayHistory::transitionCount(unsigned int relay) const
+ * \brief Number of stored transitions of the relay.
+ * \param relay Relay number from 0 to 7.
+ */
+
+/*!
+ * \fn std::size_t RelayHistory::buttonEventCount(unsigned int relay) const
+ * \brief Number of stored button events of the relay.
+ * \param relay Relay number from 0 to 7.
+ */
+
+
+/*!
+ * \brief Minimum and maximum of the relay state in the time range.
+ * \param relay Relay number from 0 to 7.
+ * \param from The start of the range in milliseconds, inclusive.
+ * \param to The end of the range in milliseconds, exclusive.
+ * \return Combination of RelayHistory::kOff and RelayHistory::kOn flags, zero if the state is not known in the range.
+ */
+unsigned char RelayHistory::levels(unsigned int relay, qint64 from, qint64 to) const
+{
+    const std::deque<Event>& events = transitions_[relay];
+    auto first = firstAt(events, from);
+    auto last = firstAt(events, to);
+    unsigned char result = 0;
+    // the state before the range lasts into it unless a transition starts the range
+    if (first != events.begin() && (first == events.end() || first->time != from)) {
+        result |= std::prev(first)->value ? kOn : kOff;
+    }
+    // stored transitions alternate, so at most two of them are visited
+    for (auto it = first; it != last && result != (kOn | kOff); ++it) {
+        result |= it->value ? kOn : kOff;
+    }
+    return result;
+}
+
+
+/*!
+ * \brief Button events in the time range.
+ * \param relay Button number from 0 to 7.
+ * \param from The start of the range in milliseconds, inclusive.
+ * \param to The end of the range in milliseconds, exclusive.
+ * \return Combination of RelayHistory::kPressed and RelayHistory::kReleased flags.
+ */
+unsigned char RelayHistory::buttonEvents(unsigned int relay, qint64 from, qint64 to) const
+{
+    const std::deque<Event>& events = buttons_[relay];
+    auto last = firstAt(events, to);
+    unsigned char result = 0;
+    // presses and releases alternate too, so at most two of them are visited
+    for (auto it = firstAt(events, from); it != last && result != (kPressed | kReleased); ++it) {
+        result |= it->value ? kPressed : kReleased;
+    }
+    return result;
+}
+
+
+// appends event and discards the oldest one if the capacity is exceeded
+void RelayHistory::append(std::deque<Event>* events, qint64 time, bool value, std::size_t capacity)
+{
+    events->push_back(Event{time, value});
+    if (events->size() > capacity) {
+        events->pop_front();
+    }
+}
+
+
+// finds the first event which is not older than time
+std::deque<RelayHistory::Event>::const_iterator RelayHistory::firstAt(const std::deque<Event>& events, qint64 time)
+{
+    return std::lower_bound(
+        events.begin(), events.end(), time, [](const Event& event, qint64 value) { return event.time < value; });
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,98 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      relay_history.h
+ * \brief     The biomolecules::sprelay::gui::RelayHistory class which stores the relay and button history.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_GUI_RELAY_HISTORY_H_
+#define BIOMOLECULES_SPRELAY_GUI_RELAY_HISTORY_H_
+
+#include <array>
+#include <cstddef>
+#include <deque>
+
+#include <QtGlobal>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/// \brief In-memory buffer of relay transitions and button events with min/max downsampling queries.
+/// \headerfile ""
+class RelayHistory
+{
+public:
+    static const std::size_t kDefaultCapacity;
+    static const unsigned char kOff;
+    static const unsigned char kOn;
+    static const unsigned char kPressed;
+    static const unsigned char kReleased;
+
+    explicit RelayHistory(std::size_t capacity = kDefaultCapacity);
+
+    void addRelayStatus(qint64 time, core::k8090::RelayID current);
+    void addButtonStatus(qint64 time, core::k8090::RelayID pressed, core::k8090::RelayID released);
+    void clear();
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t transitionCount(unsigned int relay) const { return transitions_[relay].size(); }
+    std::size_t buttonEventCount(unsigned int relay) const { return buttons_[relay].size(); }
+    unsigned char levels(unsigned int relay, qint64 from, qint64 to) const;
+    unsigned char buttonEvents(unsigned int relay, qint64 from, qint64 to) const;
+
+private:
+    struct Event
+    {
+        qint64 time;
+        bool value;
+    };
+
+    static void append(std::deque<Event>* events, qint64 time, bool value, std::size_t capacity);
+    static std::deque<Event>::const_iterator firstAt(const std::deque<Event>& events, qint64 time);
+
+    std::size_t capacity_;
+    bool has_relay_status_;
+    core::k8090::RelayID current_;
+    std::array<std::deque<Event>, 8> transitions_;
+    std::array<std::deque<Event>, 8> buttons_;
+};
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_GUI_RELAY_HISTORY_H_
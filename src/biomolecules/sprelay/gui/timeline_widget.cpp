@@ -0,0 +1,385 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      timeline_widget.cpp
+ * \brief     The biomolecules::sprelay::gui::TimelineWidget class which plots the relay history.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "timeline_widget.h"
+
+#include <algorithm>
+
+#include <QHideEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QShowEvent>
+#include <QTimer>
+#include <QWheelEvent>
+
+#include "biomolecules/sprelay/core/k8090.h"
+
+#include "relay_history.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+/*!
+ * \class TimelineWidget
+ *
+ * The widget records every relay status and button status emitted by the card into a RelayHistory and plots one row
+ * per relay. Intervals, when the relay is switched on, are drawn as filled bars, button presses and releases as
+ * marks at the top of the row. Time flows from left to right, the right edge shows the present while the widget
+ * follows the card.
+ *
+ * The plot is downsampled to one min/max pair per pixel column, so the rendering cost depends only on the widget
+ * width and not on the number of events in the view. Columns, where the relay was both switched on and off, are
+ * drawn with lighter colour, so fast switching remains visible even at scales of minutes per pixel.
+ *
+ * The rendered plot is cached in a pixmap. While following the card, the cached pixmap is scrolled by whole columns
+ * and only the newly exposed columns are rendered, so appending new events never triggers a full redraw. New events
+ * always fall to the right of the rendered columns, because the rendered range never extends into the future. The
+ * whole plot is rendered only when the view is resized, zoomed or panned.
+ *
+ * The mouse wheel zooms the view, dragging pans it into the past and double click returns it to the present. The
+ * history is recorded all the time, the view is scrolled only while the widget is visible.
+ *
+ * \remarks reentrant
+ */
+
+
+/*!
+ * \brief Constructs the widget.
+ * \param k8090 The card, the history of which is shown.
+ * \param parent The widget's parent object in Qt ownership system.
+ */
+TimelineWidget::TimelineWidget(core::k8090::K8090* k8090, QWidget* parent)
+    : QWidget{parent},
+      history_{new RelayHistory},
+      scroll_timer_{new QTimer},
+      scale_{kDefaultScale_},
+      view_end_{0},
+      following_{true},
+      drag_x_{0},
+      drag_end_{0}
+{
+    clock_.start();
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(8 * kRowHeight_ + kAxisHeight_);
+    setToolTip(tr("Wheel zooms, dragging pans into the past, double click returns to the present."));
+
+    connect(k8090, &core::k8090::K8090::relayStatus, this, &TimelineWidget::onRelayStatus);
+    connect(k8090, &core::k8090::K8090::buttonStatus, this, &TimelineWidget::onButtonStatus);
+    connect(scroll_timer_.get(), &QTimer::timeout, this, &TimelineWidget::advance);
+}
+
+
+/*!
+ * \brief The destructor.
+ */
+TimelineWidget::~TimelineWidget() = default;
+
+
+/*!
+ * \brief Preferred size of the widget.
+ * \return The size.
+ */
+QSize TimelineWidget::sizeHint() const
+{
+    return QSize{kLabelWidth_ + 640, 8 * kRowHeight_ + kAxisHeight_};
+}
+
+
+/*!
+ * \brief Paints the cached plot, the relay labels and the time span.
+ * \param event The paint event.
+ */
+void TimelineWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter{this};
+    const QRect plot = plotRect();
+    const QRect exposed = event->rect() & plot;
+    if (!exposed.isEmpty()) {
+        painter.drawPixmap(exposed, cache_, exposed.translated(-plot.topLeft()));
+    }
+    if (plot.contains(event->rect())) {
+        return;
+    }
+
+    const QRect axis{kLabelWidth_, plot.bottom() + 1, plot.width(), height() - plot.height()};
+    painter.fillRect(QRect{0, 0, kLabelWidth_, height()}, palette().window());
+    painter.fillRect(axis, palette().window());
+    painter.setPen(palette().windowText().color());
+    for (int i = 0; i < 8; ++i) {
+        painter.drawText(QRect{4, i * kRowHeight_, kLabelWidth_ - 8, kRowHeight_},
+            Qt::AlignLeft | Qt::AlignVCenter,
+            tr("Relay %1").arg(i + 1));
+    }
+    const double span = static_cast<double>(plot.width() * scale_) / 1000.0;
+    QString text = tr("last %1 s").arg(span, 0, 'f', 1);
+    if (!following_) {
+        const double age = static_cast<double>(alignedNow() - view_end_) / 1000.0;
+        text = tr("%1 s ending %2 s ago").arg(span, 0, 'f', 1).arg(age, 0, 'f', 1);
+    }
+    painter.drawText(
+        QRect{axis.left(), axis.top(), axis.width(), kAxisHeight_}, Qt::AlignRight | Qt::AlignVCenter, text);
+}
+
+
+/*!
+ * \brief Renders the whole plot for the new size.
+ * \param event The resize event.
+ */
+void TimelineWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    const QRect plot = plotRect();
+    cache_ = QPixmap{std::max(plot.width(), 1), std::max(plot.height(), 1)};
+    renderAll();
+}
+
+
+/*!
+ * \brief Brings the plot up to date and starts scrolling when the widget is shown.
+ * \param event The show event.
+ */
+void TimelineWidget::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    if (following_) {
+        follow();
+    }
+    scroll_timer_->start(kScrollIntervalMs_);
+}
+
+
+/*!
+ * \brief Stops scrolling when the widget is hidden.
+ * \param event The hide event.
+ */
+void TimelineWidget::hideEvent(QHideEvent* event)
+{
+    scroll_timer_->stop();
+    QWidget::hideEvent(event);
+}
+
+
+/*!
+ * \brief Zooms the view in or out by the factor of two.
+ * \param event The wheel event.
+ */
+void TimelineWidget::wheelEvent(QWheelEvent* event)
+{
+    event->accept();
+    const qint64 scale = event->angleDelta().y() > 0 ? scale_ / 2 : scale_ * 2;
+    if (scale < kMinScale_ || scale > kMaxScale_) {
+        return;
+    }
+    scale_ = scale;
+    if (following_) {
+        follow();
+    } else {
+        view_end_ -= view_end_ % scale_;
+        renderAll();
+    }
+}
+
+
+/*!
+ * \brief Starts panning.
+ * \param event The mouse event.
+ */
+void TimelineWidget::mousePressEvent(QMouseEvent* event)
+{
+    drag_x_ = event->x();
+    drag_end_ = view_end_;
+    event->accept();
+}
+
+
+/*!
+ * \brief Pans the view.
+ *
+ * The view cannot be panned into the future. If it is panned to the present, it starts following the card again.
+ *
+ * \param event The mouse event.
+ */
+void TimelineWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!(event->buttons() & Qt::LeftButton)) {
+        return;
+    }
+    const qint64 now = alignedNow();
+    const qint64 end = drag_end_ + (drag_x_ - event->x()) * scale_;
+    if (end >= now) {
+        following_ = true;
+        follow();
+    } else {
+        following_ = false;
+        view_end_ = end;
+        renderAll();
+    }
+    event->accept();
+}
+
+
+/*!
+ * \brief Returns the view to the present.
+ * \param event The mouse event.
+ */
+void TimelineWidget::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    following_ = true;
+    follow();
+    event->accept();
+}
+
+
+// records the relay status
+void TimelineWidget::onRelayStatus(
+    core::k8090::RelayID previous, core::k8090::RelayID current, core::k8090::RelayID timed)
+{
+    Q_UNUSED(previous)
+    Q_UNUSED(timed)
+    history_->addRelayStatus(clock_.elapsed(), current);
+}
+
+
+// records the button presses and releases
+void TimelineWidget::onButtonStatus(
+    core::k8090::RelayID state, core::k8090::RelayID pressed, core::k8090::RelayID released)
+{
+    Q_UNUSED(state)
+    history_->addButtonStatus(clock_.elapsed(), pressed, released);
+}
+
+
+// scrolls the cached plot to the present and renders only the newly exposed columns
+void TimelineWidget::advance()
+{
+    if (!following_) {
+        return;
+    }
+    const qint64 end = alignedNow();
+    const qint64 columns = (end - view_end_) / scale_;
+    if (columns <= 0) {
+        return;
+    }
+    const QRect plot = plotRect();
+    view_end_ = end;
+    if (columns >= plot.width()) {
+        renderAll();
+        return;
+    }
+    const int dx = static_cast<int>(columns);
+    cache_.scroll(-dx, 0, cache_.rect());
+    renderColumns(plot.width() - dx, plot.width());
+    // moves the pixels already on the screen, only the exposed strip is repainted
+    scroll(-dx, 0, plot);
+}
+
+
+// the area of the plot inside the widget
+QRect TimelineWidget::plotRect() const
+{
+    return QRect{kLabelWidth_, 0, std::max(width() - kLabelWidth_, 0), 8 * kRowHeight_};
+}
+
+
+// the present time rounded down to whole columns, the last column is never partially rendered
+qint64 TimelineWidget::alignedNow() const
+{
+    const qint64 now = clock_.elapsed();
+    return now - now % scale_;
+}
+
+
+// moves the view to the present
+void TimelineWidget::follow()
+{
+    view_end_ = alignedNow();
+    renderAll();
+}
+
+
+// renders the whole cached plot
+void TimelineWidget::renderAll()
+{
+    if (cache_.isNull()) {
+        return;
+    }
+    renderColumns(0, cache_.width());
+    update();
+}
+
+
+// renders the pixel columns of the cached plot, each column shows min/max of the relay state in its time range
+void TimelineWidget::renderColumns(int from, int to)
+{
+    const QColor background = palette().base().color();
+    const QColor grid = palette().mid().color();
+    const QColor on = palette().highlight().color();
+    const QColor mixed = on.lighter(160);
+    const QColor off = palette().dark().color();
+    const QColor button = palette().link().color();
+
+    QPainter painter{&cache_};
+    painter.fillRect(QRect{from, 0, to - from, cache_.height()}, background);
+    const qint64 start = view_end_ - cache_.width() * scale_;
+    for (int i = 0; i < 8; ++i) {
+        const int top = i * kRowHeight_;
+        const int baseline = top + kRowHeight_ - 3;
+        painter.setPen(grid);
+        painter.drawLine(from, top + kRowHeight_ - 1, to - 1, top + kRowHeight_ - 1);
+        for (int x = from; x < to; ++x) {
+            const qint64 begin = start + x * scale_;
+            const unsigned char levels = history_->levels(static_cast<unsigned int>(i), begin, begin + scale_);
+            if (levels == RelayHistory::kOn) {
+                painter.fillRect(x, top + 4, 1, baseline - top - 3, on);
+            } else if (levels == (RelayHistory::kOn | RelayHistory::kOff)) {
+                painter.fillRect(x, top + 4, 1, baseline - top - 3, mixed);
+            } else if (levels == RelayHistory::kOff) {
+                painter.fillRect(x, baseline, 1, 1, off);
+            }
+            if (history_->buttonEvents(static_cast<unsigned int>(i), begin, begin + scale_) != 0) {
+                painter.fillRect(x, top + 1, 1, 2, button);
+            }
+        }
+    }
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
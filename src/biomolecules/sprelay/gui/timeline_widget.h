@@ -0,0 +1,137 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      timeline_widget.h
+ * \brief     The biomolecules::sprelay::gui::TimelineWidget class which plots the relay history.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_GUI_TIMELINE_WIDGET_H_
+#define BIOMOLECULES_SPRELAY_GUI_TIMELINE_WIDGET_H_
+
+#include <memory>
+
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QWidget>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+// forward declarations
+class QHideEvent;
+class QMouseEvent;
+class QPaintEvent;
+class QResizeEvent;
+class QShowEvent;
+class QTimer;
+class QWheelEvent;
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+// forward declarations
+class K8090;
+}  // namespace k8090
+}  // namespace core
+
+namespace gui {
+
+// forward declarations
+class RelayHistory;
+class TimelineWidgetBenchmark;
+
+/// \brief Widget which plots relay on/off intervals and button events of the card history.
+/// \headerfile ""
+class TimelineWidget : public QWidget
+{
+    Q_OBJECT
+    // the scrolling of the cached plot is verified on the private members
+    friend class TimelineWidgetBenchmark;
+
+public:
+    explicit TimelineWidget(core::k8090::K8090* k8090, QWidget* parent = nullptr);
+    TimelineWidget(const TimelineWidget&) = delete;
+    TimelineWidget(TimelineWidget&&) = delete;
+    TimelineWidget& operator=(const TimelineWidget&) = delete;
+    TimelineWidget& operator=(TimelineWidget&&) = delete;
+    ~TimelineWidget() override;
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private slots:
+    void onRelayStatus(core::k8090::RelayID previous, core::k8090::RelayID current, core::k8090::RelayID timed);
+    void onButtonStatus(core::k8090::RelayID state, core::k8090::RelayID pressed, core::k8090::RelayID released);
+    void advance();
+
+private:
+    static const int kRowHeight_ = 18;
+    static const int kLabelWidth_ = 64;
+    static const int kAxisHeight_ = 18;
+    static const int kScrollIntervalMs_ = 50;
+    static const qint64 kMinScale_ = 1;
+    static const qint64 kMaxScale_ = 60000;
+    static const qint64 kDefaultScale_ = 100;
+
+    QRect plotRect() const;
+    qint64 alignedNow() const;
+    void follow();
+    void renderAll();
+    void renderColumns(int from, int to);
+
+    std::unique_ptr<RelayHistory> history_;
+    std::unique_ptr<QTimer> scroll_timer_;
+    QElapsedTimer clock_;
+    QPixmap cache_;
+    qint64 scale_;
+    qint64 view_end_;
+    bool following_;
+    int drag_x_;
+    qint64 drag_end_;
+};
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_GUI_TIMELINE_WIDGET_H_
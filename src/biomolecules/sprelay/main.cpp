@@ -46,6 +46,9 @@
 int main(int argc, char* argv[])
 {
     QApplication a(argc, argv);
+    // used by QSettings, which stores the last used port
+    QApplication::setOrganizationName("biomolecules");
+    QApplication::setApplicationName("sprelay");
     biomolecules::sprelay::gui::MainWindow w;
     w.show();
 
@@ -0,0 +1,114 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      central_widget_benchmark.cpp
+ * \brief     The biomolecules::sprelay::gui::CentralWidgetBenchmark class which measures startup time of
+ *            biomolecules::sprelay::gui::CentralWidget.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "central_widget_benchmark.h"
+
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QSignalSpy>
+#include <QString>
+#include <QtTest>
+
+#include "biomolecules/sprelay/gui/central_widget.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+namespace {
+
+const int kPortsTimeout = 10000;
+
+void add_startup_modes()
+{
+    QTest::addColumn<bool>("fast_start");
+    QTest::newRow("full start") << false;
+    QTest::newRow("fast start") << true;
+}
+
+}  // namespace
+
+
+void CentralWidgetBenchmark::initTestCase()
+{
+    // the port remembered by previous runs would be connected automatically
+    QSettings{}.remove("last_port");
+}
+
+
+void CentralWidgetBenchmark::windowShown_data()
+{
+    add_startup_modes();
+}
+
+
+void CentralWidgetBenchmark::windowShown()
+{
+    QFETCH(bool, fast_start);
+    QElapsedTimer timer;
+    timer.start();
+    CentralWidget widget{nullptr, QString{}, nullptr, fast_start};
+    widget.show();
+    QCoreApplication::processEvents();
+    // the widget destruction, which waits for the port enumeration, is not measured
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+}
+
+
+void CentralWidgetBenchmark::portsReady_data()
+{
+    add_startup_modes();
+}
+
+
+void CentralWidgetBenchmark::portsReady()
+{
+    QFETCH(bool, fast_start);
+    QElapsedTimer timer;
+    timer.start();
+    CentralWidget widget{nullptr, QString{}, nullptr, fast_start};
+    if (fast_start) {
+        QSignalSpy ports_spy{&widget, SIGNAL(portsInitialized())};
+        QVERIFY(ports_spy.wait(kPortsTimeout));
+    }
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
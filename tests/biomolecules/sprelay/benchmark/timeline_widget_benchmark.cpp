@@ -0,0 +1,134 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      timeline_widget_benchmark.cpp
+ * \brief     The biomolecules::sprelay::gui::TimelineWidgetBenchmark class which measures rendering cost of
+ *            biomolecules::sprelay::gui::TimelineWidget.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "timeline_widget_benchmark.h"
+
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/gui/timeline_widget.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+namespace {
+
+const int kAppends = 1000;
+
+}  // namespace
+
+
+void TimelineWidgetBenchmark::appendWithoutRedraw()
+{
+    core::k8090::K8090 k8090;
+    TimelineWidget widget{&k8090};
+    widget.resize(widget.sizeHint());
+    widget.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&widget));
+    widget.follow();
+    core::k8090::RelayID current = core::k8090::RelayID::None;
+    auto toggle = [&widget, &current]() {
+        current ^= core::k8090::RelayID::One;
+        widget.onRelayStatus(core::k8090::RelayID::None, current, core::k8090::RelayID::None);
+    };
+
+    // the marker survives in the cached plot unless the whole plot is rendered again
+    const QColor marker{Qt::magenta};
+    const int x = widget.cache_.width() / 2;
+    QPainter{&widget.cache_}.fillRect(x, 0, 1, 1, marker);
+    const qint64 view_end = widget.view_end_;
+
+    for (int i = 0; i < kAppends; ++i) {
+        toggle();
+        widget.advance();
+    }
+    QTest::qWait(static_cast<int>(3 * widget.scale_));
+    toggle();
+    widget.advance();
+
+    // the plot was scrolled by whole columns only
+    const int dx = static_cast<int>((widget.view_end_ - view_end) / widget.scale_);
+    QVERIFY2(dx > 0, "The plot was not scrolled.");
+    QVERIFY(dx <= x);
+    QCOMPARE(widget.cache_.toImage().pixel(x - dx, 0), marker.rgb());
+}
+
+
+void TimelineWidgetBenchmark::renderCost_data()
+{
+    QTest::addColumn<bool>("append");
+
+    QTest::newRow("append and scroll") << true;
+    QTest::newRow("full redraw") << false;
+}
+
+
+void TimelineWidgetBenchmark::renderCost()
+{
+    QFETCH(bool, append);
+    core::k8090::K8090 k8090;
+    TimelineWidget widget{&k8090};
+    widget.resize(widget.sizeHint());
+    widget.show();
+    core::k8090::RelayID current = core::k8090::RelayID::None;
+    auto toggle = [&widget, &current]() {
+        current ^= core::k8090::RelayID::One;
+        widget.onRelayStatus(core::k8090::RelayID::None, current, core::k8090::RelayID::None);
+    };
+    for (int i = 0; i < kAppends; ++i) {
+        toggle();
+    }
+    widget.follow();
+
+    QBENCHMARK {
+        if (append) {
+            toggle();
+            widget.advance();
+        } else {
+            widget.renderAll();
+        }
+    }
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules
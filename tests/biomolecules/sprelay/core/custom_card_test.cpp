@@ -0,0 +1,117 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      custom_card_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::CustomCardTest class which tests K8090 subclass controlling other
+ *            than %K8090 card.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "custom_card_test.h"
+
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/card_traits.h"
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+// imaginary card with four relays, the protocol of K8090 and slower timing, defined only by the installed headers
+struct FourRelayTraits
+{
+    static constexpr unsigned int kRelayCount = 4;
+    static constexpr int kCommandDelay = 20;
+    static constexpr int kFactoryDefaultsDelayFactor = 3;
+    static constexpr int kFailureDelay = 500;
+    static constexpr int kMaxFailureCount = 5;
+    static constexpr quint16 kProductID = 1;
+    static constexpr quint16 kVendorID = 2;
+
+    static const impl_::CommandTable& commands() { return impl_::kCommands; }
+    static const impl_::PriorityTable& priorities() { return impl_::kPriorities; }
+    static const impl_::ResponseTable& responses() { return impl_::kResponses; }
+};
+
+class FourRelayCard : public K8090
+{
+public:
+    explicit FourRelayCard(QObject* parent = nullptr) : K8090{impl_::card_descriptor<FourRelayTraits>(), parent} {}
+};
+
+const int kResponseDelay = 10;
+
+}  // namespace
+
+
+void CustomCardTest::relayWear()
+{
+    // the statistics are sized by the relay count of the card
+    FourRelayCard card;
+    std::vector<RelayWear> wear = card.relayWear();
+    QCOMPARE(wear.size(), static_cast<std::size_t>(FourRelayTraits::kRelayCount));
+    for (const RelayWear& relay : wear) {
+        QCOMPARE(relay.switch_count, quint64{0});
+    }
+    K8090 k8090;
+    QCOMPARE(k8090.relayWear().size(), static_cast<std::size_t>(impl_::K8090Traits::kRelayCount));
+}
+
+
+void CustomCardTest::planExecution()
+{
+    // the commands are spaced by the default command delay of the card
+    FourRelayCard card;
+    ExecutionPlan plan = card.planExecution({CardCommand{CommandID::RelayOn, RelayID::One, 0, 0}}, kResponseDelay);
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QCOMPARE(plan.commands[1].command.id, CommandID::QueryRelay);
+    QCOMPARE(plan.commands[1].send_time, FourRelayTraits::kCommandDelay);
+
+    // the factory defaults are followed by the query after the longer delay of the card
+    plan = card.planExecution({CardCommand{CommandID::ResetFactoryDefaults, RelayID::None, 0, 0}}, kResponseDelay);
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QCOMPARE(plan.commands[1].command.id, CommandID::QueryRelay);
+    QCOMPARE(plan.commands[1].send_time, FourRelayTraits::kFactoryDefaultsDelayFactor * FourRelayTraits::kCommandDelay);
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
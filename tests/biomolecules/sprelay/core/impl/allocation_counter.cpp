@@ -0,0 +1,147 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      allocation_counter.cpp
+ * \brief     Utilities counting heap allocations in sprelay tests.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// allocations made by the thread, other threads of the test do not disturb the counting
+thread_local std::size_t thread_allocation_count = 0;
+
+}  // namespace
+
+
+// The global allocation functions are replaced in the whole test executable. They only count the allocations and
+// forward them to malloc, so the tests which do not use AllocationCounter are not affected.
+void* operator new(std::size_t size)
+{
+    ++thread_allocation_count;
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* ptr = std::malloc(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+void operator delete[](void* ptr) noexcept
+{
+    ::operator delete(ptr);
+}
+
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+/*!
+ * \class AllocationCounter
+ *
+ * The counter is used to check per-operation allocation budgets. Only the allocations made through the global
+ * operator new in the thread, which created the counter, are counted. Qt containers like QList, QByteArray or QString
+ * allocate their storage by malloc directly, so they are not counted.
+ *
+ * \code
+ * AllocationCounter counter;
+ * queue.pop();
+ * QCOMPARE(counter.count(), std::size_t{0});
+ * \endcode
+ */
+
+
+/*!
+ * \brief Starts counting.
+ */
+AllocationCounter::AllocationCounter() : start_{thread_allocation_count} {}
+
+
+/*!
+ * \brief Number of allocations since the construction or the last AllocationCounter::reset().
+ */
+std::size_t AllocationCounter::count() const
+{
+    return thread_allocation_count - start_;
+}
+
+
+/*!
+ * \brief Starts counting again from zero.
+ */
+void AllocationCounter::reset()
+{
+    start_ = thread_allocation_count;
+}
+
+
+/*!
+ * \brief Describes allocation budget check for test failure messages.
+ * \param operation Name of the checked operation.
+ * \param count Number of allocations made by the operation.
+ * \param budget Maximal allowed number of allocations.
+ * \return The description.
+ */
+QString allocation_budget_message(const char* operation, std::size_t count, std::size_t budget)
+{
+    return QString{"%1 made %2 allocations, the budget is %3."}.arg(operation).arg(count).arg(budget);
+}
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
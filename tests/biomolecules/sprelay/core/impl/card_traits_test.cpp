@@ -0,0 +1,151 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      card_traits_test.cpp
+ * \brief     Test suite for card traits of Velleman K8090 compatible cards.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "card_traits_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/card_traits.h"
+#include "biomolecules/sprelay/core/concurent_command_queue.h"
+#include "biomolecules/sprelay/core/execution_planner.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// imaginary card with four relays, different relay status code, slower factory reset and reversed priorities
+struct TestTraits
+{
+    static constexpr unsigned int kRelayCount = 4;
+    static constexpr int kCommandDelay = 20;
+    static constexpr int kFactoryDefaultsDelayFactor = 3;
+    static constexpr int kFailureDelay = 500;
+    static constexpr int kMaxFailureCount = 5;
+    static constexpr quint16 kProductID = 1;
+    static constexpr quint16 kVendorID = 2;
+
+    static const CommandTable& commands() { return kCommands; }
+    static const PriorityTable& priorities()
+    {
+        static const PriorityTable priorities{{2, 2, 2, 1, 2, 1, 2, 2, 1, 2, 2, 2}};
+        return priorities;
+    }
+    static const ResponseTable& responses()
+    {
+        static const ResponseTable responses{{0x22, 0x44, 0x50, 0x52, 0x70, 0x71}};
+        return responses;
+    }
+};
+
+const int kResponseDelay = 10;
+
+}  // namespace
+
+
+void CardTraitsTest::k8090Descriptor()
+{
+    const CardDescriptor& card = card_descriptor<K8090Traits>();
+    QCOMPARE(&card, &card_descriptor<K8090Traits>());
+    QCOMPARE(card.commands, kCommands.data());
+    QCOMPARE(card.priorities, kPriorities.data());
+    QCOMPARE(card.relay_count, 8u);
+    QCOMPARE(card.command_delay, 50);
+    QCOMPARE(card.factory_defaults_delay_factor, 2);
+    QCOMPARE(card.product_id, kProductID);
+    QCOMPARE(card.vendor_id, kVendorID);
+    for (unsigned int i = 0; i < kResponses.size(); ++i) {
+        QCOMPARE(card.response_ids[kResponses[i]], static_cast<ResponseID>(i));
+    }
+    QCOMPARE(card.response_ids[0x00], ResponseID::None);
+    QCOMPARE(card.response_ids[kCommands[as_number(CommandID::RelayOn)]], ResponseID::None);
+}
+
+
+void CardTraitsTest::customDescriptor()
+{
+    const CardDescriptor& card = card_descriptor<TestTraits>();
+    QVERIFY(&card != &card_descriptor<K8090Traits>());
+    QCOMPARE(card.relay_count, 4u);
+    QCOMPARE(card.command_delay, 20);
+    QCOMPARE(card.factory_defaults_delay_factor, 3);
+    QCOMPARE(card.failure_delay, 500);
+    QCOMPARE(card.max_failure_count, 5);
+    QCOMPARE(card.product_id, quint16{1});
+    QCOMPARE(card.vendor_id, quint16{2});
+    QCOMPARE(card.response_ids[0x52], ResponseID::RelayStatus);
+    QCOMPARE(card.response_ids[0x51], ResponseID::None);
+    QCOMPARE(card.response_ids[0x50], ResponseID::ButtonStatus);
+}
+
+
+void CardTraitsTest::customPriorities()
+{
+    ConcurentCommandQueue queue{card_descriptor<TestTraits>().priorities};
+    queue.updateOrPush(CommandID::QueryRelay, RelayID::None, 0, 0);
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0);
+
+    // query has lower priority than the relay switching on the test card
+    QCOMPARE(queue.pop().id, CommandID::RelayOn);
+    QCOMPARE(queue.pop().id, CommandID::QueryRelay);
+    QVERIFY(queue.empty());
+}
+
+
+void CardTraitsTest::customPlanner()
+{
+    const CardDescriptor& card = card_descriptor<TestTraits>();
+    ExecutionPlanner planner{card.command_delay, kResponseDelay, card};
+    planner.enqueue(CardCommand{CommandID::ResetFactoryDefaults, RelayID::None, 0, 0});
+    ExecutionPlan plan = planner.plan();
+
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QCOMPARE(plan.commands[1].command.id, CommandID::QueryRelay);
+    QCOMPARE(plan.commands[1].send_time, 3 * card.command_delay);
+    QCOMPARE(plan.completion_time, 4 * card.command_delay);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
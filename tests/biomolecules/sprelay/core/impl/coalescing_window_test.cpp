@@ -0,0 +1,129 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      coalescing_window_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CoalescingWindowTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::CoalescingWindow.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "coalescing_window_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/coalescing_window.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void CoalescingWindowTest::disabled()
+{
+    CoalescingWindow window;
+    QVERIFY(!window.enabled());
+    QCOMPARE(window.window(), 0);
+
+    window.setMaxWindow(-5);
+    QVERIFY(!window.enabled());
+    QCOMPARE(window.maxWindow(), 0);
+
+    window.setMaxWindow(20);
+    QVERIFY(window.enabled());
+    QCOMPARE(window.window(), 20);
+}
+
+
+void CoalescingWindowTest::shrinkForLoneCommands()
+{
+    CoalescingWindow window;
+    window.setMaxWindow(20);
+    // the window moves halfway to twice the burst span
+    QCOMPARE(window.startBurst(), 20);
+    window.commandArrived(3);
+    QCOMPARE(window.burstSize(), 2);
+    QCOMPARE(window.startBurst(), 13);
+    window.commandArrived(3);
+    QCOMPARE(window.startBurst(), 10);
+    // lone commands shrink the window to 1 ms
+    QCOMPARE(window.startBurst(), 5);
+    QCOMPARE(window.startBurst(), 3);
+    QCOMPARE(window.startBurst(), 2);
+    QCOMPARE(window.startBurst(), 1);
+    QCOMPARE(window.startBurst(), 1);
+}
+
+
+void CoalescingWindowTest::growForBursts()
+{
+    CoalescingWindow window;
+    window.setMaxWindow(20);
+    for (int i = 0; i < 10; ++i) {
+        window.startBurst();
+    }
+    QCOMPARE(window.window(), 1);
+
+    // commands later than the maximal window do not belong to the burst
+    window.commandArrived(30);
+    QCOMPARE(window.burstSize(), 1);
+    QCOMPARE(window.startBurst(), 1);
+
+    // commands after the closed window are counted, so the window grows
+    window.commandArrived(9);
+    QCOMPARE(window.startBurst(), 10);
+    window.commandArrived(15);
+    QCOMPARE(window.startBurst(), 15);
+
+    // the maximum restarts the adaptation
+    window.setMaxWindow(8);
+    QCOMPARE(window.startBurst(), 8);
+}
+
+
+void CoalescingWindowTest::endBurst()
+{
+    CoalescingWindow window;
+    window.setMaxWindow(20);
+    QCOMPARE(window.startBurst(), 20);
+    window.commandArrived(2);
+    window.endBurst();
+    window.commandArrived(5);
+    QCOMPARE(window.burstSize(), 2);
+    QCOMPARE(window.startBurst(), 5 + (20 - 5) / 2);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
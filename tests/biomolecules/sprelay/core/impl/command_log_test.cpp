@@ -0,0 +1,176 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      command_log_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::CommandLogTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::CommandLog.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "command_log_test.h"
+
+#include <vector>
+
+#include <QByteArray>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/command_log.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void CommandLogTest::loggedCommands()
+{
+    QVERIFY(CommandLog::isLogged(CommandID::RelayOn));
+    QVERIFY(CommandLog::isLogged(CommandID::SetTimer));
+    QVERIFY(CommandLog::isLogged(CommandID::ResetFactoryDefaults));
+    QVERIFY(!CommandLog::isLogged(CommandID::QueryRelay));
+    QVERIFY(!CommandLog::isLogged(CommandID::Timer));
+
+    CommandLog log;
+    QVERIFY(!log.hasPendingRecords());
+    log.append(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    QVERIFY(log.hasPendingRecords());
+    QVERIFY(log.hasUncommittedCommands());
+    QVERIFY(log.hasUnacknowledgedCommands());
+
+    // the commit releases the commands but does not acknowledge them
+    bool truncate = true;
+    QCOMPARE(log.takePendingRecords(&truncate).size(), 6);
+    QVERIFY(!truncate);
+    QVERIFY(!log.hasPendingRecords());
+    QVERIFY(!log.hasUncommittedCommands());
+    QVERIFY(log.hasUnacknowledgedCommands());
+}
+
+
+void CommandLogTest::recover()
+{
+    CommandLog log;
+    log.append(CardCommand{CommandID::RelayOn, RelayID::One | RelayID::Three, 0, 0});
+    log.append(CardCommand{CommandID::SetTimer, RelayID::Two, 0x12, 0x34});
+    bool truncate = false;
+    QByteArray data = log.takePendingRecords(&truncate);
+
+    CommandLog recovered;
+    QCOMPARE(recovered.recover(data), data.size());
+    QVERIFY(recovered.hasUnacknowledgedCommands());
+    QVERIFY(!recovered.hasRecoveredRelays());
+    const std::vector<CardCommand>& commands = recovered.recoveredCommands();
+    QCOMPARE(commands.size(), std::vector<CardCommand>::size_type{2});
+    QCOMPARE(commands[0].id, CommandID::RelayOn);
+    QCOMPARE(commands[0].mask, RelayID::One | RelayID::Three);
+    QCOMPARE(commands[1].id, CommandID::SetTimer);
+    QCOMPARE(commands[1].mask, RelayID::Two);
+    QCOMPARE(commands[1].param1, static_cast<unsigned char>(0x12));
+    QCOMPARE(commands[1].param2, static_cast<unsigned char>(0x34));
+
+    recovered.clearRecovered();
+    QVERIFY(recovered.recoveredCommands().empty());
+}
+
+
+void CommandLogTest::tornTail()
+{
+    CommandLog log;
+    log.append(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    log.append(CardCommand{CommandID::RelayOff, RelayID::Two, 0, 0});
+    bool truncate = false;
+    QByteArray data = log.takePendingRecords(&truncate);
+
+    // incomplete record is ignored
+    CommandLog recovered;
+    QCOMPARE(recovered.recover(data.left(9)), 6);
+    QCOMPARE(recovered.recoveredCommands().size(), std::vector<CardCommand>::size_type{1});
+
+    // record with invalid checksum stops the recovery
+    data[7] = static_cast<char>(data[7] ^ 0x40);
+    QCOMPARE(recovered.recover(data), 6);
+    QCOMPARE(recovered.recoveredCommands().size(), std::vector<CardCommand>::size_type{1});
+
+    QCOMPARE(recovered.recover(QByteArray{}), 0);
+    QVERIFY(recovered.recoveredCommands().empty());
+    QVERIFY(!recovered.hasUnacknowledgedCommands());
+}
+
+
+void CommandLogTest::checkpoint()
+{
+    CommandLog log;
+    log.append(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    log.checkpoint(true, RelayID::One);
+    QVERIFY(!log.hasUnacknowledgedCommands());
+    log.append(CardCommand{CommandID::ToggleRelay, RelayID::Two, 0, 0});
+
+    // the records before the checkpoint are compacted
+    bool truncate = false;
+    QByteArray data = log.takePendingRecords(&truncate);
+    QVERIFY(truncate);
+    QCOMPARE(data.size(), 12);
+
+    CommandLog recovered;
+    QCOMPARE(recovered.recover(data), 12);
+    QVERIFY(recovered.hasRecoveredRelays());
+    QCOMPARE(recovered.recoveredRelays(), RelayID::One);
+    QCOMPARE(recovered.recoveredCommands().size(), std::vector<CardCommand>::size_type{1});
+    QCOMPARE(recovered.recoveredCommands()[0].id, CommandID::ToggleRelay);
+
+    // the last checkpoint acknowledges all the commands
+    log.checkpoint(false, RelayID::None);
+    data += log.takePendingRecords(&truncate);
+    QCOMPARE(recovered.recover(data), 18);
+    QVERIFY(!recovered.hasRecoveredRelays());
+    QVERIFY(recovered.recoveredCommands().empty());
+}
+
+
+void CommandLogTest::expectedRelays()
+{
+    std::vector<CardCommand> commands{CardCommand{CommandID::RelayOn, RelayID::One | RelayID::Two, 0, 0},
+        CardCommand{CommandID::RelayOff, RelayID::Three, 0, 0}, CardCommand{CommandID::ToggleRelay, RelayID::Two, 0, 0},
+        CardCommand{CommandID::StartTimer, RelayID::Four, 0, 0}};
+    QCOMPARE(CommandLog::expectedRelays(RelayID::Three | RelayID::Five, commands), RelayID::One | RelayID::Five);
+
+    commands.push_back(CardCommand{CommandID::ResetFactoryDefaults, RelayID::None, 0, 0});
+    commands.push_back(CardCommand{CommandID::RelayOn, RelayID::Eight, 0, 0});
+    QCOMPARE(CommandLog::expectedRelays(RelayID::Three, commands), RelayID::Eight);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -38,12 +38,17 @@
 
 #include "command_queue_test.h"
 
+#include <cstddef>
+
 #include <QtTest>
 
 #include "biomolecules/sprelay/core/command_queue.h"
+#include "biomolecules/sprelay/core/concurent_command_queue.h"
 #include "biomolecules/sprelay/core/k8090.h"
 #include "biomolecules/sprelay/core/k8090_utils.h"
 
+#include "allocation_counter.h"
+
 namespace biomolecules {
 namespace sprelay {
 namespace core {
@@ -51,6 +56,13 @@ namespace command_queue {
 
 using Command = biomolecules::sprelay::core::k8090::impl_::Command;
 
+namespace {
+
+// the command node owned by the queue, storages of the queue are warmed up in the tests
+const std::size_t kPushBudget = 1;
+
+}  // namespace
+
 void CommandQueueTest::uniquePush()
 {
     CommandQueue<Command, k8090::as_number(k8090::CommandID::None)> command_queue;
@@ -208,6 +220,103 @@ void CommandQueueTest::updateCommand()
     QCOMPARE(command_queue.size(), std::size_t{0});
 }
 
+void CommandQueueTest::pushAllocations()
+{
+    CommandQueue<Command, k8090::as_number(k8090::CommandID::None)> command_queue;
+    Command cmd1{k8090::CommandID::RelayOn, 1, 1, 2, 3};
+    Command cmd2{k8090::CommandID::RelayOff, 1, 2, 3, 4};
+    // warm up the heap storage
+    command_queue.push(cmd1);
+    command_queue.push(cmd2);
+    command_queue.pop();
+    command_queue.pop();
+
+    AllocationCounter counter;
+    command_queue.push(cmd1);
+    std::size_t count = counter.count();
+    QVERIFY2(count <= kPushBudget, qPrintable(allocation_budget_message("unique push", count, kPushBudget)));
+
+    counter.reset();
+    command_queue.push(cmd2, false);
+    count = counter.count();
+    QVERIFY2(count <= kPushBudget, qPrintable(allocation_budget_message("not unique push", count, kPushBudget)));
+}
+
+void CommandQueueTest::popAllocations()
+{
+    CommandQueue<Command, k8090::as_number(k8090::CommandID::None)> command_queue;
+    command_queue.push(Command{k8090::CommandID::RelayOn, 1, 1, 2, 3});
+    command_queue.push(Command{k8090::CommandID::RelayOff, 2, 2, 3, 4});
+
+    AllocationCounter counter;
+    command_queue.pop();
+    command_queue.pop();
+    command_queue.pop();  // empty queue
+    QCOMPARE(counter.count(), std::size_t{0});
+}
+
+void CommandQueueTest::updateAllocations()
+{
+    CommandQueue<Command, k8090::as_number(k8090::CommandID::None)> command_queue;
+    const int priority = 1;
+    command_queue.push(Command{k8090::CommandID::RelayOn, priority, 1, 2, 3}, false);
+    command_queue.push(Command{k8090::CommandID::RelayOn, priority, 2, 3, 4}, false);
+    command_queue.push(Command{k8090::CommandID::RelayOff, priority, 1, 2, 3});
+
+    // updates keeping the priority don't reorder the queue
+    AllocationCounter counter;
+    command_queue.updateCommand(1, Command{k8090::CommandID::RelayOn, priority, 5, 6, 7});
+    // unique push of already enqueued command is an update
+    command_queue.push(Command{k8090::CommandID::RelayOff, priority, 4, 5, 6});
+    int pending = command_queue.get(k8090::CommandID::RelayOn).size();
+    QCOMPARE(counter.count(), std::size_t{0});
+    QCOMPARE(pending, 2);
+}
+
+void CommandQueueTest::vectorListAllocations()
+{
+    // the index of the commands with the same id is counted only when it uses the global operator new
+    CommandQueue<Command, k8090::as_number(k8090::CommandID::None), VectorList> command_queue;
+    Command cmd1{k8090::CommandID::RelayOn, 1, 1, 2, 3};
+    Command cmd2{k8090::CommandID::RelayOn, 1, 2, 3, 4};
+    // warm up the heap storage and the index
+    command_queue.push(cmd1, false);
+    command_queue.push(cmd2, false);
+    command_queue.pop();
+    command_queue.pop();
+
+    AllocationCounter counter;
+    command_queue.push(cmd1, false);
+    std::size_t count = counter.count();
+    QVERIFY2(count <= kPushBudget, qPrintable(allocation_budget_message("first indexed push", count, kPushBudget)));
+
+    counter.reset();
+    command_queue.push(cmd2, false);
+    count = counter.count();
+    QVERIFY2(count <= kPushBudget, qPrintable(allocation_budget_message("second indexed push", count, kPushBudget)));
+    QCOMPARE(command_queue.get(k8090::CommandID::RelayOn).size(), 2);
+
+    counter.reset();
+    command_queue.pop();
+    command_queue.pop();
+    QCOMPARE(counter.count(), std::size_t{0});
+}
+
+void CommandQueueTest::mergeAllocations()
+{
+    k8090::impl_::ConcurentCommandQueue command_queue;
+    command_queue.updateOrPush(k8090::CommandID::RelayOn, k8090::RelayID::One, 0, 0);
+    command_queue.updateOrPush(k8090::CommandID::RelayOff, k8090::RelayID::Two, 0, 0);
+
+    // compatible commands are merged into the pending ones
+    AllocationCounter counter;
+    command_queue.updateOrPush(k8090::CommandID::RelayOn, k8090::RelayID::Three, 0, 0);
+    command_queue.updateOrPush(k8090::CommandID::RelayOff, k8090::RelayID::One, 0, 0);
+    int pending = command_queue.count(k8090::CommandID::RelayOn);
+    QCOMPARE(counter.count(), std::size_t{0});
+    QCOMPARE(pending, 1);
+}
+
 }  // namespace command_queue
 }  // namespace core
 }  // namespace sprelay
@@ -55,6 +55,11 @@ private slots:
     void uniquePush();
     void notUniquePush();
     void updateCommand();
+    void pushAllocations();
+    void popAllocations();
+    void updateAllocations();
+    void vectorListAllocations();
+    void mergeAllocations();
 };
 
 // NOLINTNEXTLINE(cert-err58-cpp, fuchsia-statically-constructed-objects)
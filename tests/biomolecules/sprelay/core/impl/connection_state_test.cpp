@@ -0,0 +1,170 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      connection_state_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ConnectionStateTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::ConnectionState.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "connection_state_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/connection_state.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+Q_DECLARE_METATYPE(biomolecules::sprelay::core::k8090::impl_::ResponseAction)
+Q_DECLARE_METATYPE(biomolecules::sprelay::core::k8090::ResponseID)
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void ConnectionStateTest::lifecycle()
+{
+    ConnectionState state;
+    QCOMPARE(state.phase(), ConnectionPhase::Disconnected);
+    QVERIFY(!state.isActive());
+
+    QVERIFY(state.transition(ConnectionEvent::Connect));
+    QCOMPARE(state.phase(), ConnectionPhase::Connecting);
+    QVERIFY(state.isActive());
+    QVERIFY(!state.isConnected());
+
+    QVERIFY(state.transition(ConnectionEvent::Establish));
+    QVERIFY(state.isConnected());
+
+    // reconnection of the connected card
+    QVERIFY(state.transition(ConnectionEvent::Connect));
+    QCOMPARE(state.phase(), ConnectionPhase::Connecting);
+
+    QVERIFY(state.transition(ConnectionEvent::Disconnect));
+    QCOMPARE(state.phase(), ConnectionPhase::Disconnected);
+}
+
+
+void ConnectionStateTest::rejectedTransitions()
+{
+    ConnectionState state;
+    QVERIFY(!state.transition(ConnectionEvent::Establish));
+    QVERIFY(!state.transition(ConnectionEvent::Disconnect));
+    QCOMPARE(state.phase(), ConnectionPhase::Disconnected);
+
+    state.transition(ConnectionEvent::Connect);
+    QVERIFY(!state.transition(ConnectionEvent::Connect));
+    QCOMPARE(state.phase(), ConnectionPhase::Connecting);
+
+    state.transition(ConnectionEvent::Establish);
+    QVERIFY(!state.transition(ConnectionEvent::Establish));
+    QCOMPARE(state.phase(), ConnectionPhase::Connected);
+
+    // the connection can't be established after the disconnection
+    state.transition(ConnectionEvent::Connect);
+    state.transition(ConnectionEvent::Disconnect);
+    QVERIFY(!state.transition(ConnectionEvent::Establish));
+    QCOMPARE(state.phase(), ConnectionPhase::Disconnected);
+}
+
+
+void ConnectionStateTest::responseActions_data()
+{
+    QTest::addColumn<ResponseID>("response");
+    QTest::addColumn<ResponseAction>("disconnected");
+    QTest::addColumn<ResponseAction>("connecting");
+    QTest::addColumn<ResponseAction>("connected");
+
+    QTest::newRow("button mode") << ResponseID::ButtonMode << ResponseAction::Fail << ResponseAction::Handshake
+                                 << ResponseAction::Deliver;
+    QTest::newRow("timer") << ResponseID::Timer << ResponseAction::Fail << ResponseAction::Handshake
+                           << ResponseAction::Deliver;
+    QTest::newRow("button status") << ResponseID::ButtonStatus << ResponseAction::Ignore << ResponseAction::Ignore
+                                   << ResponseAction::Deliver;
+    QTest::newRow("relay status") << ResponseID::RelayStatus << ResponseAction::Ignore << ResponseAction::Handshake
+                                  << ResponseAction::Deliver;
+    QTest::newRow("jumper status") << ResponseID::JumperStatus << ResponseAction::Fail << ResponseAction::Handshake
+                                   << ResponseAction::Deliver;
+    QTest::newRow("firmware version") << ResponseID::FirmwareVersion << ResponseAction::Fail
+                                      << ResponseAction::Handshake << ResponseAction::Deliver;
+    QTest::newRow("none") << ResponseID::None << ResponseAction::Fail << ResponseAction::Fail << ResponseAction::Fail;
+}
+
+
+void ConnectionStateTest::responseActions()
+{
+    QFETCH(ResponseID, response);
+    QFETCH(ResponseAction, disconnected);
+    QFETCH(ResponseAction, connecting);
+    QFETCH(ResponseAction, connected);
+
+    ConnectionState state;
+    QCOMPARE(state.responseAction(response), disconnected);
+    state.transition(ConnectionEvent::Connect);
+    QCOMPARE(state.responseAction(response), connecting);
+    state.transition(ConnectionEvent::Establish);
+    QCOMPARE(state.responseAction(response), connected);
+}
+
+
+void ConnectionStateTest::concurrentConnect()
+{
+    const int kThreadCount = 8;
+    ConnectionState state;
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadCount; ++i) {
+        threads.emplace_back([&state, &succeeded]() {
+            if (state.transition(ConnectionEvent::Connect)) {
+                ++succeeded;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    // only one of the concurrent connections wins
+    QCOMPARE(succeeded.load(), 1);
+    QCOMPARE(state.phase(), ConnectionPhase::Connecting);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
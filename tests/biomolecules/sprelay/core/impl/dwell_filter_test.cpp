@@ -0,0 +1,183 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      dwell_filter_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::DwellFilterTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::DwellFilter.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "dwell_filter_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/dwell_filter.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void DwellFilterTest::disabled()
+{
+    DwellFilter filter;
+    QVERIFY(!filter.enabled());
+    QCOMPARE(filter.filter(true, RelayID::One, 0), RelayID::One);
+    QCOMPARE(filter.filter(false, RelayID::One, 1), RelayID::One);
+    QCOMPARE(filter.filter(true, RelayID::One, 2), RelayID::One);
+    QCOMPARE(filter.deferred(), RelayID::None);
+    QCOMPARE(filter.nextRelease(), qint64{-1});
+}
+
+
+void DwellFilterTest::collapseFlapping()
+{
+    const int kDwell = 100;
+    DwellFilter filter;
+    filter.setDwell(kDwell);
+    QVERIFY(filter.enabled());
+
+    QCOMPARE(filter.filter(true, RelayID::One, 1000), RelayID::One);
+    // transitions within the dwell are deferred and collapsed to the latest one
+    QCOMPARE(filter.filter(false, RelayID::One, 1010), RelayID::None);
+    QCOMPARE(filter.deferred(), RelayID::One);
+    QCOMPARE(filter.filter(true, RelayID::One, 1020), RelayID::None);
+    QCOMPARE(filter.suppressedTransitions(), 1u);
+    QCOMPARE(filter.nextRelease(), qint64{1000 + kDwell});
+
+    RelayID on;
+    RelayID off;
+    filter.release(1050, RelayID::One, &on, &off);
+    QCOMPARE(on, RelayID::None);
+    QCOMPARE(off, RelayID::None);
+    QCOMPARE(filter.deferred(), RelayID::One);
+
+    // the latest intent equals the current state, so nothing is sent
+    filter.release(1000 + kDwell, RelayID::One, &on, &off);
+    QCOMPARE(on, RelayID::None);
+    QCOMPARE(off, RelayID::None);
+    QCOMPARE(filter.deferred(), RelayID::None);
+    QCOMPARE(filter.nextRelease(), qint64{-1});
+    QCOMPARE(filter.suppressedTransitions(), 2u);
+    QCOMPARE(filter.savedCommands(), 2u);
+
+    filter.resetStatistics();
+    QCOMPARE(filter.suppressedTransitions(), 0u);
+    QCOMPARE(filter.savedCommands(), 0u);
+}
+
+
+void DwellFilterTest::releaseChanged()
+{
+    const int kDwell = 100;
+    DwellFilter filter;
+    filter.setDwell(kDwell);
+
+    QCOMPARE(filter.filter(true, RelayID::One, 0), RelayID::One);
+    QCOMPARE(filter.filter(false, RelayID::One, 10), RelayID::None);
+    RelayID on;
+    RelayID off;
+    filter.release(kDwell, RelayID::One, &on, &off);
+    QCOMPARE(on, RelayID::None);
+    QCOMPARE(off, RelayID::One);
+    QCOMPARE(filter.suppressedTransitions(), 0u);
+    QCOMPARE(filter.savedCommands(), 0u);
+
+    // the released transition starts a new dwell
+    QCOMPARE(filter.filter(true, RelayID::One, kDwell + 50), RelayID::None);
+    QCOMPARE(filter.nextRelease(), qint64{2 * kDwell});
+}
+
+
+void DwellFilterTest::partialDeferral()
+{
+    const int kDwell = 100;
+    DwellFilter filter;
+    filter.setDwell(kDwell);
+
+    QCOMPARE(filter.filter(true, RelayID::One, 0), RelayID::One);
+    QCOMPARE(filter.filter(false, RelayID::One | RelayID::Two, 10), RelayID::Two);
+    QCOMPARE(filter.deferred(), RelayID::One);
+
+    // the relay with deferred intent is deferred even after its dwell, so the order of intents is kept
+    QCOMPARE(filter.filter(true, RelayID::One, kDwell + 10), RelayID::None);
+    RelayID on;
+    RelayID off;
+    filter.release(kDwell + 10, RelayID::One, &on, &off);
+    QCOMPARE(on, RelayID::None);
+    QCOMPARE(off, RelayID::None);
+    QCOMPARE(filter.suppressedTransitions(), 2u);
+}
+
+
+void DwellFilterTest::unchangedStatePasses()
+{
+    const int kDwell = 100;
+    DwellFilter filter;
+    filter.setDwell(kDwell);
+
+    QCOMPARE(filter.filter(true, RelayID::One, 0), RelayID::One);
+    QCOMPARE(filter.filter(true, RelayID::One, 10), RelayID::One);
+    QCOMPARE(filter.deferred(), RelayID::None);
+    QCOMPARE(filter.filter(false, RelayID::Three, 20), RelayID::Three);
+    QCOMPARE(filter.filter(false, RelayID::Three, 30), RelayID::Three);
+}
+
+
+void DwellFilterTest::toggle()
+{
+    const int kDwell = 100;
+    DwellFilter filter;
+    filter.setDwell(kDwell);
+
+    QCOMPARE(filter.filter(true, RelayID::One, 0), RelayID::One);
+    QCOMPARE(filter.filter(false, RelayID::One, 10), RelayID::None);
+    // toggling replaces the deferred intent and starts a new dwell
+    filter.toggle(RelayID::One, 20);
+    QCOMPARE(filter.deferred(), RelayID::None);
+    QCOMPARE(filter.suppressedTransitions(), 1u);
+    QCOMPARE(filter.filter(true, RelayID::One, 30), RelayID::None);
+    QCOMPARE(filter.nextRelease(), qint64{20 + kDwell});
+
+    filter.clear();
+    QCOMPARE(filter.deferred(), RelayID::None);
+    QCOMPARE(filter.filter(false, RelayID::One, 40), RelayID::One);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,143 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_cache_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventCacheTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::EventCache.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "event_cache_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/event_cache.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void EventCacheTest::relayStatusChanges()
+{
+    EventCache cache;
+    QVERIFY(!cache.hasRelayStatus());
+
+    // the first status changes all relays
+    QCOMPARE(cache.updateRelayStatus(RelayID::One, RelayID::One, RelayID::None), RelayID::All);
+    QVERIFY(cache.hasRelayStatus());
+    QCOMPARE(cache.currentRelays(), RelayID::One);
+
+    // the same status does not change anything
+    QCOMPARE(cache.updateRelayStatus(RelayID::One, RelayID::One, RelayID::None), RelayID::None);
+
+    // reported transition
+    QCOMPARE(cache.updateRelayStatus(RelayID::One, RelayID::One | RelayID::Two, RelayID::None), RelayID::Two);
+
+    // state differs from the last known one even if the card does not report the transition
+    QCOMPARE(cache.updateRelayStatus(RelayID::Three, RelayID::Three, RelayID::None),
+        RelayID::One | RelayID::Two | RelayID::Three);
+
+    // timed flag change
+    QCOMPARE(cache.updateRelayStatus(RelayID::Three, RelayID::Three, RelayID::Three), RelayID::Three);
+    QCOMPARE(cache.timedRelays(), RelayID::Three);
+}
+
+
+void EventCacheTest::buttonStatusChanges()
+{
+    EventCache cache;
+    QVERIFY(!cache.hasButtonStatus());
+
+    QCOMPARE(cache.updateButtonStatus(RelayID::One, RelayID::One, RelayID::None), RelayID::All);
+    QCOMPARE(cache.buttonState(), RelayID::One);
+
+    // press and release are always changes
+    QCOMPARE(cache.updateButtonStatus(RelayID::One | RelayID::Two, RelayID::Two, RelayID::None), RelayID::Two);
+    QCOMPARE(cache.updateButtonStatus(RelayID::Two, RelayID::None, RelayID::One), RelayID::One);
+
+    // unchanged state without press and release
+    QCOMPARE(cache.updateButtonStatus(RelayID::Two, RelayID::None, RelayID::None), RelayID::None);
+}
+
+
+void EventCacheTest::timerDelayChanges()
+{
+    EventCache cache;
+    const quint16 delay1 = 5;
+    const quint16 delay2 = 10;
+
+    QCOMPARE(cache.knownTimerDelays(TimerDelayType::Total), RelayID::None);
+    QCOMPARE(cache.updateTimerDelay(TimerDelayType::Total, RelayID::One, delay1), RelayID::One);
+    QCOMPARE(cache.knownTimerDelays(TimerDelayType::Total), RelayID::One);
+    QCOMPARE(cache.timerDelay(TimerDelayType::Total, 0), delay1);
+
+    // the same delay is not a change
+    QCOMPARE(cache.updateTimerDelay(TimerDelayType::Total, RelayID::One, delay1), RelayID::None);
+
+    // only relays with different or unknown delay are changed
+    QCOMPARE(cache.updateTimerDelay(TimerDelayType::Total, RelayID::One | RelayID::Two, delay1), RelayID::Two);
+    QCOMPARE(cache.updateTimerDelay(TimerDelayType::Total, RelayID::Two, delay2), RelayID::Two);
+    QCOMPARE(cache.timerDelay(TimerDelayType::Total, 1), delay2);
+
+    // total and remaining delays are independent
+    QCOMPARE(cache.knownTimerDelays(TimerDelayType::Remaining), RelayID::None);
+    QCOMPARE(cache.updateTimerDelay(TimerDelayType::Remaining, RelayID::One, delay1), RelayID::One);
+    QCOMPARE(cache.knownTimerDelays(TimerDelayType::Total), RelayID::One | RelayID::Two);
+}
+
+
+void EventCacheTest::reset()
+{
+    EventCache cache;
+    const quint16 delay = 5;
+    cache.updateRelayStatus(RelayID::One, RelayID::One, RelayID::None);
+    cache.updateButtonStatus(RelayID::One, RelayID::One, RelayID::None);
+    cache.updateTimerDelay(TimerDelayType::Total, RelayID::One, delay);
+
+    cache.reset();
+    QVERIFY(!cache.hasRelayStatus());
+    QVERIFY(!cache.hasButtonStatus());
+    QCOMPARE(cache.knownTimerDelays(TimerDelayType::Total), RelayID::None);
+
+    // after reset, the first status changes all relays again
+    QCOMPARE(cache.updateRelayStatus(RelayID::One, RelayID::One, RelayID::None), RelayID::All);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,209 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_listeners_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventListenersTest class which implements tests and
+ *            dispatch benchmark of biomolecules::sprelay::core::k8090::impl_::EventListeners.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "event_listeners_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/event_listeners.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+const int kEventCount = 100000;
+const int kTimeout = 10000;
+
+CardEvent relay_status(RelayID current)
+{
+    return CardEvent{ResponseID::RelayStatus, 0, as_number(current), 0, false};
+}
+
+}  // namespace
+
+
+void EventListenersTest::dispatch()
+{
+    EventListeners listeners;
+    QVERIFY(listeners.empty());
+    std::vector<int> calls;
+    listeners.add([&calls](const CardEvent& event) { calls.push_back(event.param1); });
+    listeners.add([&calls](const CardEvent& event) { calls.push_back(event.param1 + 100); });
+    QVERIFY(!listeners.empty());
+
+    // listeners are called in the order of their addition
+    listeners.dispatch(relay_status(RelayID::Two));
+    QCOMPARE(calls, (std::vector<int>{2, 102}));
+}
+
+
+void EventListenersTest::remove()
+{
+    EventListeners listeners;
+    int first_calls = 0;
+    int second_calls = 0;
+    int first = listeners.add([&first_calls](const CardEvent&) { ++first_calls; });
+    int second = listeners.add([&second_calls](const CardEvent&) { ++second_calls; });
+    QVERIFY(first != second);
+
+    QVERIFY(listeners.remove(first));
+    QVERIFY(!listeners.remove(first));
+    listeners.dispatch(relay_status(RelayID::One));
+    QCOMPARE(first_calls, 0);
+    QCOMPARE(second_calls, 1);
+
+    QVERIFY(listeners.remove(second));
+    QVERIFY(listeners.empty());
+}
+
+
+void EventListenersTest::reentrancy()
+{
+    EventListeners listeners;
+    int calls = 0;
+    int added_calls = 0;
+    int id = 0;
+    // the listener removes itself and adds another one, the change takes effect from the next event
+    id = listeners.add([&](const CardEvent&) {
+        ++calls;
+        listeners.remove(id);
+        listeners.add([&added_calls](const CardEvent&) { ++added_calls; });
+    });
+    listeners.dispatch(relay_status(RelayID::One));
+    QCOMPARE(calls, 1);
+    QCOMPARE(added_calls, 0);
+    listeners.dispatch(relay_status(RelayID::One));
+    QCOMPARE(calls, 1);
+    QCOMPARE(added_calls, 1);
+}
+
+
+void EventListenersTest::removeWaitsForDispatch()
+{
+    EventListeners listeners;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> released{false};
+    std::atomic<bool> removed{false};
+    int id = listeners.add([&entered, &released](const CardEvent&) {
+        entered = true;
+        while (!released) {
+            std::this_thread::yield();
+        }
+    });
+    std::thread dispatcher{[&listeners] { listeners.dispatch(relay_status(RelayID::One)); }};
+    QTRY_VERIFY_WITH_TIMEOUT(entered.load(), kTimeout);
+
+    // the removal from other thread returns after the running call of the listener
+    std::thread remover{[&listeners, &removed, id] {
+        listeners.remove(id);
+        removed = true;
+    }};
+    QTest::qWait(50);
+    QVERIFY(!removed);
+    released = true;
+    dispatcher.join();
+    remover.join();
+    QVERIFY(removed);
+    QVERIFY(listeners.empty());
+}
+
+
+void EventListenersTest::dispatchCost_data()
+{
+    QTest::addColumn<bool>("direct");
+
+    QTest::newRow("direct listener") << true;
+    QTest::newRow("queued signal") << false;
+}
+
+
+void EventListenersTest::dispatchCost()
+{
+    QFETCH(bool, direct);
+    qRegisterMetaType<RelayID>();
+
+    // the consumer lives in another thread as it is usual for the gui
+    QThread thread;
+    QObject consumer;
+    consumer.moveToThread(&thread);
+    thread.start();
+    std::atomic<int> delivered{0};
+
+    EventListeners listeners;
+    listeners.add([&delivered](const CardEvent&) { ++delivered; });
+    RelayStatusEmitter emitter;
+    connect(&emitter, &RelayStatusEmitter::relayStatus, &consumer,
+        [&delivered](RelayID, RelayID, RelayID) { ++delivered; }, Qt::QueuedConnection);
+
+    // cost in the decoding thread and the delivery latency of all the events
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kEventCount; ++i) {
+        auto current = static_cast<RelayID>(i & 0xFF);
+        if (direct) {
+            listeners.dispatch(relay_status(current));
+        } else {
+            emit emitter.relayStatus(RelayID::None, current, RelayID::None);
+        }
+    }
+    qint64 dispatch_time = timer.nsecsElapsed();
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.load(), kEventCount, kTimeout);
+    qint64 delivery_time = timer.nsecsElapsed();
+    thread.quit();
+    thread.wait();
+
+    qDebug() << "Dispatch cost per event:" << dispatch_time / kEventCount << "ns, delivered in"
+             << delivery_time / kEventCount << "ns per event";
+    QTest::setBenchmarkResult(delivery_time / 1000000, QTest::WalltimeMilliseconds);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,85 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      event_listeners_test.h
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::EventListenersTest class which implements tests and
+ *            dispatch benchmark of biomolecules::sprelay::core::k8090::impl_::EventListeners.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#ifndef BIOMOLECULES_SPRELAY_CORE_IMPL_EVENT_LISTENERS_TEST_H_
+#define BIOMOLECULES_SPRELAY_CORE_IMPL_EVENT_LISTENERS_TEST_H_
+
+#include <QObject>
+
+#include "lumik/qtest_suite/qtest_suite.h"
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+class EventListenersTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void dispatch();
+    void remove();
+    void reentrancy();
+    void removeWaitsForDispatch();
+    void dispatchCost_data();
+    void dispatchCost();
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, fuchsia-statically-constructed-objects)
+ADD_TEST(EventListenersTest)
+
+
+/// Emits relay status in the same way as K8090, it is used to compare the cost of the signal delivery.
+class RelayStatusEmitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void relayStatus(biomolecules::sprelay::core::k8090::RelayID previous,
+        biomolecules::sprelay::core::k8090::RelayID current, biomolecules::sprelay::core::k8090::RelayID timed);
+};
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
+
+#endif  // BIOMOLECULES_SPRELAY_CORE_IMPL_EVENT_LISTENERS_TEST_H_
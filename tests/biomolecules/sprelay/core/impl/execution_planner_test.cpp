@@ -0,0 +1,158 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      execution_planner_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ExecutionPlannerTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::ExecutionPlanner.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "execution_planner_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/execution_planner.h"
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+const int kCommandDelay = 50;
+const int kResponseDelay = 10;
+
+bool is_planned(const PlannedCommand& planned, CommandID id, RelayID mask, int send_time, bool follow_up)
+{
+    return planned.command.id == id && planned.command.mask == mask && planned.send_time == send_time
+        && planned.follow_up == follow_up;
+}
+
+}  // namespace
+
+
+void ExecutionPlannerTest::empty()
+{
+    ExecutionPlanner planner{kCommandDelay, kResponseDelay};
+    ExecutionPlan plan = planner.plan();
+    QVERIFY(plan.commands.empty());
+    QCOMPARE(plan.completion_time, 0);
+}
+
+
+void ExecutionPlannerTest::followUpQueries()
+{
+    ExecutionPlanner planner{kCommandDelay, kResponseDelay};
+
+    planner.enqueue(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    ExecutionPlan plan = planner.plan();
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QVERIFY(is_planned(plan.commands[0], CommandID::RelayOn, RelayID::One, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::QueryRelay, RelayID::None, kCommandDelay, true));
+    QCOMPARE(plan.completion_time, 2 * kCommandDelay);
+
+    // the planner is reusable
+    planner.enqueue(CardCommand{CommandID::SetButtonMode, RelayID::One, 0, 0});
+    plan = planner.plan();
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QVERIFY(is_planned(plan.commands[0], CommandID::SetButtonMode, RelayID::One, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::ButtonMode, RelayID::None, kCommandDelay, true));
+    QCOMPARE(plan.completion_time, kCommandDelay + kResponseDelay);
+
+    planner.enqueue(CardCommand{CommandID::SetTimer, RelayID::Two, 0, 5});
+    plan = planner.plan();
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QVERIFY(is_planned(plan.commands[0], CommandID::SetTimer, RelayID::Two, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::Timer, RelayID::Two, kCommandDelay, true));
+    QCOMPARE(plan.commands[1].command.param1, as_number(TimerDelayType::Total));
+    QCOMPARE(plan.completion_time, kCommandDelay + kResponseDelay);
+}
+
+
+void ExecutionPlannerTest::merging()
+{
+    ExecutionPlanner planner{kCommandDelay, kResponseDelay};
+    planner.enqueue(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    planner.enqueue(CardCommand{CommandID::RelayOn, RelayID::Two, 0, 0});
+    planner.enqueue(CardCommand{CommandID::RelayOn, RelayID::Three, 0, 0});
+    ExecutionPlan plan = planner.plan();
+
+    // the first command is sent directly, the rest is merged in the queue
+    QCOMPARE(plan.commands.size(), std::size_t{4});
+    QVERIFY(is_planned(plan.commands[0], CommandID::RelayOn, RelayID::One, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::QueryRelay, RelayID::None, kCommandDelay, true));
+    QVERIFY(is_planned(plan.commands[2], CommandID::RelayOn, RelayID::Two | RelayID::Three, 2 * kCommandDelay, false));
+    QVERIFY(is_planned(plan.commands[3], CommandID::QueryRelay, RelayID::None, 3 * kCommandDelay, true));
+    QCOMPARE(plan.completion_time, 4 * kCommandDelay);
+}
+
+
+void ExecutionPlannerTest::priorities()
+{
+    ExecutionPlanner planner{kCommandDelay, kResponseDelay};
+    planner.enqueue(CardCommand{CommandID::RelayOn, RelayID::One, 0, 0});
+    planner.enqueue(CardCommand{CommandID::SetTimer, RelayID::Two, 0, 5});
+    planner.enqueue(CardCommand{CommandID::Timer, RelayID::All, as_number(TimerDelayType::Total), 0});
+    ExecutionPlan plan = planner.plan();
+
+    // queries have higher priority than the set timer command
+    QCOMPARE(plan.commands.size(), std::size_t{5});
+    QVERIFY(is_planned(plan.commands[0], CommandID::RelayOn, RelayID::One, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::QueryRelay, RelayID::None, kCommandDelay, true));
+    QVERIFY(is_planned(plan.commands[2], CommandID::Timer, RelayID::All, 2 * kCommandDelay, false));
+    QVERIFY(is_planned(plan.commands[3], CommandID::SetTimer, RelayID::Two, 2 * kCommandDelay + kResponseDelay, false));
+    QVERIFY(is_planned(plan.commands[4], CommandID::Timer, RelayID::Two, 3 * kCommandDelay + kResponseDelay, true));
+    QCOMPARE(plan.completion_time, 3 * kCommandDelay + 2 * kResponseDelay);
+}
+
+
+void ExecutionPlannerTest::factoryDefaults()
+{
+    ExecutionPlanner planner{kCommandDelay, kResponseDelay};
+    planner.enqueue(CardCommand{CommandID::ResetFactoryDefaults, RelayID::None, 0, 0});
+    ExecutionPlan plan = planner.plan();
+
+    // reset factory defaults execution takes double command delay
+    QCOMPARE(plan.commands.size(), std::size_t{2});
+    QVERIFY(is_planned(plan.commands[0], CommandID::ResetFactoryDefaults, RelayID::None, 0, false));
+    QVERIFY(is_planned(plan.commands[1], CommandID::QueryRelay, RelayID::None, 2 * kCommandDelay, true));
+    QCOMPARE(plan.completion_time, 3 * kCommandDelay);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
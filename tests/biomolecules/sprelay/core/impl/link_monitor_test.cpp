@@ -0,0 +1,183 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      link_monitor_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LinkMonitorTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::LinkMonitor.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "link_monitor_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/link_monitor.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void LinkMonitorTest::counters()
+{
+    LinkMonitor monitor;
+    LinkStatistics statistics = monitor.snapshot();
+    QCOMPARE(statistics.queue_depth, 0);
+    QCOMPARE(statistics.enqueued_commands, 0u);
+    QCOMPARE(statistics.sent_commands, 0u);
+    QCOMPARE(statistics.latency_samples, 0u);
+
+    monitor.commandEnqueued(false, 0);
+    monitor.commandSent(20);
+    monitor.commandEnqueued(false, 1);
+    monitor.commandEnqueued(true, 1);
+    monitor.commandEnqueued(false, 2);
+    monitor.commandFailed();
+    statistics = monitor.snapshot();
+    QCOMPARE(statistics.queue_depth, 2);
+    QCOMPARE(statistics.enqueued_commands, 4u);
+    QCOMPARE(statistics.merged_commands, 1u);
+    QCOMPARE(statistics.sent_commands, 1u);
+    QCOMPARE(statistics.failures, 1u);
+    QCOMPARE(statistics.command_delay, 20);
+
+    monitor.commandDequeued(1);
+    monitor.commandSent(0);
+    statistics = monitor.snapshot();
+    QCOMPARE(statistics.queue_depth, 1);
+    QCOMPARE(statistics.sent_commands, 2u);
+    QCOMPARE(monitor.sentCommands(), 2u);
+    QCOMPARE(statistics.command_delay, 0);
+
+    monitor.clearQueue();
+    QCOMPARE(monitor.snapshot().queue_depth, 0);
+
+    monitor.setCoalescingWindow(20);
+    monitor.coalescingWindowOpened(13);
+    statistics = monitor.snapshot();
+    QCOMPARE(statistics.coalescing_window, 13);
+    QCOMPARE(statistics.coalesced_bursts, 1u);
+
+    monitor.setDwellStatistics(5, 3);
+    statistics = monitor.snapshot();
+    QCOMPARE(statistics.dwell_suppressed_transitions, 5u);
+    QCOMPARE(statistics.dwell_saved_commands, 3u);
+
+    QCOMPARE(statistics.wakeups, 0u);
+    monitor.wakeup();
+    monitor.wakeup();
+    QCOMPARE(monitor.snapshot().wakeups, 2u);
+
+    monitor.replyConfirmed();
+    monitor.unsolicitedStatus();
+    monitor.unsolicitedStatus();
+    statistics = monitor.snapshot();
+    QCOMPARE(statistics.confirmed_replies, 1u);
+    QCOMPARE(statistics.unsolicited_statuses, 2u);
+}
+
+
+void LinkMonitorTest::percentiles()
+{
+    LinkMonitor monitor;
+    // 100 samples with latencies 1 .. 100 ms
+    for (int i = 1; i <= 100; ++i) {
+        monitor.recordLatency(i);
+    }
+    LinkStatistics statistics = monitor.snapshot();
+    QCOMPARE(statistics.latency_samples, 100u);
+    QCOMPARE(statistics.latency_p50, 50);
+    QCOMPARE(statistics.latency_p90, 90);
+    QCOMPARE(statistics.latency_p99, 99);
+    QCOMPARE(statistics.latency_max, 100);
+
+    // one sample gives the same value for all percentiles
+    LinkMonitor single;
+    single.recordLatency(7);
+    statistics = single.snapshot();
+    QCOMPARE(statistics.latency_p50, 7);
+    QCOMPARE(statistics.latency_p99, 7);
+    QCOMPARE(statistics.latency_max, 7);
+}
+
+
+void LinkMonitorTest::overflowLatency()
+{
+    LinkMonitor monitor;
+    monitor.recordLatency(-1);
+    monitor.recordLatency(10 * LinkMonitor::kLatencyBuckets);
+    LinkStatistics statistics = monitor.snapshot();
+    QCOMPARE(statistics.latency_samples, 2u);
+    QCOMPARE(statistics.latency_p50, 0);
+    QCOMPARE(statistics.latency_max, LinkMonitor::kLatencyBuckets - 1);
+}
+
+
+void LinkMonitorTest::reset()
+{
+    LinkMonitor monitor;
+    monitor.commandEnqueued(true, 3);
+    monitor.commandSent(20);
+    monitor.commandFailed();
+    monitor.recordLatency(5);
+    monitor.coalescingWindowOpened(10);
+    monitor.setDwellStatistics(2, 1);
+    monitor.wakeup();
+    monitor.replyConfirmed();
+    monitor.unsolicitedStatus();
+    monitor.reset();
+    LinkStatistics statistics = monitor.snapshot();
+    QCOMPARE(statistics.enqueued_commands, 0u);
+    QCOMPARE(statistics.merged_commands, 0u);
+    QCOMPARE(statistics.sent_commands, 0u);
+    QCOMPARE(statistics.failures, 0u);
+    QCOMPARE(statistics.latency_samples, 0u);
+    QCOMPARE(statistics.latency_max, 0);
+    QCOMPARE(statistics.coalesced_bursts, 0u);
+    QCOMPARE(statistics.dwell_suppressed_transitions, 0u);
+    QCOMPARE(statistics.dwell_saved_commands, 0u);
+    QCOMPARE(statistics.wakeups, 0u);
+    QCOMPARE(statistics.confirmed_replies, 0u);
+    QCOMPARE(statistics.unsolicited_statuses, 0u);
+    // the current state is kept
+    QCOMPARE(statistics.queue_depth, 3);
+    QCOMPARE(statistics.command_delay, 20);
+    QCOMPARE(statistics.coalescing_window, 10);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
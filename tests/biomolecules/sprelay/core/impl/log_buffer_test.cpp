@@ -0,0 +1,137 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      log_buffer_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::LogBufferTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::LogBuffer.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "log_buffer_test.h"
+
+#include <QtTest>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/log_buffer.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+LogRecord record(int value)
+{
+    return LogRecord{0, LogLevel::Info, LogEvent::CommandFailed, CommandID::RelayOn, RelayID::One, value};
+}
+
+}  // namespace
+
+
+void LogBufferTest::pushRead()
+{
+    LogBuffer buffer{3};
+    QCOMPARE(buffer.capacity(), std::size_t{4});
+    QVERIFY(buffer.empty());
+
+    QVERIFY(buffer.push(record(1)));
+    QVERIFY(buffer.push(record(2)));
+    QCOMPARE(buffer.size(), std::size_t{2});
+
+    std::vector<LogRecord> records;
+    QCOMPARE(buffer.readAll(&records), std::size_t{2});
+    QCOMPARE(records.size(), std::size_t{2});
+    QCOMPARE(records[0].value, 1);
+    QCOMPARE(records[1].value, 2);
+    QCOMPARE(records[1].command, CommandID::RelayOn);
+    QVERIFY(buffer.empty());
+    QCOMPARE(buffer.readAll(&records), std::size_t{0});
+}
+
+
+void LogBufferTest::full()
+{
+    LogBuffer buffer{2};
+    QVERIFY(buffer.push(record(1)));
+    QVERIFY(buffer.push(record(2)));
+    // the full buffer drops the record
+    QVERIFY(!buffer.push(record(3)));
+
+    std::vector<LogRecord> records;
+    QCOMPARE(buffer.readAll(&records), std::size_t{2});
+    QCOMPARE(records.back().value, 2);
+    // the read frees the space and the positions wrap around
+    QVERIFY(buffer.push(record(4)));
+    QCOMPARE(buffer.readAll(&records), std::size_t{1});
+    QCOMPARE(records.back().value, 4);
+}
+
+
+void LogBufferTest::concurrent()
+{
+    const int n_records = 200000;
+    LogBuffer buffer{64};
+
+    // the producer retries the dropped records, the consumer checks that nothing is lost or reordered
+    std::thread producer{[&buffer, n_records]() {
+        for (int i = 0; i < n_records; ++i) {
+            while (!buffer.push(record(i))) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    std::vector<LogRecord> records;
+    while (records.size() < static_cast<std::size_t>(n_records)) {
+        buffer.readAll(&records);
+    }
+    producer.join();
+
+    bool in_order = true;
+    for (int i = 0; i < n_records; ++i) {
+        in_order = in_order && records[static_cast<std::size_t>(i)].value == i;
+    }
+    QVERIFY2(in_order, "The records were lost or reordered.");
+    QVERIFY(buffer.empty());
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
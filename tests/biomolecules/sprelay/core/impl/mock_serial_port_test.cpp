@@ -50,6 +50,7 @@
 #include <list>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "biomolecules/sprelay/core/k8090.h"
 #include "biomolecules/sprelay/core/k8090_utils.h"
@@ -941,6 +942,85 @@ void MockSerialPortTest::moreDefaultTimers()
 }
 
 
+void MockSerialPortTest::scenario()
+{
+    //                                                   STX   CMD   MASK  PAR1  PAR2  CHK   ETX
+    static const unsigned char press_one[] /*       */ = {0x04, 0x50, 0x01, 0x01, 0x00, 0xaa, 0x0f};
+    static const unsigned char on_status[] /*       */ = {0x04, 0x51, 0x00, 0x01, 0x00, 0xaa, 0x0f};
+    static const unsigned char release_one[] /*     */ = {0x04, 0x50, 0x00, 0x00, 0x01, 0xab, 0x0f};
+    static const unsigned char press_two[] /*       */ = {0x04, 0x50, 0x02, 0x02, 0x00, 0xa8, 0x0f};
+    static const unsigned char release_two[] /*     */ = {0x04, 0x50, 0x00, 0x00, 0x02, 0xaa, 0x0f};
+    static const unsigned char query_jumper[] /*    */ = {0x04, 0x70, 0x00, 0x00, 0x00, 0x8c, 0x0f};
+    static const unsigned char jumper_on[] /*       */ = {0x04, 0x70, 0x00, 0x01, 0x00, 0x8b, 0x0f};
+    static const unsigned char start_timer[] /*     */ = {0x04, 0x41, 0x10, 0x00, 0x00, 0xab, 0x0f};
+    static const unsigned char timer_status[] /*    */ = {0x04, 0x51, 0x01, 0x11, 0x10, 0x89, 0x0f};
+    static const unsigned char expired_status[] /*  */ = {0x04, 0x51, 0x11, 0x01, 0x00, 0x99, 0x0f};
+
+    {  // toggle button switches the relay on press and reports both press and release
+        std::vector<k8090::ScenarioEvent> events{
+            {0, k8090::ScenarioAction::PressButtons, k8090::RelayID::One},
+            {30, k8090::ScenarioAction::ReleaseButtons, k8090::RelayID::One}};
+        mock_serial_port_->runScenario(events, 0, 1);
+        QByteArray data = readResponses(mock_serial_port_.get(), 3);
+        if (data.size() != 21) {
+            QFAIL(qPrintable(QString{"Response has %1 bytes but expected 21."}.arg(data.size())));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto buffer = reinterpret_cast<const unsigned char*>(data.constData());
+        QVERIFY(compareResponse(buffer, press_one));
+        QVERIFY(compareResponse(buffer + 7, on_status));
+        QVERIFY(compareResponse(buffer + 14, release_one));
+    }
+    {  // the jumper disables relay control by buttons
+        std::vector<k8090::ScenarioEvent> events{
+            {0, k8090::ScenarioAction::SetJumper, k8090::RelayID::None},
+            {0, k8090::ScenarioAction::PressButtons, k8090::RelayID::Two},
+            {10, k8090::ScenarioAction::ReleaseButtons, k8090::RelayID::Two}};
+        mock_serial_port_->runScenario(events, 0, 1);
+        QByteArray data = readResponses(mock_serial_port_.get(), 2);
+        if (data.size() != 14) {
+            QFAIL(qPrintable(QString{"Response has %1 bytes but expected 14."}.arg(data.size())));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto buffer = reinterpret_cast<const unsigned char*>(data.constData());
+        QVERIFY(compareResponse(buffer, press_two));
+        QVERIFY(compareResponse(buffer + 7, release_two));
+
+        qint64 dummy_elapsed_ms;
+        if (measureCommandWithResponse(mock_serial_port_.get(), query_jumper, &dummy_elapsed_ms)) {
+            QFAIL("There is no response from the card.");
+        }
+        data = mock_serial_port_->readAll();
+        if (data.size() != 7) {
+            QFAIL(qPrintable(QString{"Response has %1 bytes but expected 7."}.arg(data.size())));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        QVERIFY(compareResponse(reinterpret_cast<const unsigned char*>(data.constData()), jumper_on));
+    }
+    {  // expired timer switches the relay off immediately
+        qint64 dummy_elapsed_ms;
+        if (measureCommandWithResponse(mock_serial_port_.get(), start_timer, &dummy_elapsed_ms)) {
+            QFAIL("There is no response from the card.");
+        }
+        QByteArray data = mock_serial_port_->readAll();
+        if (data.size() != 7) {
+            QFAIL(qPrintable(QString{"Response has %1 bytes but expected 7."}.arg(data.size())));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        QVERIFY(compareResponse(reinterpret_cast<const unsigned char*>(data.constData()), timer_status));
+
+        std::vector<k8090::ScenarioEvent> events{{0, k8090::ScenarioAction::ExpireTimers, k8090::RelayID::All}};
+        mock_serial_port_->runScenario(events, 0, 1);
+        data = readResponses(mock_serial_port_.get(), 1);
+        if (data.size() != 7) {
+            QFAIL(qPrintable(QString{"Response has %1 bytes but expected 7."}.arg(data.size())));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        QVERIFY(compareResponse(reinterpret_cast<const unsigned char*>(data.constData()), expired_status));
+    }
+}
+
+
 bool MockSerialPortTest::compareResponse(const unsigned char* response, const unsigned char* expected)
 {
     unsigned char check_sum = k8090::impl_::check_sum(expected, 5);
@@ -988,6 +1068,20 @@ bool MockSerialPortTest::measureCommandWithResponse(
     return !timer.isActive();
 }
 
+
+
+QByteArray MockSerialPortTest::readResponses(MockSerialPort* serial_port, int count)
+{
+    QByteArray data;
+    QElapsedTimer elapsed_timer;
+    elapsed_timer.start();
+    while (data.size() < 7 * count && elapsed_timer.elapsed() < 10 * kCommandTimeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, kDelayBetweenCommandsMs);
+        data.append(serial_port->readAll());
+    }
+    return data;
+}
+
 }  // namespace core
 }  // namespace sprelay
 }  // namespace biomolecules
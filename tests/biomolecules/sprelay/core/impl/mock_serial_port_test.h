@@ -39,6 +39,7 @@
 #ifndef BIOMOLECULES_SPRELAY_CORE_IMPL_MOCK_SERIAL_PORT_TEST_H_
 #define BIOMOLECULES_SPRELAY_CORE_IMPL_MOCK_SERIAL_PORT_TEST_H_
 
+#include <QByteArray>
 #include <QObject>
 #include <QString>
 
@@ -74,12 +75,14 @@ private slots:
     void defaultTimer();
     void moreTimers();
     void moreDefaultTimers();
+    void scenario();
     // TODO(lumik): add test for factory defaults command
 
 private:
     bool compareResponse(const unsigned char* response, const unsigned char* expected);
     void sendCommand(MockSerialPort* serial_port, const unsigned char* command) const;
     bool measureCommandWithResponse(MockSerialPort* serial_port, const unsigned char* message, qint64* elapsed_ms);
+    QByteArray readResponses(MockSerialPort* serial_port, int count);
 
     std::unique_ptr<MockSerialPort> mock_serial_port_;
 };
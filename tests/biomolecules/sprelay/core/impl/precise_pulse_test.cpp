@@ -0,0 +1,132 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      precise_pulse_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::PrecisePulseTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::PrecisePulse.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "precise_pulse_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/precise_pulse.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void PrecisePulseTest::start()
+{
+    PrecisePulse pulse;
+    QVERIFY(!pulse.isActive());
+    QVERIFY(pulse.pendingEdge() == CommandID::None);
+    QVERIFY(!pulse.start(RelayID::None, 100));
+    QVERIFY(!pulse.start(RelayID::One, 0));
+
+    QVERIFY(pulse.start(RelayID::One | RelayID::Two, 100));
+    QVERIFY(pulse.isActive());
+    QVERIFY(pulse.phase() == PulsePhase::OnPending);
+    QVERIFY(pulse.pendingEdge() == CommandID::RelayOn);
+    QCOMPARE(pulse.width(), qint64{100000});
+    // only one pulse can run
+    QVERIFY(!pulse.start(RelayID::Three, 100));
+
+    pulse.reset();
+    QVERIFY(!pulse.isActive());
+    QVERIFY(pulse.start(RelayID::Three, 100));
+}
+
+
+void PrecisePulseTest::compensation()
+{
+    PrecisePulse pulse;
+    QVERIFY(pulse.start(RelayID::One, 100));
+    pulse.edgeSent(1000);
+    QVERIFY(pulse.pendingEdge() == CommandID::None);
+
+    // the confirmation comes after 8 ms, so the off edge is sent 8 ms sooner than without the compensation
+    QCOMPARE(pulse.relayStatus(RelayID::One | RelayID::Two, 9000), qint64{92000});
+    QCOMPARE(pulse.oneWayLatency(), qint64{4000});
+    QVERIFY(pulse.phase() == PulsePhase::Holding);
+    pulse.offDue();
+    QVERIFY(pulse.pendingEdge() == CommandID::RelayOff);
+
+    // the off edge waits 2 ms for the line and its latency is 5 ms
+    pulse.edgeSent(103000);
+    QCOMPARE(pulse.relayStatus(RelayID::One, 105000), qint64{-1});
+    QVERIFY(pulse.isActive());
+    QCOMPARE(pulse.relayStatus(RelayID::Two, 113000), qint64{-1});
+    QVERIFY(pulse.phase() == PulsePhase::Finished);
+    QVERIFY(!pulse.isActive());
+    QCOMPARE(pulse.achievedWidth(), qint64{103000});
+    QCOMPARE(pulse.widthError(), qint64{3000});
+}
+
+
+void PrecisePulseTest::lateConfirmation()
+{
+    // the confirmation slower than the width makes the off edge due immediately
+    PrecisePulse pulse;
+    QVERIFY(pulse.start(RelayID::One, 10));
+    pulse.edgeSent(0);
+    QCOMPARE(pulse.relayStatus(RelayID::One, 30000), qint64{0});
+    QCOMPARE(pulse.oneWayLatency(), qint64{15000});
+}
+
+
+void PrecisePulseTest::ignoredStatus()
+{
+    PrecisePulse pulse;
+    QVERIFY(pulse.start(RelayID::One | RelayID::Two, 100));
+    // the status before the edge is sent is ignored
+    QCOMPARE(pulse.relayStatus(RelayID::All, 0), qint64{-1});
+    QVERIFY(pulse.phase() == PulsePhase::OnPending);
+    pulse.edgeSent(1000);
+    // not all the relays are on
+    QCOMPARE(pulse.relayStatus(RelayID::One, 2000), qint64{-1});
+    QVERIFY(pulse.phase() == PulsePhase::OnSent);
+    // the off edge is not due before the relays are on
+    pulse.offDue();
+    QVERIFY(pulse.pendingEdge() == CommandID::None);
+    QCOMPARE(pulse.achievedWidth(), qint64{0});
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
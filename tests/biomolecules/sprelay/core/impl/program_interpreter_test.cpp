@@ -0,0 +1,182 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      program_interpreter_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ProgramInterpreterTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::ProgramInterpreter.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+#include "program_interpreter_test.h"
+
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/program_interpreter.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+ProgramStep command_step(CommandID id, RelayID relays)
+{
+    return ProgramStep{ProgramOpcode::Command, CardCommand{id, relays, 0, 0}, RelayID::None, RelayID::None, 0, 0};
+}
+
+ProgramStep wait_step(RelayID relays, RelayID state)
+{
+    return ProgramStep{
+        ProgramOpcode::WaitRelays, CardCommand{CommandID::None, RelayID::None, 0, 0}, relays, state, 0, 0};
+}
+
+ProgramStep delay_step(int msec)
+{
+    return ProgramStep{
+        ProgramOpcode::Delay, CardCommand{CommandID::None, RelayID::None, 0, 0}, RelayID::None, RelayID::None, msec, 0};
+}
+
+ProgramStep loop_step(int start, int count)
+{
+    return ProgramStep{ProgramOpcode::Loop, CardCommand{CommandID::None, RelayID::None, 0, 0}, RelayID::None,
+        RelayID::None, start, count};
+}
+
+}  // namespace
+
+
+void ProgramInterpreterTest::sequence()
+{
+    ProgramInterpreter interpreter{{command_step(CommandID::RelayOn, RelayID::One), delay_step(100),
+        command_step(CommandID::RelayOff, RelayID::One)}};
+    QVERIFY(!interpreter.isFinished());
+
+    const ProgramStep* step = interpreter.next();
+    QVERIFY(step != nullptr);
+    QCOMPARE(step->opcode, ProgramOpcode::Command);
+    QCOMPARE(step->command.id, CommandID::RelayOn);
+    step = interpreter.next();
+    QVERIFY(step != nullptr);
+    QCOMPARE(step->opcode, ProgramOpcode::Delay);
+    QCOMPARE(step->argument, 100);
+    QVERIFY(!interpreter.isWaiting());
+    step = interpreter.next();
+    QVERIFY(step != nullptr);
+    QCOMPARE(step->command.id, CommandID::RelayOff);
+    QVERIFY(interpreter.next() == nullptr);
+    QVERIFY(interpreter.isFinished());
+}
+
+
+void ProgramInterpreterTest::loops()
+{
+    ProgramInterpreter interpreter{{command_step(CommandID::QueryRelay, RelayID::None),
+        command_step(CommandID::ToggleRelay, RelayID::One), loop_step(1, 3),
+        command_step(CommandID::QueryRelay, RelayID::None)}};
+
+    QCOMPARE(interpreter.next()->command.id, CommandID::QueryRelay);
+    for (int i = 0; i < 3; ++i) {
+        const ProgramStep* step = interpreter.next();
+        QVERIFY(step != nullptr);
+        QCOMPARE(step->command.id, CommandID::ToggleRelay);
+    }
+    QCOMPARE(interpreter.next()->command.id, CommandID::QueryRelay);
+    QVERIFY(interpreter.next() == nullptr);
+}
+
+
+void ProgramInterpreterTest::nestedLoops()
+{
+    ProgramInterpreter interpreter{{command_step(CommandID::RelayOn, RelayID::One),
+        command_step(CommandID::ToggleRelay, RelayID::Two), loop_step(1, 3), loop_step(0, 2)}};
+
+    // the inner loop is repeated in each iteration of the outer loop
+    std::vector<CommandID> expected{CommandID::RelayOn, CommandID::ToggleRelay, CommandID::ToggleRelay,
+        CommandID::ToggleRelay, CommandID::RelayOn, CommandID::ToggleRelay, CommandID::ToggleRelay,
+        CommandID::ToggleRelay};
+    for (CommandID id : expected) {
+        const ProgramStep* step = interpreter.next();
+        QVERIFY(step != nullptr);
+        QCOMPARE(step->command.id, id);
+    }
+    QVERIFY(interpreter.next() == nullptr);
+    QVERIFY(interpreter.isFinished());
+}
+
+
+void ProgramInterpreterTest::infiniteLoop()
+{
+    ProgramInterpreter interpreter{
+        {command_step(CommandID::ToggleRelay, RelayID::One), delay_step(10), loop_step(0, 0)}};
+
+    for (int i = 0; i < 100; ++i) {
+        const ProgramStep* step = interpreter.next();
+        QVERIFY(step != nullptr);
+        QCOMPARE(step->command.id, CommandID::ToggleRelay);
+        step = interpreter.next();
+        QVERIFY(step != nullptr);
+        QCOMPARE(step->opcode, ProgramOpcode::Delay);
+    }
+    QVERIFY(!interpreter.isFinished());
+}
+
+
+void ProgramInterpreterTest::waitRelays()
+{
+    ProgramInterpreter interpreter{
+        {wait_step(RelayID::One | RelayID::Two, RelayID::One), command_step(CommandID::RelayOff, RelayID::One)}};
+
+    // nothing is satisfied when the program does not wait
+    QVERIFY(!interpreter.isWaiting());
+    QVERIFY(!interpreter.isSatisfied(RelayID::One));
+
+    QCOMPARE(interpreter.next()->opcode, ProgramOpcode::WaitRelays);
+    QVERIFY(interpreter.isWaiting());
+    QVERIFY(!interpreter.isSatisfied(RelayID::None));
+    QVERIFY(!interpreter.isSatisfied(RelayID::One | RelayID::Two));
+    QVERIFY(interpreter.isSatisfied(RelayID::One));
+    // relays which are not tested are ignored
+    QVERIFY(interpreter.isSatisfied(RelayID::One | RelayID::Three));
+
+    QCOMPARE(interpreter.next()->command.id, CommandID::RelayOff);
+    QVERIFY(!interpreter.isWaiting());
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
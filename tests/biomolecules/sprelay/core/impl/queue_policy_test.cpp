@@ -0,0 +1,161 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_policy_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueuePolicyTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::QueuePolicy.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "queue_policy_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/concurent_command_queue.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/queue_policy.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void QueuePolicyTest::create()
+{
+    std::shared_ptr<const QueuePolicy> priority = QueuePolicy::create(SchedulingPolicy::Priority);
+    QVERIFY(priority->type() == SchedulingPolicy::Priority);
+    QCOMPARE(priority->priority(CommandID::QueryRelay, kPriorities.data()),
+        kPriorities[as_number(CommandID::QueryRelay)]);
+    QVERIFY(priority->merges(CommandID::RelayOn));
+    QVERIFY(priority->cancelsOpposites());
+
+    std::shared_ptr<const QueuePolicy> fifo = QueuePolicy::create(SchedulingPolicy::Fifo);
+    QVERIFY(fifo->type() == SchedulingPolicy::Fifo);
+    QCOMPARE(fifo->priority(CommandID::QueryRelay, kPriorities.data()),
+        fifo->priority(CommandID::RelayOn, kPriorities.data()));
+    QVERIFY(fifo->merges(CommandID::RelayOn));
+    QVERIFY(fifo->cancelsOpposites());
+
+    std::shared_ptr<const QueuePolicy> no_merge = QueuePolicy::create(SchedulingPolicy::NoMerge);
+    QVERIFY(no_merge->type() == SchedulingPolicy::NoMerge);
+    QVERIFY(!no_merge->merges(CommandID::RelayOn));
+    QVERIFY(!no_merge->cancelsOpposites());
+}
+
+
+void QueuePolicyTest::priorityOrdering()
+{
+    // the default policy sends queries before relay commands
+    ConcurentCommandQueue queue;
+    QVERIFY(queue.policy()->type() == SchedulingPolicy::Priority);
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0);
+    queue.updateOrPush(CommandID::QueryRelay, RelayID::None, 0, 0);
+    QVERIFY(queue.pop().id == CommandID::QueryRelay);
+    QVERIFY(queue.pop().id == CommandID::RelayOn);
+}
+
+
+void QueuePolicyTest::fifoOrdering()
+{
+    ConcurentCommandQueue queue{kPriorities.data(), QueuePolicy::create(SchedulingPolicy::Fifo)};
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0);
+    queue.updateOrPush(CommandID::QueryRelay, RelayID::None, 0, 0);
+    // the merged command keeps its position
+    QVERIFY(queue.updateOrPush(CommandID::RelayOn, RelayID::Two, 0, 0));
+    QCOMPARE(queue.size(), std::size_t{2});
+    Command command = queue.pop();
+    QVERIFY(command.id == CommandID::RelayOn);
+    QCOMPARE(command.params[0], as_number(RelayID::One | RelayID::Two));
+    QVERIFY(queue.pop().id == CommandID::QueryRelay);
+}
+
+
+void QueuePolicyTest::merging()
+{
+    ConcurentCommandQueue merging_queue{kPriorities.data(), QueuePolicy::create(SchedulingPolicy::Priority)};
+    QVERIFY(!merging_queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0));
+    QVERIFY(merging_queue.updateOrPush(CommandID::RelayOn, RelayID::Two, 0, 0));
+    QCOMPARE(merging_queue.size(), std::size_t{1});
+
+    ConcurentCommandQueue queue{kPriorities.data(), QueuePolicy::create(SchedulingPolicy::NoMerge)};
+    QVERIFY(!queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0));
+    QVERIFY(!queue.updateOrPush(CommandID::RelayOn, RelayID::Two, 0, 0));
+    QCOMPARE(queue.size(), std::size_t{2});
+    QCOMPARE(queue.count(CommandID::RelayOn), 2);
+    QCOMPARE(queue.pop().params[0], as_number(RelayID::One));
+    QCOMPARE(queue.pop().params[0], as_number(RelayID::Two));
+}
+
+
+void QueuePolicyTest::opposites()
+{
+    ConcurentCommandQueue cancelling_queue;
+    cancelling_queue.updateOrPush(CommandID::RelayOn, RelayID::One | RelayID::Two, 0, 0);
+    cancelling_queue.updateOrPush(CommandID::RelayOff, RelayID::One, 0, 0);
+    Command command = cancelling_queue.pop();
+    QVERIFY(command.id == CommandID::RelayOn);
+    QCOMPARE(command.params[0], as_number(RelayID::Two));
+    command = cancelling_queue.pop();
+    QVERIFY(command.id == CommandID::RelayOff);
+    QCOMPARE(command.params[0], as_number(RelayID::One));
+
+    ConcurentCommandQueue queue{kPriorities.data(), QueuePolicy::create(SchedulingPolicy::NoMerge)};
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One | RelayID::Two, 0, 0);
+    queue.updateOrPush(CommandID::RelayOff, RelayID::One, 0, 0);
+    QCOMPARE(queue.pop().params[0], as_number(RelayID::One | RelayID::Two));
+    QCOMPARE(queue.pop().params[0], as_number(RelayID::One));
+}
+
+
+void QueuePolicyTest::setPolicy()
+{
+    ConcurentCommandQueue queue;
+    queue.setPolicy(QueuePolicy::create(SchedulingPolicy::NoMerge));
+    QVERIFY(queue.policy()->type() == SchedulingPolicy::NoMerge);
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0);
+    queue.updateOrPush(CommandID::RelayOn, RelayID::One, 0, 0);
+    QCOMPARE(queue.size(), std::size_t{2});
+
+    // the pending commands are kept, the new policy applies to the new commands
+    queue.setPolicy(nullptr);
+    QVERIFY(queue.policy()->type() == SchedulingPolicy::Priority);
+    QVERIFY(queue.updateOrPush(CommandID::RelayOn, RelayID::Two, 0, 0));
+    QCOMPARE(queue.size(), std::size_t{2});
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
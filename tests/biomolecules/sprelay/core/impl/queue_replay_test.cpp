@@ -0,0 +1,173 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+
+/*!
+ * \file      queue_replay_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::QueueReplayTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::QueueReplay.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "queue_replay_test.h"
+
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/queue_replay.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void QueueReplayTest::burst()
+{
+    std::vector<ReplayRequest> workload{{0, {CommandID::RelayOn, RelayID::One, 0, 0}},
+        {0, {CommandID::RelayOn, RelayID::Two, 0, 0}}, {0, {CommandID::RelayOn, RelayID::Three, 0, 0}},
+        {0, {CommandID::QueryRelay, RelayID::None, 0, 0}}};
+    QueueReplay replay{workload, 50};
+    std::vector<ReplayResult> results =
+        replay.compare({SchedulingPolicy::Priority, SchedulingPolicy::Fifo, SchedulingPolicy::NoMerge});
+    QCOMPARE(results.size(), std::size_t{3});
+
+    // the query overtakes the merged relay command
+    const ReplayResult& priority = results[0];
+    QVERIFY(priority.policy == SchedulingPolicy::Priority);
+    QCOMPARE(priority.requests, 4);
+    QCOMPARE(priority.wire_commands, 2);
+    QCOMPARE(priority.dropped, 0);
+    QCOMPARE(priority.mean_latency, 37.5);
+    QCOMPARE(priority.max_latency, 50);
+    QCOMPARE(priority.duration, 100);
+    QVERIFY(qAbs(priority.fairness - 350.0 * 350.0 / (4 * 32500.0)) < 1e-9);
+
+    // the merged relay command goes first
+    const ReplayResult& fifo = results[1];
+    QVERIFY(fifo.policy == SchedulingPolicy::Fifo);
+    QCOMPARE(fifo.wire_commands, 2);
+    QCOMPARE(fifo.mean_latency, 12.5);
+    QCOMPARE(fifo.max_latency, 50);
+
+    // every command is sent
+    const ReplayResult& no_merge = results[2];
+    QVERIFY(no_merge.policy == SchedulingPolicy::NoMerge);
+    QCOMPARE(no_merge.wire_commands, 4);
+    QCOMPARE(no_merge.dropped, 0);
+    QCOMPARE(no_merge.mean_latency, 75.0);
+    QCOMPARE(no_merge.max_latency, 150);
+    QCOMPARE(no_merge.duration, 200);
+
+    QString report = QueueReplay::report(results);
+    QCOMPARE(report.count(QChar('\n')), 4);
+    QVERIFY(report.contains(QString("priority")));
+    QVERIFY(report.contains(QString("fifo")));
+    QVERIFY(report.contains(QString("no-merge")));
+}
+
+
+void QueueReplayTest::cancellation()
+{
+    // the query occupies the line, so the toggles meet in the queue and cancel each other
+    std::vector<ReplayRequest> workload{{0, {CommandID::QueryRelay, RelayID::None, 0, 0}},
+        {10, {CommandID::ToggleRelay, RelayID::One, 0, 0}}, {20, {CommandID::ToggleRelay, RelayID::One, 0, 0}}};
+    QueueReplay replay{workload, 50};
+
+    ReplayResult priority = replay.run(SchedulingPolicy::Priority);
+    QCOMPARE(priority.wire_commands, 2);
+    QCOMPARE(priority.dropped, 2);
+    QCOMPARE(priority.mean_latency, 0.0);
+
+    ReplayResult no_merge = replay.run(SchedulingPolicy::NoMerge);
+    QCOMPARE(no_merge.wire_commands, 3);
+    QCOMPARE(no_merge.dropped, 0);
+}
+
+
+void QueueReplayTest::generatedWorkload()
+{
+    std::vector<ReplayRequest> workload = QueueReplay::generateWorkload(500, 10, 7);
+    QCOMPARE(workload.size(), std::size_t{500});
+    for (std::size_t i = 1; i < workload.size(); ++i) {
+        QVERIFY(workload[i - 1].time <= workload[i].time);
+    }
+    // the same seed generates the same workload
+    std::vector<ReplayRequest> repeated = QueueReplay::generateWorkload(500, 10, 7);
+    for (std::size_t i = 0; i < workload.size(); ++i) {
+        QCOMPARE(repeated[i].time, workload[i].time);
+        QVERIFY(repeated[i].command.id == workload[i].command.id);
+    }
+
+    // the commands arrive faster than the line sends them
+    QueueReplay replay{workload, 20};
+    std::vector<ReplayResult> results =
+        replay.compare({SchedulingPolicy::Priority, SchedulingPolicy::Fifo, SchedulingPolicy::NoMerge});
+    const ReplayResult& no_merge = results[2];
+    QCOMPARE(no_merge.wire_commands, 500);
+    QCOMPARE(no_merge.dropped, 0);
+    for (const ReplayResult& result : results) {
+        QCOMPARE(result.requests, 500);
+        QVERIFY(result.wire_commands <= no_merge.wire_commands);
+        QVERIFY(result.fairness > 0.0 && result.fairness <= 1.0);
+        QVERIFY(result.mean_latency <= result.max_latency);
+    }
+    QVERIFY(results[0].wire_commands < no_merge.wire_commands);
+    QVERIFY(results[0].duration < no_merge.duration);
+}
+
+
+void QueueReplayTest::recordedWorkload()
+{
+    std::vector<CardCommand> commands{{CommandID::RelayOn, RelayID::One, 0, 0},
+        {CommandID::RelayOff, RelayID::One, 0, 0}, {CommandID::QueryRelay, RelayID::None, 0, 0}};
+    std::vector<ReplayRequest> workload = QueueReplay::fromCommands(commands, 100);
+    QCOMPARE(workload.size(), std::size_t{3});
+    QCOMPARE(workload[2].time, 200);
+
+    // the line is idle, when the commands arrive, so the policies don't matter
+    QueueReplay replay{workload, 50};
+    for (SchedulingPolicy policy : {SchedulingPolicy::Priority, SchedulingPolicy::Fifo, SchedulingPolicy::NoMerge}) {
+        ReplayResult result = replay.run(policy);
+        QCOMPARE(result.wire_commands, 3);
+        QCOMPARE(result.dropped, 0);
+        QCOMPARE(result.max_latency, 0);
+        QCOMPARE(result.fairness, 1.0);
+        QCOMPARE(result.duration, 250);
+    }
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,169 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      refresh_flight_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::RefreshFlightTest class which tests sharing of the card
+ *            info refresh.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "refresh_flight_test.h"
+
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/refresh_flight.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+const unsigned int kFirstPart = 1u << 0u;
+const unsigned int kSecondPart = 1u << 1u;
+const unsigned int kAllParts = kFirstPart | kSecondPart;
+const int kFreshness = 60000;
+
+}  // namespace
+
+
+void RefreshFlightTest::singleFlight()
+{
+    RefreshFlight flight;
+    std::vector<bool> results;
+    auto handler = [&results](bool completed) { results.push_back(completed); };
+    QVERIFY(flight.request(handler, kAllParts, true));
+    QVERIFY(flight.pending());
+    // the second request attaches to the refresh in flight
+    QVERIFY(!flight.request(handler, kAllParts, true));
+
+    flight.partReceived(kFirstPart);
+    flight.partReceived(kFirstPart);
+    QVERIFY(results.empty());
+    flight.partReceived(kSecondPart);
+    QCOMPARE(results, (std::vector<bool>{true, true}));
+    QVERIFY(!flight.pending());
+
+    // parts received without the refresh in flight are ignored
+    flight.partReceived(kAllParts);
+    QCOMPARE(results.size(), static_cast<std::size_t>(2));
+}
+
+
+void RefreshFlightTest::fail()
+{
+    RefreshFlight flight;
+    std::vector<bool> results;
+    QVERIFY(flight.request([&results](bool completed) { results.push_back(completed); }, kAllParts, true));
+    flight.partReceived(kFirstPart);
+    flight.fail();
+    QCOMPARE(results, (std::vector<bool>{false}));
+    QVERIFY(!flight.pending());
+
+    // the failure without the refresh in flight completes nothing and the next refresh needs all the parts
+    flight.fail();
+    QCOMPARE(results.size(), static_cast<std::size_t>(1));
+    QVERIFY(flight.request([&results](bool completed) { results.push_back(completed); }, kAllParts, true));
+    flight.partReceived(kSecondPart);
+    QCOMPARE(results.size(), static_cast<std::size_t>(1));
+    flight.partReceived(kFirstPart);
+    QCOMPARE(results, (std::vector<bool>{false, true}));
+}
+
+
+void RefreshFlightTest::disconnected()
+{
+    RefreshFlight flight;
+    std::vector<bool> results;
+    // the queries are sent anyway, but the refresh doesn't start
+    QVERIFY(flight.request([&results](bool completed) { results.push_back(completed); }, kAllParts, false));
+    QCOMPARE(results, (std::vector<bool>{false}));
+    QVERIFY(!flight.pending());
+}
+
+
+void RefreshFlightTest::freshness()
+{
+    RefreshFlight flight;
+    flight.setFreshness(kFreshness);
+    std::vector<bool> results;
+    auto handler = [&results](bool completed) { results.push_back(completed); };
+    QVERIFY(flight.request(handler, kAllParts, true));
+    flight.partReceived(kAllParts);
+    QCOMPARE(results, (std::vector<bool>{true}));
+
+    // the fresh refresh satisfies the request without queries
+    QVERIFY(!flight.request(handler, kAllParts, true));
+    QCOMPARE(results, (std::vector<bool>{true, true}));
+    QVERIFY(!flight.pending());
+
+    // the invalidated refresh is not fresh
+    flight.invalidate();
+    QVERIFY(flight.request(handler, kAllParts, true));
+    QVERIFY(flight.pending());
+
+    // the disabled window doesn't satisfy any request
+    flight.partReceived(kAllParts);
+    flight.setFreshness(0);
+    QVERIFY(flight.request(handler, kAllParts, true));
+}
+
+
+void RefreshFlightTest::reentrancy()
+{
+    RefreshFlight flight;
+    int first_calls = 0;
+    int second_calls = 0;
+    // the handler requests another refresh, which is not completed by the same parts
+    QVERIFY(flight.request(
+        [&](bool) {
+            ++first_calls;
+            QVERIFY(flight.request([&second_calls](bool) { ++second_calls; }, kAllParts, true));
+        },
+        kAllParts, true));
+    flight.partReceived(kAllParts);
+    QCOMPARE(first_calls, 1);
+    QCOMPARE(second_calls, 0);
+    QVERIFY(flight.pending());
+    flight.partReceived(kAllParts);
+    QCOMPARE(second_calls, 1);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
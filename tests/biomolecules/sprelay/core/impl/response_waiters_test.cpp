@@ -0,0 +1,132 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      response_waiters_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::ResponseWaitersTest class which tests waiting for card
+ *            responses.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "response_waiters_test.h"
+
+#include <vector>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/response_waiters.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+CardEvent relay_status(RelayID current)
+{
+    return CardEvent{ResponseID::RelayStatus, 0, as_number(current), 0, false};
+}
+
+bool is_relay_status(const CardEvent& event)
+{
+    return event.response == ResponseID::RelayStatus;
+}
+
+bool is_button_status(const CardEvent& event)
+{
+    return event.response == ResponseID::ButtonStatus;
+}
+
+}  // namespace
+
+
+void ResponseWaitersTest::complete()
+{
+    ResponseWaiters waiters;
+    QVERIFY(waiters.empty());
+    std::vector<int> calls;
+    waiters.add(is_relay_status, [&calls](const CardEvent& event) { calls.push_back(event.param1); });
+    waiters.add(is_button_status, [&calls](const CardEvent& event) { calls.push_back(event.param1 + 100); });
+    waiters.add(is_relay_status, [&calls](const CardEvent& event) { calls.push_back(event.param1 + 200); });
+    QVERIFY(!waiters.empty());
+
+    // the matched waiters are completed in the order of their addition and only once
+    waiters.complete(relay_status(RelayID::Two));
+    QCOMPARE(calls, (std::vector<int>{2, 202}));
+    waiters.complete(relay_status(RelayID::Two));
+    QCOMPARE(calls, (std::vector<int>{2, 202}));
+    QVERIFY(!waiters.empty());
+}
+
+
+void ResponseWaitersTest::disconnection()
+{
+    ResponseWaiters waiters;
+    std::vector<ResponseID> responses;
+    auto handler = [&responses](const CardEvent& event) { responses.push_back(event.response); };
+    waiters.add(is_relay_status, handler);
+    waiters.add(is_button_status, handler);
+
+    // the disconnection completes all the waiters without testing the matchers
+    waiters.complete(CardEvent{ResponseID::None, 0, 0, 0, false});
+    QCOMPARE(responses, (std::vector<ResponseID>{ResponseID::None, ResponseID::None}));
+    QVERIFY(waiters.empty());
+}
+
+
+void ResponseWaitersTest::reentrancy()
+{
+    ResponseWaiters waiters;
+    int first_calls = 0;
+    int second_calls = 0;
+    // the handler waits for the next response, the new waiter is not completed by the same event
+    waiters.add(is_relay_status, [&](const CardEvent&) {
+        ++first_calls;
+        waiters.add(is_relay_status, [&second_calls](const CardEvent&) { ++second_calls; });
+    });
+    waiters.complete(relay_status(RelayID::One));
+    QCOMPARE(first_calls, 1);
+    QCOMPARE(second_calls, 0);
+    QVERIFY(!waiters.empty());
+    waiters.complete(relay_status(RelayID::One));
+    QCOMPARE(first_calls, 1);
+    QCOMPARE(second_calls, 1);
+    QVERIFY(waiters.empty());
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,139 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      spsc_byte_channel_test.cpp
+ * \brief     The biomolecules::sprelay::core::SpscByteChannelTest class which implements tests for
+ *            biomolecules::sprelay::core::SpscByteChannel.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "spsc_byte_channel_test.h"
+
+#include <QByteArray>
+#include <QtTest>
+
+#include <cstddef>
+#include <thread>
+
+#include "biomolecules/sprelay/core/spsc_byte_channel.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+
+void SpscByteChannelTest::capacity()
+{
+    QCOMPARE(SpscByteChannel{1}.capacity(), std::size_t{1});
+    QCOMPARE(SpscByteChannel{7}.capacity(), std::size_t{8});
+    QCOMPARE(SpscByteChannel{64}.capacity(), std::size_t{64});
+    QCOMPARE(SpscByteChannel{}.capacity(), SpscByteChannel::kDefaultCapacity);
+}
+
+
+void SpscByteChannelTest::writeRead()
+{
+    SpscByteChannel channel{16};
+    QVERIFY(channel.empty());
+    QVERIFY(channel.readAll().isEmpty());
+
+    QCOMPARE(channel.write("abc", 3), std::size_t{3});
+    QCOMPARE(channel.write("defg", 4), std::size_t{4});
+    QCOMPARE(channel.size(), std::size_t{7});
+    QCOMPARE(channel.readAll(), QByteArray{"abcdefg"});
+    QVERIFY(channel.empty());
+}
+
+
+void SpscByteChannelTest::full()
+{
+    SpscByteChannel channel{8};
+    QCOMPARE(channel.write("0123456789", 10), std::size_t{8});
+    QCOMPARE(channel.write("x", 1), std::size_t{0});
+    QCOMPARE(channel.readAll(), QByteArray{"01234567"});
+    QCOMPARE(channel.write("x", 1), std::size_t{1});
+    QCOMPARE(channel.readAll(), QByteArray{"x"});
+}
+
+
+void SpscByteChannelTest::wrapAround()
+{
+    SpscByteChannel channel{8};
+    QCOMPARE(channel.write("abcdef", 6), std::size_t{6});
+    QCOMPARE(channel.readAll(), QByteArray{"abcdef"});
+    // the next write is split at the end of the buffer
+    QCOMPARE(channel.write("ghijklm", 7), std::size_t{7});
+    QCOMPARE(channel.size(), std::size_t{7});
+    QCOMPARE(channel.readAll(), QByteArray{"ghijklm"});
+}
+
+
+void SpscByteChannelTest::concurrent()
+{
+    const int n_bytes = 1000000;
+    SpscByteChannel channel{64};
+
+    // the producer writes a known sequence in small chunks, the consumer checks that nothing is lost or reordered
+    std::thread producer{[&channel, n_bytes]() {
+        char chunk[7];
+        int written = 0;
+        while (written < n_bytes) {
+            int n = 0;
+            for (; n < 7 && written + n < n_bytes; ++n) {
+                chunk[n] = static_cast<char>((written + n) % 251);
+            }
+            std::size_t offset = 0;
+            while (offset < static_cast<std::size_t>(n)) {
+                offset += channel.write(&chunk[offset], static_cast<std::size_t>(n) - offset);
+            }
+            written += n;
+        }
+    }};
+
+    int received = 0;
+    bool in_order = true;
+    while (received < n_bytes) {
+        QByteArray data = channel.readAll();
+        for (char byte : data) {
+            in_order = in_order && byte == static_cast<char>(received % 251);
+            ++received;
+        }
+    }
+    producer.join();
+
+    QCOMPARE(received, n_bytes);
+    QVERIFY2(in_order, "The bytes were lost or reordered.");
+    QVERIFY(channel.empty());
+}
+
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
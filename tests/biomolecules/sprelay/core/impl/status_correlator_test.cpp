@@ -0,0 +1,129 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      status_correlator_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::StatusCorrelatorTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::StatusCorrelator.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "status_correlator_test.h"
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+#include "biomolecules/sprelay/core/status_correlator.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void StatusCorrelatorTest::queryReply()
+{
+    const qint64 elapsed = 10;
+    StatusCorrelator correlator;
+    QCOMPARE(correlator.expected(), CommandID::None);
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::One, RelayID::One, elapsed)
+        == StatusOrigin::Ambiguous);
+
+    correlator.expect(CommandID::QueryRelay, RelayID::None, RelayID::One, true);
+    QCOMPARE(correlator.expected(), CommandID::QueryRelay);
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::Two, RelayID::Two, elapsed) == StatusOrigin::Reply);
+
+    // the transition is reported only by the spontaneous event
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::One, RelayID::One | RelayID::Two, elapsed)
+        == StatusOrigin::Unsolicited);
+
+    // other commands are not awaited
+    correlator.expect(CommandID::RelayOn, RelayID::One, RelayID::One, true);
+    QCOMPARE(correlator.expected(), CommandID::None);
+}
+
+
+void StatusCorrelatorTest::toggleReply()
+{
+    const qint64 elapsed = 10;
+    StatusCorrelator correlator;
+
+    correlator.expect(CommandID::ToggleRelay, RelayID::One | RelayID::Two, RelayID::One, true);
+    QVERIFY(correlator.classify(CommandID::ToggleRelay, RelayID::One, RelayID::Two, elapsed) == StatusOrigin::Reply);
+
+    // other changes than the toggled relays
+    QVERIFY(correlator.classify(CommandID::ToggleRelay, RelayID::One, RelayID::One | RelayID::Three, elapsed)
+        == StatusOrigin::Unsolicited);
+    QVERIFY(correlator.classify(CommandID::ToggleRelay, RelayID::One, RelayID::One, elapsed)
+        == StatusOrigin::Unsolicited);
+
+    // the right change from the unexpected state
+    RelayID toggled = RelayID::One | RelayID::Two | RelayID::Three;
+    QVERIFY(correlator.classify(CommandID::ToggleRelay, RelayID::Three, toggled, elapsed) == StatusOrigin::Ambiguous);
+
+    // the state is unknown before the first relay status
+    correlator.expect(CommandID::ToggleRelay, RelayID::Two, RelayID::None, false);
+    QVERIFY(correlator.classify(CommandID::ToggleRelay, RelayID::Three, RelayID::Two | RelayID::Three, elapsed)
+        == StatusOrigin::Reply);
+}
+
+
+void StatusCorrelatorTest::earlyFrame()
+{
+    StatusCorrelator correlator;
+    correlator.expect(CommandID::QueryRelay, RelayID::None, RelayID::None, true);
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::None, RelayID::None, 0) == StatusOrigin::Ambiguous);
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::None, RelayID::None, StatusCorrelator::kMinReplyTime)
+        == StatusOrigin::Reply);
+}
+
+
+void StatusCorrelatorTest::outdatedExpectation()
+{
+    const qint64 elapsed = 10;
+    StatusCorrelator correlator;
+    correlator.expect(CommandID::QueryRelay, RelayID::None, RelayID::None, true);
+
+    // the query was already completed
+    QVERIFY(correlator.classify(CommandID::None, RelayID::None, RelayID::None, elapsed) == StatusOrigin::Ambiguous);
+
+    correlator.clear();
+    QCOMPARE(correlator.expected(), CommandID::None);
+    QVERIFY(correlator.classify(CommandID::QueryRelay, RelayID::None, RelayID::None, elapsed)
+        == StatusOrigin::Ambiguous);
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
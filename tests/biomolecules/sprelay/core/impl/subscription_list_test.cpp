@@ -0,0 +1,155 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      subscription_list_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::SubscriptionListTest class which tests collecting of event
+ *            subscriptions.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "subscription_list_test.h"
+
+#include <vector>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QPointer>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/event_subscription.h"
+#include "biomolecules/sprelay/core/subscription_list.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+namespace {
+
+// deletes the subscriptions released by deleteLater()
+void delete_released()
+{
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+}  // namespace
+
+
+void SubscriptionListTest::dispatch()
+{
+    SubscriptionList subscriptions;
+    std::vector<EventSubscription*> targets;
+    // nothing is collected without subscriptions
+    QVERIFY(!subscriptions.beginDispatch(EventType::RelayStatus, RelayID::One, &targets));
+
+    EventSubscription* relays = subscriptions.add(EventType::RelayStatus, RelayID::One | RelayID::Two);
+    EventSubscription* buttons = subscriptions.add(EventType::ButtonStatus, RelayID::All);
+    QCOMPARE(relays->events(), EventType::RelayStatus);
+    QCOMPARE(relays->relays(), RelayID::One | RelayID::Two);
+
+    // the subscriptions are matched by the event type and the changed relays
+    QVERIFY(subscriptions.beginDispatch(EventType::RelayStatus, RelayID::Two | RelayID::Three, &targets));
+    QCOMPARE(targets, (std::vector<EventSubscription*>{relays}));
+    subscriptions.endDispatch(&targets);
+    QVERIFY(targets.empty());
+    QVERIFY(subscriptions.beginDispatch(EventType::ButtonStatus, RelayID::Eight, &targets));
+    QCOMPARE(targets, (std::vector<EventSubscription*>{buttons}));
+    subscriptions.endDispatch(&targets);
+    QVERIFY(!subscriptions.beginDispatch(EventType::RelayStatus, RelayID::Three, &targets));
+    QVERIFY(!subscriptions.beginDispatch(EventType::RelayStatus, RelayID::None, &targets));
+    QVERIFY(targets.empty());
+}
+
+
+void SubscriptionListTest::removeDuringDispatch()
+{
+    SubscriptionList subscriptions;
+    QPointer<EventSubscription> first = subscriptions.add(EventType::RelayStatus, RelayID::All);
+    QPointer<EventSubscription> second = subscriptions.add(EventType::RelayStatus, RelayID::All);
+    std::vector<EventSubscription*> targets;
+    QVERIFY(subscriptions.beginDispatch(EventType::RelayStatus, RelayID::One, &targets));
+    QCOMPARE(targets.size(), static_cast<std::size_t>(2));
+
+    // the collected subscription is not released until the dispatching ends
+    subscriptions.remove(first);
+    delete_released();
+    QVERIFY(!first.isNull());
+    subscriptions.endDispatch(&targets);
+    delete_released();
+    QVERIFY(first.isNull());
+
+    // the subscription removed outside of the dispatching is released at once
+    QVERIFY(subscriptions.beginDispatch(EventType::RelayStatus, RelayID::One, &targets));
+    QCOMPARE(targets, (std::vector<EventSubscription*>{second.data()}));
+    subscriptions.endDispatch(&targets);
+    subscriptions.remove(second);
+    delete_released();
+    QVERIFY(second.isNull());
+    QVERIFY(!subscriptions.beginDispatch(EventType::RelayStatus, RelayID::One, &targets));
+}
+
+
+void SubscriptionListTest::replay()
+{
+    SubscriptionList subscriptions;
+    QPointer<EventSubscription> subscription = subscriptions.add(EventType::RelayStatus, RelayID::All);
+    QVERIFY(subscriptions.beginReplay(subscription));
+    subscriptions.remove(subscription);
+    delete_released();
+    QVERIFY(!subscription.isNull());
+    subscriptions.endReplay();
+    delete_released();
+    QVERIFY(subscription.isNull());
+
+    // the released subscription is not replayed
+    QVERIFY(!subscriptions.beginReplay(subscription.data()));
+}
+
+
+void SubscriptionListTest::destroy()
+{
+    QPointer<EventSubscription> subscription;
+    {
+        SubscriptionList subscriptions;
+        subscription = subscriptions.add(EventType::RelayStatus, RelayID::All);
+    }
+    QVERIFY(!subscription.isNull());
+    delete_released();
+    QVERIFY(subscription.isNull());
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -73,7 +73,8 @@ void UnifiedSerialPortTest::initTestCase()
     for (const serial_utils::ComPortParams& params : UnifiedSerialPort::availablePorts()) {
         if (params.product_identifier == k8090::impl_::kProductID
             && params.vendor_identifier == k8090::impl_::kVendorID) {
-            if (params.port_name != UnifiedSerialPort::kMockPortName) {
+            if (params.port_name != UnifiedSerialPort::kMockPortName
+                && params.port_name != UnifiedSerialPort::kThreadedMockPortName) {
                 real_card_port_name_ = params.port_name;
                 real_card_present_ = true;
                 break;
@@ -85,16 +86,21 @@ void UnifiedSerialPortTest::initTestCase()
 
 void UnifiedSerialPortTest::availablePorts()
 {
-    // test, if the mock port is always present
+    // test, if the mock ports are always present
     bool mock_found = false;
+    bool threaded_mock_found = false;
     for (const serial_utils::ComPortParams& params : UnifiedSerialPort::availablePorts()) {
-        if (params.port_name == UnifiedSerialPort::kMockPortName
-            && params.product_identifier == k8090::impl_::kProductID
+        if (params.product_identifier == k8090::impl_::kProductID
             && params.vendor_identifier == k8090::impl_::kVendorID) {
-            mock_found = true;
+            if (params.port_name == UnifiedSerialPort::kMockPortName) {
+                mock_found = true;
+            } else if (params.port_name == UnifiedSerialPort::kThreadedMockPortName) {
+                threaded_mock_found = true;
+            }
         }
     }
     QCOMPARE(mock_found, true);
+    QCOMPARE(threaded_mock_found, true);
 }
 
 
@@ -225,6 +231,109 @@ void UnifiedSerialPortTest::switchRealVirtual()
 }
 
 
+void UnifiedSerialPortTest::switchVirtualThreadedVirtual()
+{
+    std::unique_ptr<UnifiedSerialPort> serial_port = createSerialPort(UnifiedSerialPort::kMockPortName);
+    if (!serial_port) {
+        QFAIL(qPrintable(QString{"Port '%1' can't be opened."}.arg(UnifiedSerialPort::kMockPortName)));
+    }
+    QVERIFY2(serial_port->isMock(), "The serial port should be virtual now.");
+
+    //                                                STX   CMD   MASK  PAR1  PAR2  CHK   ETX
+    static const unsigned char on[] /*          */ = {0x04, 0x11, 0x01, 0x00, 0x00, 0xea, 0x0f};
+    static const unsigned char response_on[] /* */ = {0x04, 0x51, 0x00, 0x01, 0x00, 0xaa, 0x0f};
+    static const unsigned char query_status[] /**/ = {0x04, 0x18, 0x00, 0x00, 0x00, 0xe4, 0x0f};
+    static const unsigned char response[] /*    */ = {0x04, 0x51, 0x00, 0x00, 0x00, 0xab, 0x0f};
+
+    // change to threaded virtual port, the parameters should transfer to the newly oppened port
+    serial_port->setPortName(UnifiedSerialPort::kThreadedMockPortName);
+    if (!serial_port->open(QIODevice::ReadWrite)) {
+        QFAIL(qPrintable(QString{"Port '%1' can't be opened."}.arg(UnifiedSerialPort::kThreadedMockPortName)));
+    }
+    QVERIFY2(serial_port->isOpen(), "The serial port should be oppened by now.");
+    QVERIFY2(serial_port->isMock(), "The threaded serial port should be virtual too.");
+    QVERIFY2(!serial_port->isReal(), "The threaded serial port shouldn't be real.");
+
+    // the new card is in the default state and it responds asynchronously
+    const std::list<std::pair<const unsigned char*, const unsigned char*>> commands{
+        {&query_status[0], &response[0]}, {&on[0], &response_on[0]}};
+    for (const auto& command : commands) {
+        qint64 elapsed_time;
+        if (measureCommandWithResponse(serial_port.get(), command.first, &elapsed_time)) {
+            QFAIL("There is no response from the card.");
+        }
+        QByteArray data = serial_port->readAll();
+        int n = data.size();
+        if (n != 7) {
+            QFAIL(qPrintable(QString{"Response has %1 but should have 7"}.arg(n)));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto buffer = reinterpret_cast<const unsigned char*>(data.constData());
+        QVERIFY2(compareResponse(buffer, command.second),
+            qPrintable(QString{"The response '%1' does not match the expected %2."}
+                           .arg(serial_utils::byte_to_hex(buffer, 7))
+                           .arg(serial_utils::byte_to_hex(command.second, 7))));
+    }
+
+    // flushing reports the data handed over to the card thread
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    QCOMPARE(serial_port->write(reinterpret_cast<const char*>(query_status), 7), qint64{7});
+    QVERIFY2(serial_port->flush(), "The written data should be reported by flush.");
+    QVERIFY2(!serial_port->flush(), "There should be no more data to flush.");
+
+    // closing discards undelivered data
+    sendCommand(serial_port.get(), query_status);
+    serial_port->close();
+    QVERIFY2(!serial_port->isOpen(), "The serial port should be closed by now.");
+    QVERIFY2(serial_port->readAll().isEmpty(), "The data should be discarded by closing the port.");
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    QCOMPARE(serial_port->write(reinterpret_cast<const char*>(query_status), 7), qint64{-1});
+
+    // change back to virtual port
+    serial_port->setPortName(UnifiedSerialPort::kMockPortName);
+    if (!serial_port->open(QIODevice::ReadWrite)) {
+        QFAIL(qPrintable(QString{"Port '%1' can't be opened."}.arg(UnifiedSerialPort::kMockPortName)));
+    }
+    QVERIFY2(serial_port->isMock(), "The serial port should be virtual now.");
+}
+
+
+void UnifiedSerialPortTest::virtualBenchmark_data()
+{
+    QTest::addColumn<QString>("port_name");
+
+    QTest::newRow("virtual card") << QString{UnifiedSerialPort::kMockPortName};
+    QTest::newRow("threaded virtual card") << QString{UnifiedSerialPort::kThreadedMockPortName};
+}
+
+
+void UnifiedSerialPortTest::virtualBenchmark()
+{
+    QFETCH(QString, port_name);
+
+    std::unique_ptr<UnifiedSerialPort> serial_port = createSerialPort(port_name);
+    if (!serial_port) {
+        QFAIL(qPrintable(QString{"Port '%1' can't be opened."}.arg(port_name)));
+    }
+
+    //                                                STX   CMD   MASK  PAR1  PAR2  CHK   ETX
+    static const unsigned char query_status[] /**/ = {0x04, 0x18, 0x00, 0x00, 0x00, 0xe4, 0x0f};
+    const int n_commands = 20;
+    qint64 elapsed_time = 0;
+    for (int i = 0; i < n_commands; ++i) {
+        qint64 local_elapsed_time;
+        if (measureCommandWithResponse(serial_port.get(), query_status, &local_elapsed_time)) {
+            QFAIL("There is no response from the card.");
+        }
+        elapsed_time += local_elapsed_time;
+        QCOMPARE(serial_port->readAll().size(), 7);
+    }
+    qDebug() << QString("%1 command took: %2 ms").arg(port_name).arg(elapsed_time / static_cast<double>(n_commands));
+
+    QTest::setBenchmarkResult(elapsed_time / static_cast<double>(n_commands), QTest::WalltimeMilliseconds);
+}
+
+
 void UnifiedSerialPortTest::realBenchmark_data()
 {
     if (!real_card_present_) {
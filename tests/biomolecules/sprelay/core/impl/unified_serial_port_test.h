@@ -65,6 +65,9 @@ private slots:
     void initTestCase();
     void availablePorts();
     void switchRealVirtual();
+    void switchVirtualThreadedVirtual();
+    void virtualBenchmark_data();
+    void virtualBenchmark();
     void realBenchmark_data();
     void realBenchmark();
     void realJumperStatus();
@@ -0,0 +1,190 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      wear_accounting_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::impl_::WearAccountingTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::impl_::WearAccounting.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "wear_accounting_test.h"
+
+#include <QByteArray>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/core/wear_accounting.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+namespace impl_ {
+
+void WearAccountingTest::switchCounts()
+{
+    WearAccounting accounting;
+    const qint64 t0 = 1000;
+
+    // the first status only initializes the state
+    QVERIFY(accounting.update(RelayID::One, t0));
+    QCOMPARE(accounting.wear(0, t0).switch_count, quint64{0});
+    QVERIFY(!accounting.isDirty());
+
+    // repeated status is not a transition
+    QVERIFY(!accounting.update(RelayID::One, t0 + 10));
+    QCOMPARE(accounting.wear(0, t0 + 10).switch_count, quint64{0});
+
+    QVERIFY(accounting.update(RelayID::Two, t0 + 20));
+    QCOMPARE(accounting.wear(0, t0 + 20).switch_count, quint64{1});
+    QCOMPARE(accounting.wear(1, t0 + 20).switch_count, quint64{1});
+    QCOMPARE(accounting.wear(0, t0 + 20).last_transition, t0 + 20);
+    QCOMPARE(accounting.wear(2, t0 + 20).switch_count, quint64{0});
+    QCOMPARE(accounting.wear(2, t0 + 20).last_transition, qint64{0});
+    QVERIFY(accounting.isDirty());
+
+    accounting.clearDirty();
+    QVERIFY(!accounting.isDirty());
+    accounting.update(RelayID::None, t0 + 30);
+    QCOMPARE(accounting.wear(1, t0 + 30).switch_count, quint64{2});
+    QVERIFY(accounting.isDirty());
+}
+
+
+void WearAccountingTest::onTime()
+{
+    WearAccounting accounting;
+    const qint64 t0 = 1000;
+
+    accounting.update(RelayID::None, t0);
+    accounting.update(RelayID::One, t0 + 100);
+    // on-time of switched on relay includes the time until now
+    QCOMPARE(accounting.wear(0, t0 + 150).on_time, qint64{50});
+    QCOMPARE(accounting.switchedOn(), RelayID::One);
+
+    accounting.update(RelayID::None, t0 + 300);
+    QCOMPARE(accounting.wear(0, t0 + 1000).on_time, qint64{200});
+    QCOMPARE(accounting.switchedOn(), RelayID::None);
+
+    accounting.update(RelayID::One, t0 + 400);
+    accounting.update(RelayID::None, t0 + 450);
+    QCOMPARE(accounting.wear(0, t0 + 1000).on_time, qint64{250});
+
+    // time going backwards does not decrease on-time
+    accounting.update(RelayID::One, t0 + 500);
+    accounting.update(RelayID::None, t0);
+    QCOMPARE(accounting.wear(0, t0 + 1000).on_time, qint64{250});
+}
+
+
+void WearAccountingTest::epochOffset()
+{
+    const qint64 offset = 1500000000000;
+    WearAccounting accounting{offset};
+    const qint64 t0 = 1000;
+
+    // only the last transition time is converted, the on-time stays monotonic
+    accounting.update(RelayID::None, t0);
+    accounting.update(RelayID::One, t0 + 100);
+    QCOMPARE(accounting.wear(0, t0 + 150).last_transition, offset + t0 + 100);
+    QCOMPARE(accounting.wear(0, t0 + 150).on_time, qint64{50});
+    QVERIFY(WearAccounting::now() <= WearAccounting::now());
+}
+
+
+void WearAccountingTest::invalidate()
+{
+    WearAccounting accounting;
+    const qint64 t0 = 1000;
+
+    accounting.update(RelayID::One, t0);
+    accounting.invalidate(t0 + 100);
+    QCOMPARE(accounting.wear(0, t0 + 200).on_time, qint64{100});
+    QCOMPARE(accounting.switchedOn(), RelayID::None);
+
+    // the first status after invalidation is not counted as transition
+    accounting.update(RelayID::None, t0 + 300);
+    QCOMPARE(accounting.wear(0, t0 + 300).switch_count, quint64{0});
+    QCOMPARE(accounting.wear(0, t0 + 400).on_time, qint64{100});
+}
+
+
+void WearAccountingTest::serialization()
+{
+    WearAccounting accounting;
+    const qint64 t0 = 1000;
+
+    accounting.update(RelayID::None, t0);
+    accounting.update(RelayID::One | RelayID::Eight, t0 + 100);
+    accounting.update(RelayID::Eight, t0 + 200);
+    QByteArray data = accounting.serialize(t0 + 300);
+    const int kExpectedSize = 4 + 1 + 8 * 3 * 8;
+    QCOMPARE(data.size(), kExpectedSize);
+
+    WearAccounting restored;
+    QVERIFY(restored.deserialize(data));
+    for (unsigned int i = 0; i < 8; ++i) {
+        QCOMPARE(restored.wear(i, t0 + 300).switch_count, accounting.wear(i, t0 + 300).switch_count);
+        QCOMPARE(restored.wear(i, t0 + 300).on_time, accounting.wear(i, t0 + 300).on_time);
+        QCOMPARE(restored.wear(i, t0 + 300).last_transition, accounting.wear(i, t0 + 300).last_transition);
+    }
+    // the stored on-time of switched on relay is not counted twice
+    QCOMPARE(restored.wear(7, t0 + 1000).on_time, qint64{200});
+    QCOMPARE(restored.switchedOn(), RelayID::None);
+}
+
+
+void WearAccountingTest::invalidData()
+{
+    WearAccounting accounting;
+    const qint64 t0 = 1000;
+    accounting.update(RelayID::None, t0);
+    accounting.update(RelayID::One, t0 + 100);
+    QByteArray data = accounting.serialize(t0 + 200);
+
+    WearAccounting restored;
+    QVERIFY(!restored.deserialize(QByteArray{}));
+    QVERIFY(!restored.deserialize(data.left(data.size() - 1)));
+    QByteArray longer = data;
+    longer.append('\0');
+    QVERIFY(!restored.deserialize(longer));
+    QByteArray bad_magic = data;
+    bad_magic[0] = 'X';
+    QVERIFY(!restored.deserialize(bad_magic));
+    QCOMPARE(restored.wear(0, t0).switch_count, quint64{0});
+}
+
+}  // namespace impl_
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
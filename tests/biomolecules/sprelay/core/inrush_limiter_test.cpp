@@ -0,0 +1,167 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      inrush_limiter_test.cpp
+ * \brief     Tests of biomolecules::sprelay::core::k8090::InrushLimiter and staggered switching.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "inrush_limiter_test.h"
+
+#include <memory>
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/inrush_limiter.h"
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+const int kTimeout = 5000;
+
+// counts relays in the mask
+int relay_count(RelayID relays)
+{
+    int count = 0;
+    for (unsigned int i = 0; i < 8; ++i) {
+        if ((relays & from_number(i)) != RelayID::None) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+
+void InrushLimiterTest::reserve()
+{
+    InrushLimiter limiter{3, 100};
+    QCOMPARE(limiter.maxClosings(), 3);
+    QCOMPARE(limiter.window(), 100);
+    const qint64 t0 = 1000;
+
+    QCOMPARE(limiter.nextAvailable(t0), t0);
+    QCOMPARE(limiter.reserve(2, t0), 2);
+    QCOMPARE(limiter.reserve(2, t0 + 10), 1);
+    QCOMPARE(limiter.reserve(1, t0 + 20), 0);
+    // the window has to slide over the first closings
+    QCOMPARE(limiter.nextAvailable(t0 + 20), t0 + 100);
+}
+
+
+void InrushLimiterTest::slidingWindow()
+{
+    InrushLimiter limiter{2, 100};
+    const qint64 t0 = 1000;
+
+    QCOMPARE(limiter.reserve(1, t0), 1);
+    QCOMPARE(limiter.reserve(1, t0 + 50), 1);
+    QCOMPARE(limiter.nextAvailable(t0 + 60), t0 + 100);
+    QCOMPARE(limiter.reserve(2, t0 + 100), 1);
+    QCOMPARE(limiter.nextAvailable(t0 + 100), t0 + 150);
+    QCOMPARE(limiter.reserve(1, t0 + 149), 0);
+    QCOMPARE(limiter.reserve(1, t0 + 150), 1);
+}
+
+
+void InrushLimiterTest::globalLimit()
+{
+    auto global = std::make_shared<InrushLimiter>(3, 100);
+    InrushLimiter first{2, 100, global};
+    InrushLimiter second{2, 100, global};
+    const qint64 t0 = 1000;
+
+    // the card limit applies first
+    QCOMPARE(first.reserve(3, t0), 2);
+    // the global limit is shared by the cards
+    QCOMPARE(second.reserve(2, t0), 1);
+    QCOMPARE(second.nextAvailable(t0 + 10), t0 + 100);
+
+    // refused global closings are not counted by the card limiter
+    QCOMPARE(second.reserve(1, t0 + 100), 1);
+    QCOMPARE(second.reserve(1, t0 + 100), 1);
+}
+
+
+void InrushLimiterTest::staggeredSwitching()
+{
+    const RelayID kRelays = RelayID::One | RelayID::Two | RelayID::Three;
+    const int kWindow = 100;
+
+    K8090 k8090;
+    k8090.setComPortName(impl_::kMockPortName);
+    QSignalSpy spy_connected(&k8090, SIGNAL(connected()));
+    k8090.connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_connected.count(), 1, kTimeout);
+    QSignalSpy spy_relay_status(&k8090,
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090.switchRelayOff(kRelays);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & kRelays) == RelayID::None,
+        kTimeout);
+
+    // one relay is closed in each window
+    k8090.setInrushLimiter(std::make_shared<InrushLimiter>(1, kWindow));
+    spy_relay_status.clear();
+    QElapsedTimer timer;
+    timer.start();
+    k8090.switchRelayOn(kRelays);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & kRelays) == kRelays,
+        kTimeout);
+    QVERIFY(timer.elapsed() >= 2 * kWindow);
+    RelayID closed = RelayID::None;
+    for (const QList<QVariant>& status : spy_relay_status) {
+        auto current = qvariant_cast<RelayID>(status.at(1));
+        QVERIFY(relay_count(current & kRelays & ~closed) <= 1);
+        closed |= current & kRelays;
+    }
+
+    k8090.switchRelayOff(kRelays);
+    QTRY_VERIFY_WITH_TIMEOUT((qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & kRelays) == RelayID::None,
+        kTimeout);
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
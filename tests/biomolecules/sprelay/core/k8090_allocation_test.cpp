@@ -0,0 +1,254 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      k8090_allocation_test.cpp
+ * \brief     Heap allocation budget tests of biomolecules::sprelay::core::k8090::K8090 operations.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "k8090_allocation_test.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/k8090_utils.h"
+
+#include "biomolecules/sprelay/core/impl/allocation_counter.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+// the command node owned by the command queue, the growth of the queue storage and the growth of the index of the
+// commands with the same id
+const std::size_t kEnqueueBudget = 3;
+// the record of the timer registered in the event dispatcher, each armed timer allocates one
+const std::size_t kTimerBudget = 1;
+// the event requesting the transfer of the written frame to the thread of the threaded mock card
+const std::size_t kTransferBudget = 1;
+
+struct Operation
+{
+    const char* name;
+    void (*call)(K8090* k8090);
+    std::size_t commands;
+    bool checks_connection;
+    std::size_t timers;  // timers armed when the command is sent to the free line
+};
+
+const std::array<Operation, 13> kOperations{{
+    {"switchRelayOn", [](K8090* k8090) { k8090->switchRelayOn(RelayID::One | RelayID::Two); }, 1, true, 1},
+    {"switchRelayOff", [](K8090* k8090) { k8090->switchRelayOff(RelayID::Three); }, 1, true, 1},
+    {"toggleRelay", [](K8090* k8090) { k8090->toggleRelay(RelayID::Four); }, 1, true, 2},
+    {"setButtonMode", [](K8090* k8090) { k8090->setButtonMode(RelayID::One, RelayID::Two, RelayID::Three); }, 1,
+        true, 1},
+    {"startRelayTimer", [](K8090* k8090) { k8090->startRelayTimer(RelayID::Five, 1); }, 1, true, 1},
+    {"setRelayTimerDelay", [](K8090* k8090) { k8090->setRelayTimerDelay(RelayID::Six, 2); }, 1, true, 1},
+    {"queryRelayStatus", [](K8090* k8090) { k8090->queryRelayStatus(); }, 1, true, 2},
+    {"queryTotalTimerDelay", [](K8090* k8090) { k8090->queryTotalTimerDelay(RelayID::All); }, 1, true, 1},
+    {"queryRemainingTimerDelay", [](K8090* k8090) { k8090->queryRemainingTimerDelay(RelayID::All); }, 1, true, 1},
+    {"queryButtonModes", [](K8090* k8090) { k8090->queryButtonModes(); }, 1, true, 1},
+    {"queryJumperStatus", [](K8090* k8090) { k8090->queryJumperStatus(); }, 1, true, 1},
+    {"queryFirmwareVersion", [](K8090* k8090) { k8090->queryFirmwareVersion(); }, 1, true, 1},
+    {"refreshRelaysInfo", [](K8090* k8090) { k8090->refreshRelaysInfo(); }, 6, false, 0},
+}};
+
+void add_operations(bool connection_checking_only, bool single_command_only = false)
+{
+    QTest::addColumn<int>("operation");
+    for (std::size_t i = 0; i < kOperations.size(); ++i) {
+        if ((!connection_checking_only || kOperations[i].checks_connection)
+            && (!single_command_only || kOperations[i].commands == 1)) {
+            QTest::newRow(kOperations[i].name) << static_cast<int>(i);
+        }
+    }
+}
+
+
+impl_::CardMessage make_response(ResponseID response, unsigned char mask, unsigned char param1, unsigned char param2)
+{
+    impl_::CardMessage message{
+        impl_::kStxByte, impl_::kResponses[as_number(response)], mask, param1, param2, 0, impl_::kEtxByte};
+    message.checksumMessage();
+    return message;
+}
+
+}  // namespace
+
+
+void K8090AllocationTest::init()
+{
+    k8090_.reset(new K8090);
+    k8090_->setComPortName(impl_::kMockPortName);
+    QSignalSpy spy(k8090_.get(), SIGNAL(connected()));
+    k8090_->connectK8090();
+    if (spy.count() < 1) {
+        QVERIFY2(spy.wait(), "Card was not connected!");
+    }
+}
+
+
+void K8090AllocationTest::cleanup()
+{
+    k8090_.reset();
+}
+
+
+void K8090AllocationTest::enqueueAllocations_data()
+{
+    add_operations(false);
+}
+
+
+void K8090AllocationTest::enqueueAllocations()
+{
+    QFETCH(int, operation);
+    const Operation& tested = kOperations[static_cast<std::size_t>(operation)];
+
+    // the card is busy now, so the tested commands are only enqueued, the event loop doesn't run during the test, so
+    // they stay in the queue
+    k8090_->queryRelayStatus();
+
+    AllocationCounter counter;
+    tested.call(k8090_.get());
+    std::size_t count = counter.count();
+    std::size_t budget = tested.commands * kEnqueueBudget;
+    QVERIFY2(count <= budget, qPrintable(allocation_budget_message(tested.name, count, budget)));
+
+    // the same commands are merged into the pending ones
+    counter.reset();
+    tested.call(k8090_.get());
+    count = counter.count();
+    QVERIFY2(count == 0, qPrintable(allocation_budget_message(tested.name, count, 0)));
+}
+
+
+void K8090AllocationTest::sendAllocations_data()
+{
+    add_operations(true, true);
+}
+
+
+void K8090AllocationTest::sendAllocations()
+{
+    QFETCH(int, operation);
+    const Operation& tested = kOperations[static_cast<std::size_t>(operation)];
+
+    // the threaded mock card receives the frames through the lock-free channel, so only K8090 and the event dispatcher
+    // allocate in this thread
+    k8090_.reset(new K8090);
+    k8090_->setComPortName(impl_::kThreadedMockPortName);
+    QSignalSpy spy(k8090_.get(), SIGNAL(connected()));
+    k8090_->connectK8090();
+    if (spy.count() < 1) {
+        QVERIFY2(spy.wait(), "Card was not connected!");
+    }
+    // the command is written directly by writeCommand() when the line is free
+    QTRY_VERIFY(k8090_->isLineFree() && k8090_->linkStatistics().queue_depth == 0);
+
+    AllocationCounter counter;
+    tested.call(k8090_.get());
+    std::size_t count = counter.count();
+    std::size_t budget = tested.timers * kTimerBudget + kTransferBudget;
+    QVERIFY2(count <= budget, qPrintable(allocation_budget_message(tested.name, count, budget)));
+    QCOMPARE(k8090_->linkStatistics().queue_depth, 0);
+}
+
+
+void K8090AllocationTest::responseAllocations()
+{
+    QTRY_VERIFY(k8090_->isLineFree() && k8090_->linkStatistics().queue_depth == 0);
+    // the relay status repeats the known state and the button status is not awaited, so they are decoded and
+    // delivered without changing the card state
+    const std::array<std::pair<const char*, impl_::CardMessage>, 2> frames{{
+        {"relay status", make_response(ResponseID::RelayStatus, 0, 0, 0)},
+        {"button status", make_response(ResponseID::ButtonStatus, 0, 0, 0)},
+    }};
+    for (const auto& frame : frames) {
+        AllocationCounter counter;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        k8090_->processResponses(reinterpret_cast<const char*>(frame.second.data.data()),
+            static_cast<int>(frame.second.data.size()));
+        std::size_t count = counter.count();
+        QVERIFY2(count == 0, qPrintable(allocation_budget_message(frame.first, count, 0)));
+    }
+    QVERIFY(k8090_->isConnected());
+}
+
+
+void K8090AllocationTest::notConnectedAllocations_data()
+{
+    add_operations(true);
+}
+
+
+void K8090AllocationTest::notConnectedAllocations()
+{
+    QFETCH(int, operation);
+    const Operation& tested = kOperations[static_cast<std::size_t>(operation)];
+    QSignalSpy spy_disconnected(k8090_.get(), SIGNAL(disconnected()));
+    k8090_->disconnect();
+    if (spy_disconnected.count() < 1) {
+        QVERIFY2(spy_disconnected.wait(), "Card was not disconnected!");
+    }
+
+    AllocationCounter counter;
+    tested.call(k8090_.get());
+    std::size_t count = counter.count();
+    QVERIFY2(count == 0, qPrintable(allocation_budget_message(tested.name, count, 0)));
+}
+
+
+void K8090AllocationTest::stateAllocations()
+{
+    AllocationCounter counter;
+    bool connected = k8090_->isConnected();
+    int pending = k8090_->pendingCommandCount(CommandID::RelayOn);
+    std::size_t count = counter.count();
+    QVERIFY(connected);
+    QCOMPARE(pending, 0);
+    QVERIFY2(count == 0, qPrintable(allocation_budget_message("state queries", count, 0)));
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,158 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      k8090_coroutines_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::K8090CoroutinesTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::AsyncK8090.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "k8090_coroutines_test.h"
+
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/k8090_coroutines.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+const int kCoroutineTimeout = 5000;
+
+struct CommandsState
+{
+    bool done{false};
+    RelayStatusResult on{};
+    RelayStatusResult off{};
+    TimerDelaysResult delays{};
+};
+
+CardTask run_commands(AsyncK8090 card, CommandsState* state)
+{
+    state->on = co_await card.switchOn(RelayID::Six | RelayID::Seven);
+    state->off = co_await card.switchOff(RelayID::Six);
+    state->delays = co_await card.setTimerDelay(RelayID::Eight, 7);
+    state->done = true;
+}
+
+struct QueriesState
+{
+    bool done{false};
+    RelayStatusResult status{};
+    ButtonModesResult modes{};
+    TimerDelaysResult delays{};
+    FirmwareVersionResult firmware{};
+};
+
+CardTask run_queries(AsyncK8090 card, QueriesState* state)
+{
+    state->status = co_await card.queryRelayStatus();
+    state->modes = co_await card.queryButtonModes();
+    state->delays = co_await card.queryTotalTimerDelay(RelayID::One | RelayID::Two);
+    state->firmware = co_await card.queryFirmwareVersion();
+    state->done = true;
+}
+
+}  // namespace
+
+
+void K8090CoroutinesTest::init()
+{
+    k8090_.reset(new K8090);
+    k8090_->setComPortName(impl_::kMockPortName);
+    QSignalSpy spy(k8090_.get(), SIGNAL(connected()));
+    k8090_->connectK8090();
+    if (spy.count() < 1) {
+        QVERIFY2(spy.wait(), "Card was not connected!");
+    }
+}
+
+
+void K8090CoroutinesTest::cleanup()
+{
+    k8090_.reset();
+}
+
+
+void K8090CoroutinesTest::commands()
+{
+    CommandsState state;
+    run_commands(AsyncK8090{k8090_.get()}, &state);
+    QTRY_VERIFY_WITH_TIMEOUT(state.done, kCoroutineTimeout);
+
+    QVERIFY(state.on.ok);
+    QCOMPARE(state.on.current & (RelayID::Six | RelayID::Seven), RelayID::Six | RelayID::Seven);
+    QVERIFY(state.off.ok);
+    QCOMPARE(state.off.current & RelayID::Six, RelayID::None);
+    QVERIFY(state.delays.ok);
+    QCOMPARE(state.delays.relays & RelayID::Eight, RelayID::Eight);
+    QCOMPARE(state.delays.delays[7], quint16{7});
+}
+
+
+void K8090CoroutinesTest::queries()
+{
+    QueriesState state;
+    run_queries(AsyncK8090{k8090_.get()}, &state);
+    QTRY_VERIFY_WITH_TIMEOUT(state.done, kCoroutineTimeout);
+
+    QVERIFY(state.status.ok);
+    QVERIFY(state.modes.ok);
+    QVERIFY(state.delays.ok);
+    QCOMPARE(state.delays.relays & (RelayID::One | RelayID::Two), RelayID::One | RelayID::Two);
+    QVERIFY(state.firmware.ok);
+    QVERIFY(state.firmware.year >= 2000);
+}
+
+
+void K8090CoroutinesTest::notConnected()
+{
+    k8090_->disconnect();
+    QTRY_VERIFY_WITH_TIMEOUT(!k8090_->isConnected(), kCoroutineTimeout);
+
+    // the coroutine is not suspended when the card is not connected
+    QueriesState state;
+    run_queries(AsyncK8090{k8090_.get()}, &state);
+    QVERIFY(state.done);
+    QVERIFY(!state.status.ok);
+    QVERIFY(!state.firmware.ok);
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -38,8 +38,13 @@
 
 #include "k8090_test.h"
 
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QList>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QVariant>
 #include <QtTest>
 
@@ -62,7 +67,8 @@ void K8090Test::initTestCase()
     real_card_present_ = false;
     for (const serial_utils::ComPortParams& params : K8090::availablePorts()) {
         if (params.product_identifier == K8090::kProductID && params.vendor_identifier == K8090::kVendorID) {
-            if (params.port_name != k8090::impl_::kMockPortName) {
+            if (params.port_name != k8090::impl_::kMockPortName
+                && params.port_name != k8090::impl_::kThreadedMockPortName) {
                 real_card_port_name_ = params.port_name;
                 real_card_present_ = true;
                 break;
@@ -78,6 +84,8 @@ void K8090Test::initTestCase()
     }
     port_names << k8090::impl_::kMockPortName;
     qDebug() << "Virtual card port name:" << port_names.last();
+    port_names << k8090::impl_::kThreadedMockPortName;
+    qDebug() << "Threaded virtual card port name:" << port_names.last();
 
     for (const auto& port_name : port_names) {
         k8090_.reset(new K8090);
@@ -1520,6 +1528,620 @@ void K8090Test::priorities()
 }
 
 
+void K8090Test::subscribe_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::subscribe()
+{
+    const int kCommandDelay = 100;  // max delay between command and response
+
+    EventSubscription* subscription = k8090_->subscribe(EventType::RelayStatus, RelayID::Three);
+    QSignalSpy spy_relay_status(subscription,
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QSignalSpy spy_timer_delay(
+        subscription, SIGNAL(totalTimerDelay(biomolecules::sprelay::core::k8090::RelayID, quint16)));
+
+    // the last known relay status obtained during connection is replayed without querying the card
+    if (spy_relay_status.count() < 1) {
+        QVERIFY2(spy_relay_status.wait(), "Relay status was not replayed!");
+    }
+    QCOMPARE(spy_relay_status.count(), 1);
+    QList<QVariant> relay_status_arguments = spy_relay_status.takeFirst();
+    auto previous = qvariant_cast<biomolecules::sprelay::core::k8090::RelayID>(relay_status_arguments.at(0));
+    auto current = qvariant_cast<biomolecules::sprelay::core::k8090::RelayID>(relay_status_arguments.at(1));
+    QVERIFY2(previous == current, "The replayed relay status should not contain any transition.");
+    // timer delays were not subscribed
+    QCOMPARE(spy_timer_delay.count(), 0);
+
+    // changes of other relays are not delivered
+    QSignalSpy spy_k8090_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090_->toggleRelay(RelayID::Four);
+    if (spy_k8090_relay_status.count() < 1) {
+        QVERIFY2(spy_k8090_relay_status.wait(), "Relay status signal not received!");
+    }
+    spy_relay_status.wait(kCommandDelay);
+    QCOMPARE(spy_relay_status.count(), 0);
+    k8090_->toggleRelay(RelayID::Four);
+
+    // changes of the subscribed relay are delivered
+    k8090_->toggleRelay(RelayID::Three);
+    if (spy_relay_status.count() < 1) {
+        QVERIFY2(spy_relay_status.wait(), "Relay status signal not received!");
+    }
+    QCOMPARE(spy_relay_status.count(), 1);
+    relay_status_arguments = spy_relay_status.takeFirst();
+    previous = qvariant_cast<biomolecules::sprelay::core::k8090::RelayID>(relay_status_arguments.at(0));
+    current = qvariant_cast<biomolecules::sprelay::core::k8090::RelayID>(relay_status_arguments.at(1));
+    QVERIFY2(static_cast<bool>((current ^ previous) & RelayID::Three), "The status of relay 3 should change.");
+
+    // nothing is delivered after unsubscription
+    k8090_->unsubscribe(subscription);
+    spy_k8090_relay_status.clear();
+    k8090_->toggleRelay(RelayID::Three);
+    if (spy_k8090_relay_status.count() < 1) {
+        QVERIFY2(spy_k8090_relay_status.wait(), "Relay status signal not received!");
+    }
+    QCOMPARE(spy_relay_status.count(), 0);
+}
+
+
+void K8090Test::runProgram_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::runProgram()
+{
+    const int kProgramTimeout = 5000;
+
+    // invalid programs are refused
+    RelayProgram unbalanced;
+    unbalanced.beginLoop(2).toggleRelay(RelayID::One);
+    QVERIFY(!k8090_->runProgram(unbalanced));
+    RelayProgram blocking;
+    blocking.beginLoop().toggleRelay(RelayID::One).endLoop();
+    QVERIFY(!k8090_->runProgram(blocking));
+
+    // each step waits for the relay status of the previous one
+    QSignalSpy spy_program_finished(k8090_.get(), SIGNAL(programFinished(bool)));
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    RelayProgram program;
+    program.beginLoop(2)
+        .switchRelayOn(RelayID::Five)
+        .waitForRelays(RelayID::Five, RelayID::Five)
+        .switchRelayOff(RelayID::Five)
+        .waitForRelays(RelayID::Five, RelayID::None)
+        .endLoop();
+    QVERIFY(k8090_->runProgram(program));
+    if (spy_program_finished.count() < 1) {
+        QVERIFY2(spy_program_finished.wait(kProgramTimeout), "Program was not finished!");
+    }
+    QCOMPARE(spy_program_finished.count(), 1);
+    QCOMPARE(spy_program_finished.takeFirst().at(0).toBool(), true);
+    // each switching is confirmed by at least one relay status
+    QVERIFY(spy_relay_status.count() >= 4);
+    auto current = qvariant_cast<biomolecules::sprelay::core::k8090::RelayID>(spy_relay_status.last().at(1));
+    QVERIFY2((current & RelayID::Five) == RelayID::None, "Relay 5 should be switched off.");
+
+    // infinite program is stopped
+    RelayProgram infinite;
+    infinite.beginLoop().command(CardCommand{CommandID::QueryRelay, RelayID::None, 0, 0}).delay(50).endLoop();
+    QVERIFY(k8090_->runProgram(infinite));
+    k8090_->stopProgram();
+    if (spy_program_finished.count() < 1) {
+        QVERIFY2(spy_program_finished.wait(kProgramTimeout), "Program was not stopped!");
+    }
+    QCOMPARE(spy_program_finished.count(), 1);
+    QCOMPARE(spy_program_finished.takeFirst().at(0).toBool(), false);
+}
+
+
+void K8090Test::waitForResponse_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::waitForResponse()
+{
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+
+    // the handler is called once with the matching response
+    int handled = 0;
+    CardEvent handled_event{ResponseID::None, 0, 0, 0, false};
+    k8090_->waitForResponse(
+        [](const CardEvent& event) {
+            return event.response == ResponseID::RelayStatus
+                && (static_cast<RelayID>(event.param1) & RelayID::Six) == RelayID::Six;
+        },
+        [&handled, &handled_event](const CardEvent& event) {
+            ++handled;
+            handled_event = event;
+        });
+    k8090_->switchRelayOn(RelayID::Six);
+    while (handled == 0 && spy_relay_status.wait()) {
+    }
+    QCOMPARE(handled, 1);
+    QCOMPARE(handled_event.response, ResponseID::RelayStatus);
+    k8090_->switchRelayOff(RelayID::Six);
+    spy_relay_status.clear();
+    if (spy_relay_status.count() < 1) {
+        QVERIFY2(spy_relay_status.wait(), "Relay status signal not received!");
+    }
+    QCOMPARE(handled, 1);
+
+    // pending waiters are completed by disconnection
+    bool disconnected = false;
+    k8090_->waitForResponse([](const CardEvent&) { return false; },
+        [&disconnected](const CardEvent& event) { disconnected = event.response == ResponseID::None; });
+    k8090_->disconnect();
+    QVERIFY(disconnected);
+}
+
+
+void K8090Test::eventListener_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::eventListener()
+{
+    const int kListenerTimeout = 5000;
+
+    // the listener is called with each response directly from the decoding
+    std::atomic<int> relay_events{0};
+    std::atomic<bool> switched_on{false};
+    int id = k8090_->addEventListener([&relay_events, &switched_on](const CardEvent& event) {
+        if (event.response == ResponseID::RelayStatus) {
+            ++relay_events;
+            if ((static_cast<RelayID>(event.param1) & RelayID::Four) == RelayID::Four) {
+                switched_on = true;
+            }
+        }
+    });
+    k8090_->switchRelayOn(RelayID::Four);
+    QTRY_VERIFY_WITH_TIMEOUT(switched_on.load(), kListenerTimeout);
+
+    // removed listener is not called
+    k8090_->removeEventListener(id);
+    int events = relay_events.load();
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090_->switchRelayOff(RelayID::Four);
+    QVERIFY2(spy_relay_status.wait(kListenerTimeout), "Relay status signal not received!");
+    QCOMPARE(relay_events.load(), events);
+}
+
+
+void K8090Test::commandLog_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::commandLog()
+{
+    const int kLogTimeout = 5000;
+    const qint64 kRecordSize = 6;
+    const int kLongCommitDelay = 60000;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString file_name = dir.path() + "/commands.log";
+    QVERIFY(k8090_->setCommandLogFile(file_name));
+
+    // commands issued at once share one commit and they are acknowledged by a checkpoint
+    k8090_->switchRelayOn(RelayID::Eight);
+    k8090_->switchRelayOff(RelayID::Seven);
+    QTRY_COMPARE_WITH_TIMEOUT(k8090_->commandLogStatistics().commits, quint64{2}, kLogTimeout);
+    CommandLogStatistics statistics = k8090_->commandLogStatistics();
+    QCOMPARE(statistics.logged_commands, quint64{2});
+    QCOMPARE(statistics.failed_commits, quint64{0});
+    QCOMPARE(QFileInfo{file_name}.size(), kRecordSize);
+    qDebug() << "Command log commit time:" << statistics.commit_time / static_cast<qint64>(statistics.commits)
+             << "ns";
+
+    // commands are not sent before they are durable
+    QVERIFY(k8090_->setCommandLogFile(file_name, kLongCommitDelay));
+    k8090_->switchRelayOn(RelayID::Seven);
+    QTest::qWait(100);
+    QCOMPARE(k8090_->pendingCommandCount(CommandID::RelayOn), 1);
+
+    // the crash is simulated by destruction, the command was committed but not acknowledged
+    k8090_.reset();
+    QCOMPARE(QFileInfo{file_name}.size(), 2 * kRecordSize);
+
+    // the recovered command is replayed after the connection
+    QFETCH(QString, port_name);
+    k8090_.reset(new K8090);
+    k8090_->setComPortName(port_name);
+    QVERIFY(k8090_->setCommandLogFile(file_name));
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090_->connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(k8090_->commandLogStatistics().replayed_commands, quint64{1}, kLogTimeout);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven) == RelayID::Seven,
+        kLogTimeout);
+    k8090_->switchRelayOff(RelayID::Seven | RelayID::Eight);
+    QTRY_COMPARE_WITH_TIMEOUT(QFileInfo{file_name}.size(), kRecordSize, kLogTimeout);
+}
+
+
+void K8090Test::linkStatistics_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::linkStatistics()
+{
+    const int kStatisticsTimeout = 5000;
+
+    k8090_->resetLinkStatistics();
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090_->switchRelayOn(RelayID::Three);
+    k8090_->switchRelayOn(RelayID::Five);
+    k8090_->switchRelayOn(RelayID::Six);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Six) == RelayID::Six,
+        kStatisticsTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(k8090_->linkStatistics().queue_depth, 0, kStatisticsTimeout);
+
+    LinkStatistics statistics = k8090_->linkStatistics();
+    QCOMPARE(statistics.enqueued_commands, 3u);
+    QVERIFY(statistics.sent_commands >= 1u);
+    QVERIFY(statistics.sent_commands + statistics.merged_commands >= statistics.enqueued_commands);
+    QVERIFY(statistics.latency_samples >= 1u);
+    QVERIFY(statistics.latency_p50 <= statistics.latency_p99);
+    QVERIFY(statistics.latency_p99 <= statistics.latency_max);
+    QCOMPARE(statistics.failures, 0u);
+    qDebug() << "Link latency p50:" << statistics.latency_p50 << "ms, p99:" << statistics.latency_p99 << "ms";
+
+    k8090_->switchRelayOff(RelayID::Three | RelayID::Five | RelayID::Six);
+    QTRY_COMPARE_WITH_TIMEOUT(k8090_->linkStatistics().queue_depth, 0, kStatisticsTimeout);
+    k8090_->resetLinkStatistics();
+    statistics = k8090_->linkStatistics();
+    QCOMPARE(statistics.enqueued_commands, 0u);
+    QCOMPARE(statistics.latency_samples, 0u);
+}
+
+
+void K8090Test::singleFlightRefresh_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::singleFlightRefresh()
+{
+    const int kRefreshTimeout = 5000;
+    const int kLongFreshness = 60000;
+
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QSignalSpy spy_firmware_version(k8090_.get(), SIGNAL(firmwareVersion(int, int)));
+
+    // concurrent requests attach to the refresh in flight and complete from the same responses
+    std::atomic<int> first{-1};
+    std::atomic<int> second{-1};
+    k8090_->refreshRelaysInfo([&first](bool completed) { first = completed ? 1 : 0; });
+    k8090_->refreshRelaysInfo([&second](bool completed) { second = completed ? 1 : 0; });
+    QTRY_COMPARE_WITH_TIMEOUT(first.load(), 1, kRefreshTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(second.load(), 1, kRefreshTimeout);
+    QTest::qWait(100);
+    QCOMPARE(spy_relay_status.count(), 1);
+    QCOMPARE(spy_firmware_version.count(), 1);
+
+    // recent refresh satisfies new requests immediately
+    k8090_->setRefreshFreshness(kLongFreshness);
+    int fresh = -1;
+    k8090_->refreshRelaysInfo([&fresh](bool completed) { fresh = completed ? 1 : 0; });
+    QCOMPARE(fresh, 1);
+    QTest::qWait(100);
+    QCOMPARE(spy_firmware_version.count(), 1);
+    k8090_->setRefreshFreshness(0);
+
+    // the refresh of disconnected card fails immediately
+    QSignalSpy spy_disconnected(k8090_.get(), SIGNAL(disconnected()));
+    k8090_->disconnect();
+    QVERIFY2(spy_disconnected.count() > 0 || spy_disconnected.wait(kRefreshTimeout), "Card was not disconnected!");
+    int disconnected = -1;
+    k8090_->refreshRelaysInfo([&disconnected](bool completed) { disconnected = completed ? 1 : 0; });
+    QCOMPARE(disconnected, 0);
+}
+
+
+void K8090Test::coalescingWindow_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::coalescingWindow()
+{
+    const int kBatchTimeout = 5000;
+    const int kWindow = 50;
+    const int kLongWindow = 60000;
+
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+
+    // the burst is merged before the first command is sent
+    k8090_->setCoalescingWindow(kWindow);
+    QCOMPARE(k8090_->linkStatistics().coalescing_window, kWindow);
+    k8090_->resetLinkStatistics();
+    k8090_->switchRelayOn(RelayID::One);
+    k8090_->switchRelayOn(RelayID::Two);
+    k8090_->switchRelayOn(RelayID::Three);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & (RelayID::One | RelayID::Two | RelayID::Three))
+                == (RelayID::One | RelayID::Two | RelayID::Three),
+        kBatchTimeout);
+    LinkStatistics statistics = k8090_->linkStatistics();
+    QCOMPARE(statistics.coalesced_bursts, 1u);
+    QCOMPARE(statistics.merged_commands, 2u);
+
+    // the flush hint sends the burst without waiting for the window
+    k8090_->setCoalescingWindow(kLongWindow);
+    k8090_->switchRelayOff(RelayID::One | RelayID::Two | RelayID::Three);
+    k8090_->flushCommands();
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & (RelayID::One | RelayID::Two | RelayID::Three))
+            == RelayID::None,
+        kBatchTimeout);
+
+    k8090_->setCoalescingWindow(0);
+    QCOMPARE(k8090_->linkStatistics().coalescing_window, 0);
+}
+
+
+void K8090Test::relayDwell_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::relayDwell()
+{
+    const int kDwellTimeout = 5000;
+    const int kDwell = 300;
+
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    k8090_->setRelayDwell(kDwell);
+    k8090_->resetLinkStatistics();
+
+    // the flapping relay is switched only once
+    k8090_->switchRelayOn(RelayID::Seven);
+    k8090_->switchRelayOff(RelayID::Seven);
+    k8090_->switchRelayOn(RelayID::Seven);
+    QTRY_COMPARE_WITH_TIMEOUT(k8090_->linkStatistics().dwell_suppressed_transitions, 2u, kDwellTimeout);
+    QCOMPARE(k8090_->linkStatistics().dwell_saved_commands, 2u);
+    QVERIFY(spy_relay_status.count() > 0);
+    QCOMPARE(qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven, RelayID::Seven);
+
+    // the deferred transition, which changes the state, is sent after the dwell
+    QTest::qWait(kDwell);
+    k8090_->switchRelayOff(RelayID::Seven);
+    k8090_->switchRelayOn(RelayID::Seven);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven) == RelayID::None, kDwellTimeout);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven) == RelayID::Seven, kDwellTimeout);
+    QCOMPARE(k8090_->linkStatistics().dwell_suppressed_transitions, 2u);
+
+    k8090_->setRelayDwell(0);
+    k8090_->switchRelayOff(RelayID::Seven);
+}
+
+
+void K8090Test::mockScenario_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::mockScenario()
+{
+    const int kScenarioTimeout = 1000;
+
+    QFETCH(QString, port_name);
+    if (port_name == real_card_port_name_) {
+        QVERIFY(!k8090_->runMockScenario(MockScenario{}));
+        QSKIP("The scenario can be executed only by the virtual card.");
+    }
+    QVERIFY(!k8090_->runMockScenario(MockScenario{}.pressButtons(-1, RelayID::Eight)));
+
+    QSignalSpy spy_button_status(k8090_.get(),
+        SIGNAL(buttonStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+
+    // the toggle button switches the relay on and reports press and release
+    QVERIFY(k8090_->runMockScenario(MockScenario{}.pressButtons(0, RelayID::Eight, 20)));
+    QTRY_COMPARE_WITH_TIMEOUT(spy_button_status.count(), 2, kScenarioTimeout);
+    QCOMPARE(qvariant_cast<RelayID>(spy_button_status.at(0).at(1)), RelayID::Eight);
+    QCOMPARE(qvariant_cast<RelayID>(spy_button_status.at(1).at(2)), RelayID::Eight);
+    QVERIFY(spy_relay_status.count() > 0);
+    QCOMPARE(qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Eight, RelayID::Eight);
+
+    // the expired timer switches the relay off
+    k8090_->startRelayTimer(RelayID::Seven, 100);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven) == RelayID::Seven, kScenarioTimeout);
+    QVERIFY(k8090_->runMockScenario(MockScenario{}.expireTimers(0, RelayID::Seven)));
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Seven) == RelayID::None, kScenarioTimeout);
+
+    k8090_->switchRelayOff(RelayID::Eight);
+}
+
+
+void K8090Test::mockScenarioLoad_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::mockScenarioLoad()
+{
+    const int kRoundTrips = 20;
+    const int kRoundTripTimeout = 1000;
+
+    QFETCH(QString, port_name);
+    if (port_name == real_card_port_name_) {
+        QSKIP("The scenario can be executed only by the virtual card.");
+    }
+
+    QSignalSpy spy_button_status(k8090_.get(),
+        SIGNAL(buttonStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+
+    // somebody keeps pressing the buttons while the relay is switched by commands
+    QVERIFY(k8090_->runMockScenario(MockScenario{}
+                                        .pressButtons(0, RelayID::Seven | RelayID::Eight, 5)
+                                        .pressButtons(10, RelayID::Eight, 5)
+                                        .repeat(20)));
+    k8090_->resetLinkStatistics();
+    QElapsedTimer elapsed_timer;
+    elapsed_timer.start();
+    for (int i = 0; i < kRoundTrips; ++i) {
+        k8090_->switchRelayOn(RelayID::One);
+        QTRY_VERIFY_WITH_TIMEOUT(!spy_relay_status.isEmpty()
+                && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::One) == RelayID::One,
+            kRoundTripTimeout);
+        k8090_->switchRelayOff(RelayID::One);
+        QTRY_VERIFY_WITH_TIMEOUT(
+            (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::One) == RelayID::None, kRoundTripTimeout);
+    }
+    QTest::setBenchmarkResult(elapsed_timer.elapsed(), QTest::WalltimeMilliseconds);
+    QVERIFY(k8090_->runMockScenario(MockScenario{}));
+
+    LinkStatistics statistics = k8090_->linkStatistics();
+    QVERIFY(spy_button_status.count() > 0);
+    QCOMPARE(statistics.failures, 0u);
+    qDebug() << QString{"%1 round trips with %2 button events, latency p50 = %3 ms, p99 = %4 ms"}
+                    .arg(kRoundTrips)
+                    .arg(spy_button_status.count())
+                    .arg(statistics.latency_p50)
+                    .arg(statistics.latency_p99);
+}
+
+
+void K8090Test::pulseRelay_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::pulseRelay()
+{
+    const int kPulseTimeout = 2000;
+    const int kPulseWidth = 200;
+    // the error includes the timer resolution and the waiting for the line after the follow-up query
+    const int kMaxError = 60000;
+
+    QSignalSpy spy_pulse(k8090_.get(),
+        SIGNAL(pulseFinished(biomolecules::sprelay::core::k8090::RelayID, int, int)));
+    QVERIFY(!k8090_->pulseRelay(RelayID::None, kPulseWidth));
+    QVERIFY(!k8090_->pulseRelay(RelayID::Six, 0));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(k8090_->pulseRelay(RelayID::Six, kPulseWidth));
+    // only one pulse can run
+    QVERIFY(!k8090_->pulseRelay(RelayID::Five, kPulseWidth));
+    QTRY_COMPARE_WITH_TIMEOUT(spy_pulse.count(), 1, kPulseTimeout);
+    QVERIFY(timer.elapsed() >= kPulseWidth);
+    QCOMPARE(qvariant_cast<RelayID>(spy_pulse.at(0).at(0)), RelayID::Six);
+    int width = spy_pulse.at(0).at(1).toInt();
+    int error = spy_pulse.at(0).at(2).toInt();
+    QCOMPARE(width - error, kPulseWidth * 1000);
+    QVERIFY(qAbs(error) < kMaxError);
+
+    // the next pulse can be started after the previous one finished
+    QVERIFY(k8090_->pulseRelay(RelayID::Six, kPulseWidth));
+    QTRY_COMPARE_WITH_TIMEOUT(spy_pulse.count(), 2, kPulseTimeout);
+
+    k8090_->disconnect();
+    QTRY_VERIFY_WITH_TIMEOUT(!k8090_->isConnected(), kPulseTimeout);
+    QVERIFY(!k8090_->pulseRelay(RelayID::Six, kPulseWidth));
+}
+
+
+void K8090Test::idleMode_data()
+{
+    createTestData();
+}
+
+
+void K8090Test::idleMode()
+{
+    const int kIdleTimeout = 5000;
+    const int kIdleInterval = 300;
+
+    QSignalSpy spy_relay_status(k8090_.get(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QVERIFY(!k8090_->isIdleMode());
+    k8090_->setIdleMode(true);
+    QVERIFY(k8090_->isIdleMode());
+
+    // the queued commands are sent, even if the delay after the query is not timed
+    k8090_->switchRelayOn(RelayID::Three | RelayID::Four);
+    k8090_->switchRelayOff(RelayID::Four);
+    QTRY_VERIFY_WITH_TIMEOUT(spy_relay_status.count() > 0
+            && (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & (RelayID::Three | RelayID::Four))
+                == RelayID::Three,
+        kIdleTimeout);
+    // the command requested on the idle line is sent too
+    QTest::qWait(kIdleInterval);
+    k8090_->switchRelayOff(RelayID::Three);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (qvariant_cast<RelayID>(spy_relay_status.last().at(1)) & RelayID::Three) == RelayID::None, kIdleTimeout);
+
+    // the wakeups are counted only while the measurement is enabled
+    k8090_->resetLinkStatistics();
+    QVERIFY(!k8090_->isWakeupMeasurementEnabled());
+    k8090_->setWakeupMeasurement(true);
+    QVERIFY(k8090_->isWakeupMeasurementEnabled());
+    QTest::qWait(kIdleInterval);
+    QVERIFY(k8090_->linkStatistics().wakeups > 0u);
+    k8090_->setWakeupMeasurement(false);
+    QTest::qWait(kIdleInterval);
+    quint32 wakeups = k8090_->linkStatistics().wakeups;
+    QTest::qWait(kIdleInterval);
+    QCOMPARE(k8090_->linkStatistics().wakeups, wakeups);
+
+    k8090_->setIdleMode(false);
+}
+
+
 void K8090Test::createTestData()
 {
     QTest::addColumn<QString>("port_name");
@@ -1528,6 +2150,7 @@ void K8090Test::createTestData()
         QTest::newRow("real card") << real_card_port_name_;
     }
     QTest::newRow("virtual card") << k8090::impl_::kMockPortName;
+    QTest::newRow("threaded virtual card") << k8090::impl_::kThreadedMockPortName;
 }
 
 }  // namespace k8090
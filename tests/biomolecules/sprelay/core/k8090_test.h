@@ -92,6 +92,32 @@ private slots:
     void firmwareVersion();
     void priorities_data();
     void priorities();
+    void subscribe_data();
+    void subscribe();
+    void runProgram_data();
+    void runProgram();
+    void waitForResponse_data();
+    void waitForResponse();
+    void eventListener_data();
+    void eventListener();
+    void commandLog_data();
+    void commandLog();
+    void linkStatistics_data();
+    void linkStatistics();
+    void singleFlightRefresh_data();
+    void singleFlightRefresh();
+    void coalescingWindow_data();
+    void coalescingWindow();
+    void relayDwell_data();
+    void relayDwell();
+    void mockScenario_data();
+    void mockScenario();
+    void mockScenarioLoad_data();
+    void mockScenarioLoad();
+    void pulseRelay_data();
+    void pulseRelay();
+    void idleMode_data();
+    void idleMode();
 
 private:
     void createTestData();
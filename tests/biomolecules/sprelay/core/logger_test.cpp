@@ -0,0 +1,324 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      logger_test.cpp
+ * \brief     The biomolecules::sprelay::core::k8090::LoggerTest class which implements tests for
+ *            biomolecules::sprelay::core::k8090::Logger.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "logger_test.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/logger.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+const int kTimeout = 5000;
+const int kRoundTrips = 200;
+
+// collects the records passed to the sink by the writer thread
+class RecordCollector
+{
+public:
+    Logger::Sink sink()
+    {
+        return [this](const std::vector<LogRecord>& records) {
+            QMutexLocker locker{&mutex_};
+            records_.insert(records_.end(), records.begin(), records.end());
+        };
+    }
+
+    std::vector<LogRecord> records()
+    {
+        QMutexLocker locker{&mutex_};
+        return records_;
+    }
+
+    int count(LogEvent event)
+    {
+        QMutexLocker locker{&mutex_};
+        int n = 0;
+        for (const LogRecord& record : records_) {
+            if (record.event == event) {
+                ++n;
+            }
+        }
+        return n;
+    }
+
+private:
+    QMutex mutex_;
+    std::vector<LogRecord> records_;
+};
+
+}  // namespace
+
+
+void LoggerTest::levels()
+{
+    QVERIFY(Logger::isCompiledIn(LogLevel::Error));
+    RecordCollector collector;
+    Logger logger{collector.sink(), LogLevel::Warning};
+    QCOMPARE(logger.level(), LogLevel::Warning);
+    QVERIFY(logger.isEnabled(LogLevel::Error));
+    QVERIFY(!logger.isEnabled(LogLevel::Info));
+
+    logger.log(LogLevel::Info, LogEvent::Connected);
+    logger.log(LogLevel::Error, LogEvent::ConnectionFailed);
+    logger.setLevel(LogLevel::Info);
+    logger.log(LogLevel::Info, LogEvent::Disconnected);
+    logger.flush();
+
+    std::vector<LogRecord> records = collector.records();
+    QCOMPARE(records.size(), std::size_t{2});
+    QCOMPARE(records[0].event, LogEvent::ConnectionFailed);
+    QCOMPARE(records[1].event, LogEvent::Disconnected);
+}
+
+
+void LoggerTest::sink()
+{
+    RecordCollector collector;
+    {
+        Logger logger{collector.sink(), LogLevel::Debug};
+        logger.log(LogLevel::Warning, LogEvent::CommandFailed, CommandID::RelayOn, RelayID::Two, 3);
+        logger.flush();
+        std::vector<LogRecord> records = collector.records();
+        QCOMPARE(records.size(), std::size_t{1});
+        QCOMPARE(records[0].level, LogLevel::Warning);
+        QCOMPARE(records[0].command, CommandID::RelayOn);
+        QCOMPARE(records[0].relays, RelayID::Two);
+        QCOMPARE(records[0].value, 3);
+        QVERIFY(records[0].time > 0);
+
+        // the records not flushed explicitly are written by the destructor at the latest
+        logger.log(LogLevel::Info, LogEvent::Resync);
+    }
+    QCOMPARE(collector.count(LogEvent::Resync), 1);
+}
+
+
+void LoggerTest::threads()
+{
+    const int kThreads = 4;
+    const int kRecords = 200;
+    RecordCollector collector;
+    Logger logger{collector.sink(), LogLevel::Debug, 1, 4096};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&logger, i, kRecords]() {
+            for (int j = 0; j < kRecords; ++j) {
+                logger.log(LogLevel::Debug, LogEvent::CommandMerged, CommandID::None, from_number(i), j);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    // no record is lost and the records of every thread keep their order
+    std::vector<LogRecord> records = collector.records();
+    QCOMPARE(records.size(), static_cast<std::size_t>(kThreads * kRecords));
+    std::vector<int> next(kThreads, 0);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        int thread = 0;
+        while (from_number(static_cast<unsigned int>(thread)) != records[i].relays) {
+            ++thread;
+        }
+        QCOMPARE(records[i].value, next[static_cast<std::size_t>(thread)]++);
+    }
+    QCOMPARE(logger.droppedRecords(), quint64{0});
+}
+
+
+void LoggerTest::droppedRecords()
+{
+    RecordCollector collector;
+    // the long flush interval keeps the records in the buffer until the flush
+    Logger logger{collector.sink(), LogLevel::Info, 60000, 2};
+    for (int i = 0; i < 5; ++i) {
+        logger.log(LogLevel::Info, LogEvent::CommandFailed, CommandID::None, RelayID::None, i);
+    }
+    logger.flush();
+
+    QCOMPARE(logger.droppedRecords(), quint64{3});
+    QCOMPARE(collector.count(LogEvent::CommandFailed), 2);
+    std::vector<LogRecord> records = collector.records();
+    QCOMPARE(records.back().event, LogEvent::RecordsDropped);
+    QCOMPARE(records.back().value, 3);
+}
+
+
+void LoggerTest::format()
+{
+    LogRecord record{QDateTime::currentMSecsSinceEpoch(), LogLevel::Warning, LogEvent::CommandFailed,
+        CommandID::RelayOn, RelayID::One | RelayID::Two, 2};
+    QString line = Logger::format(record);
+    QVERIFY2(line.endsWith(" WARNING CommandFailed command=RelayOn relays=0x03 value=2"), qPrintable(line));
+
+    // the missing command and relays are omitted
+    record.command = CommandID::None;
+    record.relays = RelayID::None;
+    line = Logger::format(record);
+    QVERIFY2(line.endsWith(" WARNING CommandFailed value=2"), qPrintable(line));
+}
+
+
+void LoggerTest::fileLogger()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString file_name = dir.path() + "/sprelay.log";
+    QVERIFY(!Logger::createFileLogger(dir.path() + "/missing/sprelay.log"));
+
+    std::shared_ptr<Logger> logger = Logger::createFileLogger(file_name);
+    QVERIFY(logger);
+    logger->log(LogLevel::Info, LogEvent::Connected);
+    logger->log(LogLevel::Error, LogEvent::ProtocolError, CommandID::Timer);
+    logger.reset();
+
+    QFile file{file_name};
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QList<QByteArray> lines = file.readAll().trimmed().split('\n');
+    QCOMPARE(lines.size(), 2);
+    QVERIFY(lines[0].contains(" INFO Connected "));
+    QVERIFY(lines[1].contains(" ERROR ProtocolError command=Timer "));
+}
+
+
+void LoggerTest::cardEvents()
+{
+    RecordCollector collector;
+    auto logger = std::make_shared<Logger>(collector.sink(), LogLevel::Debug);
+    K8090 k8090;
+    k8090.setLogger(logger);
+    QCOMPARE(k8090.logger(), logger);
+
+    // unknown port
+    QSignalSpy spy_connection_failed(&k8090, SIGNAL(connectionFailed()));
+    k8090.setComPortName("SPRELAY_NO_SUCH_PORT");
+    k8090.connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_connection_failed.count(), 1, kTimeout);
+
+    QSignalSpy spy_connected(&k8090, SIGNAL(connected()));
+    k8090.setComPortName(impl_::kMockPortName);
+    k8090.connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_connected.count(), 1, kTimeout);
+    QSignalSpy spy_disconnected(&k8090, SIGNAL(disconnected()));
+    k8090.disconnect();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_disconnected.count(), 1, kTimeout);
+    logger->flush();
+
+    QCOMPARE(collector.count(LogEvent::ConnectionFailed), 1);
+    QCOMPARE(collector.count(LogEvent::Connected), 1);
+    QCOMPARE(collector.count(LogEvent::Disconnected), 1);
+
+    // no more records after the logger is removed
+    k8090.setLogger(nullptr);
+    k8090.connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_connected.count(), 2, kTimeout);
+    logger->flush();
+    QCOMPARE(collector.count(LogEvent::Connected), 1);
+}
+
+
+void LoggerTest::cardThroughput_data()
+{
+    QTest::addColumn<bool>("attached");
+
+    QTest::newRow("logger attached") << true;
+    QTest::newRow("logger detached") << false;
+}
+
+
+void LoggerTest::cardThroughput()
+{
+    QFETCH(bool, attached);
+    RecordCollector collector;
+    K8090 k8090;
+    if (attached) {
+        k8090.setLogger(std::make_shared<Logger>(collector.sink(), LogLevel::Debug));
+    }
+    QSignalSpy spy_connected(&k8090, SIGNAL(connected()));
+    k8090.setComPortName(impl_::kMockPortName);
+    k8090.connectK8090();
+    QTRY_COMPARE_WITH_TIMEOUT(spy_connected.count(), 1, kTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(k8090.linkStatistics().queue_depth, 0, kTimeout);
+
+    // each toggle is confirmed by the relay status, the decoding of which checks the logger
+    QSignalSpy spy_relay_status(&k8090,
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kRoundTrips; ++i) {
+        k8090.toggleRelay(RelayID::One);
+        if (spy_relay_status.count() <= i) {
+            QVERIFY2(spy_relay_status.wait(kTimeout), "The toggle was not confirmed!");
+        }
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    k8090.disconnect();
+    if (attached) {
+        k8090.logger()->flush();
+    }
+
+    qDebug() << (attached ? "Logger attached:" : "Logger detached:") << elapsed / kRoundTrips / 1000
+             << "us per round trip," << static_cast<int>(collector.records().size()) << "records";
+    QTest::setBenchmarkResult(elapsed / 1000000, QTest::WalltimeMilliseconds);
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
@@ -0,0 +1,161 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      redundant_k8090_test.cpp
+ * \brief     Tests of biomolecules::sprelay::core::k8090::RedundantK8090 failover.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "redundant_k8090_test.h"
+
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090.h"
+#include "biomolecules/sprelay/core/k8090_commands.h"
+#include "biomolecules/sprelay/core/redundant_k8090.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace core {
+namespace k8090 {
+
+namespace {
+
+const int kReconciliationInterval = 20;
+const int kTimeout = 5000;
+
+}  // namespace
+
+
+void RedundantK8090Test::init()
+{
+    redundant_k8090_.reset(new RedundantK8090);
+    redundant_k8090_->setComPortNames(impl_::kMockPortName, impl_::kMockPortName);
+    redundant_k8090_->setReconciliationInterval(kReconciliationInterval);
+}
+
+
+void RedundantK8090Test::cleanup()
+{
+    redundant_k8090_.reset();
+}
+
+
+void RedundantK8090Test::reconciliation()
+{
+    QSignalSpy spy_connected(redundant_k8090_.get(), SIGNAL(connected()));
+    redundant_k8090_->connectK8090();
+    if (spy_connected.count() < 1) {
+        QVERIFY2(spy_connected.wait(), "Primary card was not connected!");
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(redundant_k8090_->standbyCard()->isConnected(), kTimeout);
+
+    // the standby card follows the primary card
+    RelayID standby_relays = RelayID::None;
+    connect(redundant_k8090_->standbyCard(), &K8090::relayStatus, this,
+        [&standby_relays](RelayID, RelayID current, RelayID) { standby_relays = current; });
+    redundant_k8090_->switchRelayOff(RelayID::All);
+    redundant_k8090_->switchRelayOn(RelayID::Two | RelayID::Five);
+    QTRY_COMPARE_WITH_TIMEOUT(redundant_k8090_->desiredRelays(), RelayID::Two | RelayID::Five, kTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(standby_relays, RelayID::Two | RelayID::Five, kTimeout);
+
+    // relays switched on and off are reconciled in consecutive reconciliations
+    redundant_k8090_->switchRelayOff(RelayID::Two);
+    redundant_k8090_->switchRelayOn(RelayID::Seven);
+    QTRY_COMPARE_WITH_TIMEOUT(redundant_k8090_->desiredRelays(), RelayID::Five | RelayID::Seven, kTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(standby_relays, RelayID::Five | RelayID::Seven, kTimeout);
+    QVERIFY(!redundant_k8090_->isFailedOver());
+}
+
+
+void RedundantK8090Test::failover()
+{
+    QSignalSpy spy_connected(redundant_k8090_.get(), SIGNAL(connected()));
+    redundant_k8090_->connectK8090();
+    if (spy_connected.count() < 1) {
+        QVERIFY2(spy_connected.wait(), "Primary card was not connected!");
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(redundant_k8090_->standbyCard()->isConnected(), kTimeout);
+    redundant_k8090_->switchRelayOff(RelayID::All);
+    redundant_k8090_->switchRelayOn(RelayID::One | RelayID::Eight);
+    QTRY_COMPARE_WITH_TIMEOUT(redundant_k8090_->desiredRelays(), RelayID::One | RelayID::Eight, kTimeout);
+
+    // simulate the primary card failure
+    QSignalSpy spy_failed_over(redundant_k8090_.get(), SIGNAL(failedOver(qint64)));
+    QSignalSpy spy_connection_failed(redundant_k8090_.get(), SIGNAL(connectionFailed()));
+    emit redundant_k8090_->primaryCard()->connectionFailed();
+    QVERIFY(redundant_k8090_->isFailedOver());
+    QCOMPARE(redundant_k8090_->activeCard(), redundant_k8090_->standbyCard());
+    if (spy_failed_over.count() < 1) {
+        QVERIFY2(spy_failed_over.wait(kTimeout), "Failover was not confirmed!");
+    }
+    QCOMPARE(spy_failed_over.count(), 1);
+    QVERIFY(spy_failed_over.takeFirst().at(0).toLongLong() >= 0);
+    QCOMPARE(spy_connection_failed.count(), 0);
+    QCOMPARE(redundant_k8090_->desiredRelays(), RelayID::One | RelayID::Eight);
+
+    // the commands go to the standby card now
+    QSignalSpy spy_standby_status(redundant_k8090_->standbyCard(),
+        SIGNAL(relayStatus(biomolecules::sprelay::core::k8090::RelayID, biomolecules::sprelay::core::k8090::RelayID,
+            biomolecules::sprelay::core::k8090::RelayID)));
+    redundant_k8090_->switchRelayOn(RelayID::Three);
+    if (spy_standby_status.count() < 1) {
+        QVERIFY2(spy_standby_status.wait(kTimeout), "Standby card did not respond!");
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(
+        redundant_k8090_->desiredRelays(), RelayID::One | RelayID::Three | RelayID::Eight, kTimeout);
+}
+
+
+void RedundantK8090Test::failoverWithoutStandby()
+{
+    redundant_k8090_->setComPortNames(impl_::kMockPortName, "nonexistent port");
+    QSignalSpy spy_standby_failed(redundant_k8090_.get(), SIGNAL(standbyFailed()));
+    QSignalSpy spy_connected(redundant_k8090_.get(), SIGNAL(connected()));
+    redundant_k8090_->connectK8090();
+    if (spy_connected.count() < 1) {
+        QVERIFY2(spy_connected.wait(), "Primary card was not connected!");
+    }
+    QCOMPARE(spy_standby_failed.count(), 1);
+
+    QSignalSpy spy_connection_failed(redundant_k8090_.get(), SIGNAL(connectionFailed()));
+    emit redundant_k8090_->primaryCard()->connectionFailed();
+    QCOMPARE(spy_connection_failed.count(), 1);
+    QVERIFY(!redundant_k8090_->isFailedOver());
+    QCOMPARE(redundant_k8090_->activeCard(), redundant_k8090_->primaryCard());
+}
+
+}  // namespace k8090
+}  // namespace core
+}  // namespace sprelay
+}  // namespace biomolecules
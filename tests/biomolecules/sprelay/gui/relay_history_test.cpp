@@ -0,0 +1,192 @@
+// -*-c++-*-
+
+/***************************************************************************
+**                                                                        **
+**  Controlling interface for K8090 8-Channel Relay Card from Velleman    **
+**  through usb using virtual serial port in Qt.                          **
+**  Copyright (C) 2018 Jakub Klener                                       **
+**                                                                        **
+**  This file is part of SpRelay application.                             **
+**                                                                        **
+**  You can redistribute it and/or modify it under the terms of the       **
+**  3-Clause BSD License as published by the Open Source Initiative.      **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          **
+**  3-Clause BSD License for more details.                                **
+**                                                                        **
+**  You should have received a copy of the 3-Clause BSD License along     **
+**  with this program.                                                    **
+**  If not, see https://opensource.org/licenses/                          **
+**                                                                        **
+****************************************************************************/
+
+/*!
+ * \file      relay_history_test.cpp
+ * \brief     The biomolecules::sprelay::gui::RelayHistoryTest class which implements tests for
+ *            biomolecules::sprelay::gui::RelayHistory.
+ *
+ * \author    Jakub Klener <lumiksro@centrum.cz>
+ * \date      2026-10-18
+ * \copyright Copyright (C) 2018 Jakub Klener. All rights reserved.
+ *
+ * \copyright This project is released under the 3-Clause BSD License. You should have received a copy of the 3-Clause
+ *            BSD License along with this program. If not, see https://opensource.org/licenses/.
+ */
+
+
+#include "relay_history_test.h"
+
+#include <cstddef>
+
+#include <QtTest>
+
+#include "biomolecules/sprelay/core/k8090_defines.h"
+#include "biomolecules/sprelay/gui/relay_history.h"
+
+namespace biomolecules {
+namespace sprelay {
+namespace gui {
+
+namespace {
+
+using core::k8090::RelayID;
+
+const unsigned char kBoth = RelayHistory::kOn | RelayHistory::kOff;
+const unsigned char kClicked = RelayHistory::kPressed | RelayHistory::kReleased;
+
+}  // namespace
+
+
+void RelayHistoryTest::rangeBoundaries()
+{
+    RelayHistory history;
+    history.addRelayStatus(100, RelayID::One);
+    history.addRelayStatus(200, RelayID::None);
+
+    // the state is unknown before the first status
+    QCOMPARE(history.levels(0, 0, 100), static_cast<unsigned char>(0));
+    // the start of the range is inclusive and the end is exclusive
+    QCOMPARE(history.levels(0, 100, 101), RelayHistory::kOn);
+    QCOMPARE(history.levels(0, 99, 100), static_cast<unsigned char>(0));
+    QCOMPARE(history.levels(0, 150, 200), RelayHistory::kOn);
+    QCOMPARE(history.levels(0, 150, 201), kBoth);
+    // the transition at the start of the range replaces the previous state
+    QCOMPARE(history.levels(0, 200, 201), RelayHistory::kOff);
+    // the last state lasts until the next transition
+    QCOMPARE(history.levels(0, 500, 600), RelayHistory::kOff);
+    QCOMPARE(history.levels(0, 120, 180), RelayHistory::kOn);
+}
+
+
+void RelayHistoryTest::firstStatus()
+{
+    RelayHistory history;
+    // the first status records all the relays, the following ones only the changed relays
+    history.addRelayStatus(10, RelayID::Two);
+    for (unsigned int relay = 0; relay < 8; ++relay) {
+        QCOMPARE(history.transitionCount(relay), std::size_t{1});
+    }
+    history.addRelayStatus(20, RelayID::Two | RelayID::Three);
+    QCOMPARE(history.transitionCount(1), std::size_t{1});
+    QCOMPARE(history.transitionCount(2), std::size_t{2});
+    QCOMPARE(history.levels(0, 10, 11), RelayHistory::kOff);
+    QCOMPARE(history.levels(1, 10, 11), RelayHistory::kOn);
+    QCOMPARE(history.levels(2, 10, 30), kBoth);
+}
+
+
+void RelayHistoryTest::columnMinMax()
+{
+    const qint64 kColumn = 10;
+    RelayHistory history;
+    history.addRelayStatus(0, RelayID::None);
+    // fast switching in the second column, a single switch on in the third one
+    RelayID current = RelayID::None;
+    for (qint64 t = 11; t < 19; ++t) {
+        current ^= RelayID::One;
+        history.addRelayStatus(t, current);
+    }
+    history.addRelayStatus(25, RelayID::One);
+
+    QCOMPARE(history.levels(0, 0, kColumn), RelayHistory::kOff);
+    QCOMPARE(history.levels(0, kColumn, 2 * kColumn), kBoth);
+    QCOMPARE(history.levels(0, 2 * kColumn, 3 * kColumn), kBoth);
+    QCOMPARE(history.levels(0, 3 * kColumn, 4 * kColumn), RelayHistory::kOn);
+    // the other relays stay switched off in each column
+    for (qint64 column = 0; column < 4; ++column) {
+        QCOMPARE(history.levels(1, column * kColumn, (column + 1) * kColumn), RelayHistory::kOff);
+    }
+    // one column covering the whole history
+    QCOMPARE(history.levels(0, 0, 100), kBoth);
+}
+
+
+void RelayHistoryTest::buttonEvents()
+{
+    RelayHistory history;
+    history.addButtonStatus(10, RelayID::One, RelayID::None);
+    history.addButtonStatus(20, RelayID::None, RelayID::One);
+    // the press and the release reported by the same status
+    history.addButtonStatus(30, RelayID::Two, RelayID::Two);
+
+    QCOMPARE(history.buttonEventCount(0), std::size_t{2});
+    QCOMPARE(history.buttonEventCount(1), std::size_t{2});
+    QCOMPARE(history.buttonEvents(0, 10, 11), RelayHistory::kPressed);
+    QCOMPARE(history.buttonEvents(0, 11, 20), static_cast<unsigned char>(0));
+    QCOMPARE(history.buttonEvents(0, 20, 21), RelayHistory::kReleased);
+    QCOMPARE(history.buttonEvents(0, 0, 100), kClicked);
+    QCOMPARE(history.buttonEvents(1, 30, 31), kClicked);
+    QCOMPARE(history.buttonEvents(2, 0, 100), static_cast<unsigned char>(0));
+}
+
+
+void RelayHistoryTest::eviction()
+{
+    QCOMPARE(RelayHistory{0}.capacity(), std::size_t{1});
+
+    RelayHistory history{3};
+    RelayID current = RelayID::None;
+    history.addRelayStatus(10, current);
+    for (qint64 t = 20; t <= 50; t += 10) {
+        current ^= RelayID::One;
+        history.addRelayStatus(t, current);
+        history.addButtonStatus(t, RelayID::One, RelayID::None);
+    }
+
+    // the oldest transitions are discarded, their range is unknown again
+    QCOMPARE(history.transitionCount(0), std::size_t{3});
+    QCOMPARE(history.levels(0, 0, 30), static_cast<unsigned char>(0));
+    QCOMPARE(history.levels(0, 30, 31), RelayHistory::kOff);
+    QCOMPARE(history.levels(0, 50, 60), RelayHistory::kOff);
+    QCOMPARE(history.levels(0, 40, 50), RelayHistory::kOn);
+    // relays without transitions keep their first status
+    QCOMPARE(history.transitionCount(1), std::size_t{1});
+    QCOMPARE(history.levels(1, 10, 11), RelayHistory::kOff);
+
+    QCOMPARE(history.buttonEventCount(0), std::size_t{3});
+    QCOMPARE(history.buttonEvents(0, 0, 30), static_cast<unsigned char>(0));
+    QCOMPARE(history.buttonEvents(0, 30, 31), RelayHistory::kPressed);
+}
+
+
+void RelayHistoryTest::clear()
+{
+    RelayHistory history;
+    history.addRelayStatus(10, RelayID::One);
+    history.addButtonStatus(10, RelayID::One, RelayID::None);
+    history.clear();
+    QCOMPARE(history.transitionCount(0), std::size_t{0});
+    QCOMPARE(history.buttonEventCount(0), std::size_t{0});
+    QCOMPARE(history.levels(0, 0, 100), static_cast<unsigned char>(0));
+
+    // the next status records all the relays again
+    history.addRelayStatus(20, RelayID::One);
+    QCOMPARE(history.transitionCount(0), std::size_t{1});
+    QCOMPARE(history.transitionCount(7), std::size_t{1});
+}
+
+}  // namespace gui
+}  // namespace sprelay
+}  // namespace biomolecules